@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/HashAggregate.hpp>
+#include <db/HeapFile.hpp>
+#include <db/SeqScan.hpp>
+#include <db/StreamAggregate.hpp>
+#include <map>
+
+namespace {
+    constexpr int num_tuples = 200000;
+    constexpr int num_parts = 4;
+
+    const db::TupleDesc td({db::type_t::INT, db::type_t::INT, db::type_t::DOUBLE}, {"id", "customer", "amount"});
+
+    const std::vector<db::Aggregate> aggregates = {{db::AggregateOp::COUNT, 0},
+                                                   {db::AggregateOp::SUM,   2},
+                                                   {db::AggregateOp::MAX,   2}};
+
+    /// Orders [first, last) of `groups` customers
+    template<typename File, typename... Args>
+    db::DbFile &ordersFile(const std::string &name, int first, int last, int groups, Args... args) {
+        std::remove(name.c_str());
+        db::getDatabase().getBufferPool().resize(4096);
+        db::getDatabase().add(std::make_unique<File>(name, td, args...));
+        auto &file = db::getDatabase().get(name);
+        for (int i = first; i < last; i++) {
+            file.insertTuple({{i, static_cast<int>((static_cast<int64_t>(i) * 7919) % groups),
+                               static_cast<double>(i % 100)}});
+        }
+        return file;
+    }
+
+    /// The orders split into files of the same size
+    const std::vector<db::DbFile *> &parts(int groups, int count) {
+        static std::map<std::pair<int, int>, std::vector<db::DbFile *>> files;
+        auto &result = files[{groups, count}];
+        if (result.empty()) {
+            for (int p = 0; p < count; p++) {
+                const std::string name = "bench_aggregate_" + std::to_string(groups) + "_" + std::to_string(count) +
+                                         "_" + std::to_string(p) + ".db";
+                result.push_back(&ordersFile<db::HeapFile>(name, p * num_tuples / count,
+                                                           (p + 1) * num_tuples / count, groups));
+            }
+        }
+        return result;
+    }
+
+    db::DbFile &ordersTree() {
+        // sorted on (customer, id)
+        static db::DbFile &file = ordersFile<db::BTreeFile>("bench_aggregate_btree.db", 0, num_tuples, 1000,
+                                                            std::vector<size_t>{1, 0});
+        return file;
+    }
+
+    std::vector<std::unique_ptr<db::Operator>> scans(const std::vector<db::DbFile *> &files) {
+        std::vector<std::unique_ptr<db::Operator>> result;
+        for (auto *file: files) {
+            result.push_back(std::make_unique<db::SeqScan>(*file));
+        }
+        return result;
+    }
+
+    size_t drain(db::Operator &op) {
+        size_t count = 0;
+        op.open();
+        while (op.next()) {
+            count++;
+        }
+        return count;
+    }
+} // namespace
+
+/**
+ * SELECT customer, COUNT(id), SUM(amount), MAX(amount) GROUP BY customer over a HeapFile. The argument is the number
+ * of customers.
+ */
+static void BM_HashAggregate(benchmark::State &state) {
+    const auto &files = parts(static_cast<int>(state.range(0)), 1);
+    db::HashAggregate aggregate(scans(files), {1}, aggregates);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(aggregate));
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_HashAggregate)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+/**
+ * The same query over the table split into 4 files, aggregated by 4 threads with thread-local tables.
+ */
+static void BM_ParallelHashAggregate(benchmark::State &state) {
+    const auto &files = parts(static_cast<int>(state.range(0)), num_parts);
+    db::HashAggregate aggregate(scans(files), {1}, aggregates);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(aggregate));
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_ParallelHashAggregate)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * The query with 100000 customers and a memory budget of 256 KB, most groups are written to disk.
+ */
+static void BM_SpillHashAggregate(benchmark::State &state) {
+    const auto &files = parts(100000, 1);
+    db::HashAggregate aggregate(scans(files), {1}, aggregates, 256 * 1024);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(aggregate));
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_SpillHashAggregate)->Unit(benchmark::kMillisecond);
+
+/**
+ * The query with 1000 customers over a BTreeFile sorted on the customer, with a hash table and with streaming.
+ */
+static void BM_BTreeHashAggregate(benchmark::State &state) {
+    db::HashAggregate aggregate(std::make_unique<db::SeqScan>(ordersTree()), {1}, aggregates);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(aggregate));
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_BTreeHashAggregate)->Unit(benchmark::kMillisecond);
+
+static void BM_StreamAggregate(benchmark::State &state) {
+    db::StreamAggregate aggregate(std::make_unique<db::SeqScan>(ordersTree()), {1}, aggregates);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(aggregate));
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_StreamAggregate)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,87 @@
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <db/BTreeFile.hpp>
+#include <db/BTreeScan.hpp>
+#include <db/Database.hpp>
+#include <db/Gather.hpp>
+#include <random>
+
+namespace {
+    constexpr int preloaded_keys = 200000;
+
+    std::atomic<int> next_key{preloaded_keys};
+
+    db::BTreeFile &mixedFile() {
+        static db::BTreeFile &file = [] () -> db::BTreeFile & {
+            const char *name = "bench_btree_mixed.db";
+            std::remove(name);
+            // every thread pins at most a few pages per level of the tree
+            db::getDatabase().getBufferPool().resize(4096);
+            db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+            db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+            auto &file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+            for (int i = 0; i < preloaded_keys; i++) {
+                file.insertTuple({{i, "apple", 1.0}});
+            }
+            return file;
+        }();
+        return file;
+    }
+} // namespace
+
+/**
+ * Mixed point lookups and inserts of new keys. The argument is the percentage of inserts.
+ */
+static void BM_BTreeMixed(benchmark::State &state) {
+    db::BTreeFile &file = mixedFile();
+    const int insert_pct = static_cast<int>(state.range(0));
+    std::mt19937 gen(state.thread_index());
+    std::uniform_int_distribution<int> op(0, 99);
+    std::uniform_int_distribution<int> key(0, preloaded_keys - 1);
+    for (auto _: state) {
+        if (op(gen) < insert_pct) {
+            file.insertTuple({{next_key++, "orange", 2.0}});
+        } else {
+            benchmark::DoNotOptimize(file.lookup(key(gen)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_BTreeMixed)->Arg(5)->Arg(50)->ThreadRange(1, 64)->UseRealTime();
+
+/**
+ * Read-only point lookups of existing keys.
+ */
+static void BM_BTreeLookup(benchmark::State &state) {
+    db::BTreeFile &file = mixedFile();
+    std::mt19937 gen(state.thread_index());
+    std::uniform_int_distribution<int> key(0, preloaded_keys - 1);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(file.lookup(key(gen)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_BTreeLookup)->ThreadRange(1, 64)->UseRealTime();
+
+/**
+ * An ordered scan of a range of half of the preloaded keys, split into parts at the level of the index pages and
+ * merged in key order by an ordered Gather. The argument is the number of parts (threads).
+ */
+static void BM_BTreeParallelRangeScan(benchmark::State &state) {
+    db::BTreeFile &file = mixedFile();
+    db::Gather gather(db::BTreeScan::create(file, state.range(0), {preloaded_keys / 4}, {preloaded_keys * 3 / 4}),
+                      0, true);
+    for (auto _: state) {
+        size_t count = 0;
+        gather.open();
+        while (gather.next()) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * preloaded_keys / 2);
+}
+
+BENCHMARK(BM_BTreeParallelRangeScan)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,72 @@
+#include <benchmark/benchmark.h>
+#include <db/Crc32c.hpp>
+#include <db/DbFile.hpp>
+#include <db/PageFormat.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+    constexpr size_t num_pages = 1024;
+
+    const db::TupleDesc td({db::type_t::INT}, {"id"});
+
+    const char *pagesFile() {
+        static const char *name = [] {
+            const char *name = "bench_checksum.db";
+            std::remove(name);
+            db::DbFile file(name, td);
+            db::Page page;
+            for (size_t id = 0; id < num_pages; id++) {
+                page.fill(static_cast<uint8_t>(id));
+                file.writePage(page, id);
+            }
+            return name;
+        }();
+        return name;
+    }
+} // namespace
+
+/**
+ * The checksum of a page.
+ */
+static void BM_Crc32c(benchmark::State &state) {
+    db::Page page;
+    page.fill(42);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(db::crc32c(page.data(), page.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(page.size()));
+}
+
+BENCHMARK(BM_Crc32c);
+
+/**
+ * Reading the pages of a file that is in the page cache, the cheapest I/O: with the verification of the checksums
+ * (DbFile::readPage), and with a plain pread of the same bytes.
+ */
+static void BM_ReadPage(benchmark::State &state) {
+    db::DbFile file(pagesFile(), td);
+    db::Page page;
+    size_t id = 0;
+    for (auto _: state) {
+        file.readPage(page, id);
+        id = (id + 1) % num_pages;
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(page.size()));
+}
+
+BENCHMARK(BM_ReadPage);
+
+static void BM_ReadPageUnchecked(benchmark::State &state) {
+    const int fd = open(pagesFile(), O_RDONLY);
+    db::Page page{};
+    size_t id = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(pread(fd, page.data(), page.size(), static_cast<off_t>(db::pageOffset(id))));
+        id = (id + 1) % num_pages;
+    }
+    close(fd);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(db::DEFAULT_PAGE_SIZE));
+}
+
+BENCHMARK(BM_ReadPageUnchecked);
@@ -0,0 +1,64 @@
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <db/Database.hpp>
+#include <db/HashFile.hpp>
+#include <random>
+
+namespace {
+    constexpr int preloaded_keys = 200000;
+
+    std::atomic<int> next_key{preloaded_keys};
+
+    db::HashFile &mixedFile() {
+        static db::HashFile &file = [] () -> db::HashFile & {
+            const char *name = "bench_hash_mixed.db";
+            std::remove(name);
+            db::getDatabase().getBufferPool().resize(4096);
+            db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+            db::getDatabase().add(std::make_unique<db::HashFile>(name, td, 0));
+            auto &file = dynamic_cast<db::HashFile &>(db::getDatabase().get(name));
+            for (int i = 0; i < preloaded_keys; i++) {
+                file.insertTuple({{i, "apple", 1.0}});
+            }
+            return file;
+        }();
+        return file;
+    }
+} // namespace
+
+/**
+ * Mixed point lookups and inserts of new keys, same workload as BM_BTreeMixed. The argument is the percentage of
+ * inserts.
+ */
+static void BM_HashMixed(benchmark::State &state) {
+    db::HashFile &file = mixedFile();
+    const int insert_pct = static_cast<int>(state.range(0));
+    std::mt19937 gen(state.thread_index());
+    std::uniform_int_distribution<int> op(0, 99);
+    std::uniform_int_distribution<int> key(0, preloaded_keys - 1);
+    for (auto _: state) {
+        if (op(gen) < insert_pct) {
+            file.insertTuple({{next_key++, "orange", 2.0}});
+        } else {
+            benchmark::DoNotOptimize(file.lookup(key(gen)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HashMixed)->Arg(5)->Arg(50)->ThreadRange(1, 64)->UseRealTime();
+
+/**
+ * Read-only point lookups of existing keys, same workload as BM_BTreeLookup. Every lookup latches a single page.
+ */
+static void BM_HashLookup(benchmark::State &state) {
+    db::HashFile &file = mixedFile();
+    std::mt19937 gen(state.thread_index());
+    std::uniform_int_distribution<int> key(0, preloaded_keys - 1);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(file.lookup(key(gen)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HashLookup)->ThreadRange(1, 64)->UseRealTime();
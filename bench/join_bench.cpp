@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/GraceHashJoin.hpp>
+#include <db/HashJoin.hpp>
+#include <db/HeapFile.hpp>
+#include <db/SeqScan.hpp>
+#include <db/SortMergeJoin.hpp>
+
+namespace {
+    constexpr int num_build = 50000;
+    constexpr int num_probe = 200000;
+
+    const db::TupleDesc build_td({db::type_t::INT, db::type_t::CHAR}, {"b_key", "b_name"});
+    const db::TupleDesc probe_td({db::type_t::INT, db::type_t::DOUBLE}, {"p_key", "p_value"});
+
+    /// Every probe row matches one build row
+    template<typename File, typename... Args>
+    db::DbFile &joinFile(const char *name, const db::TupleDesc &td, int count, Args... args) {
+        std::remove(name);
+        db::getDatabase().getBufferPool().resize(4096);
+        db::getDatabase().add(std::make_unique<File>(name, td, args...));
+        auto &file = db::getDatabase().get(name);
+        for (int i = 0; i < count; i++) {
+            const int key = static_cast<int>((static_cast<int64_t>(i) * 7919) % count) % num_build;
+            if (td.field_type(1) == db::type_t::CHAR) {
+                file.insertTuple({{key, "name" + std::to_string(key % 100)}});
+            } else {
+                file.insertTuple({{key, static_cast<double>(i)}});
+            }
+        }
+        return file;
+    }
+
+    db::DbFile &heapBuild() {
+        static db::DbFile &file = joinFile<db::HeapFile>("bench_join_build.db", build_td, num_build);
+        return file;
+    }
+
+    db::DbFile &heapProbe() {
+        static db::DbFile &file = joinFile<db::HeapFile>("bench_join_probe.db", probe_td, num_probe);
+        return file;
+    }
+
+    db::DbFile &btreeBuild() {
+        static db::DbFile &file = joinFile<db::BTreeFile>("bench_join_build_btree.db", build_td, num_build,
+                                                          size_t{0});
+        return file;
+    }
+
+    db::DbFile &btreeProbe() {
+        static db::DbFile &file = joinFile<db::BTreeFile>("bench_join_probe_btree.db", probe_td, num_probe,
+                                                          std::vector<size_t>{0, 1});
+        return file;
+    }
+
+    size_t drain(db::Operator &op) {
+        size_t count = 0;
+        op.open();
+        while (op.next()) {
+            benchmark::DoNotOptimize(op.row());
+            count++;
+        }
+        return count;
+    }
+} // namespace
+
+/**
+ * In-memory hash join of a 50k row build side with a 200k row probe side, in probe rows per second.
+ */
+static void BM_HashJoin(benchmark::State &state) {
+    db::DbFile &build = heapBuild();
+    db::DbFile &probe = heapProbe();
+    db::HashJoin join(std::make_unique<db::SeqScan>(build), std::make_unique<db::SeqScan>(probe), 0, 0);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(join));
+    }
+    state.SetItemsProcessed(state.iterations() * num_probe);
+}
+
+BENCHMARK(BM_HashJoin)->Unit(benchmark::kMillisecond);
+
+/**
+ * The same join with a memory budget of 1/argument of the build side, so that both sides are partitioned to disk.
+ */
+static void BM_GraceHashJoin(benchmark::State &state) {
+    db::DbFile &build = heapBuild();
+    db::DbFile &probe = heapProbe();
+    const size_t budget = num_build * build_td.length() / state.range(0);
+    db::GraceHashJoin join(std::make_unique<db::SeqScan>(build), std::make_unique<db::SeqScan>(probe), 0, 0, budget,
+                           2 * state.range(0));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(join));
+    }
+    state.SetItemsProcessed(state.iterations() * num_probe);
+}
+
+BENCHMARK(BM_GraceHashJoin)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+
+/**
+ * Merge join of the same tables stored in BTreeFiles sorted on the join key.
+ */
+static void BM_SortMergeJoin(benchmark::State &state) {
+    db::DbFile &build = btreeBuild();
+    db::DbFile &probe = btreeProbe();
+    db::SortMergeJoin join(std::make_unique<db::SeqScan>(build), std::make_unique<db::SeqScan>(probe), 0, 0);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(join));
+    }
+    state.SetItemsProcessed(state.iterations() * num_probe);
+}
+
+BENCHMARK(BM_SortMergeJoin)->Unit(benchmark::kMillisecond);
+
+/**
+ * The hash join of the BTreeFiles, to compare with the merge join on the same inputs.
+ */
+static void BM_HashJoinBTree(benchmark::State &state) {
+    db::DbFile &build = btreeBuild();
+    db::DbFile &probe = btreeProbe();
+    db::HashJoin join(std::make_unique<db::SeqScan>(build), std::make_unique<db::SeqScan>(probe), 0, 0);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(join));
+    }
+    state.SetItemsProcessed(state.iterations() * num_probe);
+}
+
+BENCHMARK(BM_HashJoinBTree)->Unit(benchmark::kMillisecond);
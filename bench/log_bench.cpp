@@ -0,0 +1,140 @@
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/LogManager.hpp>
+#include <filesystem>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    std::atomic<int> next_key{0};
+
+    /// A new empty BTreeFile on the id, the file of the previous call is removed
+    db::BTreeFile &emptyTree(const std::string &prefix) {
+        static std::string previous;
+        static int counter = 0;
+        if (!previous.empty()) {
+            db::getDatabase().remove(previous);
+            std::remove(previous.c_str());
+        }
+        previous = prefix + "_" + std::to_string(counter++) + ".db";
+        std::remove(previous.c_str());
+        db::getDatabase().add(std::make_unique<db::BTreeFile>(previous, td, 0));
+        return dynamic_cast<db::BTreeFile &>(db::getDatabase().get(previous));
+    }
+
+    db::BTreeFile *tree = nullptr;
+
+    constexpr int recovery_inserts = 100000;
+
+    /**
+     * Save a log of random inserts into a BTreeFile, committed by groups of 1000, and the file as it was when the process
+     * stopped. With a checkpoint, the pages are written and a checkpoint is taken after two thirds of the inserts.
+     */
+    void saveCrash(bool checkpoint) {
+        const char *name = "bench_log_recovery.db";
+        std::remove(name);
+        std::remove("bench_log_recovery.log");
+        auto &database = db::getDatabase();
+        auto &pool = database.getBufferPool();
+        pool.resize(4096);
+        database.setLog(std::make_unique<db::LogManager>("bench_log_recovery.log"));
+        database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+        auto &file = database.get(name);
+        for (int i = 0; i < recovery_inserts; i++) {
+            file.insertTuple({{static_cast<int>(static_cast<int64_t>(i) * 7919 % recovery_inserts), "apple", 1.0}});
+            if (i % 1000 == 999) {
+                database.getLog()->commit();
+            }
+            if (checkpoint && i == recovery_inserts * 2 / 3) {
+                pool.resize(pool.size());
+                database.checkpoint();
+            }
+        }
+        database.getLog()->commit();
+        for (size_t page = 0; page < file.getNumPages(); page++) {
+            if (pool.contains({name, page})) {
+                pool.discardPage({name, page});
+            }
+        }
+        database.remove(name);
+        database.setLog(nullptr);
+        std::filesystem::copy_file(name, "bench_log_recovery.db.saved",
+                                   std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::copy_file("bench_log_recovery.log", "bench_log_recovery.log.saved",
+                                   std::filesystem::copy_options::overwrite_existing);
+    }
+} // namespace
+
+/**
+ * A transaction that inserts a tuple and commits by forcing the dirty pages: every page is written with a random write
+ * and the file is synced.
+ */
+static void BM_CommitForce(benchmark::State &state) {
+    auto &file = emptyTree("bench_log_force");
+    for (auto _: state) {
+        file.insertTuple({{next_key++, "apple", 1.0}});
+        db::getDatabase().getBufferPool().flushFile(file.getName());
+        file.sync();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CommitForce)->UseRealTime();
+
+/**
+ * The same transactions committed with the write-ahead log: the changes are appended to the log and synced, the pages
+ * stay dirty in the buffer pool. Concurrent commits share the syncs of the log, the argument is the group delay in
+ * microseconds.
+ */
+static void BM_CommitLog(benchmark::State &state) {
+    if (state.thread_index() == 0) {
+        std::remove("bench_log.log");
+        db::getDatabase().setLog(
+                std::make_unique<db::LogManager>("bench_log.log", std::chrono::microseconds(state.range(0))));
+        tree = &emptyTree("bench_log_wal");
+    }
+    for (auto _: state) {
+        tree->insertTuple({{next_key++, "apple", 1.0}});
+        db::getDatabase().getLog()->commit();
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        const auto &log = *db::getDatabase().getLog();
+        state.counters["commits_per_sync"] =
+                static_cast<double>(log.getNumCommits()) / static_cast<double>(std::max<size_t>(log.getNumSyncs(), 1));
+        db::getDatabase().getBufferPool().flushFile(tree->getName());
+        db::getDatabase().setLog(nullptr);
+        std::remove("bench_log.log");
+    }
+}
+
+BENCHMARK(BM_CommitLog)->Arg(0)->Arg(200)->ThreadRange(1, 16)->UseRealTime();
+
+/**
+ * Opening the log of 100k inserts after a crash. The first argument is the number of redo threads, the second one is 1
+ * if a checkpoint was taken after two thirds of the inserts.
+ */
+static void BM_Recovery(benchmark::State &state) {
+    saveCrash(state.range(1) != 0);
+    size_t redone = 0;
+    for (auto _: state) {
+        state.PauseTiming();
+        std::filesystem::copy_file("bench_log_recovery.db.saved", "bench_log_recovery.db",
+                                   std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::copy_file("bench_log_recovery.log.saved", "bench_log_recovery.log",
+                                   std::filesystem::copy_options::overwrite_existing);
+        state.ResumeTiming();
+        db::LogManager log("bench_log_recovery.log", {}, state.range(0));
+        redone = log.getNumRedone();
+    }
+    state.counters["redone"] = static_cast<double>(redone);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(redone));
+    for (const char *name: {"bench_log_recovery.db", "bench_log_recovery.log", "bench_log_recovery.db.saved",
+                            "bench_log_recovery.log.saved"}) {
+        std::remove(name);
+    }
+}
+
+BENCHMARK(BM_Recovery)->ArgsProduct({{1, 4}, {0, 1}})->Unit(benchmark::kMillisecond)->UseRealTime();
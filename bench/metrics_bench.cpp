@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <db/Metrics.hpp>
+#include <db/Tracer.hpp>
+
+/**
+ * The cost of the metrics on the hot paths: a Counter increment and a Histogram record, from 1 or 4 threads sharing
+ * the metrics.
+ */
+static void BM_CounterAdd(benchmark::State &state) {
+    static db::Counter counter;
+    for (auto _: state) {
+        counter.add();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CounterAdd)->Threads(1)->Threads(4);
+
+static void BM_HistogramRecord(benchmark::State &state) {
+    static db::Histogram histogram;
+    uint64_t value = 1000;
+    for (auto _: state) {
+        histogram.record(value);
+        value = value * 1103515245 % 1000003;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HistogramRecord)->Threads(1)->Threads(4);
+
+/**
+ * A latency measurement: two clock reads around an empty section.
+ */
+static void BM_LatencyTimer(benchmark::State &state) {
+    static db::Histogram histogram;
+    for (auto _: state) {
+        db::LatencyTimer timer(histogram);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_LatencyTimer);
+
+/**
+ * A span of the Tracer around an empty section, with tracing off (arg 0) and on (arg 1).
+ */
+static void BM_TraceSpan(benchmark::State &state) {
+    if (state.range(0) != 0) {
+        db::Tracer::start();
+    }
+    size_t spans = 0;
+    for (auto _: state) {
+        db::TraceSpan span("span", "bench");
+        // keep the trace small while tracing
+        if (++spans % 100000 == 0 && db::Tracer::enabled()) {
+            db::Tracer::start();
+        }
+    }
+    db::Tracer::stop();
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_TraceSpan)->Arg(0)->Arg(1);
@@ -0,0 +1,92 @@
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <db/Database.hpp>
+#include <db/SeqScan.hpp>
+#include <db/SnapshotScan.hpp>
+#include <db/VersionedHeapFile.hpp>
+#include <thread>
+
+namespace {
+    constexpr int num_tuples = 100000;
+    constexpr int max_inserts = 100000;
+
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int i) { return {{i, "name" + std::to_string(i % 1000), (i % 100) / 4.0}}; }
+
+    /// A new VersionedHeapFile with the ids below num_tuples, the file of the previous call is removed
+    db::VersionedHeapFile &itemsFile() {
+        static std::string previous;
+        static int counter = 0;
+        if (!previous.empty()) {
+            db::getDatabase().remove(previous);
+            std::remove(previous.c_str());
+        }
+        previous = "bench_mvcc_" + std::to_string(counter++) + ".db";
+        const char *name = previous.c_str();
+        std::remove(name);
+        db::getDatabase().getBufferPool().resize(4096);
+        db::getDatabase().add(std::make_unique<db::VersionedHeapFile>(name, td, std::chrono::milliseconds(1)));
+        auto &file = dynamic_cast<db::VersionedHeapFile &>(db::getDatabase().get(name));
+        for (int i = 0; i < num_tuples; i++) {
+            file.insertTuple(item(i));
+        }
+        return file;
+    }
+
+    /**
+     * Scan a file while another thread inserts tuples in it, if the argument of the benchmark is 1. The scan only
+     * counts the ids of the initial tuples.
+     */
+    template<typename Scan>
+    void scanDuringIngest(benchmark::State &state) {
+        auto &file = itemsFile();
+        std::atomic<bool> stop{false};
+        std::atomic<int> inserts{0};
+        std::thread writer;
+        if (state.range(0) != 0) {
+            writer = std::thread([&] {
+                while (!stop && inserts < max_inserts) {
+                    file.insertTuple(item(num_tuples + inserts++));
+                }
+            });
+        }
+        Scan scan(file);
+        scan.pushDown({0, db::PredicateOp::LT, num_tuples});
+        const auto start = std::chrono::steady_clock::now();
+        for (auto _: state) {
+            size_t count = 0;
+            scan.open();
+            while (scan.next()) {
+                count++;
+            }
+            if (count != num_tuples) {
+                state.SkipWithError("wrong number of tuples");
+                break;
+            }
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        stop = true;
+        if (writer.joinable()) {
+            writer.join();
+        }
+        state.SetItemsProcessed(state.iterations() * num_tuples);
+        state.counters["inserts_per_second"] = inserts / elapsed.count();
+    }
+} // namespace
+
+/**
+ * A snapshot scan of a versioned file: the scan reads the pages without latching them, and the writer does not wait
+ * for the scan.
+ */
+static void BM_SnapshotScan(benchmark::State &state) { scanDuringIngest<db::SnapshotScan>(state); }
+
+BENCHMARK(BM_SnapshotScan)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * The same scan of the latest versions, which latches every page in shared mode while the writer latches the last
+ * page in exclusive mode.
+ */
+static void BM_LatchedScan(benchmark::State &state) { scanDuringIngest<db::SeqScan>(state); }
+
+BENCHMARK(BM_LatchedScan)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
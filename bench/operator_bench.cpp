@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include <db/Batch.hpp>
+#include <db/Database.hpp>
+#include <db/Filter.hpp>
+#include <db/Gather.hpp>
+#include <db/HeapFile.hpp>
+#include <db/MorselScan.hpp>
+#include <db/Project.hpp>
+#include <db/SeqScan.hpp>
+
+namespace {
+    constexpr int num_tuples = 200000;
+
+    db::HeapFile &scanFile() {
+        static db::HeapFile &file = [] () -> db::HeapFile & {
+            const char *name = "bench_scan.db";
+            std::remove(name);
+            db::getDatabase().getBufferPool().resize(4096);
+            db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+            db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+            auto &file = dynamic_cast<db::HeapFile &>(db::getDatabase().get(name));
+            for (int i = 0; i < num_tuples; i++) {
+                file.insertTuple({{i, "apple", static_cast<double>(i % 100)}});
+            }
+            return file;
+        }();
+        return file;
+    }
+} // namespace
+
+/**
+ * SELECT SUM(price) FROM file WHERE id < n with a tuple at a time loop over the iterators of the file. The argument
+ * is the selectivity of the predicate in percent.
+ */
+static void BM_IteratorSum(benchmark::State &state) {
+    db::HeapFile &file = scanFile();
+    const int bound = static_cast<int>(num_tuples * state.range(0) / 100);
+    for (auto _: state) {
+        double sum = 0;
+        for (const db::Tuple &t: file) {
+            if (std::get<int>(t.get_field(0)) < bound) {
+                sum += std::get<double>(t.get_field(2));
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_IteratorSum)->Arg(1)->Arg(50)->Arg(100);
+
+/**
+ * The same query with a SeqScan, a pushed down predicate and a projection.
+ */
+static void BM_OperatorSum(benchmark::State &state) {
+    db::HeapFile &file = scanFile();
+    const int bound = static_cast<int>(num_tuples * state.range(0) / 100);
+    db::Filter filter(std::make_unique<db::Project>(std::make_unique<db::SeqScan>(file), std::vector<size_t>{0, 2}),
+                      {{0, db::PredicateOp::LT, bound}});
+    for (auto _: state) {
+        double sum = 0;
+        filter.open();
+        while (filter.next()) {
+            sum += filter.getDouble(1);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_OperatorSum)->Arg(1)->Arg(50)->Arg(100);
+
+/**
+ * The same query with a BatchScan: the predicate refines the selection vector of every batch and the sum runs over
+ * the price column.
+ */
+static void BM_BatchSum(benchmark::State &state) {
+    db::HeapFile &file = scanFile();
+    const int bound = static_cast<int>(num_tuples * state.range(0) / 100);
+    db::BatchScan scan(file);
+    scan.pushDown({0, db::PredicateOp::LT, bound});
+    db::Batch batch(file.getTupleDesc(), {0, 2});
+    for (auto _: state) {
+        double sum = 0;
+        scan.open();
+        while (scan.next(batch)) {
+            sum += batch.sum(2);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_BatchSum)->Arg(1)->Arg(50)->Arg(100);
+
+/**
+ * The query with 50% selectivity over a morsel-driven parallel scan: each worker filters and projects its morsels
+ * in its own thread, and a Gather merges the rows. The argument is the number of workers.
+ */
+static void BM_ParallelOperatorSum(benchmark::State &state) {
+    db::HeapFile &file = scanFile();
+    std::vector<std::unique_ptr<db::Operator>> pipelines;
+    for (auto &scan: db::MorselScan::create(file, state.range(0))) {
+        pipelines.push_back(std::make_unique<db::Project>(std::move(scan), std::vector<size_t>{0, 2}));
+    }
+    db::Gather gather(std::move(pipelines));
+    gather.pushDown({0, db::PredicateOp::LT, num_tuples / 2});
+    for (auto _: state) {
+        double sum = 0;
+        gather.open();
+        while (gather.next()) {
+            sum += gather.getDouble(1);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_ParallelOperatorSum)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
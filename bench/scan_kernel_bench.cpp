@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include <db/ScanKernels.hpp>
+#include <db/Tuple.hpp>
+#include <random>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    /// The tuples of a HeapPage, a data region with the stride of the tuples
+    constexpr size_t num_rows = 1 << 16;
+
+    const std::vector<uint8_t> &rows() {
+        static const std::vector<uint8_t> rows = [] {
+            std::vector<uint8_t> rows(num_rows * td.length());
+            std::mt19937 gen(0);
+            std::uniform_int_distribution<int> value(0, 99);
+            for (size_t i = 0; i < num_rows; i++) {
+                int v = value(gen);
+                td.serialize(rows.data() + i * td.length(), {{v, "name" + std::to_string(v), static_cast<double>(v)}});
+            }
+            return rows;
+        }();
+        return rows;
+    }
+
+    /// Run a kernel with the instruction set of the argument, skip the benchmark if it is not supported
+    template<typename F>
+    void runKernel(benchmark::State &state, F kernel) {
+        const auto level = static_cast<db::SimdLevel>(state.range(0));
+        if (!db::simdSupported(level)) {
+            state.SkipWithError("instruction set not supported");
+            return;
+        }
+        const db::SimdLevel initial = db::getSimdLevel();
+        db::setSimdLevel(level);
+        std::vector<uint64_t> bitmap(num_rows / 64);
+        for (auto _: state) {
+            kernel(bitmap.data());
+            benchmark::DoNotOptimize(bitmap.data());
+        }
+        db::setSimdLevel(initial);
+        state.SetItemsProcessed(state.iterations() * num_rows);
+    }
+
+    void levels(benchmark::internal::Benchmark *b) {
+        b->ArgName("level");
+        for (auto level: {db::SimdLevel::SCALAR, db::SimdLevel::AVX2, db::SimdLevel::AVX512}) {
+            b->Arg(static_cast<int>(level));
+        }
+    }
+} // namespace
+
+/**
+ * `id BETWEEN 10 AND 59` on the INT field. The argument is the instruction set (0 scalar, 1 AVX2, 2 AVX-512), the
+ * items are rows (single thread, so rows/sec per core).
+ */
+static void BM_SelectIntRange(benchmark::State &state) {
+    const uint8_t *data = rows().data() + td.offset_of(0);
+    runKernel(state, [&](uint64_t *bitmap) { db::selectIntRange(data, td.length(), num_rows, 10, 59, bitmap); });
+}
+
+BENCHMARK(BM_SelectIntRange)->Apply(levels);
+
+/**
+ * `price < 50.0` on the DOUBLE field.
+ */
+static void BM_SelectDoubleRange(benchmark::State &state) {
+    const uint8_t *data = rows().data() + td.offset_of(2);
+    runKernel(state, [&](uint64_t *bitmap) {
+        db::selectDoubleRange(data, td.length(), num_rows, -1e300, 49.5, bitmap);
+    });
+}
+
+BENCHMARK(BM_SelectDoubleRange)->Apply(levels);
+
+/**
+ * `name = 'name42'` on the CHAR field.
+ */
+static void BM_SelectCharEqual(benchmark::State &state) {
+    const uint8_t *data = rows().data() + td.offset_of(1);
+    std::vector<uint8_t> pattern(db::CHAR_SIZE), mask(db::CHAR_SIZE);
+    const std::string value = "name42";
+    std::copy(value.begin(), value.end(), pattern.begin());
+    std::fill(mask.begin(), mask.begin() + value.size() + 1, 0xFF);
+    runKernel(state, [&](uint64_t *bitmap) {
+        db::selectCharMatch(data, td.length(), num_rows, pattern.data(), mask.data(), bitmap);
+    });
+}
+
+BENCHMARK(BM_SelectCharEqual)->Apply(levels);
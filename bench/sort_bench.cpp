@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/ExternalSort.hpp>
+#include <db/HeapFile.hpp>
+#include <db/Limit.hpp>
+#include <db/SeqScan.hpp>
+#include <db/TopK.hpp>
+
+namespace {
+    constexpr int num_tuples = 200000;
+
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int i) {
+        // a permutation of the ids
+        const int id = static_cast<int>((static_cast<int64_t>(i) * 7919) % num_tuples);
+        return {{id, "name" + std::to_string(id % 1000), (id % 100) / 4.0}};
+    }
+
+    db::DbFile &itemsFile() {
+        static db::DbFile &file = [] () -> db::DbFile & {
+            const char *name = "bench_sort_heap.db";
+            std::remove(name);
+            db::getDatabase().getBufferPool().resize(4096);
+            db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+            auto &file = db::getDatabase().get(name);
+            for (int i = 0; i < num_tuples; i++) {
+                file.insertTuple(item(i));
+            }
+            return file;
+        }();
+        return file;
+    }
+
+    size_t drain(db::Operator &op) {
+        size_t count = 0;
+        op.open();
+        while (op.next()) {
+            count++;
+        }
+        return count;
+    }
+
+    /// A new empty BTreeFile on the id, the file of the previous call is removed
+    db::BTreeFile &emptyTree(const std::string &prefix) {
+        static std::string previous;
+        static int counter = 0;
+        if (!previous.empty()) {
+            db::getDatabase().remove(previous);
+            std::remove(previous.c_str());
+        }
+        previous = prefix + "_" + std::to_string(counter++) + ".db";
+        std::remove(previous.c_str());
+        db::getDatabase().add(std::make_unique<db::BTreeFile>(previous, td, 0));
+        return dynamic_cast<db::BTreeFile &>(db::getDatabase().get(previous));
+    }
+} // namespace
+
+/**
+ * ORDER BY name, id over a HeapFile. The argument is the memory budget in KB: 64 MB sorts in memory, 1 MB writes
+ * about 30 runs that are merged at once.
+ */
+static void BM_ExternalSort(benchmark::State &state) {
+    auto &file = itemsFile();
+    db::ExternalSort sort(std::make_unique<db::SeqScan>(file), {{1}, {0}}, state.range(0) * 1024);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(sort));
+    }
+    state.counters["runs"] = static_cast<double>(sort.numRuns());
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_ExternalSort)->Arg(64 * 1024)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+/**
+ * Building a BTreeFile on the id, by inserting the tuples of the HeapFile one at a time, and by bulk loading them
+ * from a sort.
+ */
+static void BM_BTreeInsert(benchmark::State &state) {
+    auto &file = itemsFile();
+    for (auto _: state) {
+        auto &tree = emptyTree("bench_sort_insert");
+        for (auto it = file.begin(); it != file.end(); file.next(it)) {
+            tree.insertTuple(file.getTuple(it));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_BTreeInsert)->Unit(benchmark::kMillisecond);
+
+static void BM_BTreeBulkLoad(benchmark::State &state) {
+    auto &file = itemsFile();
+    for (auto _: state) {
+        auto &tree = emptyTree("bench_sort_bulk");
+        db::ExternalSort sort(std::make_unique<db::SeqScan>(file), {{0}});
+        tree.bulkLoad(sort);
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_BTreeBulkLoad)->Unit(benchmark::kMillisecond);
+
+/**
+ * ORDER BY price DESC, id LIMIT k over a HeapFile: a full sort followed by a limit, and a TopK that keeps k rows.
+ * The argument is k.
+ */
+static void BM_SortLimit(benchmark::State &state) {
+    auto &file = itemsFile();
+    db::Limit limit(std::make_unique<db::ExternalSort>(std::make_unique<db::SeqScan>(file),
+                                                       std::vector<db::SortField>{{2, true}, {0}}),
+                    state.range(0));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(limit));
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_SortLimit)->Arg(10)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void BM_TopK(benchmark::State &state) {
+    auto &file = itemsFile();
+    auto top = db::topK(file, {{2, true}, {0}}, state.range(0));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(*top));
+    }
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_TopK)->Arg(10)->Arg(1000)->Unit(benchmark::kMillisecond);
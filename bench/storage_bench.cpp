@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HeapPage.hpp>
+#include <db/SeqScan.hpp>
+#include <map>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int i) { return {{i, "name" + std::to_string(i % 97), static_cast<double>(i % 100)}}; }
+
+    /// A file of `num_pages` pages written directly, without the buffer pool
+    const std::string &pagesFile(size_t num_pages) {
+        static std::map<size_t, std::string> names;
+        auto &name = names[num_pages];
+        if (name.empty()) {
+            name = "bench_storage_pages_" + std::to_string(num_pages) + ".db";
+            std::remove(name.c_str());
+            db::getDatabase().getBufferPool().resize(db::DEFAULT_NUM_PAGES);
+            db::getDatabase().add(std::make_unique<db::DbFile>(name, td));
+            const db::DbFile &file = db::getDatabase().get(name);
+            for (size_t id = 0; id < num_pages; id++) {
+                file.writePage(db::Page{}, id);
+            }
+        }
+        return name;
+    }
+
+    /// A HeapFile of `num_tuples` tuples
+    db::DbFile &heapFile(int num_tuples) {
+        static std::map<int, db::DbFile *> files;
+        auto &file = files[num_tuples];
+        if (file == nullptr) {
+            const std::string name = "bench_storage_heap_" + std::to_string(num_tuples) + ".db";
+            std::remove(name.c_str());
+            db::getDatabase().getBufferPool().resize(4096);
+            db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+            file = &db::getDatabase().get(name);
+            for (int i = 0; i < num_tuples; i++) {
+                file->insertTuple(item(i));
+            }
+        }
+        return *file;
+    }
+
+    void reportHitRatio(benchmark::State &state, const db::MetricsSnapshot &before) {
+        const db::MetricsSnapshot after = db::getDatabase().getMetrics().snapshot();
+        const auto hits = static_cast<double>(after.counters.at("pool_hits") - before.counters.at("pool_hits"));
+        const auto misses = static_cast<double>(after.counters.at("pool_misses") - before.counters.at("pool_misses"));
+        state.counters["hit_ratio"] = hits + misses == 0 ? 0 : hits / (hits + misses);
+    }
+} // namespace
+
+/**
+ * BufferPool::getPage of pages that stay in the pool, from several threads that contend on the mutex of the pool.
+ */
+static void BM_GetPageHit(benchmark::State &state) {
+    constexpr size_t num_pages = 32;
+    static const std::string &name = pagesFile(num_pages);
+    auto &pool = db::getDatabase().getBufferPool();
+    size_t id = state.thread_index();
+    for (auto _: state) {
+        benchmark::DoNotOptimize(&pool.getPage({name, id}));
+        id = (id + 1) % num_pages;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_GetPageHit)->ThreadRange(1, 4)->UseRealTime();
+
+/**
+ * BufferPool::getPage of the pages of a file of 1024 pages in a random order. The argument is the size of the pool in
+ * pages, it sets the hit ratio: the misses evict a page and read another one.
+ */
+static void BM_GetPage(benchmark::State &state) {
+    constexpr size_t num_pages = 1024;
+    const std::string &name = pagesFile(num_pages);
+    auto &pool = db::getDatabase().getBufferPool();
+    pool.resize(state.range(0));
+    const db::MetricsSnapshot before = db::getDatabase().getMetrics().snapshot();
+    uint64_t x = 88172645463325252;
+    for (auto _: state) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        benchmark::DoNotOptimize(&pool.getPage({name, x % num_pages}));
+    }
+    reportHitRatio(state, before);
+    pool.resize(db::DEFAULT_NUM_PAGES);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_GetPage)->Arg(64)->Arg(512)->Arg(1024);
+
+/**
+ * HeapPage::insertTuple until the page is full, then the page is emptied.
+ */
+static void BM_HeapPageInsert(benchmark::State &state) {
+    db::Page page{};
+    db::HeapPage heap_page(page, td);
+    const db::Tuple t = item(42);
+    for (auto _: state) {
+        if (!heap_page.insertTuple(t)) {
+            state.PauseTiming();
+            page.fill(0);
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HeapPageInsert);
+
+static void BM_Serialize(benchmark::State &state) {
+    std::vector<uint8_t> row(td.length());
+    const db::Tuple t = item(42);
+    for (auto _: state) {
+        td.serialize(row.data(), t);
+        benchmark::DoNotOptimize(row.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Serialize);
+
+static void BM_Deserialize(benchmark::State &state) {
+    std::vector<uint8_t> row(td.length());
+    td.serialize(row.data(), item(42));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(td.deserialize(row.data()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Deserialize);
+
+/**
+ * A SeqScan of a HeapFile. The arguments are the number of tuples and the size of the pool in pages: a file larger
+ * than the pool is read from its file on every scan.
+ */
+static void BM_HeapScan(benchmark::State &state) {
+    const int num_tuples = static_cast<int>(state.range(0));
+    db::DbFile &file = heapFile(num_tuples);
+    auto &pool = db::getDatabase().getBufferPool();
+    pool.resize(state.range(1));
+    const db::MetricsSnapshot before = db::getDatabase().getMetrics().snapshot();
+    db::SeqScan scan(file);
+    for (auto _: state) {
+        scan.open();
+        size_t count = 0;
+        while (scan.next()) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    reportHitRatio(state, before);
+    pool.resize(4096);
+    state.SetItemsProcessed(state.iterations() * num_tuples);
+}
+
+BENCHMARK(BM_HeapScan)->ArgsProduct({{10000, 200000}, {64, 4096}})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include <db/Database.hpp>
+#include <db/Gather.hpp>
+#include <db/HashAggregate.hpp>
+#include <db/HeapFile.hpp>
+#include <db/MorselScan.hpp>
+#include <db/SeqScan.hpp>
+#include <map>
+
+namespace {
+    /// The rows of LINEITEM at scale factor 1
+    constexpr int lineitem_rows = 6000000;
+
+    /// LINEITEM of TPC-H with the columns read by Q1 and Q6, the dates are days since 1992-01-01
+    const db::TupleDesc lineitem_td({db::type_t::INT, db::type_t::DOUBLE, db::type_t::DOUBLE, db::type_t::DOUBLE,
+                                     db::type_t::CHAR, db::type_t::CHAR, db::type_t::INT},
+                                    {"orderkey", "quantity", "extendedprice", "discount", "returnflag", "linestatus",
+                                     "shipdate"});
+
+    /// 1994-01-01 and 1998-09-02, the dates of Q6 and Q1
+    constexpr int q6_date = 731;
+    constexpr int q1_date = 2436;
+
+    /**
+     * @brief The LINEITEM table at a scale factor, the argument is the scale factor in thousandths
+     * @details The values follow the distributions of dbgen (uniform quantities, discounts and ship dates, the return
+     * flag and line status determined by the ship date) from a fixed seed, without the text columns.
+     */
+    const db::HeapFile &lineitem(int64_t millis) {
+        static std::map<int64_t, const db::HeapFile *> files;
+        auto &file = files[millis];
+        if (file == nullptr) {
+            const std::string name = "bench_tpch_lineitem_" + std::to_string(millis) + ".db";
+            std::remove(name.c_str());
+            db::getDatabase().getBufferPool().resize(16384);
+            db::getDatabase().add(std::make_unique<db::HeapFile>(name, lineitem_td));
+            auto &heap_file = dynamic_cast<db::HeapFile &>(db::getDatabase().get(name));
+            uint64_t x = 2463534242;
+            const auto next = [&x](uint64_t n) {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                return x % n;
+            };
+            const int64_t rows = lineitem_rows * millis / 1000;
+            for (int64_t i = 0; i < rows; i++) {
+                const auto quantity = static_cast<double>(1 + next(50));
+                const double price = quantity * static_cast<double>(900 + next(100000)) / 100;
+                const double discount = static_cast<double>(next(11)) / 100;
+                const int shipdate = static_cast<int>(next(2526));
+                const char *returnflag = shipdate > 1260 ? "N" : next(2) == 0 ? "R" : "A";
+                const char *linestatus = shipdate > 2356 ? "O" : "F";
+                heap_file.insertTuple({{static_cast<int>(i / 4), quantity, price, discount, returnflag, linestatus,
+                                        shipdate}});
+            }
+            file = &heap_file;
+        }
+        return *file;
+    }
+
+    /// The scans of a parallel query, a single SeqScan for one worker
+    std::vector<std::unique_ptr<db::Operator>> scans(const db::HeapFile &file, size_t workers) {
+        if (workers == 1) {
+            std::vector<std::unique_ptr<db::Operator>> result;
+            result.push_back(std::make_unique<db::SeqScan>(file));
+            return result;
+        }
+        return db::MorselScan::create(file, workers);
+    }
+
+    size_t drain(db::Operator &op) {
+        size_t count = 0;
+        op.open();
+        while (op.next()) {
+            count++;
+        }
+        return count;
+    }
+} // namespace
+
+/**
+ * A TPC-H Q1 like query: SELECT returnflag, linestatus, SUM(quantity), SUM(extendedprice), AVG(discount), COUNT(*)
+ * FROM lineitem WHERE shipdate <= '1998-09-02' GROUP BY returnflag, linestatus. The arguments are the scale factor
+ * in thousandths and the number of threads.
+ */
+static void BM_TpchQ1(benchmark::State &state) {
+    const db::HeapFile &file = lineitem(state.range(0));
+    auto inputs = scans(file, state.range(1));
+    for (auto &input: inputs) {
+        input->pushDown({6, db::PredicateOp::LE, q1_date});
+    }
+    db::HashAggregate aggregate(std::move(inputs), {4, 5},
+                                {{db::AggregateOp::SUM, 1}, {db::AggregateOp::SUM, 2}, {db::AggregateOp::AVG, 3},
+                                 {db::AggregateOp::COUNT, 0}});
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(aggregate));
+    }
+    state.SetItemsProcessed(state.iterations() * lineitem_rows * state.range(0) / 1000);
+}
+
+BENCHMARK(BM_TpchQ1)->ArgsProduct({{10, 100}, {1, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * A TPC-H Q6 like query: SELECT SUM(extendedprice) FROM lineitem WHERE shipdate >= '1994-01-01' AND shipdate <
+ * '1995-01-01' AND discount BETWEEN 0.05 AND 0.07 AND quantity < 24. Q6 sums extendedprice * discount, there are no
+ * expressions in the operators. The predicates are evaluated in the scans. The arguments are the scale factor in
+ * thousandths and the number of threads.
+ */
+static void BM_TpchQ6(benchmark::State &state) {
+    const db::HeapFile &file = lineitem(state.range(0));
+    auto inputs = scans(file, state.range(1));
+    for (auto &input: inputs) {
+        input->pushDown({6, db::PredicateOp::GE, q6_date});
+        input->pushDown({6, db::PredicateOp::LT, q6_date + 365});
+        input->pushDown({3, db::PredicateOp::GE, 0.05});
+        input->pushDown({3, db::PredicateOp::LE, 0.07});
+        input->pushDown({1, db::PredicateOp::LT, 24.0});
+    }
+    db::HashAggregate aggregate(std::move(inputs), {}, {{db::AggregateOp::SUM, 2}});
+    for (auto _: state) {
+        benchmark::DoNotOptimize(drain(aggregate));
+    }
+    state.SetItemsProcessed(state.iterations() * lineitem_rows * state.range(0) / 1000);
+}
+
+BENCHMARK(BM_TpchQ6)->ArgsProduct({{10, 100}, {1, 4}})->Unit(benchmark::kMillisecond)->UseRealTime();
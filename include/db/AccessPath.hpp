@@ -0,0 +1,58 @@
+#pragma once
+
+#include <db/HeapFile.hpp>
+#include <db/Operator.hpp>
+#include <db/SecondaryIndex.hpp>
+#include <db/Statistics.hpp>
+#include <memory>
+
+namespace db {
+
+    /// The ways to read the tuples of a table
+    enum class AccessMethod {
+        FULL_SCAN, INDEX_SCAN
+    };
+
+    /**
+     * @brief The cheapest way to read the tuples of a table that satisfy a conjunction of predicates.
+     * @details The cost model estimates the cost of each path in sequential page reads, from the statistics of the
+     * table (see TableStatistics). A full scan reads every page of the table. An index scan reads the leaves of the
+     * index that hold the range of the predicates on its field, then the pages of the table that hold the selected
+     * tuples, which are random reads: k of the tuples of a table of n pages are spread on n (1 - (1 - 1/n)^k) pages.
+     * Both evaluate every predicate on the tuples they read. The index scan is chosen when the predicates on the
+     * indexed field are selective enough, typically a few percent of the tuples or less.
+     */
+    struct AccessPath {
+        /// The cost of reading a page at a random position, relative to a sequential read
+        static constexpr double RANDOM_PAGE_COST = 4;
+        /// The cost of evaluating the predicates on a tuple, relative to a sequential page read
+        static constexpr double TUPLE_COST = 0.01;
+
+        AccessMethod method = AccessMethod::FULL_SCAN;
+        /// The index of an INDEX_SCAN, and the range of the indexed field (inclusive)
+        const SecondaryIndex *index = nullptr;
+        field_t low;
+        field_t high;
+        /// The estimated number of tuples that satisfy the predicates
+        double rows = 0;
+        /// The estimated cost of the path
+        double cost = 0;
+
+        /**
+         * @brief Choose between a full scan and a scan of each index of a table
+         * @param table the table
+         * @param stats the statistics of the table
+         * @param predicates the predicates that the tuples must satisfy
+         * @throws std::logic_error if a predicate does not match the table
+         */
+        static AccessPath choose(const HeapFile &table, const TableStatistics &stats,
+                                 const std::vector<Predicate> &predicates);
+
+        /**
+         * @brief Create the scan of the path, with the predicates pushed down
+         * @return a SeqScan or an IndexScan
+         */
+        std::unique_ptr<Operator> open(const HeapFile &table, const std::vector<Predicate> &predicates) const;
+    };
+
+} // namespace db
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/Operator.hpp>
+#include <memory>
+
+namespace db {
+
+    enum class AggregateOp {
+        COUNT, SUM, MIN, MAX, AVG
+    };
+
+    /**
+     * @brief An aggregate function of a field: `op(field)`.
+     * @details COUNT counts the rows of a group (there are no null values), as an INT. SUM and AVG are computed as
+     * DOUBLE values over INT and DOUBLE fields, MIN and MAX have the type of their field and also apply to CHAR fields.
+     * Without group fields, an empty input produces one row: COUNT and SUM are 0, AVG is NaN, and MIN and MAX are 0 or
+     * the empty string in place of the null values of SQL.
+     */
+    struct Aggregate {
+        AggregateOp op;
+        /// The index of the field in the input rows
+        size_t field;
+    };
+
+    /**
+     * @brief The rows and the states of a GROUP BY query.
+     * @details The key of a group is its values of the group fields, serialized as in the output rows, with the
+     * bytes of CHAR values after their end set to 0 so that keys can be compared with memcmp. The state of a group
+     * holds the running value of every aggregate. The output rows are the group fields followed by the aggregates,
+     * named after their function and field (e.g. `sum_price`).
+     */
+    class AggregateLayout {
+        const TupleDesc &input_td;
+        std::vector<size_t> group_fields;
+        std::vector<Aggregate> aggregates;
+        std::vector<size_t> state_offsets;
+        size_t key_length;
+        size_t state_length;
+        TupleDesc td;
+
+    public:
+        /**
+         * @brief Initialize the layout of a query
+         * @param input_td the tuple descriptor of the input rows
+         * @param group_fields the indices of the INT or CHAR fields to group on, no fields for a single group
+         * @param aggregates the aggregates to compute
+         * @throws std::logic_error if a field does not exist, a group field is not an INT or CHAR field, SUM or AVG is
+         * applied to a CHAR field, or two output fields have the same name
+         */
+        AggregateLayout(const TupleDesc &input_td, const std::vector<size_t> &group_fields,
+                        const std::vector<Aggregate> &aggregates);
+
+        /**
+         * @brief Get the tuple descriptor of the output rows
+         */
+        const TupleDesc &getTupleDesc() const;
+
+        const std::vector<size_t> &getGroupFields() const;
+
+        size_t keyLength() const;
+
+        size_t stateLength() const;
+
+        /**
+         * @brief Extract the key of an input row
+         * @param key the buffer of the key, keyLength() bytes
+         */
+        void key(const uint8_t *row, uint8_t *key) const;
+
+        uint64_t hash(const uint8_t *key) const;
+
+        /**
+         * @brief Initialize the state of a group with its first row
+         */
+        void init(uint8_t *state, const uint8_t *row) const;
+
+        /**
+         * @brief Initialize the state of the group of an empty input (see Aggregate)
+         */
+        void initEmpty(uint8_t *state) const;
+
+        /**
+         * @brief Add a row to the state of a group
+         */
+        void update(uint8_t *state, const uint8_t *row) const;
+
+        /**
+         * @brief Add the state of the same group computed over other rows
+         */
+        void merge(uint8_t *state, const uint8_t *other) const;
+
+        /**
+         * @brief Serialize the output row of a group
+         * @param out the buffer of the row, `getTupleDesc().length()` bytes
+         * @throws std::runtime_error if a COUNT is larger than the largest INT
+         */
+        void finalize(const uint8_t *key, const uint8_t *state, uint8_t *out) const;
+    };
+
+    /**
+     * @brief Create the operator that computes a GROUP BY query over a file
+     * @details If the tuples of the file are stored grouped (see StreamAggregate::sortedOn), the groups are computed
+     * one at a time while the file is scanned (StreamAggregate); otherwise they are hashed (HashAggregate).
+     * @param memory_budget the memory of the groups of a HashAggregate, in bytes
+     * @throws std::logic_error if the query does not match the tuples of the file (see AggregateLayout)
+     */
+    std::unique_ptr<Operator> groupBy(const DbFile &file, const std::vector<size_t> &group_fields,
+                                      const std::vector<Aggregate> &aggregates, size_t memory_budget);
+
+} // namespace db
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief An open addressing hash table of the groups of an aggregation.
+     * @details Every entry holds the key of a group followed by its state (see AggregateLayout); the entries are
+     * stored contiguously in insertion order and the slots of the table, probed linearly, hold their indices. The
+     * table doubles when it is half full.
+     */
+    class AggregateTable {
+        const size_t key_length;
+        const size_t entry_length;
+        std::vector<uint8_t> entries;
+        std::vector<uint64_t> hashes;
+        /// The index + 1 of the entry of each slot, 0 for an empty slot
+        std::vector<uint32_t> slots;
+        size_t count;
+
+        void grow();
+
+    public:
+        AggregateTable(size_t key_length, size_t state_length);
+
+        /**
+         * @brief Find the entry of a key
+         * @return the entry, or nullptr if the key is not in the table
+         */
+        uint8_t *find(const uint8_t *key, uint64_t hash);
+
+        /**
+         * @brief Find the entry of a key, or insert it
+         * @param inserted set to true if the entry was inserted, its state is then uninitialized
+         * @return the entry, valid until the next insertion
+         */
+        uint8_t *findOrInsert(const uint8_t *key, uint64_t hash, bool &inserted);
+
+        /**
+         * @brief Remove every entry
+         */
+        void clear();
+
+        size_t size() const;
+
+        /**
+         * @brief Get the memory used by the entries and the slots, in bytes
+         */
+        size_t bytes() const;
+
+        /**
+         * @brief Get an entry by insertion order
+         */
+        uint8_t *entry(size_t index);
+
+        uint64_t hash(size_t index) const;
+    };
+
+} // namespace db
@@ -1,12 +1,109 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <db/BufferPool.hpp>
 #include <db/DbFile.hpp>
+#include <db/KeyDesc.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
 
 namespace db {
+    class Operator;
 
+    /**
+     * @brief A file that stores tuples sorted on a key in a B+tree.
+     * @details The key is either a single INT field, stored in IndexPage and LeafPage, or any combination of INT,
+     * DOUBLE and CHAR fields. Other keys are normalized (see KeyDesc) and stored in KeyIndexPage and KeyLeafPage:
+     * index pages hold the shortest separators of their children, and leaves store the keys without the prefix
+     * that is shared by the range of the leaf.
+     * All operations are thread-safe. Pages are pinned in the BufferPool and protected by the latch of their
+     * frame. Writers use latch crabbing: the tree is first descended optimistically with shared latches and only
+     * the leaf latched exclusively; if the leaf may split, the descent is restarted holding exclusive latches on
+     * every ancestor that may be modified by the split. Deletions use the same protocol for underflows. Splits and
+     * merges are operations of the log (see LogManager::startOperation), so that no commit is recovered in the middle
+     * of one. Scans hold at most two shared latches at a time.
+     * Point lookups use optimistic lock coupling: pages are read without latches, and the version of every frame is
+     * validated after it has been read (see BufferPool::readOptimistic). A lookup restarts when a page was modified
+     * concurrently, and falls back to shared latches after too many restarts.
+     * @note Iterators are positions (page, slot) and are not stable while other threads insert into the file.
+     */
     class BTreeFile : public DbFile {
         static constexpr size_t root_id = 0;
         size_t key_index;
+        /// The normalized key, empty if the key is a single INT field
+        std::optional<KeyDesc> key_desc;
+        std::mutex alloc_mutex;
+        /// The BufferPool frames that recently held the pages, indexed by page number modulo the size of the array
+        mutable std::array<std::atomic<size_t>, 256> frame_hints{};
+
+        /// Pages that were removed from the tree and can be reused, rebuilt from the pages that the tree does not
+        /// reach when the file is opened
+        std::vector<size_t> free_pages;
+
+        void findFreePages();
+
+        size_t allocatePage();
+
+        void freePage(PageLatch &page);
+
+        /// Free a leaf that was merged, it stays an empty leaf linked to the next leaf until it is reused
+        template<typename Layout>
+        void freeLeaf(const Layout &layout, PageLatch &page);
+
+        /// Call a function with the page layout of the tree (the tree algorithms are templates over the layout)
+        template<typename F>
+        decltype(auto) withLayout(F &&f) const;
+
+        template<typename Layout>
+        std::unique_ptr<PageLatch> latchLeaf(const Layout &layout, const typename Layout::key_type &key,
+                                             bool exclusive) const;
+
+        /// Get the first position of the leaves of a subtree
+        template<typename Layout>
+        Iterator subtreeStart(const Layout &layout, size_t page, bool index_page) const;
+
+        /// Append the first positions of the subtrees of a page in a key range, down to a depth
+        template<typename Layout>
+        void rangeBoundaries(const Layout &layout, size_t page, const typename Layout::key_type *lower,
+                             const typename Layout::key_type *upper, size_t depth,
+                             std::vector<Iterator> &boundaries) const;
+
+        template<typename Layout>
+        std::optional<Tuple> lookupKey(const Layout &layout, const typename Layout::key_type &key) const;
+
+        template<typename Layout>
+        bool lookupOptimistic(const Layout &layout, const typename Layout::key_type &key,
+                              std::optional<Tuple> &result) const;
+
+        template<typename Layout>
+        std::optional<Tuple> lookupPessimistic(const Layout &layout, const typename Layout::key_type &key) const;
+
+        template<typename Layout>
+        bool insertOptimistic(const Layout &layout, const Tuple &t, const typename Layout::key_type &key);
+
+        template<typename Layout>
+        void insertPessimistic(const Layout &layout, const Tuple &t, const typename Layout::key_type &key);
+
+        template<typename Layout>
+        void bulkLoad(const Layout &layout, Operator &input);
+
+        template<typename Layout>
+        bool deleteKey(const Layout &layout, const typename Layout::key_type &key);
+
+        template<typename Layout>
+        bool deleteOptimistic(const Layout &layout, const typename Layout::key_type &key, bool &deleted);
+
+        template<typename Layout>
+        bool deletePessimistic(const Layout &layout, const typename Layout::key_type &key);
+
+        template<typename Layout>
+        bool rebalanceLeaf(const Layout &layout, PageLatch &node, PageLatch &parent, size_t pos);
+
+        template<typename Layout>
+        bool rebalanceIndex(const Layout &layout, PageLatch &node, PageLatch &parent, size_t pos);
 
     public:
 
@@ -17,6 +114,14 @@ namespace db {
          */
         BTreeFile(const std::string &name, const TupleDesc &td, size_t key_index);
 
+        /**
+         * @brief Initialize a BTreeFile with a composite key
+         * @details Tuples are sorted on the first key field, then on the second, and so on.
+         * @param key_indices the indices of the key fields in the tuple
+         * @throws std::logic_error if the key is invalid (see KeyDesc) or the tuples are too large for the leaves
+         */
+        BTreeFile(const std::string &name, const TupleDesc &td, const std::vector<size_t> &key_indices);
+
         /**
          * @brief Insert a tuple into the file
          * @details Insert a tuple into the file. Traverse the BTree from the root to find the leaf node to insert the tuple.
@@ -27,8 +132,49 @@ namespace db {
          */
         void insertTuple(const Tuple &t) override;
 
+        /**
+         * @brief Build the tree from tuples sorted on the key
+         * @details The leaves are filled one after the other to 90% of their space, so that later insertions do not
+         * split them right away, with the separators of their parent as fences. Every level of index pages is built
+         * from the separators of the level below it, so each page is written once.
+         * Tuples with the same key replace each other, as with insertTuple. An ExternalSort on the key fields
+         * produces the input from unsorted tuples.
+         * @param input the tuples, sorted on the key (see KeyDesc), with the tuple descriptor of the file
+         * @throws std::logic_error if the file is not empty or the input has another tuple descriptor
+         * @throws std::runtime_error if the input is not sorted
+         * @note No other thread may use the file while it is loaded.
+         */
+        void bulkLoad(Operator &input);
+
+        /**
+         * @brief Delete a tuple from the file
+         * @details Delete the tuple with the key of the tuple that the iterator points to (see BTreeFile::deleteKey).
+         * @param it the iterator that identifies the tuple to be deleted
+         * @note The iterator, and any other iterator of the file, may not be advanced after the deletion.
+         */
         void deleteTuple(const Iterator &it) override;
 
+        /**
+         * @brief Delete the tuple with the provided key
+         * @details Traverse the BTree from the root to the leaf that contains the key and remove the tuple. If the leaf
+         * has less than half of its capacity, borrow a tuple from a sibling, or merge the leaf with a sibling and remove
+         * the separator key from the parent. This process is repeated for the index pages until no more merge is
+         * needed. If the root is left with a single index child, the child is moved to the root. Pages removed from the
+         * tree are reused by later insertions, also after the file is opened again. A scan that is on a leaf when it is
+         * merged continues to the next leaf.
+         * @param key the key of the tuple to delete
+         * @return true if a tuple was deleted, false if the key does not exist
+         */
+        bool deleteKey(int key);
+
+        /**
+         * @brief Delete the tuple with the provided key (see BTreeFile::deleteKey)
+         * @param key the values of the key fields
+         * @return true if a tuple was deleted, false if the key does not exist
+         * @throws std::logic_error if the values are not one per key field, with their types
+         */
+        bool deleteKey(const std::vector<field_t> &key);
+
         /**
          * @brief Get a tuple from the database file.
          * @details Get a tuple from the database file by reading the tuple from the page.
@@ -58,5 +204,86 @@ namespace db {
          * @return The iterator to the end of the file.
          */
         Iterator end() const override;
+
+        /**
+         * @brief Read the tuples of a leaf (see DbFile::readTuples).
+         * @details The tuples are copied from the leaf while it is latched, in key order. Leaves with an INT key store
+         * serialized tuples and are copied directly. The filter is evaluated on the copied tuples.
+         */
+        size_t readTuples(Iterator &it, std::vector<uint8_t> &rows, const ScanFilter &filter) const override;
+
+        /**
+         * @brief The position of a backward scan of the leaves (see BTreeFile::readPreviousLeaf)
+         */
+        struct ReversePosition {
+            /// The index pages from the root to the last leaf read, with the number of their children not read yet
+            std::vector<std::pair<size_t, size_t>> path;
+            bool started = false;
+        };
+
+        /**
+         * @brief Read the tuples of the leaf before the last leaf read, starting from the last leaf of the tree
+         * @details The leaves are only linked forward, so the scan keeps the path to the leaf and moves to the
+         * previous child of the deepest index page that has one. Empty leaves are skipped.
+         * @param position the position of the scan, default initialized to start at the last leaf
+         * @param rows the tuples of the leaf that satisfy the filter are appended, in key order
+         * @param filter the predicates that the tuples must satisfy
+         * @return false if the first leaf was read already
+         * @note The file may not be modified during the scan.
+         */
+        bool readPreviousLeaf(ReversePosition &position, std::vector<uint8_t> &rows, const ScanFilter &filter) const;
+
+        /**
+         * @brief Find the tuple with the provided key.
+         * @details Traverse the tree from the root to the leaf responsible for the key and search the leaf.
+         * @param key The key to search for.
+         * @return The tuple with the key, or an empty optional if the key does not exist.
+         */
+        std::optional<Tuple> lookup(int key) const;
+
+        /**
+         * @brief Find the tuple with the provided key (see BTreeFile::lookup)
+         * @param key The values of the key fields.
+         * @return The tuple with the key, or an empty optional if the key does not exist.
+         * @throws std::logic_error if the values are not one per key field, with their types (a prefix of the key
+         * fields is a range, see BTreeFile::lowerBound)
+         */
+        std::optional<Tuple> lookup(const std::vector<field_t> &key) const;
+
+        /**
+         * @brief Find the first tuple whose key is not less than the provided key.
+         * @details The key may contain only the first fields of a composite key, the iterator then points to the first
+         * tuple that starts with these values (or to the first greater tuple).
+         * @param key The values of the key fields.
+         * @return The iterator to the tuple, or end() if all keys are less than the provided key.
+         */
+        Iterator lowerBound(const std::vector<field_t> &key) const;
+
+        /**
+         * @brief Split a range scan into parts that can be scanned in parallel
+         * @details The range is split at the level of the index pages: the parts start at the first tuples of
+         * subtrees, as evenly as the fan out of the tree allows. The index pages just below the root are used if
+         * they give enough parts, otherwise the next levels. The parts are consecutive and in key order, each is
+         * scanned from its first position up to the first position of the next part (see BTreeScan).
+         * The bounds may contain only the first fields of a composite key, as in BTreeFile::lowerBound.
+         * @param parts the number of parts wanted, fewer parts are returned for a small tree
+         * @param lower the values of the key fields that the keys of the range are not less than, empty for the
+         * first tuple of the file
+         * @param upper the values of the key fields that the keys of the range are less than, empty for the end of
+         * the file
+         * @return the first position of each part, followed by the end of the range
+         */
+        std::vector<Iterator> splitRange(size_t parts, const std::vector<field_t> &lower = {},
+                                         const std::vector<field_t> &upper = {}) const;
+
+        /**
+         * @brief Get the index of the first key field, the field that the tuples are primarily sorted on
+         */
+        size_t getKeyIndex() const;
+
+        /**
+         * @brief Get the indices of the key fields, from the most to the least significant
+         */
+        std::vector<size_t> getKeyIndices() const;
     };
 } // namespace db
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <db/BTreeFile.hpp>
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+#include <memory>
+#include <optional>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces the tuples of a part of a BTreeFile, in key order.
+     * @details The scan starts at a position of the file and follows the leaves until another position, reading a
+     * leaf at a time as a SeqScan (see DbFile::readTuples). The parts of a range computed by BTreeFile::splitRange
+     * are scanned independently by several scans, each descending to its own subtree, e.g. by the threads of an
+     * ordered Gather that produces the whole range in key order.
+     * @note The file may not be modified while it is scanned.
+     */
+    class BTreeScan : public Operator {
+        const BTreeFile &file;
+        const Iterator first;
+        const Iterator last;
+        ScanFilter filter;
+        /// The empty filter, to read the last leaf before the tuples past the end are removed
+        const ScanFilter none;
+        std::optional<Iterator> it;
+        std::vector<uint8_t> rows;
+        size_t count;
+        size_t pos;
+        const uint8_t *current;
+
+    public:
+        /**
+         * @brief Initialize a scan of a part of a file
+         * @param file the file to scan
+         * @param first the position of the first tuple
+         * @param last the position after the last tuple, not before the first position
+         */
+        BTreeScan(const BTreeFile &file, const Iterator &first, const Iterator &last);
+
+        /**
+         * @brief Initialize a scan of the whole file
+         */
+        explicit BTreeScan(const BTreeFile &file);
+
+        /**
+         * @brief Create the scans of the parts of a range (see BTreeFile::splitRange)
+         * @return the scans, in key order
+         */
+        static std::vector<std::unique_ptr<Operator>> create(const BTreeFile &file, size_t parts,
+                                                             const std::vector<field_t> &lower = {},
+                                                             const std::vector<field_t> &upper = {});
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Evaluate a predicate in the scan
+         * @return always true
+         * @throws std::logic_error if the predicate does not match the tuples of the file
+         */
+        bool pushDown(const Predicate &predicate) override;
+
+        ScanFilter &getFilter();
+    };
+
+} // namespace db
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+#include <optional>
+#include <string_view>
+
+namespace db {
+
+    /// The number of rows that a batch is filled with (a batch holds whole pages, so it may hold a few more)
+    constexpr size_t BATCH_SIZE = 1024;
+
+    /**
+     * @brief A batch of rows of a file, stored in columns.
+     * @details The tuples of whole pages are copied into the batch (see DbFile::readTuples) and the fields that the
+     * batch was created for are decoded into typed column vectors: `int` and `double` values, and views of the CHAR
+     * fields, which point into the rows of the batch. The selection vector holds the indices of the rows that are
+     * still part of the result; filters refine it in place (see Batch::filter) and never copy the columns.
+     * Loading a batch does not allocate memory once the vectors have grown to the size of a batch.
+     */
+    class Batch {
+        const TupleDesc &td;
+        std::vector<size_t> fields;
+        std::vector<uint8_t> rows;
+        size_t num_rows;
+        /// The columns, indexed by field (only the decoded fields of the matching type are filled)
+        std::vector<std::vector<int>> ints;
+        std::vector<std::vector<double>> doubles;
+        std::vector<std::vector<std::string_view>> strings;
+        std::vector<uint32_t> selection;
+
+        void decode();
+
+    public:
+        /**
+         * @brief Initialize a batch that decodes every field
+         * @param td the tuple descriptor of the rows
+         */
+        explicit Batch(const TupleDesc &td);
+
+        /**
+         * @brief Initialize a batch that decodes some fields
+         * @param td the tuple descriptor of the rows
+         * @param fields the indices of the fields to decode, the other fields are only available through getTuple
+         * @throws std::logic_error if a field does not exist
+         */
+        Batch(const TupleDesc &td, const std::vector<size_t> &fields);
+
+        /**
+         * @brief Replace the rows of the batch with the next tuples of a file
+         * @details Pages are read until the batch holds at least BATCH_SIZE rows or the end of the file is reached.
+         * Every row is selected.
+         * @param file the file to read, with the tuple descriptor of the batch
+         * @param it the position of the first tuple to read, advanced past the last tuple read
+         * @return the number of rows read, 0 at the end of the file
+         */
+        size_t read(const DbFile &file, Iterator &it);
+
+        /**
+         * @brief Replace the rows of the batch with the next tuples of a file that satisfy a filter
+         * @details Only the tuples that satisfy the filter are copied into the batch (see DbFile::readTuples).
+         * @return the number of rows read, 0 at the end of the file
+         */
+        size_t read(const DbFile &file, Iterator &it, const ScanFilter &filter);
+
+        /**
+         * @brief Get the number of rows of the batch, selected or not
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get the indices of the selected rows, in increasing order
+         */
+        const std::vector<uint32_t> &getSelection() const;
+
+        /**
+         * @brief Get the values of an INT field
+         * @throws std::logic_error if the field is not a decoded INT field
+         */
+        const std::vector<int> &getInts(size_t field) const;
+
+        /**
+         * @brief Get the values of a DOUBLE field
+         * @throws std::logic_error if the field is not a decoded DOUBLE field
+         */
+        const std::vector<double> &getDoubles(size_t field) const;
+
+        /**
+         * @brief Get the values of a CHAR field
+         * @details The views are valid until the batch is read again.
+         * @throws std::logic_error if the field is not a decoded CHAR field
+         */
+        const std::vector<std::string_view> &getStrings(size_t field) const;
+
+        /**
+         * @brief Materialize a row
+         * @param row the index of the row in the batch (not in the selection)
+         */
+        Tuple getTuple(size_t row) const;
+
+        /**
+         * @brief Remove the rows that do not satisfy a predicate from the selection
+         * @throws std::logic_error if the predicate does not match a decoded field
+         */
+        void filter(const Predicate &predicate);
+
+        /**
+         * @brief Sum the values of an INT or DOUBLE field over the selected rows
+         * @throws std::logic_error if the field is not a decoded INT or DOUBLE field
+         */
+        double sum(size_t field) const;
+    };
+
+    /**
+     * @brief A scan that produces the tuples of a file in batches.
+     * @details Pushed down predicates are evaluated on the pages of the file (see ScanFilter), only the tuples that
+     * satisfy them are copied into the batches.
+     * @note The file may not be modified while it is scanned.
+     */
+    class BatchScan {
+        const DbFile &file;
+        ScanFilter filter;
+        std::optional<Iterator> it;
+
+    public:
+        explicit BatchScan(const DbFile &file);
+
+        const TupleDesc &getTupleDesc() const;
+
+        /**
+         * @brief Start producing batches from the beginning of the file
+         */
+        void open();
+
+        /**
+         * @brief Read the next batch of the file
+         * @param batch a batch with the tuple descriptor of the file
+         * @return false if there are no more rows
+         */
+        bool next(Batch &batch);
+
+        /**
+         * @brief Filter every batch with a predicate
+         * @throws std::logic_error if the predicate does not match the tuples of the file
+         */
+        void pushDown(const Predicate &predicate);
+
+        /**
+         * @brief Get the filter of the scan, to add predicates that are not comparisons (BETWEEN, IN, prefix)
+         * @note The filter may only be changed before the scan is opened.
+         */
+        ScanFilter &getFilter();
+    };
+
+} // namespace db
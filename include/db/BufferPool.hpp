@@ -1,12 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <db/types.hpp>
 #include <list>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 namespace db {
+    class DbFile;
+
+    class LogManager;
+
+    struct DirtyPage;
+
     constexpr size_t DEFAULT_NUM_PAGES = 50;
 
 /**
@@ -15,16 +25,45 @@ namespace db {
  * It provides functions to get a page, mark a page as dirty, and check the status of pages.
  * The class also supports flushing pages to disk and discarding pages from the buffer pool.
  * @note A BufferPool owns the Page objects that are stored in it.
+ * @note All methods are thread-safe. A page returned by getPage may be evicted by a later call; concurrent users
+ * should pin the page (BufferPool::pinPage) and hold its latch (BufferPool::getLatch) while accessing it.
+ * @note With a LogManager (BufferPool::setLog), the changes of a page are logged when it is marked dirty, and the page
+ * is stamped with the LSN of the record. A dirty page can still be evicted at any time (steal), it is written once the
+ * log is durable up to its LSN; commits only sync the log (no-force). Each frame keeps a copy of its page as it was
+ * last logged, the changes are the bytes that differ from the copy.
+ * @note Pages are read and written without the mutex of the buffer pool. A page is read into its frame under the
+ * exclusive latch of the frame, the threads that fetch the page meanwhile wait for the read to complete; a dirty
+ * victim is written under its shared latch before it is evicted.
  */
     class BufferPool {
         // TODO pa0: add private members
-        std::array<Page, DEFAULT_NUM_PAGES> pages;
-        std::array<PageId, DEFAULT_NUM_PAGES> pos_to_pid;
+        std::vector<Page> pages;
+        std::vector<PageId> pos_to_pid;
         std::unordered_map<const PageId, size_t> pid_to_pos;
         std::unordered_set<size_t> dirty;
         std::vector<size_t> available;
         std::list<size_t> lru_list;
         std::unordered_map<size_t, std::list<size_t>::iterator> pos_to_lru;
+        std::vector<size_t> pins;
+        /// The frames whose page is being read from its file, without the mutex
+        std::vector<bool> reading;
+        std::condition_variable_any read_done;
+        std::vector<std::shared_mutex> latches;
+        std::vector<std::atomic<uint64_t>> versions;
+        /// The generation of the file of every frame (DbFile::getGeneration), 0 for an empty frame
+        std::vector<std::atomic<uint64_t>> frame_files;
+        std::vector<std::atomic<size_t>> frame_pages;
+        LogManager *log = nullptr;
+        std::vector<Page> logged_pages;
+        std::vector<uint64_t> page_lsns;
+        std::vector<uint64_t> rec_lsns;
+        mutable std::recursive_mutex mutex;
+
+        /// Find or read a page, the mutex is released while a page is read or a victim is written
+        size_t fetch(const PageId &pid, std::unique_lock<std::recursive_mutex> &lock);
+
+        /// Write the page of a frame if it is dirty, with the mutex released during the write
+        void writeBack(size_t pos, std::unique_lock<std::recursive_mutex> &lock);
 
     public:
         /**
@@ -50,15 +89,114 @@ namespace db {
          * @param pid: The page id of the page to return.
          * @return: The page with the specified page id.
          * @note This method should make this page the most recently used page.
+         * @throws std::runtime_error if every page of the buffer pool is pinned.
          */
         Page &getPage(const PageId &pid);
 
+        /**
+         * @brief: Returns the page with the specified page id and pins it in the buffer pool.
+         * @details A pinned page is never evicted. Pins are counted, every call must be matched by a call to
+         * BufferPool::unpinPage(pid).
+         * @param pid: The page id of the page to pin.
+         * @return: The pinned page.
+         * @throws std::runtime_error if every page of the buffer pool is pinned.
+         */
+        Page &pinPage(const PageId &pid);
+
+        /**
+         * @brief: Releases a pin acquired with BufferPool::pinPage(pid).
+         * @param pid: The page id of the page to unpin.
+         */
+        void unpinPage(const PageId &pid);
+
+        /**
+         * @brief: Returns the latch that protects the contents of a page.
+         * @param pid: The page id of a pinned page.
+         * @return: The latch of the frame that holds the page.
+         * @note The latch belongs to the frame, so the page must stay pinned while the latch is used.
+         */
+        std::shared_mutex &getLatch(const PageId &pid);
+
+        /**
+         * @brief: Returns the version counter of the frame that holds a page.
+         * @details The version is odd while the frame is being modified (an exclusive PageLatch is held or a page is
+         * being loaded into the frame), and it changes every time the contents of the frame change.
+         * @param pid: The page id of a pinned page.
+         * @return: The version counter of the frame.
+         */
+        std::atomic<uint64_t> &getVersion(const PageId &pid);
+
+        /**
+         * @brief: Starts an optimistic read of a page.
+         * @details The page is neither pinned nor latched, and nothing is written to shared memory when the page is
+         * found in the frame at position `hint`. Otherwise, the page is fetched and `hint` is updated.
+         * @param pid: The page id of the page to read.
+         * @param file: The file that the page belongs to.
+         * @param hint: The position of the frame that is expected to hold the page.
+         * @return: The version of the frame. The version is odd if the frame is being modified.
+         * @note The frame (BufferPool::getFrame(hint)) may change at any time. Anything read from it must be validated
+         * with BufferPool::validate(hint, version) before it is used.
+         */
+        uint64_t readOptimistic(const PageId &pid, const DbFile &file, size_t &hint);
+
+        /**
+         * @brief: Checks that a frame was not modified since an optimistic read started.
+         * @param pos: The position of the frame.
+         * @param version: The version returned by BufferPool::readOptimistic.
+         * @return: True if the frame still holds the same contents, false otherwise.
+         */
+        bool validate(size_t pos, uint64_t version) const;
+
+        /**
+         * @brief: Returns the frame at a position of the buffer pool.
+         * @param pos: The position of the frame.
+         * @return: The page held by the frame.
+         */
+        Page &getFrame(size_t pos);
+
+        /**
+         * @brief: Changes the number of pages that the buffer pool can hold.
+         * @details All dirty pages are flushed and every page is discarded from the buffer pool.
+         * @param num_pages: The new number of pages.
+         * @throws std::logic_error if any page is pinned.
+         * @note No other thread may use the buffer pool while it is resized.
+         */
+        void resize(size_t num_pages);
+
+        /**
+         * @brief: Returns the number of pages that the buffer pool can hold.
+         */
+        size_t size() const;
+
+        /**
+         * @brief: Logs the changes of the pages to a write-ahead log.
+         * @param log: The log, or nullptr to stop logging.
+         * @note The pages in the buffer pool should be clean, their changes made before are not logged.
+         */
+        void setLog(LogManager *log);
+
         /**
          * @brief: Marks the page with the specified page id as dirty.
          * @param pid: The page id of the page to mark as dirty.
+         * @note The page should be marked dirty after it is modified: with a log, the changes are logged by this method.
          */
         void markDirty(const PageId &pid);
 
+        /**
+         * @brief: Returns the LSN of the last log record of a page.
+         * @param pid: The page id of the page.
+         * @return: The LSN, 0 if the page was not changed since it was read from its file.
+         */
+        uint64_t getPageLsn(const PageId &pid) const;
+
+        /**
+         * @brief: Returns the dirty page table: the pages with logged changes that are not written to their files.
+         * @param begin_lsn: Set to the LSN of the next log record, every page dirtied later has records from it.
+         * @return: The pages and the LSN of their first record since they were last written (recLSN).
+         * @throws std::logic_error if the changes are not logged.
+         */
+        std::vector<DirtyPage> getDirtyPages(uint64_t &begin_lsn) const;
+
         /**
          * @brief: Returns whether the page with the specified page id is dirty.
          * @param pid: The page id of the page to check.
@@ -78,13 +216,24 @@ namespace db {
          * @param pid: The page id of the page to discard.
          * @note This method does NOT flush the page to disk.
          * @note This method also updates the LRU and dirty pages to exclude tracking this page.
+         * @throws std::logic_error if the page is being read into the buffer pool by another thread.
          */
         void discardPage(const PageId &pid);
 
+        /**
+         * @brief: Discards all the pages of a file from the buffer pool.
+         * @param file: The name of the file.
+         * @note This method does NOT flush the pages to disk, they should be flushed first (BufferPool::flushFile).
+         * @throws std::logic_error if a page of the file is pinned.
+         */
+        void discardFile(const std::string &file);
+
         /**
          * @brief: Flushes the page with the specified page id to disk.
          * @param pid: The page id of the page to flush.
          * @note This method should remove the page from dirty pages.
+         * @note The page is pinned and its latch is held in shared mode while it is written, so it is written between
+         * two modifications. The log and the file are written without the lock of the buffer pool.
          */
         void flushPage(const PageId &pid);
 
@@ -95,4 +244,38 @@ namespace db {
          */
         void flushFile(const std::string &file);
     };
+
+/**
+ * @brief A page that is pinned in the BufferPool and latched for the lifetime of the object.
+ * @details The latch of the frame is acquired in shared or exclusive mode after the page is pinned. Both are released
+ * when the object is destroyed. The version of the frame is odd while an exclusive latch is held, so that optimistic
+ * readers (BufferPool::readOptimistic) can detect concurrent modifications.
+ */
+    class PageLatch {
+        BufferPool &pool;
+        std::shared_mutex *latch;
+        std::atomic<uint64_t> *version;
+        bool exclusive;
+        bool dirty;
+
+    public:
+        const PageId pid;
+        Page &page;
+
+        PageLatch(BufferPool &pool, const PageId &pid, bool exclusive);
+
+        ~PageLatch();
+
+        PageLatch(const PageLatch &) = delete;
+
+        PageLatch &operator=(const PageLatch &) = delete;
+
+        /**
+         * @brief: Marks the latched page as dirty.
+         * @details The page is marked dirty in the BufferPool when the latch is released, so that all the changes
+         * made under the latch are logged together.
+         * @note The latch should be held in exclusive mode.
+         */
+        void markDirty();
+    };
 } // namespace db
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <db/DbFile.hpp>
+#include <db/Statistics.hpp>
+#include <limits>
+#include <memory>
+#include <optional>
+
+namespace db {
+    class BTreeFile;
+
+    /// The classes of the files described by the Catalog
+    enum class FileKind {
+        HEAP, VERSIONED_HEAP, BTREE, HASH, SECONDARY_INDEX
+    };
+
+    /**
+     * @brief The description of a file in the Catalog, enough to open it again.
+     */
+    struct CatalogEntry {
+        std::string name;
+        FileKind kind;
+        /// The tuple descriptor of the file
+        TupleDesc td;
+        /// The key fields of a BTREE or a HASH file
+        std::vector<size_t> key_fields;
+        /// The table and the indexed field of a SECONDARY_INDEX
+        std::string table;
+        size_t field = 0;
+        /// The garbage collection interval of a VERSIONED_HEAP file
+        std::chrono::milliseconds gc_interval{};
+        /// The secondary indexes of a HEAP file
+        std::vector<std::string> indexes;
+    };
+
+    /**
+     * @brief A persistent description of the files of the Database: their classes, schemas, keys and indexes.
+     * @details The catalog is stored in a BTreeFile with one row per fact, keyed on the name of the file and a
+     * sequence number: the row of the file (its kind), then the rows of its columns, then the names of its indexes,
+     * then its statistics: the size of the file, and the distinct count, smallest and largest values and histogram
+     * bounds of every column.
+     * Finding a file is a range scan of its rows, so the size of the catalog does not matter when the Database opens
+     * its files on demand (see Database::openCatalog). The rows of the catalog have the layout of
+     * Catalog::getTupleDesc.
+     */
+    class Catalog {
+        BTreeFile &file;
+
+        /// The keys of the rows of a file in [first, last)
+        std::vector<int> sequenceNumbers(const std::string &name, int first = 0,
+                                         int last = std::numeric_limits<int>::max()) const;
+
+        /// Remove the rows of a file in [first, last)
+        void eraseRows(const std::string &name, int first, int last = std::numeric_limits<int>::max());
+
+    public:
+        /// The sequence number of the first index row of a table
+        static constexpr int INDEX_SEQ = 1 << 20;
+        /// The sequence number of the first statistics row of a file, followed by STATS_COLUMN_ROWS rows per column
+        static constexpr int STATS_SEQ = 1 << 21;
+        static constexpr int STATS_COLUMN_ROWS = 1 << 12;
+        /// The largest number of buckets of a histogram in the catalog
+        static constexpr size_t MAX_BUCKETS = STATS_COLUMN_ROWS - 3;
+
+        /**
+         * @brief The tuple descriptor of the rows of a catalog: name, seq, kind, text, value, number
+         */
+        static const TupleDesc &getTupleDesc();
+
+        /**
+         * @brief Use a file as a catalog
+         * @param file a BTreeFile with the tuple descriptor of Catalog::getTupleDesc, keyed on its first two fields
+         * @throws std::logic_error if the file is not a catalog
+         */
+        explicit Catalog(BTreeFile &file);
+
+        const BTreeFile &getFile() const;
+
+        /**
+         * @brief Describe a file, replacing its previous description
+         * @details Only the kind, columns and keys of the file are replaced: its index and statistics rows are kept.
+         * When the file described is a different one, remove them with Catalog::dropIndexes and
+         * Catalog::dropStatistics.
+         * @return false if the class of the file cannot be described (e.g. a plain DbFile), nothing is recorded
+         * @throws std::logic_error if the name is longer than a CHAR field
+         */
+        bool record(const DbFile &file);
+
+        /**
+         * @brief Record an index of a table, the index itself is described by Catalog::record
+         */
+        void addIndex(const std::string &table, const std::string &index);
+
+        /**
+         * @brief Remove the index rows of a table, the indexes themselves stay in the catalog
+         */
+        void dropIndexes(const std::string &table);
+
+        /**
+         * @brief Store the statistics of a file, replacing its previous statistics
+         * @throws std::logic_error if the file is not in the catalog, the statistics do not have a column per field
+         * of the file, a histogram has more than MAX_BUCKETS buckets, or a string is longer than a CHAR field
+         */
+        void setStatistics(const std::string &name, const TableStatistics &stats);
+
+        /**
+         * @brief Get the statistics of a file
+         * @return the statistics, or an empty optional if none were stored
+         */
+        std::optional<TableStatistics> getStatistics(const std::string &name) const;
+
+        /**
+         * @brief Remove the statistics of a file, e.g. when they no longer match it
+         */
+        void dropStatistics(const std::string &name);
+
+        /**
+         * @brief Get the description of a file
+         * @return the description, or an empty optional if the file is not in the catalog
+         */
+        std::optional<CatalogEntry> find(const std::string &name) const;
+
+        /**
+         * @brief Remove the description of a file, and the reference of its table if it is an index
+         * @return false if the file is not in the catalog
+         * @note The file itself is not removed.
+         */
+        bool erase(const std::string &name);
+
+        /**
+         * @brief Get the names of all the files in the catalog, in order
+         */
+        std::vector<std::string> getNames() const;
+
+        /**
+         * @brief Create the object of a file of the catalog
+         * @details The file is opened but neither added to the Database nor attached to its table.
+         * @throws std::logic_error if the file, or the table of an index, is not in the catalog
+         */
+        std::unique_ptr<DbFile> open(const CatalogEntry &entry) const;
+    };
+
+} // namespace db
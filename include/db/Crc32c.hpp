@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace db {
+
+    /**
+     * @brief Compute the CRC-32C (Castagnoli) checksum of a buffer.
+     * @details The CRC32 instruction of SSE 4.2 (or of ARMv8) is used when the processor has it, with three
+     * independent streams so that its latency is hidden, and a table otherwise. Checksums can be chained:
+     * `crc32c(b, m, crc32c(a, n))` is the checksum of the concatenation of a and b.
+     * @param data the buffer
+     * @param length the number of bytes
+     * @param crc the checksum of the preceding bytes, 0 to start a new checksum
+     * @return the checksum
+     */
+    uint32_t crc32c(const void *data, size_t length, uint32_t crc = 0);
+
+} // namespace db
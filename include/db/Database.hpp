@@ -1,8 +1,13 @@
 #pragma once
 
 #include <db/BufferPool.hpp>
+#include <db/Catalog.hpp>
 #include <db/DbFile.hpp>
+#include <db/LogManager.hpp>
+#include <db/Metrics.hpp>
+#include <db/VersionClock.hpp>
 #include <memory>
+#include <shared_mutex>
 
 /**
  * @brief A database is a collection of files and a BufferPool.
@@ -12,14 +17,38 @@
  * @note A Database owns the DbFile objects that are added to it.
  */
 namespace db {
+    class SecondaryIndex;
+
     class Database {
+        // the metrics outlive the files and the buffer pool, which write pages when they are destroyed
+        Metrics metrics;
+
+        // the clock outlives the files, whose garbage collectors use it
+        VersionClock versionClock;
+
         // TODO pa0: add private members
         std::unordered_map<std::string, std::unique_ptr<DbFile>> files;
 
+        // the files opened on demand from the catalog by Database::get: they are added while other threads use the
+        // database, so unlike `files` they are guarded by a mutex. Only one thread opens files at a time.
+        mutable std::unordered_map<std::string, std::unique_ptr<DbFile>> opened;
+        mutable std::shared_mutex opened_mutex;
+        mutable std::mutex open_mutex;
+        std::unique_ptr<Catalog> catalog;
+
+        // the log is destroyed after the buffer pool, which flushes it before writing the dirty pages
+        std::unique_ptr<LogManager> log;
+
         BufferPool bufferPool;
 
         Database() = default;
 
+        /// Find an added or opened file, nullptr if there is none
+        DbFile *find(const std::string &name) const;
+
+        /// Open a file of the catalog, with the indexes of a table
+        DbFile &open(const std::string &name) const;
+
     public:
         friend Database &getDatabase();
 
@@ -37,14 +66,102 @@ namespace db {
          */
         BufferPool &getBufferPool();
 
+        /**
+         * @brief Logs the changes of the pages of the BufferPool to a write-ahead log.
+         * @param log The log, its records are recovered when it is opened. nullptr stops logging.
+         * @note The previous log is closed. This method takes ownership of the log.
+         */
+        void setLog(std::unique_ptr<LogManager> log);
+
+        /**
+         * @brief Returns the write-ahead log of the database.
+         * @return The log, or nullptr if the changes are not logged.
+         */
+        LogManager *getLog() const;
+
+        /**
+         * @brief Starts a change of several pages that is recovered as a whole (see LogManager::startOperation).
+         * @return The lock of the operation, empty if the changes are not logged.
+         */
+        std::shared_lock<std::shared_mutex> startOperation() const;
+
+        /**
+         * @brief Provides access to the commit timestamps of the versioned files (see VersionedHeapFile).
+         * @return The version clock
+         */
+        VersionClock &getVersionClock();
+
+        /**
+         * @brief Provides access to the metrics of the BufferPool and of the I/O of all the files.
+         * @return The metrics
+         */
+        Metrics &getMetrics();
+
+        /**
+         * @brief Takes a fuzzy checkpoint of the write-ahead log.
+         * @details The dirty page table of the BufferPool is read, the files are synced so that the pages written
+         * before are durable, and the table is written to the log. Other threads keep modifying pages meanwhile.
+         * Recovery then starts at the oldest change of a dirty page instead of the start of the log.
+         * @throws std::logic_error if the changes are not logged.
+         */
+        void checkpoint();
+
+        /**
+         * @brief Opens a persistent catalog of the files (see Catalog).
+         * @details The catalog is created if the file does not exist. Then the files added to the database are
+         * described in the catalog, and Database::get opens the files of the catalog on demand: nothing is read when
+         * the catalog is opened. A table is opened with its indexes.
+         * @param name The name of the file of the catalog.
+         * @throws std::logic_error if a catalog is open or the file is not a catalog.
+         */
+        void openCatalog(const std::string &name);
+
+        /**
+         * @brief Closes the catalog, the files opened from it are flushed and closed.
+         * @throws std::logic_error if there is no catalog.
+         * @note No other thread may use the files of the catalog.
+         */
+        void closeCatalog();
+
+        /**
+         * @brief Returns the catalog.
+         * @return The catalog, or nullptr if there is none.
+         */
+        Catalog *getCatalog() const;
+
+        /**
+         * @brief Collects the statistics of a file (see TableStatistics::collect).
+         * @details The statistics are stored in the catalog if the file is in it, and replace its previous statistics.
+         * @param name The name of the file.
+         * @param workers The number of threads that read the file.
+         * @param sample The fraction of the pages of a HeapFile to read.
+         * @return The statistics.
+         */
+        TableStatistics analyze(const std::string &name, size_t workers = 1, double sample = 1);
+
         /**
          * @brief Adds a new file to the Database.
+         * @details If a catalog is open, the file is described in it (see Catalog::record) before it is added.
          * @param file The file to add.
-         * @throws std::logic_error if the file name already exists.
+         * @throws std::logic_error if the file name already exists, or if the catalog rejects the file (the file is
+         * not added then).
          * @note This method takes ownership of the DbFile.
          */
         void add(std::unique_ptr<DbFile> file);
 
+        /**
+         * @brief Adds a secondary index of a HeapFile.
+         * @details The index is added as a file, filled with the tuples already in the table, and updated by every
+         * later insertion or deletion in the table. A table can have many indexes.
+         * @param index The index to add.
+         * @throws std::logic_error if the index name already exists, or if the table does not exist or is not a
+         * HeapFile.
+         * @throws std::runtime_error if the table cannot be read while the index is filled: the index is removed
+         * from the Database and from the catalog, its file may hold part of the entries.
+         * @note This method takes ownership of the index.
+         */
+        void addIndex(std::unique_ptr<SecondaryIndex> index);
+
         /**
          * @brief Removes a file.
          * @param name The name of the file to remove.
@@ -52,11 +169,14 @@ namespace db {
          * @throws std::logic_error if the name does not exist.
          * @note This method should call BufferPool::flushFile(name)
          * @note This method moves the DbFile ownership to the caller.
+         * @note A removed index is detached from its table. The indexes of a removed table are not removed.
+         * @note A file of the catalog is only closed: a later Database::get opens it again (see Catalog::erase).
          */
         std::unique_ptr<DbFile> remove(const std::string &name);
 
         /**
          * @brief Returns the DbFile of the specified id.
+         * @details A file that was not added is opened from the catalog, if there is one.
          * @param name The name of the file.
          * @return The DbFile object.
          * @throws std::logic_error if the name does not exist.
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <db/Iterator.hpp>
+#include <atomic>
 #include <db/types.hpp>
+#include <mutex>
 #include <vector>
 
 namespace db {
+    class ScanFilter;
 
 /**
  * @brief Represents a database file.
@@ -15,23 +18,31 @@ namespace db {
     class DbFile {
         mutable std::vector<size_t> reads;
         mutable std::vector<size_t> writes;
+        /// The pages of a file are read and written by several threads, without the mutex of the BufferPool
+        mutable std::mutex trace_mutex;
 
         // TODO pa1: add private members
         int fd;
+        const uint64_t generation;
 
     protected:
         const std::string name;
         const TupleDesc td;
-        size_t numPages;
+        /// Read without a lock by the scans, while pages are added
+        std::atomic<size_t> numPages;
 
     public:
+        /// The number of page ids kept by getReads and getWrites, the pages read or written after are only counted in
+        /// the Metrics of the Database
+        static constexpr size_t TRACE_LIMIT = size_t{1} << 20;
+
         /**
          * @brief Construct a new Db File object with the specified file name and tuple descriptor
          * @param name of the file to be opened or created.
          * @param td tuple description of tuples in the file.
          * @throws std::runtime_error if the file cannot be opened or if the `fstat` system call fails.
-         * @note This method calculates the number of pages in the file by dividing the file size (in bytes)
-         * by the `DEFAULT_PAGE_SIZE`.
+         * @note This method calculates the number of pages in the file from the file size (in bytes), see
+         * `storedPages` (the pages are stored in groups, with a block of headers before every group).
          */
         explicit DbFile(const std::string &name, const TupleDesc &td);
 
@@ -42,25 +53,77 @@ namespace db {
 
         const std::string &getName() const;
 
+        /**
+         * @brief A number that identifies this object among all the files of the process, it is never reused
+         * @note Unlike the address of the object, it cannot be taken by a file created after this one is destroyed.
+         */
+        uint64_t getGeneration() const;
+
+        /**
+         * @brief The ids of the pages read from the file, in order, up to TRACE_LIMIT of them.
+         * @note A trace for the tests, it should not be read while the file is used. The I/O of all the files is
+         * counted in Database::getMetrics.
+         */
         const std::vector<size_t> &getReads() const;
 
+        /**
+         * @brief The ids of the pages written to the file, in order, up to TRACE_LIMIT of them.
+         * @note A trace for the tests, it should not be read while the file is used. The I/O of all the files is
+         * counted in Database::getMetrics.
+         */
         const std::vector<size_t> &getWrites() const;
 
         /**
          * @brief Read a page from the file.
+         * @details The page and its header are read by two system calls, and the checksum of the page is verified
+         * against the header (see PageFormat.hpp).
          * @param page The page to read into.
          * @param id The page number of the page to be read. It determines the offset within the file.
+         * @throws std::runtime_error if the page is torn or corrupted.
          */
         void readPage(Page &page, size_t id) const;
 
         /**
          * @brief Write a page to the file.
+         * @details The page is written at its offset, a multiple of DEFAULT_PAGE_SIZE, then its header with its
+         * checksum is written in the header block of its group (see PageFormat.hpp).
          * @param page The page to write.
          * @param id The page number of the page to which the data will be written.
          * It determines the offset in the file.
+         * @note A crash between the two writes leaves the page and its header mismatched: the page is then reported
+         * as torn when it is read. With a LogManager, recovery rebuilds it from the log.
          */
         void writePage(const Page &page, size_t id) const;
 
+        /**
+         * @brief Read consecutive pages.
+         * @details The pages of every group are read by a single system call, and their headers by another one.
+         * @param data The buffer to read into, `count * DEFAULT_PAGE_SIZE` bytes. Pages past the end of the file
+         * are filled with zeros.
+         * @param first The page number of the first page.
+         * @param count The number of pages.
+         * @throws std::runtime_error if a page is torn or corrupted.
+         */
+        void readPages(uint8_t *data, size_t first, size_t count) const;
+
+        /**
+         * @brief Write consecutive pages.
+         * @details For every group, the pages are written first by a single system call, then their headers in the
+         * header block of the group by another one.
+         * @param data The contents of the pages, `count * DEFAULT_PAGE_SIZE` bytes.
+         * @param first The page number of the first page.
+         * @param count The number of pages.
+         * @note A crash between the two writes of a group leaves its pages and their headers mismatched, see
+         * DbFile::writePage.
+         */
+        void writePages(const uint8_t *data, size_t first, size_t count) const;
+
+        /**
+         * @brief Wait until the pages written to the file are durable.
+         * @throws std::runtime_error if the `fdatasync` system call fails.
+         */
+        void sync() const;
+
         virtual void insertTuple(const Tuple &t);
 
         virtual void deleteTuple(const Iterator &it);
@@ -73,6 +136,19 @@ namespace db {
 
         virtual Iterator end() const;
 
+        /**
+         * @brief Read the tuples of a page.
+         * @details Serialize the tuples from the position of the iterator to the end of its page that satisfy a
+         * filter, and advance the iterator to the first tuple of the next page (or to the end of the file). Scans read
+         * a page at a time instead of a tuple at a time (see SeqScan).
+         * @param it The position of the first tuple to read, it must not be the end of the file.
+         * @param rows The tuples are appended to the buffer, `td.length()` bytes per tuple.
+         * @param filter The predicates that the tuples must satisfy.
+         * @return The number of tuples appended.
+         * @note The default implementation calls getTuple and next for every tuple.
+         */
+        virtual size_t readTuples(Iterator &it, std::vector<uint8_t> &rows, const ScanFilter &filter) const;
+
         size_t getNumPages() const;
 
         const TupleDesc &getTupleDesc() const;
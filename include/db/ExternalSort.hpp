@@ -0,0 +1,105 @@
+#pragma once
+
+#include <db/Operator.hpp>
+#include <db/SortKey.hpp>
+#include <db/TempFile.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that sorts its input, spilling sorted runs to disk when it does not fit in the memory budget.
+     * @details Every row gets a normalized key (see SortKey), which orders the rows with memcmp. Rows are buffered
+     * until the budget is reached, then sorted on the first 8 bytes of their key as an integer, next to the index of
+     * the row, so that most comparisons do not touch the rows; the rest of the key is only compared on ties. Each sorted buffer is written to a TempFile (a run) a block
+     * of pages at a time.
+     * If the input fits in the budget, the rows are produced from memory. Otherwise the runs are merged with a loser
+     * tree, which needs one comparison per level of the tree for each row. When there are more runs than the budget
+     * can hold blocks of, groups of runs are merged into longer runs first.
+     * Rows with equal keys are produced in the order of the input. The input is read completely when the operator is
+     * opened. Predicates are pushed down into the input.
+     */
+    class ExternalSort : public Operator {
+        /// A run being merged, with the block of rows that was read last and the key of the current row
+        struct RunCursor {
+            const TempFile *file;
+            size_t next_page;
+            std::vector<uint8_t> rows;
+            size_t count;
+            size_t pos;
+            std::vector<uint8_t> key;
+        };
+
+        std::unique_ptr<Operator> child;
+        const size_t memory_budget;
+        const size_t block_pages;
+        const SortKey sort_key;
+        const size_t key_length;
+        /// The rows and the keys of the current run, and the order of the rows
+        std::vector<uint8_t> rows;
+        std::vector<uint8_t> keys;
+        std::vector<std::pair<uint64_t, uint32_t>> order;
+        std::vector<std::unique_ptr<TempFile>> runs;
+        size_t num_runs;
+        /// The runs of the last merge, and the loser tree over them (the winner is at position 0)
+        std::vector<RunCursor> cursors;
+        std::vector<size_t> tree;
+        bool pending;
+        size_t pos;
+
+        /// Sort the buffered rows
+        void sortRows();
+
+        /// Sort the buffered rows and write them to a new run
+        void writeRun();
+
+        bool less(size_t a, size_t b) const;
+
+        /// Load the next block of a run, the run is exhausted if the block is empty
+        void loadBlock(RunCursor &cursor) const;
+
+        void advance(size_t run);
+
+        size_t buildTree(size_t node);
+
+        /// Start merging runs, the runs must outlive the merge
+        void startMerge(const std::vector<std::unique_ptr<TempFile>> &inputs, size_t first, size_t count);
+
+        /// Get the run of the next row of the merge, or the number of runs if they are exhausted
+        size_t nextMerged();
+
+    public:
+        /**
+         * @brief Initialize a sort
+         * @param child the rows to sort
+         * @param fields the fields to sort on, from the most to the least significant
+         * @param memory_budget the number of bytes of rows (with their keys) sorted in memory, and of the blocks of
+         * the runs held in memory during a merge
+         * @param block_pages the number of pages of a run read or written by a system call
+         * @throws std::logic_error if there are no sort fields or a field does not exist
+         */
+        ExternalSort(std::unique_ptr<Operator> child, const std::vector<SortField> &fields,
+                     size_t memory_budget = defaultBudget(), size_t block_pages = 32);
+
+        /**
+         * @brief Get the default memory budget of a sort: a quarter of the memory of the BufferPool
+         */
+        static size_t defaultBudget();
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+
+        /**
+         * @brief Get the number of runs written by the last sort, 0 if the input fit in memory
+         */
+        size_t numRuns() const;
+    };
+
+} // namespace db
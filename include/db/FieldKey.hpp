@@ -0,0 +1,41 @@
+#pragma once
+
+#include <db/Tuple.hpp>
+#include <string_view>
+
+namespace db {
+
+    /**
+     * @brief A single INT or CHAR field of serialized rows, used as a join or grouping key.
+     * @details INT keys are compared as numbers and CHAR keys byte by byte, which is the order of a BTreeFile on the
+     * field (see KeyDesc).
+     */
+    struct FieldKey {
+        size_t offset;
+        type_t type;
+
+        /**
+         * @brief Initialize a key
+         * @param td the tuple descriptor of the rows
+         * @param field the index of the key field
+         * @throws std::logic_error if the field does not exist or is not an INT or CHAR field
+         */
+        FieldKey(const TupleDesc &td, size_t field);
+
+        /**
+         * @brief Get the bytes of the key: the 4 bytes of an INT, or the characters of a CHAR field
+         */
+        std::string_view bytes(const uint8_t *row) const;
+
+        uint64_t hash(const uint8_t *row) const;
+
+        /**
+         * @brief Compare the key of a row with the key of a row of another descriptor
+         * @return a negative number, 0 or a positive number if the key is less, equal or greater than the other key
+         */
+        int compare(const uint8_t *row, const FieldKey &other, const uint8_t *other_row) const;
+
+        bool equal(const uint8_t *row, const FieldKey &other, const uint8_t *other_row) const;
+    };
+
+} // namespace db
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <db/Operator.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces the rows of its input that satisfy all of its predicates.
+     * @details The predicates are pushed down to the input when possible (see Operator::pushDown); the filter only
+     * evaluates the predicates that the input does not accept.
+     */
+    class Filter : public Operator {
+        std::unique_ptr<Operator> child;
+        std::vector<Predicate> predicates;
+
+    public:
+        /**
+         * @brief Initialize a filter
+         * @param child the input of the filter
+         * @param predicates the predicates on the rows of the input
+         * @throws std::logic_error if a predicate does not match the rows of the input
+         */
+        Filter(std::unique_ptr<Operator> child, const std::vector<Predicate> &predicates);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Evaluate a predicate in the filter or in its input
+         * @return always true
+         */
+        bool pushDown(const Predicate &predicate) override;
+    };
+
+} // namespace db
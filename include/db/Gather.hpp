@@ -0,0 +1,89 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <db/Operator.hpp>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace db {
+
+    /**
+     * @brief An operator that runs several pipelines in parallel and produces the rows of all of them.
+     * @details Each input is opened and drained by its own thread, e.g. the pipelines of the workers of a parallel
+     * scan (see MorselScan). The threads pass their rows to the consumer in batches through a bounded queue, so a
+     * slow consumer blocks the threads instead of buffering the whole result. The rows of the inputs are interleaved
+     * in no particular order, unless the gather is ordered: then each input has a queue of its own and the rows of
+     * an input are produced after all the rows of the inputs before it, e.g. to merge the key ranges of a parallel
+     * BTreeFile scan (see BTreeScan) in key order while the later ranges are read ahead.
+     * An exception thrown by an input is rethrown by Gather::next once the rows produced before it are consumed.
+     */
+    class Gather : public Operator {
+        std::vector<std::unique_ptr<Operator>> inputs;
+        const bool ordered;
+        const size_t max_batches;
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable produced;
+        std::condition_variable consumed;
+        /// The batches of each input if the gather is ordered, otherwise of all inputs in the first queue
+        std::vector<std::deque<std::vector<uint8_t>>> queues;
+        std::vector<bool> finished;
+        /// The queue that the consumer reads from
+        size_t source;
+        size_t running;
+        bool stopped;
+        std::exception_ptr error;
+        std::vector<uint8_t> batch;
+        size_t count;
+        size_t pos;
+        const uint8_t *current;
+
+        /// Drain an input, called by the thread of the input
+        void produce(size_t input);
+
+        /// Push a batch to the queue of an input, return false if the gather was stopped
+        bool push(size_t input, std::vector<uint8_t> &rows);
+
+        /// Stop and join the threads
+        void stop();
+
+    public:
+        /// The number of rows of a batch passed from a thread to the consumer
+        static constexpr size_t BATCH_ROWS = 1024;
+
+        /**
+         * @brief Initialize a gather
+         * @param inputs the pipelines, with the same tuple descriptor, run by one thread each
+         * @param max_batches the number of batches that a queue holds before its threads wait for the consumer, by
+         * default 4 per input if there is a single queue, and 64 per input if the gather is ordered
+         * @param ordered whether the rows of each input are produced in turn, in the order of the inputs
+         * @throws std::logic_error if there are no inputs, or their tuple descriptors differ
+         */
+        explicit Gather(std::vector<std::unique_ptr<Operator>> inputs, size_t max_batches = 0, bool ordered = false);
+
+        ~Gather() override;
+
+        const TupleDesc &getTupleDesc() const override;
+
+        /**
+         * @brief Start the threads of the inputs, the threads of the previous run are stopped first
+         */
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Push a predicate down into every input
+         * @return true if every input accepted the predicate
+         * @note If only some inputs accept it, the predicate is still evaluated by them, and the caller has to
+         * evaluate it on every row.
+         */
+        bool pushDown(const Predicate &predicate) override;
+    };
+
+} // namespace db
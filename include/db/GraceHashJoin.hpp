@@ -0,0 +1,86 @@
+#pragma once
+
+#include <db/JoinHashTable.hpp>
+#include <db/Operator.hpp>
+#include <db/SeqScan.hpp>
+#include <memory>
+#include <string>
+
+namespace db {
+
+    /**
+     * @brief An equi-join on an INT or CHAR field of each input that spills to disk when the build input is large.
+     * @details The build input is read into a JoinHashTable until it exceeds the memory budget. It is then
+     * partitioned on the hash of its key into temporary HeapFiles, and so is the probe input; each pair of partitions
+     * is joined in memory in turn (Grace hash join). If the build input fits, the probe input is streamed as in a
+     * HashJoin. The rows of the join are the build row followed by the probe row (see TupleDesc::merge).
+     * The temporary files are registered in the Database while the join uses them, and are removed and deleted when
+     * the join is opened again or destroyed.
+     * @note A partition is joined in memory even if it exceeds the budget (e.g. if most rows have the same key), the
+     * partitions are not partitioned again.
+     */
+    class GraceHashJoin : public Operator {
+        std::unique_ptr<Operator> build_child;
+        std::unique_ptr<Operator> probe_child;
+        const FieldKey build_key;
+        const FieldKey probe_key;
+        const size_t memory_budget;
+        const size_t fan_out;
+        TupleDesc td;
+        JoinHashTable table;
+        /// The names of the temporary files of the partitions, empty if the build input fits in memory
+        std::vector<std::string> build_files;
+        std::vector<std::string> probe_files;
+        size_t partition;
+        std::unique_ptr<SeqScan> probe_scan;
+        Operator *probe_source;
+        std::vector<uint8_t> probe_rows;
+        size_t probe_count;
+        bool probe_done;
+        std::vector<std::pair<uint32_t, uint32_t>> matches;
+        size_t pos;
+        std::vector<uint8_t> current;
+
+        size_t partitionOf(uint64_t hash) const;
+
+        /// Create the partition files and move the rows of the table to them
+        void spill();
+
+        void loadPartition(size_t p);
+
+        void dropFiles();
+
+    public:
+        /**
+         * @brief Initialize a join
+         * @param build the input that is hashed, usually the smaller one
+         * @param probe the input that is streamed
+         * @param build_field the index of the key field of the build input
+         * @param probe_field the index of the key field of the probe input
+         * @param memory_budget the number of bytes of the build input held in memory before it is partitioned
+         * @param fan_out the number of partitions
+         * @throws std::logic_error if the key fields do not exist, are not INT or CHAR fields or have different types,
+         * if the inputs have fields with the same name, or if the fan out is 0
+         */
+        GraceHashJoin(std::unique_ptr<Operator> build, std::unique_ptr<Operator> probe, size_t build_field,
+                      size_t probe_field, size_t memory_budget, size_t fan_out = 32);
+
+        ~GraceHashJoin() override;
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+
+        /**
+         * @brief Check whether the last run of the join partitioned its inputs to disk
+         */
+        bool spilled() const;
+    };
+
+} // namespace db
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <db/Aggregate.hpp>
+#include <db/AggregateTable.hpp>
+#include <db/TempFile.hpp>
+#include <limits>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that computes a GROUP BY query with a hash table of the groups.
+     * @details The operator has one or more inputs with the same tuple descriptor, e.g. scans of the partitions of a
+     * table. Each input is aggregated by its own thread into a thread-local AggregateTable (pre-aggregation), and
+     * the tables are merged when every input has been read.
+     * When the table of a thread exceeds its share of the memory budget, the rows of the groups that are already in
+     * the table are still aggregated in memory, and the rows of new groups are partitioned on the hash of their key
+     * into temporary files (see TempFile). Each partition is aggregated on its own after the inputs are read, so a
+     * group is always computed completely in memory. The groups of the partitions are produced first, then the
+     * groups of the merged table.
+     * Predicates on the group fields are pushed down into the inputs.
+     * @note The merged table and the tables of the partitions may exceed the budget, the partitions are not
+     * partitioned again. Without group fields, an empty input produces one row (see Aggregate).
+     */
+    class HashAggregate : public Operator {
+        std::vector<std::unique_ptr<Operator>> inputs;
+        AggregateLayout layout;
+        const size_t memory_budget;
+        const size_t fan_out;
+        AggregateTable table;
+        /// The temporary files of each input, one per partition, empty if the input did not spill
+        std::vector<std::vector<std::unique_ptr<TempFile>>> spills;
+        /// The table of the partition being produced, and whether each of its groups was merged into the table
+        AggregateTable partition_table;
+        std::vector<bool> merged;
+        size_t partition;
+        /// The table whose groups are being produced, and the position in it
+        AggregateTable *current_table;
+        size_t pos;
+        std::vector<uint8_t> current;
+
+        size_t partitionOf(uint64_t hash) const;
+
+        /// Aggregate an input, called by the thread of the input
+        void aggregateInput(Operator &input, AggregateTable &local, std::vector<std::unique_ptr<TempFile>> &files,
+                            size_t budget) const;
+
+        void loadPartition(size_t p);
+
+    public:
+        /**
+         * @brief Initialize an aggregation of one input
+         * @param input the rows to group
+         * @param group_fields the indices of the INT or CHAR fields to group on
+         * @param aggregates the aggregates to compute
+         * @param memory_budget the number of bytes of the table before new groups are written to disk
+         * @param fan_out the number of partitions of the groups written to disk
+         * @throws std::logic_error if the query does not match the tuples of the input (see AggregateLayout)
+         */
+        HashAggregate(std::unique_ptr<Operator> input, const std::vector<size_t> &group_fields,
+                      const std::vector<Aggregate> &aggregates,
+                      size_t memory_budget = std::numeric_limits<size_t>::max(), size_t fan_out = 16);
+
+        /**
+         * @brief Initialize an aggregation of several inputs that are read in parallel
+         * @param inputs the rows to group, with the same tuple descriptor, read by one thread each
+         * @throws std::logic_error if there are no inputs, or their tuple descriptors differ
+         */
+        HashAggregate(std::vector<std::unique_ptr<Operator>> inputs, const std::vector<size_t> &group_fields,
+                      const std::vector<Aggregate> &aggregates,
+                      size_t memory_budget = std::numeric_limits<size_t>::max(), size_t fan_out = 16);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+
+        /**
+         * @brief Check whether the last run of the aggregation wrote groups to disk
+         */
+        bool spilled() const;
+    };
+
+} // namespace db
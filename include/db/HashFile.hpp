@@ -0,0 +1,126 @@
+#pragma once
+
+#include <db/BufferPool.hpp>
+#include <db/DbFile.hpp>
+#include <db/KeyDesc.hpp>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief A file that stores tuples in the buckets of an extendible hash table.
+     * @details Every page of the file is a bucket (see HashPage). The directory maps the low `depth` bits of the
+     * hash of a key (its CRC-32C, the same on every platform and build) to the bucket of the key; it is kept in
+     * memory and rebuilt from the headers of the buckets when the file is opened, so a point lookup accesses a single
+     * page. When a bucket is full, it is split on the next bit of the hash and the directory is doubled if the bucket
+     * was referenced by a single entry, up to 2^20 entries. Buckets are never merged.
+     * All operations are thread-safe. Lookups, insertions and deletions hold the directory in shared mode and latch
+     * the bucket in the BufferPool; splits hold the directory in exclusive mode and are operations of the log (see
+     * LogManager::startOperation).
+     * @note Tuples are not sorted. Iterators are positions (page, slot) and are not stable while other threads
+     * modify the file.
+     */
+    class HashFile : public DbFile {
+        KeyDesc key_desc;
+        mutable std::shared_mutex directory_mutex;
+        /// The bucket of every combination of the low `global_depth` bits of a hash
+        std::vector<size_t> directory;
+        uint8_t global_depth;
+
+        uint32_t hash(std::string_view key) const;
+
+        size_t bucketOf(uint32_t hash) const;
+
+        void split(size_t page);
+
+        std::optional<Tuple> find(std::string_view key) const;
+
+        bool erase(std::string_view key);
+
+    public:
+        /**
+         * @brief Initialize a HashFile
+         * @param key_index the index of the key in the tuple
+         */
+        HashFile(const std::string &name, const TupleDesc &td, size_t key_index);
+
+        /**
+         * @brief Initialize a HashFile with a composite key
+         * @param key_indices the indices of the key fields in the tuple
+         * @throws std::logic_error if the key is invalid (see KeyDesc) or the tuples are too large for a bucket
+         */
+        HashFile(const std::string &name, const TupleDesc &td, const std::vector<size_t> &key_indices);
+
+        /**
+         * @brief Insert a tuple into the file
+         * @details If the key already exists, the previous tuple is replaced. If the bucket of the key is full, the
+         * bucket is split until the tuple fits.
+         * @param t the tuple to insert
+         * @throws std::runtime_error if the bucket cannot be split because all of its keys have the same low 20 bits
+         * of their hash
+         */
+        void insertTuple(const Tuple &t) override;
+
+        /**
+         * @brief Delete a tuple from the file
+         * @details Delete the tuple with the key of the tuple that the iterator points to (see HashFile::deleteKey).
+         * @param it the iterator that identifies the tuple to be deleted
+         * @note The last tuple of the bucket takes the slot of the deleted tuple.
+         */
+        void deleteTuple(const Iterator &it) override;
+
+        /**
+         * @brief Delete the tuple with the provided key
+         * @param key the key of the tuple to delete
+         * @return true if a tuple was deleted, false if the key does not exist
+         */
+        bool deleteKey(int key);
+
+        /**
+         * @brief Delete the tuple with the provided key
+         * @param key the values of the key fields
+         * @return true if a tuple was deleted, false if the key does not exist
+         */
+        bool deleteKey(const std::vector<field_t> &key);
+
+        Tuple getTuple(const Iterator &it) const override;
+
+        /**
+         * @brief Advance the iterator to the next tuple.
+         * @details Advance the iterator to the next slot of the bucket, or to the first tuple of the next non-empty
+         * bucket.
+         * @param it The iterator to be advanced.
+         */
+        void next(Iterator &it) const override;
+
+        Iterator begin() const override;
+
+        /**
+         * @brief Get the iterator to the end of the file.
+         * @return An iterator that points past the last page of the file.
+         */
+        Iterator end() const override;
+
+        /**
+         * @brief Find the tuple with the provided key.
+         * @details Hash the key, find its bucket in the directory and search the bucket.
+         * @param key The key to search for.
+         * @return The tuple with the key, or an empty optional if the key does not exist.
+         */
+        std::optional<Tuple> lookup(int key) const;
+
+        /**
+         * @brief Find the tuple with the provided key (see HashFile::lookup)
+         * @param key The values of the key fields.
+         * @return The tuple with the key, or an empty optional if the key does not exist.
+         */
+        std::optional<Tuple> lookup(const std::vector<field_t> &key) const;
+
+        /**
+         * @brief Get the indices of the key fields
+         */
+        const std::vector<size_t> &getKeyIndices() const;
+    };
+} // namespace db
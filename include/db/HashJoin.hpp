@@ -0,0 +1,54 @@
+#pragma once
+
+#include <db/JoinHashTable.hpp>
+#include <db/Operator.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An in-memory equi-join on an INT or CHAR field of each input.
+     * @details The build input is read into a JoinHashTable when the join is opened. The probe input is then pulled
+     * in chunks of rows that are looked up in the table together (see JoinHashTable::probe). The rows of the join
+     * are the build row followed by the probe row (see TupleDesc::merge), in no particular order.
+     * Predicates on the fields of one input are pushed down into that input.
+     * @note The whole build input is held in memory, see GraceHashJoin for inputs that may not fit.
+     */
+    class HashJoin : public Operator {
+        std::unique_ptr<Operator> build_child;
+        std::unique_ptr<Operator> probe_child;
+        const FieldKey probe_key;
+        TupleDesc td;
+        JoinHashTable table;
+        std::vector<uint8_t> probe_rows;
+        size_t probe_count;
+        bool probe_done;
+        std::vector<std::pair<uint32_t, uint32_t>> matches;
+        size_t pos;
+        std::vector<uint8_t> current;
+
+    public:
+        /**
+         * @brief Initialize a hash join
+         * @param build the input that is held in memory, usually the smaller one
+         * @param probe the input that is streamed
+         * @param build_field the index of the key field of the build input
+         * @param probe_field the index of the key field of the probe input
+         * @throws std::logic_error if the key fields do not exist, are not INT or CHAR fields or have different types,
+         * or if the inputs have fields with the same name
+         */
+        HashJoin(std::unique_ptr<Operator> build, std::unique_ptr<Operator> probe, size_t build_field,
+                 size_t probe_field);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+    };
+
+} // namespace db
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <db/KeyDesc.hpp>
+
+namespace db {
+
+    struct HashPageHeader {
+        /// The low `depth` bits shared by the hashes of all keys in the bucket
+        uint32_t pattern;
+
+        /// The number of tuples in the page
+        uint16_t size;
+
+        /// The number of hash bits that select the bucket (local depth)
+        uint8_t depth;
+    };
+
+    /**
+     * @brief A bucket of a HashFile.
+     * @details The page has a header of type HashPageHeader, followed by the hashes of the keys of the tuples and by
+     * the tuples. Tuples are not sorted: a key is found by comparing its hash with every stored hash, and only the
+     * tuples with an equal hash are deserialized. Deleting a tuple moves the last tuple into its slot.
+     */
+    struct HashPage {
+        const TupleDesc &td;
+
+        uint16_t capacity;
+
+        HashPageHeader *header;
+        uint32_t *hashes;
+        uint8_t *data;
+
+        /**
+         * @brief Initialize a bucket page
+         * @param page the page contents
+         * @param td the tuple descriptor
+         */
+        HashPage(Page &page, const TupleDesc &td);
+
+        /**
+         * @brief Find the slot of a key
+         * @param hash the hash of the key
+         * @param key the normalized key
+         * @param kd the descriptor of the keys
+         * @return the slot of the tuple with the key, or `size` if there is none
+         */
+        size_t find(uint32_t hash, std::string_view key, const KeyDesc &kd) const;
+
+        /**
+         * @brief Append a tuple to the page
+         * @return false if the page is full
+         */
+        bool insertTuple(const Tuple &t, uint32_t hash);
+
+        /**
+         * @brief Replace the tuple at a slot, the key of the tuple does not change
+         */
+        void replaceTuple(size_t slot, const Tuple &t);
+
+        /**
+         * @brief Delete a tuple from the page
+         * @details The last tuple of the page is moved to the slot.
+         * @param slot the slot of the tuple to delete
+         */
+        void deleteTuple(size_t slot);
+
+        /**
+         * @brief Get the tuple at a slot
+         */
+        Tuple getTuple(size_t slot) const;
+
+        /**
+         * @brief Split the bucket
+         * @details The local depth of the bucket grows by one bit. The tuples whose hash has the new bit set are
+         * moved to the new page.
+         * @param new_page a new empty page
+         */
+        void split(HashPage &new_page);
+    };
+
+} // namespace db
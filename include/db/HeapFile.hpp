@@ -1,22 +1,56 @@
 #pragma once
 
 #include <db/DbFile.hpp>
+#include <shared_mutex>
 
 namespace db {
+    class SecondaryIndex;
+
     class HeapFile : public DbFile {
+        /// The indexes that are updated by insertions and deletions
+        std::vector<SecondaryIndex *> indexes;
+        /// Held exclusively while an index is attached or detached, shared by the updates of the indexes
+        std::shared_mutex index_mutex;
+
     public:
         HeapFile(const std::string &name, const TupleDesc &td);
 
+        /**
+         * @brief Attach an index to the file.
+         * @details The tuples already in the file are added to the index, and the index is updated by every later
+         * insertion and deletion. Insertions and deletions wait while the index is filled, so that none is missed.
+         * @param index The index of a field of this file.
+         * @param fill Whether to add the tuples already in the file, false if the index was kept up to date with the
+         * file before, e.g. when both are opened again from the Catalog.
+         * @note The file does not own the index (see Database::addIndex).
+         */
+        void addIndex(SecondaryIndex &index, bool fill = true);
+
+        /**
+         * @brief Detach an index from the file.
+         * @param index An index attached with HeapFile::addIndex.
+         */
+        void removeIndex(const SecondaryIndex &index);
+
+        /**
+         * @brief Get the indexes attached to the file.
+         */
+        const std::vector<SecondaryIndex *> &getIndexes() const;
+
         /**
          * @brief Insert a tuple to the database file.
          * @details Insert a tuple to the first available slot of the last page. If the last page is full, create a new page.
+         * The entry of the tuple is added to every index of the file.
          * @param t The tuple to be inserted.
+         * @note Several threads may insert at the same time: the page is pinned and latched in exclusive mode while
+         * the tuple is added, and a thread that finds the last page full continues on the next page.
          */
         void insertTuple(const Tuple &t) override;
 
         /**
          * @brief Delete a tuple from the database file.
-         * @details Delete a tuple from the database file by marking the slot unused.
+         * @details Delete a tuple from the database file by marking the slot unused. The entry of the tuple is removed
+         * from every index of the file.
          * @param it The iterator that identifies the tuple to be deleted.
          */
         void deleteTuple(const Iterator &it) override;
@@ -51,5 +85,12 @@ namespace db {
          * @return The iterator to the end of the file.
          */
         Iterator end() const override;
+
+        /**
+         * @brief Read the tuples of a page (see DbFile::readTuples).
+         * @details The filter is evaluated on the page with the scan kernels, and the selected tuples are copied
+         * directly from the page. The page is latched in shared mode, so several threads can read the file.
+         */
+        size_t readTuples(Iterator &it, std::vector<uint8_t> &rows, const ScanFilter &filter) const override;
     };
 } // namespace db
@@ -40,6 +40,23 @@ namespace db {
          */
         bool insertTuple(const Tuple &t);
 
+        /**
+         * @brief Insert a tuple to the page.
+         * @param t The tuple to be inserted.
+         * @param slot Set to the slot of the inserted tuple.
+         * @return True if the tuple is inserted successfully, false otherwise if the page is full.
+         */
+        bool insertTuple(const Tuple &t, size_t &slot);
+
+        /**
+         * @brief Insert a tuple in a specific slot of the page.
+         * @details Only the bytes of the slot and its bit of the header are written.
+         * @param slot The slot of the tuple, it must be empty.
+         * @param t The tuple to be inserted.
+         * @throws std::runtime_error if the slot is out of range or occupied.
+         */
+        void putTuple(size_t slot, const Tuple &t);
+
         /**
          * @brief Delete a tuple from the page.
          * @details Delete a tuple from the page by marking the slot unused.
@@ -63,6 +80,35 @@ namespace db {
          */
         Tuple getTuple(size_t slot) const;
 
+        /**
+         * @brief Get the bitmap of the occupied slots.
+         * @param bitmap Bit i % 64 of word i / 64 is set if slot i is occupied (see ScanKernels.hpp), it must have
+         * room for (end() + 63) / 64 words.
+         */
+        void occupancy(uint64_t *bitmap) const;
+
+        /**
+         * @brief Copy the serialized tuples of the occupied slots that satisfy a filter.
+         * @details The filter is evaluated on the whole data region of the page and its bitmap is ANDed with the
+         * bitmap of the occupied slots.
+         * @param slot The first slot to copy.
+         * @param rows The buffer to copy the tuples into, it must have room for the tuples of end() - slot slots.
+         * @param filter The predicates that the tuples must satisfy.
+         * @return The number of tuples copied.
+         */
+        size_t readTuples(size_t slot, uint8_t *rows, const ScanFilter &filter) const;
+
+        /**
+         * @brief Copy the serialized tuples of a set of slots that satisfy a filter.
+         * @details The header is not read: the bytes of the selected slots are copied, and the filter is evaluated on
+         * the copies. Other slots may be modified concurrently (see VersionedHeapFile).
+         * @param bitmap The slots to copy, in the format of HeapPage::occupancy.
+         * @param rows The buffer to copy the tuples into, it must have room for the selected tuples.
+         * @param filter The predicates that the tuples must satisfy.
+         * @return The number of tuples copied.
+         */
+        size_t readTuples(const uint64_t *bitmap, uint8_t *rows, const ScanFilter &filter) const;
+
         /**
          * @brief Advance the slot to the next occupied slot.
          * @details Advance the slot to the next occupied slot by scanning the header.
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief An estimator of the number of distinct values of a stream, in a fixed amount of memory.
+     * @details The values are added as 64 bit hashes: the first `precision` bits of a hash select a register, which
+     * keeps the largest position of the first set bit among the other bits of its hashes. The harmonic mean of the
+     * registers estimates the number of distinct hashes with a standard error of about 1.04 / sqrt(2^precision), 1.6%
+     * with the default precision and 4 KB of registers. Small counts are estimated from the number of empty registers
+     * instead (linear counting). The estimators of the parts of a stream, e.g. of the threads of a parallel scan, are
+     * merged into the estimator of the whole stream.
+     */
+    class HyperLogLog {
+        uint8_t precision;
+        std::vector<uint8_t> registers;
+
+    public:
+        /**
+         * @brief Initialize an empty estimator
+         * @param precision the number of bits of a hash that select a register, from 4 to 18
+         * @throws std::logic_error if the precision is out of range
+         */
+        explicit HyperLogLog(uint8_t precision = 12);
+
+        /**
+         * @brief Add a value
+         * @param hash the hash of the value, every bit of it must depend on the value (see FieldKey::hash)
+         */
+        void add(uint64_t hash);
+
+        /**
+         * @brief Add the values of another estimator
+         * @throws std::logic_error if the estimators do not have the same precision
+         */
+        void merge(const HyperLogLog &other);
+
+        /**
+         * @brief Estimate the number of distinct values added
+         */
+        double estimate() const;
+    };
+
+} // namespace db
@@ -31,6 +31,28 @@ namespace db {
          */
         explicit IndexPage(Page &page);
 
+        /**
+         * @brief Reset the page to contain no keys and a single child
+         * @param first_child the only child of the page
+         * @param index_children whether the child is an index page
+         */
+        void init(size_t first_child, bool index_children);
+
+        /**
+         * @brief Get the key at a position
+         */
+        int key(size_t pos) const;
+
+        /**
+         * @brief Get the child at a position
+         */
+        size_t child(size_t pos) const;
+
+        /**
+         * @brief Replace the child at a position
+         */
+        void setChild(size_t pos, size_t child);
+
         /**
          * @brief Insert a new key with a corresponding child page number
          * @param key the key to insert
@@ -39,6 +61,42 @@ namespace db {
          */
         bool insert(int key, size_t child);
 
+        /**
+         * @brief Remove a key and the child on its right
+         * @param pos the position of the key (the child at position `pos + 1` is removed)
+         */
+        void erase(size_t pos);
+
+        /**
+         * @brief Merge the right sibling into the page
+         * @details The separator key of the two pages (taken from the parent) is followed by the keys of the right
+         * sibling, and the children of the right sibling are appended to the children of the page.
+         * @param key the separator key between this page and the right sibling
+         * @param right the right sibling
+         */
+        void merge(int key, IndexPage &right);
+
+        /**
+         * @brief Check if the right sibling and the separator fit in the page
+         */
+        bool canMerge(int key, const IndexPage &right) const;
+
+        /**
+         * @brief Move the last key of the left sibling through the parent
+         * @details The separator in the parent moves down to the front of the page, and the last key of the left
+         * sibling replaces it.
+         * @param left the left sibling
+         * @param parent the parent page
+         * @param pos the position of this page in the parent
+         * @return true (the keys have a fixed length and always fit)
+         */
+        bool rotateFromLeft(IndexPage &left, IndexPage &parent, size_t pos);
+
+        /**
+         * @brief Move the first key of the right sibling through the parent (see IndexPage::rotateFromLeft)
+         */
+        bool rotateFromRight(IndexPage &right, IndexPage &parent, size_t pos);
+
         /**
          * @brief Split the index page
          * @details The page is split into two pages. The old page contains the first half of the tuples, and the new page contains the second half.
@@ -46,6 +104,28 @@ namespace db {
          * @return the split key (this key is moved to the parent page)
          */
         int split(IndexPage &new_page);
+
+        /**
+         * @brief Find the child responsible for a key
+         * @param key the key to search for
+         * @return the position (in `children`) of the child whose range contains the key
+         */
+        size_t child_of(int key) const;
+
+        /**
+         * @brief Check if inserting a key may fill the page
+         */
+        bool mayOverflow() const;
+
+        /**
+         * @brief Check if the page has less keys than half of its capacity
+         */
+        bool underflows() const;
+
+        /**
+         * @brief Check if a key can be removed without making the page underflow
+         */
+        bool canLend() const;
     };
 
 } // namespace db
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <db/HeapFile.hpp>
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+#include <db/SecondaryIndex.hpp>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces the tuples of a HeapFile found in one of its secondary indexes.
+     * @details The positions of the tuples whose indexed field is in a range are read from the index when the scan is
+     * opened, and sorted so that the pages of the table are read in order and each one once. Pushed down predicates,
+     * on the indexed field or any other, are evaluated on the tuples read. The scan is chosen over a SeqScan by the
+     * cost model when the range selects few tuples (see AccessPath).
+     * @note The table may not be modified while it is scanned.
+     */
+    class IndexScan : public Operator {
+        const HeapFile &table;
+        const SecondaryIndex &index;
+        const field_t low;
+        const field_t high;
+        ScanFilter filter;
+        /// The pages and slots of the tuples of the range, in order
+        std::vector<std::pair<size_t, size_t>> positions;
+        size_t pos;
+        std::vector<uint8_t> buffer;
+        const uint8_t *current;
+
+    public:
+        /**
+         * @brief Initialize a scan of a range of an index
+         * @param table the indexed table
+         * @param index an index of the table
+         * @param low the smallest value of the indexed field (inclusive)
+         * @param high the largest value of the indexed field (inclusive)
+         * @throws std::logic_error if the index is not an index of the table
+         */
+        IndexScan(const HeapFile &table, const SecondaryIndex &index, const field_t &low, const field_t &high);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Evaluate a predicate in the scan
+         * @return always true
+         * @throws std::logic_error if the predicate does not match the tuples of the table
+         */
+        bool pushDown(const Predicate &predicate) override;
+
+        ScanFilter &getFilter();
+    };
+
+} // namespace db
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <db/FieldKey.hpp>
+#include <utility>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief The build side of a hash join: rows hashed on a key field.
+     * @details The rows are radix partitioned on the low bits of the hash of their key so that each partition, with
+     * its open addressing table, fits in the cache of a core. Probe rows are processed in chunks that are
+     * partitioned the same way, so that all the probes of a partition hit a table that is already cached (see
+     * JoinHashTable::probe). Rows are stored serialized and contiguously.
+     */
+    class JoinHashTable {
+        const TupleDesc &td;
+        const FieldKey key;
+        std::vector<uint8_t> rows;
+        std::vector<uint64_t> hashes;
+        size_t count;
+        size_t radix_bits;
+        /// The first slot of the table of each partition, followed by the end of the last table
+        std::vector<size_t> tables;
+        /// The row index + 1 of each slot, 0 for an empty slot
+        std::vector<uint32_t> slots;
+        /// Scratch space of JoinHashTable::probe
+        mutable std::vector<uint64_t> probe_hashes;
+        mutable std::vector<uint32_t> probe_order;
+        mutable std::vector<uint32_t> probe_offsets;
+
+    public:
+        /**
+         * @brief Initialize an empty table
+         * @param td the tuple descriptor of the rows
+         * @param field the index of the key field
+         * @throws std::logic_error if the field is not an INT or CHAR field
+         */
+        JoinHashTable(const TupleDesc &td, size_t field);
+
+        /**
+         * @brief Remove every row
+         */
+        void clear();
+
+        /**
+         * @brief Add a serialized row
+         * @note The row is not found by JoinHashTable::probe until the table is built again.
+         */
+        void insert(const uint8_t *row);
+
+        /**
+         * @brief Get the number of rows
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get the memory used by the rows and the table, in bytes
+         */
+        size_t bytes() const;
+
+        /**
+         * @brief Partition the rows and build the table of each partition
+         * @details The rows are reordered, so the indices returned by JoinHashTable::probe refer to the built table.
+         */
+        void build();
+
+        /**
+         * @brief Find the rows with the key of each probe row
+         * @param rows the serialized probe rows
+         * @param count the number of probe rows
+         * @param probe_td the tuple descriptor of the probe rows
+         * @param probe_key the key field of the probe rows, of the same type as the key of the table
+         * @param matches the (probe row, table row) pairs that have equal keys are appended, grouped by partition
+         */
+        void probe(const uint8_t *rows, size_t count, const TupleDesc &probe_td, const FieldKey &probe_key,
+                   std::vector<std::pair<uint32_t, uint32_t>> &matches) const;
+
+        /**
+         * @brief Get a serialized row of the built table
+         */
+        const uint8_t *row(size_t index) const;
+    };
+
+} // namespace db
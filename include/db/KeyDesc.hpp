@@ -0,0 +1,108 @@
+#pragma once
+
+#include <db/Tuple.hpp>
+#include <string>
+#include <string_view>
+
+namespace db {
+
+    /**
+     * @brief Describes a key made of one or more fields of a tuple.
+     * @details Keys are encoded in a normalized form: a byte string whose lexicographic order (as compared by
+     * `std::string_view::compare`) is the order of the key fields. INT and DOUBLE fields are stored big-endian with
+     * their sign (and for negative doubles, all bits) flipped; CHAR fields are stored up to their first null byte
+     * and terminated by a null byte, so that a string sorts before its extensions. The fields of a composite key
+     * are concatenated in the order of the key. The encoding is reversible.
+     * Normalized keys can be truncated: any prefix of a key that sorts after a smaller key separates the two keys,
+     * which allows index pages to store short separators (see KeyDesc::separator).
+     */
+    class KeyDesc {
+        const TupleDesc &td;
+        std::vector<size_t> indices;
+        /// The fields of the tuple that are not part of the key
+        std::vector<size_t> rest_fields;
+        size_t max_length = 0;
+        size_t rest_length = 0;
+
+    public:
+        /// The maximum length of a normalized key
+        static constexpr size_t MAX_KEY_LENGTH = DEFAULT_PAGE_SIZE / 16;
+
+        /**
+         * @brief Construct a key descriptor
+         * @param td the descriptor of the tuples (must outlive the key descriptor)
+         * @param indices the indices of the key fields, from the most to the least significant
+         * @throws std::logic_error if there are no indices, an index is out of range or repeated, or the key can be
+         * longer than MAX_KEY_LENGTH
+         */
+        KeyDesc(const TupleDesc &td, const std::vector<size_t> &indices);
+
+        /**
+         * @brief Get the indices of the key fields in the tuple
+         */
+        const std::vector<size_t> &fields() const;
+
+        /**
+         * @brief Get the maximum length of a normalized key
+         */
+        size_t maxLength() const;
+
+        /**
+         * @brief Get the number of bytes of a serialized tuple that are not part of the key
+         */
+        size_t restLength() const;
+
+        /**
+         * @brief Encode the key of a tuple
+         * @param t a tuple compatible with the tuple descriptor
+         * @return the normalized key
+         */
+        std::string encode(const Tuple &t) const;
+
+        /**
+         * @brief Encode a key given as the values of the key fields
+         * @details The values may be the first fields of the key only: the encoding of a prefix of the fields is a
+         * prefix of the encoding of every key that starts with these values, and sorts before all of them.
+         * @param key the values of the key fields, in the order of the key
+         * @return the normalized key
+         * @throws std::logic_error if the number or the types of the values do not match the key
+         */
+        std::string encode(const std::vector<field_t> &key) const;
+
+        /**
+         * @brief Decode a normalized key
+         * @param key a normalized key produced by KeyDesc::encode
+         * @return the values of the key fields, in the order of the key
+         */
+        std::vector<field_t> decode(std::string_view key) const;
+
+        /**
+         * @brief Copy the fields of a tuple that are not part of the key
+         * @param t a tuple compatible with the tuple descriptor
+         * @param rest a buffer of `restLength()` bytes
+         */
+        void extractRest(const Tuple &t, uint8_t *rest) const;
+
+        /**
+         * @brief Rebuild a tuple from its key and the rest of its fields
+         * @param key the normalized key of the tuple
+         * @param rest the bytes written by KeyDesc::extractRest
+         * @return the tuple
+         */
+        Tuple join(std::string_view key, const uint8_t *rest) const;
+
+        /**
+         * @brief Find the shortest separator of two keys
+         * @param left a normalized key
+         * @param right a normalized key greater than `left`
+         * @return the shortest prefix `s` of `right` such that `left < s <= right`
+         */
+        static std::string separator(std::string_view left, std::string_view right);
+
+        /**
+         * @brief Get the length of the common prefix of two keys
+         */
+        static size_t commonPrefix(std::string_view a, std::string_view b);
+    };
+
+} // namespace db
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <db/KeyDesc.hpp>
+#include <string_view>
+
+namespace db {
+
+    struct KeyIndexPageHeader {
+        /// The child on the left of all keys
+        size_t first_child;
+
+        /// Number of keys in the page
+        uint16_t size;
+
+        /// Offset of the first record, records grow from the end of the page (0 for an empty page)
+        uint16_t heap;
+
+        /// Number of bytes used by the records
+        uint16_t used;
+
+        /// Whether the next level is internal or leaf
+        bool index_children;
+    };
+
+    /**
+     * @brief An index page with variable-length normalized keys (see KeyDesc).
+     * @details The page has a header of type KeyIndexPageHeader followed by an array of `size` slots. A slot is the
+     * offset of a record, and records are stored at the end of the page. A record holds the child on the right of
+     * a key, the length of the key and the key. The slots are sorted by key. Removed records leave holes that are
+     * reclaimed when a new record does not fit in the free space between the slots and the records.
+     * The keys are separators produced by KeyDesc::separator, so they are usually much shorter than the keys of
+     * the tuples, which gives a larger fan-out than a page of fixed-length keys.
+     */
+    struct KeyIndexPage {
+        const KeyDesc &kd;
+
+        KeyIndexPageHeader *header;
+        uint16_t *slots;
+        uint8_t *data;
+
+        /**
+         * @brief Initialize an index page
+         * @param page the page contents
+         * @param kd the descriptor of the keys
+         */
+        KeyIndexPage(Page &page, const KeyDesc &kd);
+
+        /**
+         * @brief Reset the page to contain no keys and a single child
+         * @param first_child the only child of the page
+         * @param index_children whether the child is an index page
+         */
+        void init(size_t first_child, bool index_children);
+
+        /**
+         * @brief Get the key at a position
+         * @return a view of the key, valid until the page is modified
+         */
+        std::string_view key(size_t pos) const;
+
+        /**
+         * @brief Get the child at a position (the child at position `pos + 1` is on the right of key `pos`)
+         */
+        size_t child(size_t pos) const;
+
+        /**
+         * @brief Replace the child at a position
+         */
+        void setChild(size_t pos, size_t child);
+
+        /**
+         * @brief Insert a new key with a corresponding child page number
+         * @param key the key to insert
+         * @param child the child page number
+         * @return true if the page is full and needs to be split
+         * @throws std::logic_error if the key does not fit in the page
+         */
+        bool insert(std::string_view key, size_t child);
+
+        /**
+         * @brief Remove a key and the child on its right
+         * @param pos the position of the key (the child at position `pos + 1` is removed)
+         */
+        void erase(size_t pos);
+
+        /**
+         * @brief Replace a key, keeping its children
+         * @return false if the new key does not fit in the page (the page is not modified)
+         */
+        bool setKey(size_t pos, std::string_view key);
+
+        /**
+         * @brief Check if a key can replace the key at a position (see KeyIndexPage::setKey)
+         */
+        bool canSetKey(size_t pos, std::string_view key) const;
+
+        /**
+         * @brief Check if the right sibling and the separator fit in the page
+         */
+        bool canMerge(std::string_view key, const KeyIndexPage &right) const;
+
+        /**
+         * @brief Merge the right sibling into the page
+         * @param key the separator key between this page and the right sibling
+         * @param right the right sibling
+         */
+        void merge(std::string_view key, KeyIndexPage &right);
+
+        /**
+         * @brief Split the index page
+         * @details The old page keeps the first half of the keys, and the new page receives the second half.
+         * @param new_page a new page
+         * @return the split key (this key is moved to the parent page)
+         */
+        std::string split(KeyIndexPage &new_page);
+
+        /**
+         * @brief Move the last key of the left sibling through the parent
+         * @details The separator in the parent moves down to the front of the page, and the last key of the left
+         * sibling replaces it.
+         * @param left the left sibling
+         * @param parent the parent page
+         * @param pos the position of this page in the parent
+         * @return false if a key does not fit (no page is modified)
+         */
+        bool rotateFromLeft(KeyIndexPage &left, KeyIndexPage &parent, size_t pos);
+
+        /**
+         * @brief Move the first key of the right sibling through the parent (see KeyIndexPage::rotateFromLeft)
+         */
+        bool rotateFromRight(KeyIndexPage &right, KeyIndexPage &parent, size_t pos);
+
+        /**
+         * @brief Find the child responsible for a key
+         * @param key the key to search for
+         * @return the position of the child whose range contains the key
+         */
+        size_t child_of(std::string_view key) const;
+
+        /**
+         * @brief Check if inserting a key may fill the page
+         */
+        bool mayOverflow() const;
+
+        /**
+         * @brief Check if the page is less than a third full
+         */
+        bool underflows() const;
+
+        /**
+         * @brief Check if a key can be removed without making the page underflow
+         */
+        bool canLend() const;
+
+    private:
+        size_t heap() const;
+
+        size_t freeSpace() const;
+
+        size_t maxEntry() const;
+
+        size_t recordLength(size_t pos) const;
+
+        void insertAt(size_t pos, std::string_view key, size_t child);
+
+        void compact();
+    };
+
+} // namespace db
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <db/KeyIndexPage.hpp>
+#include <string>
+#include <string_view>
+
+namespace db {
+
+    struct KeyLeafPageHeader {
+        /// The next page number
+        size_t next_leaf;
+
+        /// The number of tuples in the page
+        uint16_t size;
+
+        /// Offset of the first record, records grow from the end of the page (0 for an empty page)
+        uint16_t heap;
+
+        /// Number of bytes used by the records and the fence keys
+        uint16_t used;
+
+        /// Offset of the lowest key of the leaf range (0 if the range is not bounded)
+        uint16_t low;
+
+        /// Offset of the key that bounds the leaf range from above (0 if the range is not bounded)
+        uint16_t high;
+
+        /// Length of the prefix that is shared by all keys in the range of the leaf
+        uint16_t prefix;
+    };
+
+    /**
+     * @brief A leaf page with prefix-compressed normalized keys (see KeyDesc).
+     * @details The page has a header of type KeyLeafPageHeader followed by an array of `size` slots. A slot is the
+     * offset of a record, and records are stored at the end of the page. The slots are sorted by key.
+     * The page stores its fence keys: the separators in the parent that bound the range of keys of the leaf. Every
+     * key in the range shares the common prefix of the two fences, so a record only stores the rest of its key,
+     * followed by the fields of the tuple that are not part of the key (see KeyDesc::extractRest). The fences
+     * only change when the leaf is split, merged or rebalanced; the page is then rebuilt with the new prefix.
+     */
+    struct KeyLeafPage {
+        /// A tuple in its stored form: the normalized key and the fields that are not part of the key
+        struct Entry {
+            std::string key;
+            std::string rest;
+        };
+
+        const KeyDesc &kd;
+
+        KeyLeafPageHeader *header;
+        uint16_t *slots;
+        uint8_t *data;
+
+        /**
+         * @brief Initialize a leaf page
+         * @param page the page contents
+         * @param kd the descriptor of the keys
+         */
+        KeyLeafPage(Page &page, const KeyDesc &kd);
+
+        /**
+         * @brief Check if leaf pages can hold tuples of a key descriptor
+         * @return true if a leaf page can hold at least four tuples
+         */
+        static bool supports(const KeyDesc &kd);
+
+        /**
+         * @brief Insert a tuple into the page
+         * @details The tuple is inserted in sorted order based on the key. If the key already exists, the previous
+         * tuple is replaced.
+         * @return true if the leaf is full and needs to be split.
+         * @throws std::logic_error if the tuple does not fit or its key is outside of the range of the leaf
+         */
+        bool insertTuple(const Tuple &t);
+
+        /**
+         * @brief Delete a tuple from the page
+         * @param slot the slot of the tuple to delete
+         */
+        void deleteTuple(size_t slot);
+
+        /**
+         * @brief Get the tuple at a slot
+         */
+        Tuple getTuple(size_t slot) const;
+
+        /**
+         * @brief Get the normalized key of the tuple at a slot
+         */
+        std::string key(size_t slot) const;
+
+        /**
+         * @brief Find the first slot whose key is not less than the provided key
+         * @return the slot of the first tuple with a key greater or equal to `key` (`size` if there is none)
+         */
+        size_t lower_bound(std::string_view key) const;
+
+        /**
+         * @brief Split the leaf page
+         * @details The old page keeps the first half of the tuples, and the new page receives the second half. The
+         * split key is the shortest separator of the last key of the old page and the first key of the new page.
+         * @param new_page a new page
+         * @return the split key
+         */
+        std::string split(KeyLeafPage &new_page);
+
+        /**
+         * @brief Check if the tuples of the right sibling fit in the page
+         */
+        bool canMerge(const KeyLeafPage &right) const;
+
+        /**
+         * @brief Merge the right sibling into the page
+         * @details All tuples of the right sibling are appended to the page, and the page inherits its next leaf and
+         * its upper fence.
+         * @param right the right sibling
+         */
+        void merge(KeyLeafPage &right);
+
+        /**
+         * @brief Move the last tuple of the left sibling to the page
+         * @param left the left sibling
+         * @param parent the parent page, whose separator is replaced
+         * @param pos the position of this page in the parent
+         * @return false if a page cannot hold its new contents (no page is modified)
+         */
+        bool borrowFromLeft(KeyLeafPage &left, KeyIndexPage &parent, size_t pos);
+
+        /**
+         * @brief Move the first tuple of the right sibling to the page (see KeyLeafPage::borrowFromLeft)
+         */
+        bool borrowFromRight(KeyLeafPage &right, KeyIndexPage &parent, size_t pos);
+
+        /**
+         * @brief Check if inserting a tuple may fill the page
+         */
+        bool mayOverflow() const;
+
+        /**
+         * @brief Check if the records, their slots and the fences take at least a fraction of the page
+         * @details The keys are counted whole, so that the fill of a page does not depend on its fences: the prefix
+         * compression only adds to the free space.
+         */
+        bool filledTo(double fill_factor) const;
+
+        /**
+         * @brief Check if the page is less than a third full
+         */
+        bool underflows() const;
+
+        /**
+         * @brief Check if a tuple can be removed without making the page underflow
+         */
+        bool canLend() const;
+
+        /**
+         * @brief Get the lower fence key (empty if the range is not bounded)
+         */
+        std::string_view lowFence() const;
+
+        /**
+         * @brief Get the upper fence key (empty if the range is not bounded)
+         */
+        std::string_view highFence() const;
+
+        /**
+         * @brief Replace the fence keys, the page is rebuilt with their common prefix
+         * @details The keys of the page must be in the new range, e.g. when the leaves are built in order and the
+         * upper fence is only known once the next leaf starts (see BTreeFile::bulkLoad).
+         * @throws std::logic_error if the page cannot hold its contents with the new fences
+         */
+        void setFences(std::string_view low, std::string_view high);
+
+    private:
+        size_t heap() const;
+
+        size_t freeSpace() const;
+
+        size_t maxRecord() const;
+
+        std::string_view prefix() const;
+
+        std::string_view suffix(size_t slot) const;
+
+        const uint8_t *rest(size_t slot) const;
+
+        int compare(size_t slot, std::string_view key) const;
+
+        std::vector<Entry> entries() const;
+
+        size_t required(const std::vector<Entry> &entries, std::string_view low, std::string_view high) const;
+
+        void build(const std::vector<Entry> &entries, std::string_view low, std::string_view high);
+
+        uint16_t writeFence(std::string_view key);
+
+        void insertAt(size_t slot, std::string_view suffix, const uint8_t *rest);
+    };
+
+} // namespace db
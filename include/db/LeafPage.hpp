@@ -1,5 +1,6 @@
 #pragma once
 
+#include <db/IndexPage.hpp>
 #include <db/Tuple.hpp>
 
 namespace db {
@@ -42,6 +43,59 @@ namespace db {
          */
         bool insertTuple(const Tuple &t);
 
+        /**
+         * @brief Delete a tuple from the page
+         * @details The tuples after the slot are shifted to keep the tuples sorted and contiguous.
+         * @param slot the slot of the tuple to delete
+         */
+        void deleteTuple(size_t slot);
+
+        /**
+         * @brief Merge the right sibling into the page
+         * @details All tuples of the right sibling are appended to the page, and the page inherits its next leaf.
+         * @param right the right sibling (the keys are greater than the keys of this page)
+         */
+        void merge(LeafPage &right);
+
+        /**
+         * @brief Check if the tuples of the right sibling fit in the page
+         */
+        bool canMerge(const LeafPage &right) const;
+
+        /**
+         * @brief Move the last tuple of the left sibling to the page
+         * @param left the left sibling
+         * @param parent the parent page, whose separator is replaced by the first key of the page
+         * @param pos the position of this page in the parent
+         * @return true (the tuples have a fixed length and always fit)
+         */
+        bool borrowFromLeft(LeafPage &left, IndexPage &parent, size_t pos);
+
+        /**
+         * @brief Move the first tuple of the right sibling to the page (see LeafPage::borrowFromLeft)
+         */
+        bool borrowFromRight(LeafPage &right, IndexPage &parent, size_t pos);
+
+        /**
+         * @brief Check if inserting a tuple may fill the page
+         */
+        bool mayOverflow() const;
+
+        /**
+         * @brief Check if the tuples take at least a fraction of the capacity of the page
+         */
+        bool filledTo(double fill_factor) const;
+
+        /**
+         * @brief Check if the page has less tuples than half of its capacity
+         */
+        bool underflows() const;
+
+        /**
+         * @brief Check if a tuple can be removed without making the page underflow
+         */
+        bool canLend() const;
+
         /**
          * @brief Split the leaf page
          * @details The page is split into two pages. The old page contains the first half of the tuples, and the new page contains the second half.
@@ -57,6 +111,20 @@ namespace db {
          * @return The tuple read from the page.
          */
         Tuple getTuple(size_t slot) const;
+
+        /**
+         * @brief Get the key of the tuple at the specified slot
+         * @param slot the slot of the tuple
+         * @return the key of the tuple
+         */
+        int key(size_t slot) const;
+
+        /**
+         * @brief Find the first slot whose key is not less than the provided key
+         * @param key the key to search for
+         * @return the slot of the first tuple with a key greater or equal to `key` (`size` if there is none)
+         */
+        size_t lower_bound(int key) const;
     };
 
 } // namespace db
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <db/Operator.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that skips the first rows of its input and stops after a number of rows.
+     * @details The input is not pulled after the last row, nor at all with a limit of 0. Predicates cannot be pushed
+     * through a limit.
+     */
+    class Limit : public Operator {
+        std::unique_ptr<Operator> child;
+        const size_t limit;
+        const size_t offset;
+        size_t skipped;
+        size_t produced;
+
+    public:
+        /**
+         * @brief Initialize a limit
+         * @param child the input of the limit
+         * @param limit the maximum number of rows
+         * @param offset the number of rows of the input to skip
+         */
+        Limit(std::unique_ptr<Operator> child, size_t limit, size_t offset = 0);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+    };
+
+} // namespace db
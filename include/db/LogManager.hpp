@@ -0,0 +1,187 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <db/types.hpp>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief An entry of the dirty page table of a checkpoint.
+     */
+    struct DirtyPage {
+        PageId pid;
+        /// The LSN of the first record of the page since it was last written to its file
+        uint64_t rec_lsn;
+    };
+
+    /**
+     * @brief A write-ahead log of the changes made to the pages of the BufferPool.
+     * @details When a page is marked dirty, the BufferPool appends a record of the byte ranges that changed since
+     * the page was last logged, with their old and new contents, and stamps the page with the LSN of the record (the
+     * offset of the record in the log). Records are buffered in memory and written sequentially; a page is only
+     * written back to its file once the log is durable up to its LSN, so the BufferPool may evict dirty pages at any
+     * time (steal) and never has to write pages on commit (no-force).
+     *
+     * A commit appends a commit record and waits until the log is durable up to it. Concurrent commits are grouped:
+     * one committer writes the records buffered by everyone and calls fdatasync once, while the others wait for it
+     * and return when their records are covered. With a group delay, this committer waits a little before writing so
+     * that more commits join the group.
+     *
+     * A commit is a point of the whole log, not of a thread: it also makes durable the changes logged before it by
+     * other threads. A change of several pages that must be recovered as a whole, such as a split of a B+tree page,
+     * is an operation (see LogManager::startOperation): no commit record falls between its records. When a log is
+     * opened, the changes of its records are recovered: the changes that may be missing from the files are redone,
+     * then the changes logged after the last commit are undone, and the pages are written back and synced before the
+     * log is emptied. The files are left exactly as they were at the last commit.
+     *
+     * Checkpoints bound the part of the log that recovery reads. A checkpoint records the dirty page table of the
+     * BufferPool without stopping the writers (see Database::checkpoint), and the header of the log points to the last
+     * one. Recovery starts at the oldest recLSN of the table (ARIES): it extends the table with the pages dirtied
+     * since, and only redoes the records of a page from its recLSN. The records are partitioned by page id, and each
+     * partition is redone and undone by its own thread.
+     *
+     * The record at the recLSN of a page, its first change since it was last written, holds a full image of the page
+     * before the change. A page is written before its header (see PageFormat.hpp): a page whose write was interrupted
+     * does not match its header, and is redone from the image instead of being read from its file.
+     * @note A log must be opened before the files that it recovers are added to the Database.
+     */
+    class LogManager {
+        const std::string name;
+        const std::chrono::microseconds group_delay;
+        const size_t redo_threads;
+        int fd;
+        mutable std::mutex mutex;
+        std::mutex checkpoint_mutex;
+        /// Held in shared mode by the changes that span several pages, exclusively while a commit record is appended
+        std::shared_mutex operation_mutex;
+        std::condition_variable flushed_cv;
+        /// The records that are not written yet, from `buffer_lsn` to `next_lsn`
+        std::vector<uint8_t> buffer;
+        uint64_t buffer_lsn;
+        uint64_t next_lsn;
+        /// Every record before `flushed_lsn` is durable
+        uint64_t flushed_lsn;
+        /// The end of the last commit record
+        uint64_t commit_end;
+        bool flushing;
+        /// A write or a sync of the log failed, the records after `flushed_lsn` may never be durable
+        bool failed;
+        size_t num_syncs;
+        size_t num_commits;
+        size_t num_checkpoints;
+        size_t num_redone;
+
+        uint64_t append(const std::vector<uint8_t> &record);
+
+        void flushUntil(uint64_t lsn, std::chrono::microseconds delay);
+
+        void recover();
+
+    public:
+        /**
+         * @brief Open a log and recover the changes of its records
+         * @param name the name of the log file, created if it does not exist
+         * @param group_delay the time that a commit waits for other commits before it syncs the log
+         * @param redo_threads the number of threads that recover the pages
+         * @throws std::runtime_error if the log cannot be opened or is not a log file
+         */
+        explicit LogManager(const std::string &name, std::chrono::microseconds group_delay = {},
+                            size_t redo_threads = std::thread::hardware_concurrency());
+
+        /**
+         * @brief Write the records that are still buffered and close the log
+         */
+        ~LogManager();
+
+        LogManager(const LogManager &) = delete;
+
+        LogManager &operator=(const LogManager &) = delete;
+
+        const std::string &getName() const;
+
+        /**
+         * @brief Append the record of the changes of a page
+         * @param pid the page id of the page
+         * @param before the contents of the page when it was last logged
+         * @param after the contents of the page
+         * @param image whether the record also holds all of `before`: for the first change of a page since it was
+         * read or written, so that recovery does not depend on a write of the page that may have been torn
+         * @return the LSN of the record, or 0 if the page did not change
+         */
+        uint64_t logPage(const PageId &pid, const Page &before, const Page &after, bool image = false);
+
+        /**
+         * @brief Start a change of several pages that is either recovered entirely or undone entirely
+         * @details Commits wait for the operations in progress, and the operations started later wait for the commit
+         * record to be appended, so the records of an operation are all before or all after every commit record.
+         * @return the lock of the operation, to be released once all its pages are marked dirty
+         * @note The lock must be taken before any latch of the pages, and not by a thread that already holds it.
+         */
+        std::shared_lock<std::shared_mutex> startOperation();
+
+        /**
+         * @brief Make every record appended so far durable
+         * @details The records of other threads that are buffered are written with them, and the log is synced once
+         * for all the commits that wait at the same time.
+         * @return the LSN of the commit record
+         * @throws std::runtime_error if the log cannot be written, or could not be written before: a log that failed
+         * stays failed until it is reopened and recovered
+         */
+        uint64_t commit();
+
+        /**
+         * @brief Append a checkpoint record and make the header of the log point to it
+         * @param dirty_pages the dirty page table of the BufferPool
+         * @param begin_lsn the LSN of the next record when the table was read: every page dirtied later has records
+         * from it
+         * @return the LSN of the checkpoint record
+         * @throws std::runtime_error if the checkpoint cannot be written
+         * @note The pages written before the table was read must be durable in their files.
+         */
+        uint64_t checkpoint(const std::vector<DirtyPage> &dirty_pages, uint64_t begin_lsn);
+
+        /**
+         * @brief Wait until the record with an LSN is durable
+         * @param lsn the LSN of a record
+         * @throws std::runtime_error if the log cannot be written, or could not be written before
+         */
+        void flush(uint64_t lsn);
+
+        /**
+         * @brief Get the end of the durable part of the log, every record before it is durable
+         */
+        uint64_t getFlushedLsn() const;
+
+        /**
+         * @brief Get the LSN of the next record
+         */
+        uint64_t getNextLsn() const;
+
+        /**
+         * @brief Get the number of times that the log was synced
+         */
+        size_t getNumSyncs() const;
+
+        /**
+         * @brief Get the number of commits
+         */
+        size_t getNumCommits() const;
+
+        /**
+         * @brief Get the number of checkpoints
+         */
+        size_t getNumCheckpoints() const;
+
+        /**
+         * @brief Get the number of records that were redone when the log was opened
+         */
+        size_t getNumRedone() const;
+    };
+
+} // namespace db
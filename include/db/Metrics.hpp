@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace db {
+
+    /// The number of shards of a Counter or a Histogram. Every thread updates a single shard, so threads rarely share
+    /// a cache line, and a snapshot sums the shards.
+    constexpr size_t METRIC_SHARDS = 16;
+
+    /**
+     * @brief Get the shard of the calling thread, threads are assigned to shards in turn
+     */
+    size_t metricShard();
+
+    /**
+     * @brief A monotonic counter sharded by thread.
+     * @details Counter::add is a relaxed atomic increment of a cache line that other threads rarely touch, cheap
+     * enough for the hot paths of the BufferPool. Counter::value sums the shards: it is exact when no thread is
+     * adding, and a lower bound otherwise.
+     */
+    class Counter {
+        struct alignas(64) Shard {
+            std::atomic<uint64_t> value{0};
+        };
+
+        std::array<Shard, METRIC_SHARDS> shards;
+
+    public:
+        void add(uint64_t n = 1) { shards[metricShard()].value.fetch_add(n, std::memory_order_relaxed); }
+
+        uint64_t value() const;
+
+        void reset();
+    };
+
+    /**
+     * @brief The distribution of the values of a Histogram at some point.
+     */
+    struct HistogramSnapshot {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        /// The highest value of each non-empty bucket and the number of values in it, by increasing value
+        std::vector<std::pair<uint64_t, uint64_t>> buckets;
+
+        double mean() const;
+
+        /**
+         * @brief Get a percentile of the values
+         * @param p the percentile, between 0 and 100
+         * @return the highest value of the bucket of the percentile (at most the maximum), 0 if there are no values
+         */
+        uint64_t percentile(double p) const;
+    };
+
+    /**
+     * @brief A histogram of non-negative integers with a bounded relative error (HDR histogram).
+     * @details The buckets are log-linear: each power of two is divided into 2^SUB_BITS buckets of the same width, so a
+     * value is counted in a bucket whose width is at most 1/32 of the value (the values below 32 are exact). The whole
+     * range of uint64_t is covered with a fixed number of buckets, and recording a value is a few bit operations and
+     * relaxed atomic increments in the shard of the thread.
+     */
+    class Histogram {
+    public:
+        static constexpr size_t SUB_BITS = 5;
+        static constexpr size_t NUM_BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+        /**
+         * @brief Get the bucket of a value
+         */
+        static size_t bucket(uint64_t value);
+
+        /**
+         * @brief Get the highest value of a bucket
+         */
+        static uint64_t highestValue(size_t bucket);
+
+        Histogram();
+
+        void record(uint64_t value);
+
+        HistogramSnapshot snapshot() const;
+
+        void reset();
+
+    private:
+        struct alignas(64) Shard {
+            std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+            std::atomic<uint64_t> sum{0};
+            std::atomic<uint64_t> max{0};
+        };
+
+        std::unique_ptr<Shard[]> shards;
+    };
+
+    /**
+     * @brief The values of all the metrics at some point, to be exported.
+     */
+    struct MetricsSnapshot {
+        std::map<std::string, uint64_t> counters;
+        std::map<std::string, HistogramSnapshot> histograms;
+
+        /**
+         * @brief Write the metrics as a JSON object, for a file
+         * @details The counters are numbers, and the histograms are objects with their count, sum, mean, max and
+         * p50/p90/p99/p999 percentiles.
+         */
+        void writeJson(std::ostream &out) const;
+
+        /**
+         * @brief Write the metrics in the text format of Prometheus, for a metrics endpoint
+         * @details The counters are counters, the histograms are summaries with their quantiles.
+         */
+        void writePrometheus(std::ostream &out) const;
+    };
+
+    /**
+     * @brief The metrics of the BufferPool and of the I/O of the files.
+     * @details The latencies are in nanoseconds, measured around every system call that reads or writes pages
+     * (a call may read or write several pages, see DbFile::readPages).
+     */
+    class Metrics {
+    public:
+        /// Pages found in the BufferPool
+        Counter pool_hits;
+        /// Pages read from their files into the BufferPool
+        Counter pool_misses;
+        /// Pages removed from the BufferPool to make room for others
+        Counter pool_evictions;
+        /// Dirty pages written back to their files by the BufferPool
+        Counter pool_writebacks;
+        Counter pages_read;
+        Counter pages_written;
+        Counter bytes_read;
+        Counter bytes_written;
+        Histogram read_latency;
+        Histogram write_latency;
+
+        /**
+         * @brief Read all the metrics
+         * @details The metrics keep changing while they are read, the snapshot is not atomic.
+         */
+        MetricsSnapshot snapshot() const;
+
+        /**
+         * @brief Set all the metrics to zero
+         */
+        void reset();
+    };
+
+    /**
+     * @brief Measures the time from its construction to its destruction in a Histogram
+     */
+    class LatencyTimer {
+        Histogram &histogram;
+        const std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit LatencyTimer(Histogram &histogram);
+
+        ~LatencyTimer();
+
+        LatencyTimer(const LatencyTimer &) = delete;
+
+        LatencyTimer &operator=(const LatencyTimer &) = delete;
+    };
+
+} // namespace db
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief The morsels of a parallel scan: ranges of consecutive pages of a file, shared by the workers of the scan.
+     * @details The pages are divided into one contiguous range per worker. A worker takes the morsels of its own range
+     * from the front, so it reads the file sequentially, and when its range is exhausted it steals morsels from the
+     * back of the range with the most pages left. Workers that finish early keep busy until every page is read, so a
+     * slow worker (or a skewed filter) does not delay the scan.
+     * A range is only locked by its owner and by the thieves, the workers do not contend on a single lock.
+     */
+    class MorselQueue {
+        struct Range {
+            std::mutex mutex;
+            size_t next = 0;
+            size_t end = 0;
+        };
+
+        const size_t morsel_pages;
+        std::vector<Range> ranges;
+        std::mutex mutex;
+        size_t epoch;
+        std::atomic<size_t> steals;
+
+    public:
+        /**
+         * @brief Initialize an empty queue
+         * @param workers the number of workers
+         * @param morsel_pages the number of pages of a morsel
+         * @throws std::logic_error if there are no workers or a morsel has no pages
+         */
+        MorselQueue(size_t workers, size_t morsel_pages);
+
+        /**
+         * @brief Fill the queue with the pages of a scan, once per scan
+         * @details Every worker calls start when it opens its scan: only the first call with a new epoch fills the
+         * queue, so the workers do not have to be synchronized to restart a scan.
+         * @param epoch the number of the scan, increasing
+         * @param num_pages the number of pages to scan
+         */
+        void start(size_t epoch, size_t num_pages);
+
+        /**
+         * @brief Take the next morsel of a worker
+         * @param worker the index of the worker
+         * @return the first page and the end of the morsel, nothing if every page was taken
+         */
+        std::optional<std::pair<size_t, size_t>> take(size_t worker);
+
+        size_t numWorkers() const;
+
+        /**
+         * @brief Get the number of morsels taken from the range of another worker since the queue was created
+         */
+        size_t numSteals() const;
+    };
+
+} // namespace db
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <db/HeapFile.hpp>
+#include <db/MorselQueue.hpp>
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief The scan of a worker of a morsel-driven parallel scan of a HeapFile.
+     * @details Each worker of the scan runs its own pipeline of operators (e.g. a Filter, or a HashAggregate with
+     * thread-local tables) on top of a MorselScan, in its own thread. The scans of the workers share a MorselQueue:
+     * a scan produces the tuples of the morsels that its worker takes from the queue, page by page as a SeqScan,
+     * until every page of the file was read by one of the workers. The results of the pipelines are then merged by
+     * the operator that runs them (see Gather and HashAggregate).
+     * @note The file may not be modified while it is scanned.
+     */
+    class MorselScan : public Operator {
+        const HeapFile &file;
+        std::shared_ptr<MorselQueue> queue;
+        const size_t worker;
+        ScanFilter filter;
+        size_t epoch;
+        /// The next page of the current morsel, and the end of the morsel
+        size_t page;
+        size_t last;
+        std::vector<uint8_t> rows;
+        size_t count;
+        size_t pos;
+        const uint8_t *current;
+
+    public:
+        /**
+         * @brief Initialize the scan of a worker
+         * @param file the file to scan
+         * @param queue the morsels of the scan, shared by the workers
+         * @param worker the index of the worker, less than the number of workers of the queue
+         * @throws std::logic_error if the worker does not exist
+         */
+        MorselScan(const HeapFile &file, std::shared_ptr<MorselQueue> queue, size_t worker);
+
+        /**
+         * @brief Create the scans of the workers of a parallel scan
+         * @param file the file to scan
+         * @param workers the number of workers, by default one per hardware thread
+         * @param morsel_pages the number of pages of a morsel
+         * @return the scans, one per worker, that share a MorselQueue
+         */
+        static std::vector<std::unique_ptr<Operator>> create(const HeapFile &file, size_t workers = defaultWorkers(),
+                                                             size_t morsel_pages = 64);
+
+        /**
+         * @brief Get the number of hardware threads (at least 1)
+         */
+        static size_t defaultWorkers();
+
+        const TupleDesc &getTupleDesc() const override;
+
+        /**
+         * @brief Start the scan
+         * @details Opening any scan of the workers again restarts the whole parallel scan, so every worker has to
+         * be opened again, as a group.
+         */
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Evaluate a predicate in the scan of this worker
+         * @return always true
+         * @throws std::logic_error if the predicate does not match the tuples of the file
+         */
+        bool pushDown(const Predicate &predicate) override;
+
+        ScanFilter &getFilter();
+
+        const MorselQueue &getQueue() const;
+    };
+
+} // namespace db
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <db/Tuple.hpp>
+#include <string_view>
+
+namespace db {
+
+    enum class PredicateOp {
+        EQ, NE, LT, LE, GT, GE
+    };
+
+    /**
+     * @brief A comparison of a field with a constant: `field op value`.
+     */
+    struct Predicate {
+        /// The index of the field in the rows of the operator that the predicate is applied to
+        size_t field;
+        PredicateOp op;
+        field_t value;
+
+        /**
+         * @brief Check that the predicate can be applied to the rows of a TupleDesc
+         * @throws std::logic_error if the field does not exist or the value has a different type
+         */
+        void check(const TupleDesc &td) const;
+
+        /**
+         * @brief Evaluate the predicate on a serialized row
+         * @param td the tuple descriptor of the row
+         * @param row the serialized row
+         * @return true if the row satisfies the predicate
+         */
+        bool test(const TupleDesc &td, const uint8_t *row) const;
+    };
+
+    /**
+     * @brief A pull-based query operator.
+     * @details Operators form a tree: the root produces the result of the query and pulls its input rows from its
+     * children with Operator::next. Rows are serialized with the TupleDesc of the operator (see
+     * TupleDesc::serialize) and are not materialized as Tuple objects unless Operator::getTuple is called, so a
+     * pipeline does not allocate memory for every row.
+     * Predicates are pushed down the tree (see Operator::pushDown) so that rows are filtered as early as possible,
+     * ideally in the scan, before they are passed to the other operators.
+     */
+    class Operator {
+    public:
+        virtual ~Operator() = default;
+
+        /**
+         * @brief Get the tuple descriptor of the rows produced by the operator
+         */
+        virtual const TupleDesc &getTupleDesc() const = 0;
+
+        /**
+         * @brief Start producing rows from the beginning
+         * @details An operator can be opened again to restart it.
+         */
+        virtual void open() = 0;
+
+        /**
+         * @brief Advance to the next row
+         * @return false if there are no more rows
+         */
+        virtual bool next() = 0;
+
+        /**
+         * @brief Get the current row
+         * @return the serialized row, valid until the next call to Operator::next or Operator::open
+         */
+        virtual const uint8_t *row() const = 0;
+
+        /**
+         * @brief Evaluate a predicate in this operator or in its input
+         * @details An operator that accepts a predicate only produces the rows that satisfy it.
+         * @param predicate a predicate on the rows of the operator
+         * @return true if the predicate was accepted, false if it has to be evaluated by the caller
+         */
+        virtual bool pushDown(const Predicate &predicate);
+
+        /**
+         * @brief Materialize the current row
+         */
+        Tuple getTuple() const;
+
+        int getInt(size_t field) const;
+
+        double getDouble(size_t field) const;
+
+        std::string_view getString(size_t field) const;
+    };
+
+} // namespace db
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <db/types.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The format of the pages in the files of a DbFile.
+ * @details Every page has a header of PAGE_HEADER_SIZE bytes: the CRC-32C of the page and of its page number, and the
+ * version of the format. The headers are kept apart from the pages so that every page stays aligned on
+ * DEFAULT_PAGE_SIZE bytes in the file: the file is a sequence of groups, each a block with the headers of GROUP_PAGES
+ * pages followed by these pages. The layouts of the pages (HeapPage, LeafPage, ...) are not affected, every page keeps
+ * its DEFAULT_PAGE_SIZE bytes.
+ *
+ * A page is written before its header, by two system calls, and the header is checked every time the page is read. A
+ * page that was only partially written (a torn write), a crash between the write of a page and of its header, a page
+ * corrupted on the device or written at the wrong place are all detected as a page that does not match its header,
+ * instead of being used.
+ *
+ * A header of zeros with a page of zeros is valid: it is a page that was allocated but never written (a hole in the
+ * file).
+ */
+namespace db {
+    constexpr size_t PAGE_HEADER_SIZE = 8;
+
+    /// The number of pages of a group, their headers fill one block
+    constexpr size_t GROUP_PAGES = DEFAULT_PAGE_SIZE / PAGE_HEADER_SIZE;
+
+    /// The space of a group of pages in a file: the block of their headers, then the pages
+    constexpr size_t GROUP_SIZE = (GROUP_PAGES + 1) * DEFAULT_PAGE_SIZE;
+
+    /// The offset of a page in a file, a multiple of DEFAULT_PAGE_SIZE
+    constexpr size_t pageOffset(size_t id) {
+        return id / GROUP_PAGES * GROUP_SIZE + (id % GROUP_PAGES + 1) * DEFAULT_PAGE_SIZE;
+    }
+
+    /// The offset of the header of a page in a file
+    constexpr size_t headerOffset(size_t id) {
+        return id / GROUP_PAGES * GROUP_SIZE + id % GROUP_PAGES * PAGE_HEADER_SIZE;
+    }
+
+    /**
+     * @brief Get the number of pages in a file
+     * @param file_size the size of the file in bytes
+     * @return the number of pages, including a last page that was only partially written
+     */
+    size_t storedPages(size_t file_size);
+
+    /**
+     * @brief Read consecutive pages and verify their headers
+     * @param fd the file
+     * @param name the name of the file, for the errors
+     * @param data the buffer to read into, `count * DEFAULT_PAGE_SIZE` bytes. Pages past the end of the file are
+     * filled with zeros.
+     * @param first the page number of the first page
+     * @param count the number of pages
+     * @throws std::runtime_error if the file cannot be read, or if a page is torn or corrupted
+     */
+    void readStoredPages(int fd, const std::string &name, uint8_t *data, size_t first, size_t count);
+
+    /**
+     * @brief Write consecutive pages with their headers
+     * @param fd the file
+     * @param data the contents of the pages, `count * DEFAULT_PAGE_SIZE` bytes
+     * @param first the page number of the first page
+     * @param count the number of pages
+     * @throws std::runtime_error if the pages cannot be written
+     */
+    void writeStoredPages(int fd, const uint8_t *data, size_t first, size_t count);
+
+    /**
+     * @brief Check the headers of all the pages of a file
+     * @details The file is read directly, not through the BufferPool, by several threads. It should not be written
+     * meanwhile.
+     * @param name the name of the file
+     * @param threads the number of threads that read the file
+     * @return the page numbers of the pages that are torn or corrupted, in order
+     * @throws std::runtime_error if the file cannot be read
+     */
+    std::vector<size_t> verifyFile(const std::string &name, size_t threads = std::thread::hardware_concurrency());
+} // namespace db
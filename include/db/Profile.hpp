@@ -0,0 +1,50 @@
+#pragma once
+
+#include <db/Operator.hpp>
+#include <db/Tracer.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that records a span of its input in the Tracer for every run.
+     * @details A run lasts from Profile::open until the input has no more rows (or the profile is opened again or
+     * destroyed). Its span has the number of rows produced and the pages accessed in the BufferPool by the thread
+     * during the run, including the pages of the operators below, and how many of them were read from their files.
+     * Wrapping every operator of a plan gives the time spent in each operator as nested spans.
+     * When tracing is off the profile only forwards the calls to its input.
+     * @note The input must be run by a single thread, e.g. a pipeline of a Gather is profiled inside of the Gather.
+     */
+    class Profile : public Operator {
+        std::unique_ptr<Operator> child;
+        const std::string name;
+        bool running;
+        uint64_t start;
+        uint64_t rows;
+        Tracer::PageCounts pages;
+
+        /// Record the span of the current run
+        void finish();
+
+    public:
+        /**
+         * @brief Initialize a profile
+         * @param child the profiled operator
+         * @param name the name of the spans of the operator
+         */
+        Profile(std::unique_ptr<Operator> child, std::string name);
+
+        ~Profile() override;
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+    };
+
+} // namespace db
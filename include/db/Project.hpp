@@ -0,0 +1,39 @@
+#pragma once
+
+#include <db/Operator.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces a subset of the fields of its input.
+     * @details Only the projected fields are copied from the rows of the input, the other fields are never read.
+     * Predicates on the projected fields are pushed down to the input.
+     */
+    class Project : public Operator {
+        std::unique_ptr<Operator> child;
+        std::vector<size_t> fields;
+        TupleDesc td;
+        std::vector<uint8_t> buffer;
+
+    public:
+        /**
+         * @brief Initialize a projection
+         * @param child the input of the projection
+         * @param fields the indices of the projected fields in the rows of the input
+         * @throws std::logic_error if a field does not exist or is projected twice
+         */
+        Project(std::unique_ptr<Operator> child, const std::vector<size_t> &fields);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+    };
+
+} // namespace db
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <db/BTreeFile.hpp>
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces the tuples of a BTreeFile in descending key order.
+     * @details The leaves are read from the last one backward (see BTreeFile::readPreviousLeaf), so the greatest keys
+     * are produced after reading a few pages, e.g. for ORDER BY key DESC LIMIT k. Pushed down predicates are evaluated
+     * while a leaf is read.
+     * @note The file may not be modified while it is scanned.
+     */
+    class ReverseBTreeScan : public Operator {
+        const BTreeFile &file;
+        ScanFilter filter;
+        BTreeFile::ReversePosition position;
+        std::vector<uint8_t> rows;
+        /// The number of rows of the leaf that were not produced yet, they are produced from the last one
+        size_t remaining;
+        const uint8_t *current;
+
+    public:
+        explicit ReverseBTreeScan(const BTreeFile &file);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Evaluate a predicate in the scan
+         * @return always true
+         * @throws std::logic_error if the predicate does not match the tuples of the file
+         */
+        bool pushDown(const Predicate &predicate) override;
+    };
+
+} // namespace db
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <db/Operator.hpp>
+#include <optional>
+
+namespace db {
+
+    /**
+     * @brief A conjunction of predicates that is evaluated on the serialized tuples of a page.
+     * @details Every predicate is compiled to a scan kernel (see ScanKernels.hpp) when the predicate is added:
+     * comparisons, BETWEEN and IN lists on INT and DOUBLE fields become sets of ranges, and equality or prefix
+     * predicates on CHAR fields become a masked comparison of the 64 bytes of the field. The kernels produce a
+     * bitmap of the tuples that satisfy each predicate, and the bitmaps are ANDed (see ScanFilter::apply).
+     * Comparisons of CHAR fields other than equality are evaluated one tuple at a time.
+     */
+    class ScanFilter {
+        struct Term {
+            size_t field;
+            size_t offset;
+            type_t type;
+            /// select the tuples that do not match
+            bool negate;
+            std::vector<std::pair<int, int>> int_ranges;
+            std::vector<std::pair<double, double>> double_ranges;
+            /// CHAR_SIZE bytes of pattern and CHAR_SIZE bytes of mask, empty if nothing can match
+            std::vector<uint8_t> match;
+            /// a predicate that has no kernel
+            std::optional<Predicate> predicate;
+        };
+
+        const TupleDesc &td;
+        std::vector<Term> terms;
+
+        Term &addTerm(size_t field, bool negate);
+
+        void addMatch(size_t field, const std::string &value, bool prefix, bool negate);
+
+        bool test(const Term &term, const uint8_t *row) const;
+
+    public:
+        explicit ScanFilter(const TupleDesc &td);
+
+        /**
+         * @brief Add a comparison
+         * @throws std::logic_error if the predicate does not match the tuple descriptor
+         */
+        void add(const Predicate &predicate);
+
+        /**
+         * @brief Add `low <= field <= high` on an INT or DOUBLE field
+         * @throws std::logic_error if the field is not an INT or DOUBLE field, or the values have another type
+         */
+        void addBetween(size_t field, const field_t &low, const field_t &high);
+
+        /**
+         * @brief Add `field IN (values)` on an INT or DOUBLE field
+         * @throws std::logic_error if the field is not an INT or DOUBLE field, or the values have another type
+         */
+        void addIn(size_t field, const std::vector<field_t> &values);
+
+        /**
+         * @brief Add `field LIKE 'prefix%'` on a CHAR field
+         * @throws std::logic_error if the field is not a CHAR field
+         */
+        void addPrefix(size_t field, const std::string &prefix);
+
+        /**
+         * @brief Check whether the filter has no predicates
+         */
+        bool empty() const;
+
+        /**
+         * @brief Evaluate the filter on consecutive serialized tuples
+         * @param rows the tuples, `td.length()` bytes each
+         * @param count the number of tuples
+         * @param bitmap one bit per tuple (see ScanKernels.hpp), cleared for the tuples that do not satisfy the filter
+         */
+        void apply(const uint8_t *rows, size_t count, uint64_t *bitmap) const;
+
+        /**
+         * @brief Evaluate the filter on a serialized tuple
+         */
+        bool test(const uint8_t *row) const;
+
+        /**
+         * @brief Remove the tuples that do not satisfy the filter
+         * @param rows the tuples, `td.length()` bytes each, the remaining tuples are moved to the front
+         * @param count the number of tuples
+         * @return the number of remaining tuples
+         */
+        size_t compact(uint8_t *rows, size_t count) const;
+    };
+
+} // namespace db
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <db/types.hpp>
+
+namespace db {
+
+    /// The instruction sets that the scan kernels can use
+    enum class SimdLevel {
+        SCALAR, AVX2, AVX512
+    };
+
+    /**
+     * @brief Check whether the processor supports an instruction set
+     */
+    bool simdSupported(SimdLevel level);
+
+    /**
+     * @brief Get the instruction set used by the scan kernels
+     * @details The default is the widest instruction set supported by the processor.
+     */
+    SimdLevel getSimdLevel();
+
+    /**
+     * @brief Change the instruction set used by the scan kernels (for tests and benchmarks)
+     * @throws std::logic_error if the processor does not support the instruction set
+     */
+    void setSimdLevel(SimdLevel level);
+
+    /*
+     * The kernels evaluate a predicate on a field of `count` consecutive serialized tuples: the field of tuple i
+     * starts at `data + i * stride`. Bit i % 64 of `bitmap[i / 64]` is set to the result for tuple i; the bitmap
+     * must have room for (count + 63) / 64 words, and the bits past `count` are cleared.
+     */
+
+    /**
+     * @brief Select the tuples whose INT field is in [low, high]
+     */
+    void selectIntRange(const uint8_t *data, size_t stride, size_t count, int low, int high, uint64_t *bitmap);
+
+    /**
+     * @brief Select the tuples whose DOUBLE field is in [low, high]
+     * @note NaN values are never selected.
+     */
+    void selectDoubleRange(const uint8_t *data, size_t stride, size_t count, double low, double high,
+                           uint64_t *bitmap);
+
+    /**
+     * @brief Select the tuples whose CHAR field matches a pattern on the bytes of a mask
+     * @details A tuple is selected if `(field[j] ^ pattern[j]) & mask[j]` is 0 for every byte j of the field.
+     * @param pattern the expected bytes, CHAR_SIZE bytes
+     * @param mask the compared bits, CHAR_SIZE bytes
+     */
+    void selectCharMatch(const uint8_t *data, size_t stride, size_t count, const uint8_t *pattern,
+                         const uint8_t *mask, uint64_t *bitmap);
+
+} // namespace db
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <db/BTreeFile.hpp>
+
+namespace db {
+
+    /**
+     * @brief A B+tree index on a field of a HeapFile.
+     * @details The index stores one entry per tuple of the table: the value of the indexed field and the position
+     * (page, slot) of the tuple in the table. Entries are sorted on the value and then on the position, so the key
+     * of an entry is unique even if many tuples share a value, and the tuples with the same value are found in page
+     * order. The HeapFile keeps its indexes up to date when tuples are inserted or deleted (see
+     * Database::addIndex).
+     */
+    class SecondaryIndex : public BTreeFile {
+        const std::string table;
+        const size_t field;
+
+    public:
+        /**
+         * @brief Initialize a secondary index
+         * @param name the name of the index file
+         * @param table the name of the indexed HeapFile
+         * @param td the tuple descriptor of the table
+         * @param field the index of the indexed field in the tuples of the table
+         */
+        SecondaryIndex(const std::string &name, const std::string &table, const TupleDesc &td, size_t field);
+
+        /**
+         * @brief Get the name of the indexed table
+         */
+        const std::string &getTable() const;
+
+        /**
+         * @brief Get the index of the indexed field in the tuples of the table
+         */
+        size_t getField() const;
+
+        /**
+         * @brief Add the entry of a tuple of the table
+         * @param t the tuple of the table
+         * @param page the page of the tuple in the table
+         * @param slot the slot of the tuple in the page
+         */
+        void insertEntry(const Tuple &t, size_t page, size_t slot);
+
+        /**
+         * @brief Remove the entry of a tuple of the table
+         * @param t the tuple of the table
+         * @param page the page of the tuple in the table
+         * @param slot the slot of the tuple in the page
+         */
+        void deleteEntry(const Tuple &t, size_t page, size_t slot);
+
+        /**
+         * @brief Find the tuples of the table with a value
+         * @param value the value of the indexed field
+         * @return the positions of the tuples in the table, in page order
+         */
+        std::vector<Iterator> find(const field_t &value) const;
+
+        /**
+         * @brief Find the tuples of the table with a value in a range
+         * @param low the smallest value (inclusive)
+         * @param high the largest value (inclusive)
+         * @return the positions of the tuples in the table, sorted on the value
+         */
+        std::vector<Iterator> findRange(const field_t &low, const field_t &high) const;
+    };
+
+} // namespace db
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+#include <optional>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces the tuples of a file.
+     * @details The tuples are read a page at a time (see DbFile::readTuples) into a buffer owned by the scan, so the
+     * BufferPool is accessed once per page and no page is pinned between calls to SeqScan::next. Pushed down
+     * predicates are evaluated while the page is read (see ScanFilter), only the selected tuples are copied.
+     * @note The file may not be modified while it is scanned.
+     */
+    class SeqScan : public Operator {
+        const DbFile &file;
+        ScanFilter filter;
+        std::optional<Iterator> it;
+        std::vector<uint8_t> rows;
+        size_t count;
+        size_t pos;
+        const uint8_t *current;
+
+    public:
+        explicit SeqScan(const DbFile &file);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Evaluate a predicate in the scan
+         * @return always true
+         * @throws std::logic_error if the predicate does not match the tuples of the file
+         */
+        bool pushDown(const Predicate &predicate) override;
+
+        /**
+         * @brief Get the filter of the scan, to add predicates that are not comparisons (BETWEEN, IN, prefix)
+         * @note The filter may only be changed before the scan is opened.
+         */
+        ScanFilter &getFilter();
+    };
+
+} // namespace db
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+#include <db/VersionedHeapFile.hpp>
+#include <optional>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces the tuples of a VersionedHeapFile as of a snapshot.
+     * @details The tuples are read a page at a time (see VersionedHeapFile::readSnapshot) without latching the pages,
+     * so the scan runs concurrently with insertions and deletions, and neither waits for the other. The scan either
+     * opens its own snapshot when it is opened, or uses a ReadView shared with other scans to read several files as
+     * of the same time.
+     * @note An own snapshot is closed when the scan reaches its end, so that it does not hold back the garbage
+     * collection.
+     */
+    class SnapshotScan : public Operator {
+        const VersionedHeapFile &file;
+        const ReadView *shared_view;
+        std::optional<ReadView> own_view;
+        ScanFilter filter;
+        const ReadView *view;
+        size_t page;
+        size_t num_pages;
+        std::vector<uint8_t> rows;
+        size_t count;
+        size_t pos;
+        const uint8_t *current;
+
+    public:
+        /**
+         * @param file the file to scan
+         * @param view the snapshot to read, it must outlive the scan. If it is null, a new snapshot is opened every
+         * time the scan is opened.
+         */
+        explicit SnapshotScan(const VersionedHeapFile &file, const ReadView *view = nullptr);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        /**
+         * @brief Evaluate a predicate in the scan
+         * @return always true
+         * @throws std::logic_error if the predicate does not match the tuples of the file
+         */
+        bool pushDown(const Predicate &predicate) override;
+
+        /**
+         * @brief Get the filter of the scan
+         * @note The filter may only be changed before the scan is opened.
+         */
+        ScanFilter &getFilter();
+    };
+
+} // namespace db
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <db/Tuple.hpp>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief A field to sort on, and its direction.
+     */
+    struct SortField {
+        size_t field;
+        bool descending = false;
+    };
+
+    /**
+     * @brief The normalized sort key of serialized rows.
+     * @details The sort fields are encoded with a fixed width, so that comparing the keys of two rows with memcmp
+     * gives the order of the rows: INT and DOUBLE fields as in KeyDesc, CHAR fields padded with zeros, and the bytes
+     * of descending fields inverted. Sorting operators compare the keys instead of decoding the fields of the rows
+     * (see ExternalSort and TopK).
+     */
+    class SortKey {
+        struct KeyField {
+            size_t offset;
+            type_t type;
+            bool descending;
+        };
+
+        std::vector<KeyField> fields;
+        size_t key_length;
+
+    public:
+        /**
+         * @brief Initialize the key of a sort
+         * @param td the tuple descriptor of the rows
+         * @param fields the fields to sort on, from the most to the least significant
+         * @throws std::logic_error if there are no sort fields or a field does not exist
+         */
+        SortKey(const TupleDesc &td, const std::vector<SortField> &fields);
+
+        /**
+         * @brief Get the number of bytes of a key
+         */
+        size_t length() const;
+
+        /**
+         * @brief Encode the key of a row
+         * @param row the serialized row
+         * @param key the buffer of the key, `length()` bytes
+         */
+        void encode(const uint8_t *row, uint8_t *key) const;
+
+        /**
+         * @brief Get the first 8 bytes of a key as an integer, padded with zeros, which orders the keys as their
+         * first 8 bytes
+         */
+        uint64_t prefix(const uint8_t *key) const;
+    };
+
+} // namespace db
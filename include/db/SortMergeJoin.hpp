@@ -0,0 +1,72 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/FieldKey.hpp>
+#include <db/Operator.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An equi-join of two inputs that are sorted on their INT or CHAR key field.
+     * @details The inputs are merged in a single pass: the rows of the right input with the key of the current left
+     * row are buffered, and joined with every left row with that key. Scans of BTreeFiles keyed on the join field
+     * are sorted (see SortMergeJoin::sortedOn), so joining them needs no hash table and no sort. The rows of the join
+     * are the left row followed by the right row (see TupleDesc::merge), sorted on the key.
+     * Predicates on the fields of one input are pushed down into that input.
+     */
+    class SortMergeJoin : public Operator {
+        std::unique_ptr<Operator> left_child;
+        std::unique_ptr<Operator> right_child;
+        const FieldKey left_key;
+        const FieldKey right_key;
+        TupleDesc td;
+        bool right_valid;
+        /// The right rows with the key of the group
+        std::vector<uint8_t> group;
+        size_t group_count;
+        size_t group_pos;
+        /// The last rows of the inputs, to check their order
+        std::vector<uint8_t> last_left;
+        std::vector<uint8_t> last_right;
+        std::vector<uint8_t> current;
+
+        bool nextLeft();
+
+        bool nextRight();
+
+    public:
+        /**
+         * @brief Initialize a merge join
+         * @param left an input sorted on the left key
+         * @param right an input sorted on the right key
+         * @param left_field the index of the key field of the left input
+         * @param right_field the index of the key field of the right input
+         * @throws std::logic_error if the key fields do not exist, are not INT or CHAR fields or have different types,
+         * or if the inputs have fields with the same name
+         */
+        SortMergeJoin(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right, size_t left_field,
+                      size_t right_field);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        /**
+         * @brief Advance to the next row
+         * @throws std::runtime_error if an input is not sorted on its key
+         */
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+
+        /**
+         * @brief Check whether the tuples of a file are stored sorted on a field, in the order of SortMergeJoin
+         * @return true if the file is a BTreeFile whose first key field is the field
+         */
+        static bool sortedOn(const DbFile &file, size_t field);
+    };
+
+} // namespace db
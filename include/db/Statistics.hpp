@@ -0,0 +1,83 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/Operator.hpp>
+#include <optional>
+
+namespace db {
+
+    /**
+     * @brief The distribution of the values of a column, estimated by TableStatistics::collect.
+     * @details The histogram is equi-depth: its buckets hold the same number of rows, so the frequent values get
+     * narrow buckets and a value that fills several buckets appears several times in the bounds. The first bucket
+     * starts at the smallest value.
+     */
+    struct ColumnStatistics {
+        /// The estimated number of distinct values
+        double distinct = 0;
+        /// The smallest and largest values, empty if the table is empty
+        std::optional<field_t> min;
+        std::optional<field_t> max;
+        /// The upper bounds of the buckets of the histogram, in order, the last one is the largest value
+        std::vector<field_t> bounds;
+
+        /**
+         * @brief Estimate the fraction of the rows that satisfy `column op value`
+         * @details The fraction of a bucket below a number is interpolated, strings are compared with the bounds only.
+         * Equality selects one distinct value, or the buckets that the value fills.
+         * @return a fraction between 0 and 1
+         */
+        double selectivity(PredicateOp op, const field_t &value) const;
+
+    private:
+        /// The estimated fraction of the rows with a value less than a value
+        double fractionBelow(const field_t &value) const;
+
+        /// The estimated fraction of the rows with a value equal to a value
+        double fractionEqual(const field_t &value) const;
+    };
+
+    /**
+     * @brief The statistics of a table: its size and the distribution of every column.
+     * @details The statistics are collected by a scan of the file (see TableStatistics::collect), usually stored in
+     * the Catalog (see Database::analyze), and used by the cost model to choose how to read the rows that satisfy
+     * predicates (see AccessPath).
+     */
+    struct TableStatistics {
+        /// The estimated number of rows
+        double rows = 0;
+        /// The number of pages of the file
+        size_t pages = 0;
+        /// The statistics of every field of the tuple descriptor of the file
+        std::vector<ColumnStatistics> columns;
+
+        /// The number of rows of a sample that builds the histograms
+        static constexpr size_t SAMPLE_ROWS = 1 << 15;
+
+        /**
+         * @brief Collect the statistics of a file
+         * @details The pages of a HeapFile are read by threads that take them one at a time and skip the pages that
+         * are not sampled, so a sample reads that fraction of the file. Other files are read entirely, a BTreeFile
+         * in parts by threads (see BTreeScan::create). Each thread counts its rows, tracks the smallest and largest
+         * values, estimates the distinct values with a HyperLogLog and keeps a reservoir sample of its rows; the
+         * histograms are built from the weighted union of the samples of the threads. The distinct values of a column
+         * that were mostly distinct in a sampled file are extrapolated to the whole file.
+         * @param file the file, a HeapFile, a BTreeFile, or any DbFile
+         * @param workers the number of threads
+         * @param sample the fraction of the pages of a HeapFile to read, the pages are chosen from a hash of their
+         * number, so the same pages are read again
+         * @param buckets the number of buckets of the histograms
+         * @throws std::logic_error if there are no workers or buckets, or the fraction is not in (0, 1]
+         */
+        static TableStatistics collect(const DbFile &file, size_t workers = 1, double sample = 1,
+                                       size_t buckets = 64);
+
+        /**
+         * @brief Estimate the fraction of the rows that satisfy a conjunction of predicates
+         * @details The predicates are assumed to be independent.
+         * @throws std::logic_error if a predicate is on a column without statistics
+         */
+        double selectivity(const std::vector<Predicate> &predicates) const;
+    };
+
+} // namespace db
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <db/Aggregate.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that computes a GROUP BY query over an input whose rows arrive grouped.
+     * @details The rows of a group are consecutive in the input, e.g. a scan of a BTreeFile whose key starts with
+     * the group fields (see StreamAggregate::sortedOn), so each group is aggregated while it is read and produced as
+     * soon as the next group starts. No hash table is built and only the state of one group is held in memory.
+     * The groups are produced in the order of the input.
+     * Predicates on the group fields are pushed down into the input.
+     * Without group fields, an empty input produces one row (see Aggregate).
+     * @note If the rows of a group are not consecutive, the group is produced more than once.
+     */
+    class StreamAggregate : public Operator {
+        std::unique_ptr<Operator> child;
+        AggregateLayout layout;
+        /// Whether the input is positioned on the first row of the next group
+        bool has_row;
+        /// Whether a row was produced since the operator was opened
+        bool produced;
+        std::vector<uint8_t> key;
+        std::vector<uint8_t> next_key;
+        std::vector<uint8_t> state;
+        std::vector<uint8_t> current;
+
+    public:
+        /**
+         * @brief Initialize an aggregation
+         * @param child the rows to group, grouped on the group fields
+         * @param group_fields the indices of the INT or CHAR fields to group on
+         * @param aggregates the aggregates to compute
+         * @throws std::logic_error if the query does not match the tuples of the input (see AggregateLayout)
+         */
+        StreamAggregate(std::unique_ptr<Operator> child, const std::vector<size_t> &group_fields,
+                        const std::vector<Aggregate> &aggregates);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+
+        /**
+         * @brief Check whether a scan of a file produces its tuples grouped on some fields
+         * @return true if there are no group fields, or the file is a BTreeFile whose first key fields are the group
+         * fields (in any order)
+         */
+        static bool sortedOn(const DbFile &file, const std::vector<size_t> &group_fields);
+    };
+
+} // namespace db
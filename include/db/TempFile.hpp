@@ -0,0 +1,92 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <string>
+
+namespace db {
+
+    /**
+     * @brief A temporary file of serialized rows, written once and then read sequentially.
+     * @details Rows are packed into pages without a header, `DEFAULT_PAGE_SIZE / td.length()` rows per page. The
+     * file is not registered in the Database and its pages do not go through the BufferPool: rows are buffered and
+     * written a block of pages at a time (see DbFile::writePages), and read into a buffer of the caller. A TempFile
+     * is only used by one thread at a time, so operators can spill from several threads without synchronization.
+     * The file is deleted when the object is destroyed.
+     */
+    class TempFile {
+        DbFile file;
+        const size_t rows_per_page;
+        const size_t block_pages;
+        /// The rows that are not written yet, at most `block_pages` pages
+        std::vector<uint8_t> buffer;
+        size_t buffer_rows;
+        size_t num_pages;
+        size_t num_rows;
+        bool flushed;
+
+        void writeBuffer();
+
+    public:
+        /**
+         * @brief Create an empty temporary file
+         * @param name the name of the file, an existing file is truncated
+         * @param td the tuple descriptor of the rows
+         * @param block_pages the number of pages written by a system call
+         */
+        TempFile(const std::string &name, const TupleDesc &td, size_t block_pages = 1);
+
+        ~TempFile();
+
+        TempFile(const TempFile &) = delete;
+
+        TempFile &operator=(const TempFile &) = delete;
+
+        /**
+         * @brief Get a file name that no other temporary file of the process uses
+         * @param prefix the start of the name, which identifies the operator that uses the file
+         */
+        static std::string uniqueName(const std::string &prefix);
+
+        const std::string &getName() const;
+
+        /**
+         * @brief Append a serialized row
+         * @throws std::logic_error if the file was flushed
+         */
+        void append(const uint8_t *row);
+
+        /**
+         * @brief Write the rows that are still buffered, the last page may not be full
+         * @note Rows are only read back after the file is flushed, and no row can be appended after that.
+         */
+        void flush();
+
+        /**
+         * @brief Get the number of rows of the file
+         */
+        size_t size() const;
+
+        /**
+         * @brief Get the number of pages written to the file
+         */
+        size_t numPages() const;
+
+        /**
+         * @brief Read the rows of a page
+         * @param id the page number, less than numPages()
+         * @param rows the rows of the page are appended to the buffer
+         * @return the number of rows appended
+         */
+        size_t readPage(size_t id, std::vector<uint8_t> &rows) const;
+
+        /**
+         * @brief Read the rows of consecutive pages with a single system call
+         * @param first the page number of the first page
+         * @param count the maximum number of pages, fewer pages are read at the end of the file
+         * @param rows the rows of the pages are appended to the buffer
+         * @return the number of rows appended, 0 at the end of the file
+         */
+        size_t readPages(size_t first, size_t count, std::vector<uint8_t> &rows) const;
+    };
+
+} // namespace db
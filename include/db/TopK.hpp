@@ -0,0 +1,69 @@
+#pragma once
+
+#include <db/DbFile.hpp>
+#include <db/Operator.hpp>
+#include <db/SortKey.hpp>
+#include <memory>
+
+namespace db {
+
+    /**
+     * @brief An operator that produces the first k rows of its input in the order of sort fields (ORDER BY ... LIMIT k).
+     * @details The rows are compared on their normalized keys (see SortKey). A max-heap holds the k smallest rows
+     * read so far; once it is full, a row is compared with the greatest of them, and is dropped without being copied
+     * unless it is smaller. The input is read once and only k rows are kept in memory, it is never sorted as a
+     * whole. Rows with equal keys are produced in the order of the input.
+     * Predicates are pushed down into the input.
+     */
+    class TopK : public Operator {
+        std::unique_ptr<Operator> child;
+        const SortKey sort_key;
+        const size_t k;
+        /// The slots of the rows kept, each with the key of the row, the row and its position in the input
+        std::vector<uint8_t> slots;
+        std::vector<size_t> positions;
+        /// The slots ordered as a max-heap while the input is read, then in ascending order
+        std::vector<uint32_t> heap;
+        size_t pos;
+        bool pending;
+
+        size_t slotLength() const;
+
+        bool less(uint32_t a, uint32_t b) const;
+
+    public:
+        /**
+         * @brief Initialize a top-k
+         * @param child the input
+         * @param fields the fields to sort on, from the most to the least significant
+         * @param k the number of rows
+         * @throws std::logic_error if there are no sort fields or a field does not exist
+         */
+        TopK(std::unique_ptr<Operator> child, const std::vector<SortField> &fields, size_t k);
+
+        const TupleDesc &getTupleDesc() const override;
+
+        void open() override;
+
+        bool next() override;
+
+        const uint8_t *row() const override;
+
+        bool pushDown(const Predicate &predicate) override;
+    };
+
+    /**
+     * @brief Create the operator of a query "SELECT * FROM file WHERE predicates ORDER BY fields LIMIT k"
+     * @details If the file is a BTreeFile whose first key fields are the sort fields, all ascending or all
+     * descending, the tuples are read in key order (see BTreeScan and ReverseBTreeScan) and the scan stops after k
+     * tuples, so only the first or the last leaves are read. Otherwise the file is scanned by a TopK.
+     * @param file the file to query
+     * @param fields the fields to sort on
+     * @param k the number of tuples
+     * @param predicates the predicates that the tuples must satisfy, pushed down into the scan
+     * @throws std::logic_error if the sort fields or the predicates do not match the tuples of the file
+     */
+    std::unique_ptr<Operator> topK(const DbFile &file, const std::vector<SortField> &fields, size_t k,
+                                   const std::vector<Predicate> &predicates = {});
+
+} // namespace db
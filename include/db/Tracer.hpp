@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace db {
+
+    /**
+     * @brief A span of time recorded by the Tracer.
+     */
+    struct TraceEvent {
+        std::string name;
+        /// The category of the span, e.g. "operator" or "io"
+        const char *category;
+        /// The thread that recorded the span, numbered from 1 in the order in which threads record their first span
+        uint32_t thread;
+        /// The start of the span, in nanoseconds since the tracer was started
+        uint64_t start;
+        uint64_t duration;
+        std::vector<std::pair<const char *, uint64_t>> args;
+    };
+
+    /**
+     * @brief Records spans of time of the operators and of the I/O, to profile queries.
+     * @details Tracing is off by default. Every instrumented place checks Tracer::enabled, a single relaxed load,
+     * and does nothing else when tracing is off. When it is on, the spans are appended to a buffer of the thread
+     * and the BufferPool counts the pages accessed by the thread (see Tracer::getPageCounts).
+     * The spans are written in the trace event format of Chrome (chrome://tracing, Perfetto, speedscope), where the
+     * spans of a thread are nested by time into a flame graph.
+     */
+    class Tracer {
+        static std::atomic<bool> active;
+
+    public:
+        /**
+         * @brief The pages accessed by a thread in the BufferPool while tracing
+         */
+        struct PageCounts {
+            uint64_t accessed = 0;
+            uint64_t missed = 0;
+        };
+
+        static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Discard the recorded spans and start tracing
+         */
+        static void start();
+
+        /**
+         * @brief Stop tracing, the recorded spans are kept until the next start
+         */
+        static void stop();
+
+        /**
+         * @brief The time since the tracer was started, in nanoseconds
+         */
+        static uint64_t now();
+
+        /**
+         * @brief Record a span of the calling thread
+         * @param start the start of the span, see Tracer::now
+         */
+        static void record(std::string name, const char *category, uint64_t start,
+                           std::vector<std::pair<const char *, uint64_t>> args = {});
+
+        /**
+         * @brief Count a page access of the calling thread, called by the BufferPool while tracing
+         */
+        static void countPage(bool missed);
+
+        /**
+         * @brief The pages accessed by the calling thread since the thread started
+         */
+        static const PageCounts &getPageCounts();
+
+        /**
+         * @brief Get the spans recorded since the tracer was started, by thread and start time
+         * @note The spans of the threads that are still recording are included.
+         */
+        static std::vector<TraceEvent> getEvents();
+
+        /**
+         * @brief Write the recorded spans as a JSON trace of Chrome
+         */
+        static void writeChromeTrace(std::ostream &out);
+    };
+
+    /**
+     * @brief Records the time from its construction to its destruction as a span, if tracing is on
+     */
+    class TraceSpan {
+        const char *name;
+        const char *category;
+        uint64_t start;
+        std::vector<std::pair<const char *, uint64_t>> args;
+
+        /// Record the span, called if tracing was on at its start
+        void finish();
+
+    public:
+        TraceSpan(const char *name, const char *category)
+                : name(name), category(category), start(Tracer::enabled() ? Tracer::now() : UINT64_MAX) {}
+
+        ~TraceSpan() {
+            if (start != UINT64_MAX) {
+                finish();
+            }
+        }
+
+        /**
+         * @brief Attach a value to the span
+         */
+        void arg(const char *key, uint64_t value);
+
+        TraceSpan(const TraceSpan &) = delete;
+
+        TraceSpan &operator=(const TraceSpan &) = delete;
+    };
+
+} // namespace db
@@ -24,6 +24,7 @@ namespace db {
         // TODO pa1: add private members
         std::vector<type_t> types;
         std::vector<size_t> offsets;
+        std::vector<std::string> names;
         std::unordered_map<std::string, size_t> name_to_index;
 
     public:
@@ -64,6 +65,20 @@ namespace db {
          */
         size_t index_of(const std::string &name) const;
 
+        /**
+         * @brief Get the type of the field
+         * @param index the index of the field
+         * @return the type of the field
+         */
+        type_t field_type(size_t index) const;
+
+        /**
+         * @brief Get the name of the field
+         * @param index the index of the field
+         * @return the name of the field
+         */
+        const std::string &field_name(size_t index) const;
+
         /**
          * @brief Get the number of fields in the TupleDesc
          * @return the number of fields in the TupleDesc
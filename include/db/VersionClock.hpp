@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+
+namespace db {
+
+    /**
+     * @brief The commit timestamps of multi-version concurrency control.
+     * @details Every version of a tuple is stamped with the timestamp of the commit that created it (begin) and of the
+     * commit that deleted it (end). A snapshot is a timestamp: it sees the versions created at or before it and
+     * deleted after it, so a reader sees the data as of the time it opened its snapshot no matter what writers do
+     * meanwhile. Timestamps start at 1, the tuples that were in the files when they were opened have begin 1.
+     *
+     * The clock also tracks the open snapshots. Versions deleted at or before the horizon (the oldest open snapshot)
+     * are invisible to every current and future snapshot, and their storage can be reused (see
+     * VersionedHeapFile::collectGarbage).
+     * @note All methods are thread-safe.
+     */
+    class VersionClock {
+        mutable std::mutex mutex;
+        uint64_t now;
+        std::multiset<uint64_t> snapshots;
+
+    public:
+        /// The end of a version that is not deleted
+        static constexpr uint64_t infinity = UINT64_MAX;
+
+        VersionClock();
+
+        /**
+         * @brief Get the timestamp of the last commit
+         */
+        uint64_t getTimestamp() const;
+
+        /**
+         * @brief Commit a change with a new timestamp
+         * @details The versions are stamped before the timestamp is published, so a snapshot either sees all of them
+         * or none of them.
+         * @param stamp stores the timestamp in the versions created or deleted by the change
+         * @return the timestamp of the commit
+         */
+        uint64_t commit(const std::function<void(uint64_t)> &stamp);
+
+        /**
+         * @brief Register a snapshot of the last commit
+         * @return the timestamp of the snapshot, it must be closed with VersionClock::closeSnapshot
+         */
+        uint64_t openSnapshot();
+
+        /**
+         * @brief Unregister a snapshot opened with VersionClock::openSnapshot
+         */
+        void closeSnapshot(uint64_t timestamp);
+
+        /**
+         * @brief Get the timestamp of the oldest open snapshot, or of the last commit if there are none
+         */
+        uint64_t horizon() const;
+
+        /**
+         * @brief Get the number of open snapshots
+         */
+        size_t getNumSnapshots() const;
+    };
+
+    /**
+     * @brief A snapshot that is open for the lifetime of the object.
+     * @details Several scans can share a ReadView to read several files as of the same time.
+     */
+    class ReadView {
+        VersionClock &clock;
+        const uint64_t ts;
+
+    public:
+        explicit ReadView(VersionClock &clock);
+
+        ~ReadView();
+
+        ReadView(const ReadView &) = delete;
+
+        ReadView &operator=(const ReadView &) = delete;
+
+        /**
+         * @brief Get the timestamp of the snapshot
+         */
+        uint64_t timestamp() const;
+
+        /**
+         * @brief Check if a version is visible in the snapshot
+         * @param begin the timestamp that created the version, 0 if the version does not exist
+         * @param end the timestamp that deleted the version, VersionClock::infinity if it is not deleted
+         */
+        bool sees(uint64_t begin, uint64_t end) const { return begin != 0 && begin <= ts && ts < end; }
+    };
+
+} // namespace db
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <db/HeapFile.hpp>
+#include <db/VersionClock.hpp>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace db {
+    class ReadView;
+
+    /**
+     * @brief A HeapFile with multi-version concurrency control, so that snapshot scans never wait on writers.
+     * @details Every slot has the begin and end timestamps (see VersionClock) of the version that it holds. The
+     * timestamps are kept in memory next to the pages rather than in them, the layout of HeapPage is unchanged. An
+     * insertion writes the tuple in a free slot under an exclusive PageLatch and then stamps its begin; a deletion
+     * clears the slot in the header and stamps its end, but leaves the bytes of the tuple in the page for the
+     * snapshots that still see it.
+     *
+     * Snapshot reads (VersionedHeapFile::readSnapshot) select the slots from their timestamps instead of the header,
+     * and copy them from the pinned page without taking its latch: a slot is only written while no open snapshot can
+     * see it. A deleted slot is reused once its end is at or before the horizon of the VersionClock. The garbage is
+     * collected by VersionedHeapFile::collectGarbage, called by a background thread or by the user.
+     *
+     * The methods inherited from HeapFile read the latest version of the tuples, as in a HeapFile.
+     * @note Writers are serialized. Versions are not persistent: the tuples of a file that is opened have begin 1.
+     * @note The secondary indexes of the file only have the latest version of the tuples.
+     */
+    class VersionedHeapFile : public HeapFile {
+        struct Version {
+            std::atomic<uint64_t> begin{0};
+            std::atomic<uint64_t> end{VersionClock::infinity};
+        };
+
+        struct Garbage {
+            uint64_t end;
+            size_t page;
+            size_t slot;
+        };
+
+        VersionClock &clock;
+        const size_t capacity;
+        /// Segment k has the versions of pages 2^k - 1 to 2^(k+1) - 2, a segment is never moved once allocated
+        std::array<std::unique_ptr<Version[]>, 64> segments;
+        /// The pages whose versions are allocated, readers do not access the others
+        std::atomic<size_t> visible_pages;
+        mutable std::mutex write_mutex;
+        std::vector<std::pair<size_t, size_t>> free_slots;
+        /// The deleted versions, by increasing end
+        std::deque<Garbage> garbage;
+        size_t num_reclaimed;
+        const std::chrono::milliseconds gc_interval;
+        std::mutex collector_mutex;
+        std::condition_variable collector_cv;
+        bool stopping;
+        std::thread collector;
+
+        Version &version(size_t page, size_t slot) const;
+
+        void addPage();
+
+    public:
+        /**
+         * @brief Open a versioned heap file
+         * @param name the name of the file
+         * @param td the tuple descriptor of the file
+         * @param gc_interval the time between two collections of the background thread, no thread is started if it is
+         * zero
+         */
+        VersionedHeapFile(const std::string &name, const TupleDesc &td, std::chrono::milliseconds gc_interval = {});
+
+        /**
+         * @brief Stop the garbage collector
+         */
+        ~VersionedHeapFile() override;
+
+        /**
+         * @brief Insert a tuple in a free slot and commit it.
+         * @details The slot is either a reclaimed slot or a slot of a new page.
+         * @throws std::runtime_error if the tuple is not compatible with the TupleDesc of the file
+         */
+        void insertTuple(const Tuple &t) override;
+
+        /**
+         * @brief Delete a tuple and commit the deletion.
+         * @details The tuple stays visible to the snapshots opened before.
+         * @throws std::runtime_error if the slot is not occupied
+         */
+        void deleteTuple(const Iterator &it) override;
+
+        /**
+         * @brief Get the number of pages that snapshot reads can access
+         */
+        size_t getNumVisiblePages() const;
+
+        /**
+         * @brief Read the tuples of a page that are visible in a snapshot.
+         * @details The page is pinned but not latched, so concurrent insertions and deletions do not block the read
+         * and are not seen by it. A page without visible tuples is not read at all.
+         * @param page the page, less than VersionedHeapFile::getNumVisiblePages
+         * @param view the snapshot
+         * @param rows the tuples are appended to the buffer, `td.length()` bytes per tuple
+         * @param filter the predicates that the tuples must satisfy
+         * @return the number of tuples appended
+         */
+        size_t readSnapshot(size_t page, const ReadView &view, std::vector<uint8_t> &rows,
+                            const ScanFilter &filter) const;
+
+        /**
+         * @brief Reclaim the slots of the versions that no snapshot can see anymore
+         * @return the number of slots reclaimed
+         */
+        size_t collectGarbage();
+
+        /**
+         * @brief Get the number of deleted versions that are not reclaimed yet
+         */
+        size_t getNumGarbage() const;
+
+        /**
+         * @brief Get the number of slots reclaimed since the file was opened
+         */
+        size_t getNumReclaimed() const;
+
+        /**
+         * @brief Get the time between two collections of the background thread, 0 if there is no thread
+         */
+        std::chrono::milliseconds getGcInterval() const;
+    };
+
+} // namespace db
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cmath>
+#include <db/AccessPath.hpp>
+#include <db/IndexScan.hpp>
+#include <db/SeqScan.hpp>
+#include <limits>
+
+using namespace db;
+
+namespace {
+    /// The smallest and largest values of a type
+    std::pair<field_t, field_t> extremes(type_t type) {
+        switch (type) {
+            case type_t::INT:
+                return {std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
+            case type_t::DOUBLE:
+                return {-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()};
+            case type_t::CHAR:
+                return {std::string(), std::string(CHAR_SIZE, '\xff')};
+        }
+        return {};
+    }
+} // namespace
+
+AccessPath AccessPath::choose(const HeapFile &table, const TableStatistics &stats,
+                              const std::vector<Predicate> &predicates) {
+    for (const Predicate &predicate: predicates) {
+        predicate.check(table.getTupleDesc());
+    }
+    const auto pages = static_cast<double>(stats.pages);
+    AccessPath best;
+    best.rows = stats.rows * stats.selectivity(predicates);
+    best.cost = pages + stats.rows * TUPLE_COST;
+
+    for (const SecondaryIndex *index: table.getIndexes()) {
+        const size_t field = index->getField();
+        auto [low, high] = extremes(table.getTupleDesc().field_type(field));
+        std::vector<Predicate> range;
+        for (const Predicate &predicate: predicates) {
+            if (predicate.field != field || predicate.op == PredicateOp::NE) {
+                continue;
+            }
+            range.push_back(predicate);
+            // the range is inclusive, the exclusive bounds are evaluated by the scan
+            if (predicate.op != PredicateOp::LT && predicate.op != PredicateOp::LE) {
+                low = std::max(low, predicate.value);
+            }
+            if (predicate.op != PredicateOp::GT && predicate.op != PredicateOp::GE) {
+                high = std::min(high, predicate.value);
+            }
+        }
+        if (range.empty()) {
+            continue;
+        }
+        const double selectivity = stats.selectivity(range);
+        const double selected = stats.rows * selectivity;
+        const double leaves = std::max(1.0, selectivity * static_cast<double>(index->getNumPages()));
+        const double fetched = pages == 0 ? 0 : pages * (1 - std::pow(1 - 1 / pages, selected));
+        const double cost = leaves + fetched * RANDOM_PAGE_COST + selected * TUPLE_COST;
+        if (cost < best.cost) {
+            best.method = AccessMethod::INDEX_SCAN;
+            best.index = index;
+            best.low = low;
+            best.high = high;
+            best.cost = cost;
+        }
+    }
+    return best;
+}
+
+std::unique_ptr<Operator> AccessPath::open(const HeapFile &table, const std::vector<Predicate> &predicates) const {
+    std::unique_ptr<Operator> scan;
+    if (method == AccessMethod::INDEX_SCAN) {
+        scan = std::make_unique<IndexScan>(table, *index, low, high);
+    } else {
+        scan = std::make_unique<SeqScan>(table);
+    }
+    for (const Predicate &predicate: predicates) {
+        scan->pushDown(predicate);
+    }
+    return scan;
+}
@@ -0,0 +1,293 @@
+#include <cstring>
+#include <db/Aggregate.hpp>
+#include <db/HashAggregate.hpp>
+#include <db/SeqScan.hpp>
+#include <db/StreamAggregate.hpp>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+using namespace db;
+
+namespace {
+    size_t fieldSize(type_t type) {
+        switch (type) {
+            case type_t::INT:
+                return INT_SIZE;
+            case type_t::DOUBLE:
+                return DOUBLE_SIZE;
+            case type_t::CHAR:
+                return CHAR_SIZE;
+        }
+        return 0;
+    }
+
+    template<typename T>
+    T load(const uint8_t *data) {
+        T v;
+        memcpy(&v, data, sizeof(v));
+        return v;
+    }
+
+    template<typename T>
+    void store(uint8_t *data, T v) { memcpy(data, &v, sizeof(v)); }
+
+    double loadNumber(type_t type, const uint8_t *data) {
+        return type == type_t::INT ? load<int>(data) : load<double>(data);
+    }
+
+    std::string_view loadString(const uint8_t *data) {
+        const char *chars = reinterpret_cast<const char *>(data);
+        return {chars, strnlen(chars, CHAR_SIZE)};
+    }
+
+    /// Copy a field, with the bytes of a CHAR value after its end set to 0
+    void copyField(type_t type, const uint8_t *src, uint8_t *dst) {
+        if (type == type_t::CHAR) {
+            const size_t size = loadString(src).size();
+            memcpy(dst, src, size);
+            memset(dst + size, 0, CHAR_SIZE - size);
+        } else {
+            memcpy(dst, src, fieldSize(type));
+        }
+    }
+
+    bool less(type_t type, const uint8_t *a, const uint8_t *b) {
+        switch (type) {
+            case type_t::INT:
+                return load<int>(a) < load<int>(b);
+            case type_t::DOUBLE:
+                return load<double>(a) < load<double>(b);
+            case type_t::CHAR:
+                return loadString(a) < loadString(b);
+        }
+        return false;
+    }
+
+    std::string opName(AggregateOp op) {
+        switch (op) {
+            case AggregateOp::COUNT:
+                return "count";
+            case AggregateOp::SUM:
+                return "sum";
+            case AggregateOp::MIN:
+                return "min";
+            case AggregateOp::MAX:
+                return "max";
+            case AggregateOp::AVG:
+                return "avg";
+        }
+        return "";
+    }
+
+    TupleDesc outputDesc(const TupleDesc &input_td, const std::vector<size_t> &group_fields,
+                         const std::vector<Aggregate> &aggregates) {
+        std::vector<type_t> types;
+        std::vector<std::string> names;
+        for (size_t field: group_fields) {
+            if (field >= input_td.size()) {
+                throw std::logic_error("Group field out of range");
+            }
+            if (input_td.field_type(field) == type_t::DOUBLE) {
+                throw std::logic_error("Group field must be an INT or CHAR field");
+            }
+            types.push_back(input_td.field_type(field));
+            names.push_back(input_td.field_name(field));
+        }
+        for (const Aggregate &aggregate: aggregates) {
+            if (aggregate.field >= input_td.size()) {
+                throw std::logic_error("Aggregate field out of range");
+            }
+            const type_t type = input_td.field_type(aggregate.field);
+            switch (aggregate.op) {
+                case AggregateOp::COUNT:
+                    types.push_back(type_t::INT);
+                    break;
+                case AggregateOp::SUM:
+                case AggregateOp::AVG:
+                    if (type == type_t::CHAR) {
+                        throw std::logic_error("Cannot sum a CHAR field");
+                    }
+                    types.push_back(type_t::DOUBLE);
+                    break;
+                case AggregateOp::MIN:
+                case AggregateOp::MAX:
+                    types.push_back(type);
+                    break;
+            }
+            names.push_back(opName(aggregate.op) + "_" + input_td.field_name(aggregate.field));
+        }
+        return {types, names};
+    }
+} // namespace
+
+AggregateLayout::AggregateLayout(const TupleDesc &input_td, const std::vector<size_t> &group_fields,
+                                 const std::vector<Aggregate> &aggregates)
+        : input_td(input_td), group_fields(group_fields), aggregates(aggregates), key_length(0), state_length(0),
+          td(outputDesc(input_td, group_fields, aggregates)) {
+    for (size_t field: group_fields) {
+        key_length += fieldSize(input_td.field_type(field));
+    }
+    for (const Aggregate &aggregate: aggregates) {
+        state_offsets.push_back(state_length);
+        switch (aggregate.op) {
+            case AggregateOp::COUNT:
+                state_length += sizeof(int64_t);
+                break;
+            case AggregateOp::SUM:
+                state_length += sizeof(double);
+                break;
+            case AggregateOp::AVG:
+                state_length += sizeof(double) + sizeof(int64_t);
+                break;
+            case AggregateOp::MIN:
+            case AggregateOp::MAX:
+                state_length += fieldSize(input_td.field_type(aggregate.field));
+                break;
+        }
+    }
+}
+
+const TupleDesc &AggregateLayout::getTupleDesc() const { return td; }
+
+const std::vector<size_t> &AggregateLayout::getGroupFields() const { return group_fields; }
+
+size_t AggregateLayout::keyLength() const { return key_length; }
+
+size_t AggregateLayout::stateLength() const { return state_length; }
+
+void AggregateLayout::key(const uint8_t *row, uint8_t *key) const {
+    for (size_t i = 0; i < group_fields.size(); i++) {
+        copyField(td.field_type(i), row + input_td.offset_of(group_fields[i]), key + td.offset_of(i));
+    }
+}
+
+uint64_t AggregateLayout::hash(const uint8_t *key) const {
+    return std::hash<std::string_view>{}({reinterpret_cast<const char *>(key), key_length});
+}
+
+void AggregateLayout::init(uint8_t *state, const uint8_t *row) const {
+    for (size_t i = 0; i < aggregates.size(); i++) {
+        const type_t type = input_td.field_type(aggregates[i].field);
+        const uint8_t *data = row + input_td.offset_of(aggregates[i].field);
+        uint8_t *s = state + state_offsets[i];
+        switch (aggregates[i].op) {
+            case AggregateOp::COUNT:
+                store<int64_t>(s, 1);
+                break;
+            case AggregateOp::SUM:
+                store(s, loadNumber(type, data));
+                break;
+            case AggregateOp::AVG:
+                store(s, loadNumber(type, data));
+                store<int64_t>(s + sizeof(double), 1);
+                break;
+            case AggregateOp::MIN:
+            case AggregateOp::MAX:
+                copyField(type, data, s);
+                break;
+        }
+    }
+}
+
+void AggregateLayout::initEmpty(uint8_t *state) const {
+    // COUNT, SUM and the count of AVG are 0, MIN and MAX are 0 or empty strings
+    memset(state, 0, state_length);
+}
+
+void AggregateLayout::update(uint8_t *state, const uint8_t *row) const {
+    for (size_t i = 0; i < aggregates.size(); i++) {
+        const type_t type = input_td.field_type(aggregates[i].field);
+        const uint8_t *data = row + input_td.offset_of(aggregates[i].field);
+        uint8_t *s = state + state_offsets[i];
+        switch (aggregates[i].op) {
+            case AggregateOp::COUNT:
+                store(s, load<int64_t>(s) + 1);
+                break;
+            case AggregateOp::SUM:
+                store(s, load<double>(s) + loadNumber(type, data));
+                break;
+            case AggregateOp::AVG:
+                store(s, load<double>(s) + loadNumber(type, data));
+                store(s + sizeof(double), load<int64_t>(s + sizeof(double)) + 1);
+                break;
+            case AggregateOp::MIN:
+                if (less(type, data, s)) {
+                    copyField(type, data, s);
+                }
+                break;
+            case AggregateOp::MAX:
+                if (less(type, s, data)) {
+                    copyField(type, data, s);
+                }
+                break;
+        }
+    }
+}
+
+void AggregateLayout::merge(uint8_t *state, const uint8_t *other) const {
+    for (size_t i = 0; i < aggregates.size(); i++) {
+        const type_t type = input_td.field_type(aggregates[i].field);
+        uint8_t *s = state + state_offsets[i];
+        const uint8_t *o = other + state_offsets[i];
+        switch (aggregates[i].op) {
+            case AggregateOp::COUNT:
+                store(s, load<int64_t>(s) + load<int64_t>(o));
+                break;
+            case AggregateOp::SUM:
+                store(s, load<double>(s) + load<double>(o));
+                break;
+            case AggregateOp::AVG:
+                store(s, load<double>(s) + load<double>(o));
+                store(s + sizeof(double), load<int64_t>(s + sizeof(double)) + load<int64_t>(o + sizeof(double)));
+                break;
+            case AggregateOp::MIN:
+                if (less(type, o, s)) {
+                    memcpy(s, o, fieldSize(type));
+                }
+                break;
+            case AggregateOp::MAX:
+                if (less(type, s, o)) {
+                    memcpy(s, o, fieldSize(type));
+                }
+                break;
+        }
+    }
+}
+
+void AggregateLayout::finalize(const uint8_t *key, const uint8_t *state, uint8_t *out) const {
+    memcpy(out, key, key_length);
+    for (size_t i = 0; i < aggregates.size(); i++) {
+        const uint8_t *s = state + state_offsets[i];
+        uint8_t *data = out + td.offset_of(group_fields.size() + i);
+        switch (aggregates[i].op) {
+            case AggregateOp::COUNT: {
+                const auto count = load<int64_t>(s);
+                if (count > std::numeric_limits<int>::max()) {
+                    throw std::runtime_error("COUNT does not fit in an INT");
+                }
+                store(data, static_cast<int>(count));
+                break;
+            }
+            case AggregateOp::SUM:
+                memcpy(data, s, sizeof(double));
+                break;
+            case AggregateOp::AVG:
+                store(data, load<double>(s) / static_cast<double>(load<int64_t>(s + sizeof(double))));
+                break;
+            case AggregateOp::MIN:
+            case AggregateOp::MAX:
+                memcpy(data, s, fieldSize(input_td.field_type(aggregates[i].field)));
+                break;
+        }
+    }
+}
+
+std::unique_ptr<Operator> db::groupBy(const DbFile &file, const std::vector<size_t> &group_fields,
+                                      const std::vector<Aggregate> &aggregates, size_t memory_budget) {
+    if (StreamAggregate::sortedOn(file, group_fields)) {
+        return std::make_unique<StreamAggregate>(std::make_unique<SeqScan>(file), group_fields, aggregates);
+    }
+    return std::make_unique<HashAggregate>(std::make_unique<SeqScan>(file), group_fields, aggregates, memory_budget);
+}
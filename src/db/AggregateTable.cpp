@@ -0,0 +1,75 @@
+#include <cstring>
+#include <db/AggregateTable.hpp>
+
+using namespace db;
+
+namespace {
+    constexpr size_t initial_slots = 64;
+} // namespace
+
+AggregateTable::AggregateTable(size_t key_length, size_t state_length)
+        : key_length(key_length), entry_length(key_length + state_length), slots(initial_slots, 0), count(0) {}
+
+void AggregateTable::grow() {
+    slots.assign(slots.size() * 2, 0);
+    const size_t mask = slots.size() - 1;
+    for (size_t i = 0; i < count; i++) {
+        size_t pos = hashes[i] & mask;
+        while (slots[pos] != 0) {
+            pos = (pos + 1) & mask;
+        }
+        slots[pos] = i + 1;
+    }
+}
+
+uint8_t *AggregateTable::find(const uint8_t *key, uint64_t hash) {
+    const size_t mask = slots.size() - 1;
+    for (size_t pos = hash & mask; slots[pos] != 0; pos = (pos + 1) & mask) {
+        const size_t i = slots[pos] - 1;
+        uint8_t *entry = entries.data() + i * entry_length;
+        if (hashes[i] == hash && memcmp(entry, key, key_length) == 0) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+uint8_t *AggregateTable::findOrInsert(const uint8_t *key, uint64_t hash, bool &inserted) {
+    const size_t mask = slots.size() - 1;
+    size_t pos = hash & mask;
+    for (; slots[pos] != 0; pos = (pos + 1) & mask) {
+        const size_t i = slots[pos] - 1;
+        uint8_t *entry = entries.data() + i * entry_length;
+        if (hashes[i] == hash && memcmp(entry, key, key_length) == 0) {
+            inserted = false;
+            return entry;
+        }
+    }
+    inserted = true;
+    entries.resize(entries.size() + entry_length);
+    hashes.push_back(hash);
+    slots[pos] = ++count;
+    if (2 * count > slots.size()) {
+        grow();
+    }
+    uint8_t *entry = entries.data() + (count - 1) * entry_length;
+    memcpy(entry, key, key_length);
+    return entry;
+}
+
+void AggregateTable::clear() {
+    entries.clear();
+    hashes.clear();
+    slots.assign(initial_slots, 0);
+    count = 0;
+}
+
+size_t AggregateTable::size() const { return count; }
+
+size_t AggregateTable::bytes() const {
+    return entries.capacity() + hashes.capacity() * sizeof(uint64_t) + slots.capacity() * sizeof(uint32_t);
+}
+
+uint8_t *AggregateTable::entry(size_t index) { return entries.data() + index * entry_length; }
+
+uint64_t AggregateTable::hash(size_t index) const { return hashes[index]; }
@@ -1,35 +1,1010 @@
+#include <algorithm>
 #include <cstring>
 #include <db/BTreeFile.hpp>
 #include <db/Database.hpp>
 #include <db/IndexPage.hpp>
+#include <db/KeyIndexPage.hpp>
+#include <db/KeyLeafPage.hpp>
 #include <db/LeafPage.hpp>
+#include <db/Operator.hpp>
+#include <db/ScanFilter.hpp>
+#include <deque>
+#include <memory>
 #include <stdexcept>
 
 using namespace db;
 
+namespace {
+    /// The fraction of a leaf filled by BTreeFile::bulkLoad, the rest takes later insertions without splits
+    constexpr double bulk_fill_factor = 0.9;
+
+    /// The pages of a tree whose key is a single INT field
+    struct IntLayout {
+        using key_type = int;
+
+        const TupleDesc &td;
+        size_t key_index;
+
+        IndexPage index(Page &page) const { return IndexPage(page); }
+
+        LeafPage leaf(Page &page) const { return {page, td, key_index}; }
+
+        int key(const Tuple &t) const { return std::get<int>(t.get_field(key_index)); }
+
+        int key(int key) const { return key; }
+
+        int key(const std::vector<field_t> &key) const {
+            if (key.size() != 1) {
+                throw std::logic_error("Key does not match the key fields");
+            }
+            return std::get<int>(key[0]);
+        }
+
+        int exactKey(const std::vector<field_t> &key) const { return this->key(key); }
+
+        int separator(int, int right) const { return right; }
+
+        /// The leaves of INT keys have no fences
+        void setFences(Page &, int, int) const {}
+
+        bool childOptimistic(BufferPool &bufferPool, size_t pos, uint64_t version, int key, size_t &child,
+                             bool &leaf_level) const {
+            IndexPage index(bufferPool.getFrame(pos));
+            // the page may be modified concurrently, never trust the size beyond the capacity
+            uint16_t size = std::min(index.header->size, index.capacity);
+            child = index.children[std::upper_bound(index.keys, index.keys + size, key) - index.keys];
+            leaf_level = !index.header->index_children;
+            return bufferPool.validate(pos, version);
+        }
+    };
+
+    /// The pages of a tree with a normalized key
+    struct KeyLayout {
+        using key_type = std::string;
+
+        const KeyDesc &kd;
+
+        KeyIndexPage index(Page &page) const { return {page, kd}; }
+
+        KeyLeafPage leaf(Page &page) const { return {page, kd}; }
+
+        std::string key(const Tuple &t) const { return kd.encode(t); }
+
+        std::string key(int key) const { return kd.encode(std::vector<field_t>{key}); }
+
+        std::string key(const std::vector<field_t> &key) const { return kd.encode(key); }
+
+        /// The key of a single tuple: unlike the bounds of a range, it has all the key fields
+        std::string exactKey(const std::vector<field_t> &key) const {
+            if (key.size() != kd.fields().size()) {
+                throw std::logic_error("Key does not match the key fields");
+            }
+            return kd.encode(key);
+        }
+
+        std::string separator(const std::string &left, const std::string &right) const {
+            return KeyDesc::separator(left, right);
+        }
+
+        void setFences(Page &page, const std::string &low, const std::string &high) const {
+            leaf(page).setFences(low, high);
+        }
+
+        bool childOptimistic(BufferPool &bufferPool, size_t pos, uint64_t version, const std::string &key,
+                             size_t &child, bool &leaf_level) const {
+            // the slots of a page that is modified concurrently may point anywhere, search a validated copy
+            Page page = bufferPool.getFrame(pos);
+            if (!bufferPool.validate(pos, version)) {
+                return false;
+            }
+            KeyIndexPage index(page, kd);
+            child = index.child(index.child_of(key));
+            leaf_level = !index.header->index_children;
+            return true;
+        }
+    };
+} // namespace
+
 BTreeFile::BTreeFile(const std::string &name, const TupleDesc &td, size_t key_index)
-        : DbFile(name, td), key_index(key_index) {}
+        : DbFile(name, td), key_index(key_index) {
+    if (this->td.field_type(key_index) != type_t::INT) {
+        key_desc.emplace(this->td, std::vector<size_t>{key_index});
+    }
+    findFreePages();
+}
+
+BTreeFile::BTreeFile(const std::string &name, const TupleDesc &td, const std::vector<size_t> &key_indices)
+        : DbFile(name, td), key_index(key_indices.empty() ? 0 : key_indices[0]) {
+    if (key_indices.size() != 1 || this->td.field_type(key_index) != type_t::INT) {
+        key_desc.emplace(this->td, key_indices);
+        if (!KeyLeafPage::supports(*key_desc)) {
+            throw std::logic_error("Tuples are too large for a BTreeFile");
+        }
+    }
+    findFreePages();
+}
+
+template<typename F>
+decltype(auto) BTreeFile::withLayout(F &&f) const {
+    if (key_desc.has_value()) {
+        return f(KeyLayout{*key_desc});
+    }
+    return f(IntLayout{td, key_index});
+}
+
+void BTreeFile::findFreePages() {
+    // the free pages are not stored: every page that the tree does not reach is free. Only the index pages are read,
+    // directly because the file is not registered in the database yet
+    if (numPages == root_id + 1) {
+        return;
+    }
+    std::vector<bool> reached(numPages);
+    withLayout([&](const auto &layout) {
+        Page page;
+        readPage(page, root_id);
+        if (layout.index(page).child(0) == root_id) {
+            return;
+        }
+        std::vector<size_t> index_pages{root_id};
+        while (!index_pages.empty()) {
+            readPage(page, index_pages.back());
+            index_pages.pop_back();
+            auto index = layout.index(page);
+            for (size_t pos = 0; pos <= index.header->size; pos++) {
+                const size_t child = index.child(pos);
+                if (child >= numPages) {
+                    // a page that was never written, it must not be allocated again
+                    numPages = child + 1;
+                    reached.resize(numPages);
+                }
+                reached[child] = true;
+                if (index.header->index_children) {
+                    index_pages.push_back(child);
+                }
+            }
+        }
+    });
+    // the pages with the lowest numbers are reused first
+    for (size_t page = numPages; page-- > root_id + 1;) {
+        if (!reached[page]) {
+            free_pages.push_back(page);
+        }
+    }
+}
+
+size_t BTreeFile::allocatePage() {
+    std::lock_guard lock(alloc_mutex);
+    if (!free_pages.empty()) {
+        size_t page = free_pages.back();
+        free_pages.pop_back();
+        return page;
+    }
+    return numPages++;
+}
+
+void BTreeFile::freePage(PageLatch &page) {
+    // a freed page looks like an empty leaf to scans that still reach it
+    page.page.fill(0);
+    page.markDirty();
+    std::lock_guard lock(alloc_mutex);
+    free_pages.push_back(page.pid.page);
+}
+
+template<typename Layout>
+void BTreeFile::freeLeaf(const Layout &layout, PageLatch &page) {
+    // the previous leaf links to the next leaf already, but a scan on this leaf reads its link after the merge
+    const size_t next_leaf = layout.leaf(page.page).header->next_leaf;
+    freePage(page);
+    layout.leaf(page.page).header->next_leaf = next_leaf;
+}
+
+template<typename Layout>
+std::unique_ptr<PageLatch> BTreeFile::latchLeaf(const Layout &layout, const typename Layout::key_type &key,
+                                                bool exclusive) const {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    auto node = std::make_unique<PageLatch>(bufferPool, PageId{name, root_id}, false);
+    if (layout.index(node->page).child(0) == root_id) {
+        return nullptr;
+    }
+    bool leaf_level = false;
+    while (!leaf_level) {
+        auto index = layout.index(node->page);
+        size_t child = index.child(index.child_of(key));
+        leaf_level = !index.header->index_children;
+        // latch the child before releasing the parent
+        node = std::make_unique<PageLatch>(bufferPool, PageId{name, child}, exclusive && leaf_level);
+    }
+    return node;
+}
+
+template<typename Layout>
+bool BTreeFile::insertOptimistic(const Layout &layout, const Tuple &t, const typename Layout::key_type &key) {
+    auto node = latchLeaf(layout, key, true);
+    if (node == nullptr) {
+        // the first leaf is created under an exclusive latch of the root
+        return false;
+    }
+    auto leaf = layout.leaf(node->page);
+    if (leaf.mayOverflow()) {
+        // the leaf may split, the parent has to be modified
+        return false;
+    }
+    leaf.insertTuple(t);
+    node->markDirty();
+    return true;
+}
+
+template<typename Layout>
+void BTreeFile::insertPessimistic(const Layout &layout, const Tuple &t, const typename Layout::key_type &key) {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    // a split is committed or undone as a whole, the pages are logged before the operation ends
+    const auto operation = getDatabase().startOperation();
+    // exclusive latches of the nodes that may be modified, starting from the deepest node that will not split
+    std::deque<PageLatch> path;
+    path.emplace_back(bufferPool, PageId{name, root_id}, true);
+    if (auto root = layout.index(path.back().page); root.child(0) == root_id) {
+        size_t first_leaf = allocatePage();
+        root.init(first_leaf, false);
+        path.back().markDirty();
+        PageLatch leaf(bufferPool, {name, first_leaf}, true);
+        leaf.page.fill(0);
+        leaf.markDirty();
+    }
+
+    bool leaf_level = false;
+    while (!leaf_level) {
+        auto index = layout.index(path.back().page);
+        size_t child = index.child(index.child_of(key));
+        leaf_level = !index.header->index_children;
+        path.emplace_back(bufferPool, PageId{name, child}, true);
+        bool safe;
+        if (leaf_level) {
+            safe = !layout.leaf(path.back().page).mayOverflow();
+        } else {
+            safe = !layout.index(path.back().page).mayOverflow();
+        }
+        if (safe) {
+            // a split cannot propagate above this node, release the ancestors
+            while (path.size() > 1) {
+                path.pop_front();
+            }
+        }
+    }
+
+    auto leaf = layout.leaf(path.back().page);
+    path.back().markDirty();
+    if (!leaf.insertTuple(t)) {
+        return;
+    }
+
+    size_t new_child = allocatePage();
+    typename Layout::key_type split_key;
+    {
+        PageLatch new_page(bufferPool, {name, new_child}, true);
+        auto new_leaf = layout.leaf(new_page.page);
+        split_key = leaf.split(new_leaf);
+        leaf.header->next_leaf = new_child;
+        new_page.markDirty();
+    }
+    path.pop_back();
+
+    while (true) {
+        PageLatch &parent = path.back();
+        auto index = layout.index(parent.page);
+        parent.markDirty();
+        if (!index.insert(split_key, new_child)) {
+            return;
+        }
+        if (parent.pid.page == root_id) {
+            break;
+        }
+        new_child = allocatePage();
+        PageLatch new_page(bufferPool, {name, new_child}, true);
+        auto new_index = layout.index(new_page.page);
+        split_key = index.split(new_index);
+        new_page.markDirty();
+        path.pop_back();
+    }
+
+    // The root always stays on the first page: move its contents to two new pages that become its only children
+    Page &root_page = path.back().page;
+    auto root = layout.index(root_page);
+    size_t left_id = allocatePage();
+    size_t right_id = allocatePage();
+    PageLatch left_page(bufferPool, {name, left_id}, true);
+    PageLatch right_page(bufferPool, {name, right_id}, true);
+    left_page.page = root_page;
+    auto left = layout.index(left_page.page);
+    auto right = layout.index(right_page.page);
+    auto mid = left.split(right);
+    left_page.markDirty();
+    right_page.markDirty();
+
+    root.init(left_id, true);
+    root.insert(mid, right_id);
+}
 
 void BTreeFile::insertTuple(const Tuple &t) {
     // TODO pa2
+    if (!td.compatible(t)) {
+        throw std::runtime_error("Tuple not compatible with TupleDesc");
+    }
+    withLayout([&](const auto &layout) {
+        auto key = layout.key(t);
+        if (!insertOptimistic(layout, t, key)) {
+            insertPessimistic(layout, t, key);
+        }
+    });
+}
+
+template<typename Layout>
+void BTreeFile::bulkLoad(const Layout &layout, Operator &input) {
+    using key_type = typename Layout::key_type;
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    {
+        PageLatch root(bufferPool, {name, root_id}, false);
+        if (layout.index(root.page).child(0) != root_id) {
+            throw std::logic_error("Bulk loading needs an empty BTreeFile");
+        }
+    }
+
+    // the pages of the level being built, with the separator on their left (none for the first page)
+    std::vector<std::pair<key_type, size_t>> level;
+    std::unique_ptr<PageLatch> node;
+    key_type last_key{};
+    input.open();
+    while (input.next()) {
+        const Tuple t = td.deserialize(input.row());
+        key_type key = layout.key(t);
+        if (node != nullptr && key < last_key) {
+            throw std::runtime_error("Bulk loading input is not sorted on the key");
+        }
+        // a duplicate key replaces the previous tuple, it has to go to the same leaf
+        if (node == nullptr || (key != last_key && (layout.leaf(node->page).filledTo(bulk_fill_factor) ||
+                                                    layout.leaf(node->page).mayOverflow()))) {
+            const size_t page = allocatePage();
+            auto next = std::make_unique<PageLatch>(bufferPool, PageId{name, page}, true);
+            next->page.fill(0);
+            next->markDirty();
+            if (node != nullptr) {
+                // the separators in the parents are the fences of the leaves, the leaf is compressed with them
+                key_type separator = layout.separator(last_key, key);
+                layout.leaf(node->page).header->next_leaf = page;
+                layout.setFences(node->page, level.back().first, separator);
+                layout.setFences(next->page, separator, key_type{});
+                level.emplace_back(std::move(separator), page);
+            } else {
+                level.emplace_back(key_type{}, page);
+            }
+            node = std::move(next);
+        }
+        layout.leaf(node->page).insertTuple(t);
+        last_key = std::move(key);
+    }
+    node.reset();
+    if (level.empty()) {
+        return;
+    }
+
+    bool index_children = false;
+    while (level.size() > 1) {
+        std::vector<std::pair<key_type, size_t>> parents;
+        for (auto &[separator, child]: level) {
+            if (node == nullptr || layout.index(node->page).mayOverflow()) {
+                // the separator of the first child of a page moves up to the parent
+                const size_t page = allocatePage();
+                node = std::make_unique<PageLatch>(bufferPool, PageId{name, page}, true);
+                node->page.fill(0);
+                node->markDirty();
+                layout.index(node->page).init(child, index_children);
+                parents.emplace_back(std::move(separator), page);
+            } else {
+                layout.index(node->page).insert(separator, child);
+            }
+        }
+        node.reset();
+        level = std::move(parents);
+        index_children = true;
+    }
+
+    // The root always stays on the first page: it takes the contents of the single page of the top level
+    PageLatch root(bufferPool, {name, root_id}, true);
+    if (index_children) {
+        PageLatch top(bufferPool, {name, level[0].second}, true);
+        root.page = top.page;
+        freePage(top);
+    } else {
+        layout.index(root.page).init(level[0].second, false);
+    }
+    root.markDirty();
+}
+
+void BTreeFile::bulkLoad(Operator &input) {
+    const TupleDesc &input_td = input.getTupleDesc();
+    bool compatible = input_td.size() == td.size();
+    for (size_t i = 0; compatible && i < td.size(); i++) {
+        compatible = input_td.field_type(i) == td.field_type(i);
+    }
+    if (!compatible) {
+        throw std::logic_error("Input rows do not match the tuples of the file");
+    }
+    withLayout([&](const auto &layout) { bulkLoad(layout, input); });
+}
+
+template<typename Layout>
+bool BTreeFile::deleteOptimistic(const Layout &layout, const typename Layout::key_type &key, bool &deleted) {
+    auto node = latchLeaf(layout, key, true);
+    if (node == nullptr) {
+        deleted = false;
+        return true;
+    }
+    auto leaf = layout.leaf(node->page);
+    size_t slot = leaf.lower_bound(key);
+    if (slot == leaf.header->size || leaf.key(slot) != key) {
+        deleted = false;
+        return true;
+    }
+    if (!leaf.canLend()) {
+        // the leaf may underflow, the parent and a sibling have to be modified
+        return false;
+    }
+    leaf.deleteTuple(slot);
+    node->markDirty();
+    deleted = true;
+    return true;
+}
+
+template<typename Layout>
+bool BTreeFile::rebalanceLeaf(const Layout &layout, PageLatch &node, PageLatch &parent, size_t pos) {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    auto leaf = layout.leaf(node.page);
+    auto index = layout.index(parent.page);
+    if (!leaf.underflows() || index.header->size == 0) {
+        return false;
+    }
+    node.markDirty();
+    parent.markDirty();
+    // borrow from a sibling that can lend a tuple, otherwise merge; with variable-length keys a page that does not
+    // fit in its sibling is left underfull
+    if (pos > 0) {
+        PageLatch left_page(bufferPool, {name, index.child(pos - 1)}, true);
+        auto left = layout.leaf(left_page.page);
+        left_page.markDirty();
+        if (left.canLend() && leaf.borrowFromLeft(left, index, pos)) {
+            return false;
+        }
+        if (!left.canMerge(leaf)) {
+            return false;
+        }
+        left.merge(leaf);
+        freeLeaf(layout, node);
+        index.erase(pos - 1);
+        return true;
+    }
+    PageLatch right_page(bufferPool, {name, index.child(pos + 1)}, true);
+    auto right = layout.leaf(right_page.page);
+    right_page.markDirty();
+    if (right.canLend() && leaf.borrowFromRight(right, index, pos)) {
+        return false;
+    }
+    if (!leaf.canMerge(right)) {
+        return false;
+    }
+    leaf.merge(right);
+    freeLeaf(layout, right_page);
+    index.erase(pos);
+    return true;
+}
+
+template<typename Layout>
+bool BTreeFile::rebalanceIndex(const Layout &layout, PageLatch &node, PageLatch &parent, size_t pos) {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    auto page = layout.index(node.page);
+    auto index = layout.index(parent.page);
+    if (!page.underflows() || index.header->size == 0) {
+        return false;
+    }
+    node.markDirty();
+    parent.markDirty();
+    if (pos > 0) {
+        PageLatch left_page(bufferPool, {name, index.child(pos - 1)}, true);
+        auto left = layout.index(left_page.page);
+        left_page.markDirty();
+        // rotate: the separator moves down to the page and the last key of the left sibling replaces it
+        if (left.canLend() && page.rotateFromLeft(left, index, pos)) {
+            return false;
+        }
+        typename Layout::key_type separator(index.key(pos - 1));
+        if (!left.canMerge(separator, page)) {
+            return false;
+        }
+        left.merge(separator, page);
+        freePage(node);
+        index.erase(pos - 1);
+        return true;
+    }
+    PageLatch right_page(bufferPool, {name, index.child(pos + 1)}, true);
+    auto right = layout.index(right_page.page);
+    right_page.markDirty();
+    // rotate: the separator moves down to the page and the first key of the right sibling replaces it
+    if (right.canLend() && page.rotateFromRight(right, index, pos)) {
+        return false;
+    }
+    typename Layout::key_type separator(index.key(pos));
+    if (!page.canMerge(separator, right)) {
+        return false;
+    }
+    page.merge(separator, right);
+    freePage(right_page);
+    index.erase(pos);
+    return true;
+}
+
+template<typename Layout>
+bool BTreeFile::deletePessimistic(const Layout &layout, const typename Layout::key_type &key) {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    // a merge is committed or undone as a whole, the pages are logged before the operation ends
+    const auto operation = getDatabase().startOperation();
+    // exclusive latches of the nodes that may be modified, and the position of every node in its parent
+    std::deque<PageLatch> path;
+    std::deque<size_t> positions;
+    path.emplace_back(bufferPool, PageId{name, root_id}, true);
+    positions.push_back(0);
+    if (layout.index(path.back().page).child(0) == root_id) {
+        return false;
+    }
+
+    bool leaf_level = false;
+    while (!leaf_level) {
+        auto index = layout.index(path.back().page);
+        size_t pos = index.child_of(key);
+        leaf_level = !index.header->index_children;
+        path.emplace_back(bufferPool, PageId{name, index.child(pos)}, true);
+        positions.push_back(pos);
+        bool safe;
+        if (leaf_level) {
+            safe = layout.leaf(path.back().page).canLend();
+        } else {
+            safe = layout.index(path.back().page).canLend();
+        }
+        if (safe) {
+            // an underflow cannot propagate above this node, release the ancestors
+            while (path.size() > 1) {
+                path.pop_front();
+                positions.pop_front();
+            }
+        }
+    }
+
+    auto leaf = layout.leaf(path.back().page);
+    size_t slot = leaf.lower_bound(key);
+    if (slot == leaf.header->size || leaf.key(slot) != key) {
+        return false;
+    }
+    leaf.deleteTuple(slot);
+    path.back().markDirty();
+
+    if (path.size() > 1) {
+        bool merged = rebalanceLeaf(layout, path.back(), path[path.size() - 2], positions.back());
+        path.pop_back();
+        positions.pop_back();
+        while (merged && path.size() > 1) {
+            merged = rebalanceIndex(layout, path.back(), path[path.size() - 2], positions.back());
+            path.pop_back();
+            positions.pop_back();
+        }
+    }
+
+    // The root always stays on the first page: when its only child is an index page, move the child to the root
+    if (path.size() == 1 && path.front().pid.page == root_id) {
+        PageLatch &root_page = path.front();
+        auto root = layout.index(root_page.page);
+        if (root.header->size == 0 && root.header->index_children) {
+            PageLatch child(bufferPool, {name, root.child(0)}, true);
+            root_page.page = child.page;
+            root_page.markDirty();
+            freePage(child);
+        }
+    }
+    return true;
+}
+
+template<typename Layout>
+bool BTreeFile::deleteKey(const Layout &layout, const typename Layout::key_type &key) {
+    bool deleted;
+    if (!deleteOptimistic(layout, key, deleted)) {
+        deleted = deletePessimistic(layout, key);
+    }
+    return deleted;
+}
+
+bool BTreeFile::deleteKey(int key) {
+    return withLayout([&](const auto &layout) { return deleteKey(layout, layout.key(key)); });
+}
+
+bool BTreeFile::deleteKey(const std::vector<field_t> &key) {
+    return withLayout([&](const auto &layout) { return deleteKey(layout, layout.exactKey(key)); });
 }
 
 void BTreeFile::deleteTuple(const Iterator &it) {
-    // Do not implement
+    const Tuple t = getTuple(it);
+    withLayout([&](const auto &layout) { deleteKey(layout, layout.key(t)); });
+}
+
+template<typename Layout>
+bool BTreeFile::lookupOptimistic(const Layout &layout, const typename Layout::key_type &key,
+                                 std::optional<Tuple> &result) const {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    // reads the version of a page, the hint is only written if the page moved to another frame
+    auto read = [&](size_t page, size_t &pos) {
+        std::atomic<size_t> &hint = frame_hints[page % frame_hints.size()];
+        pos = hint.load(std::memory_order_relaxed);
+        size_t old_pos = pos;
+        uint64_t version = bufferPool.readOptimistic({name, page}, *this, pos);
+        if (pos != old_pos) {
+            hint.store(pos, std::memory_order_relaxed);
+        }
+        return version;
+    };
+
+    size_t pos;
+    uint64_t version = read(root_id, pos);
+    bool leaf_level = false;
+    while (!leaf_level) {
+        if (version & 1) {
+            return false;
+        }
+        size_t child;
+        if (!layout.childOptimistic(bufferPool, pos, version, key, child, leaf_level)) {
+            return false;
+        }
+        if (child == root_id) {
+            // empty tree
+            result = std::nullopt;
+            return true;
+        }
+        size_t child_pos;
+        uint64_t child_version = read(child, child_pos);
+        // the parent must not have changed while the child was located
+        if (!bufferPool.validate(pos, version)) {
+            return false;
+        }
+        pos = child_pos;
+        version = child_version;
+    }
+    if (version & 1) {
+        return false;
+    }
+    // search a copy of the leaf, so that a tuple is never deserialized from a page that is being modified
+    Page page = bufferPool.getFrame(pos);
+    if (!bufferPool.validate(pos, version)) {
+        return false;
+    }
+    auto leaf = layout.leaf(page);
+    size_t slot = leaf.lower_bound(key);
+    if (slot == leaf.header->size || leaf.key(slot) != key) {
+        result = std::nullopt;
+    } else {
+        result = leaf.getTuple(slot);
+    }
+    return true;
+}
+
+template<typename Layout>
+std::optional<Tuple> BTreeFile::lookupKey(const Layout &layout, const typename Layout::key_type &key) const {
+    constexpr int max_restarts = 16;
+    std::optional<Tuple> result;
+    for (int i = 0; i < max_restarts; i++) {
+        if (lookupOptimistic(layout, key, result)) {
+            return result;
+        }
+    }
+    return lookupPessimistic(layout, key);
+}
+
+std::optional<Tuple> BTreeFile::lookup(int key) const {
+    return withLayout([&](const auto &layout) { return lookupKey(layout, layout.key(key)); });
+}
+
+std::optional<Tuple> BTreeFile::lookup(const std::vector<field_t> &key) const {
+    return withLayout([&](const auto &layout) { return lookupKey(layout, layout.exactKey(key)); });
+}
+
+template<typename Layout>
+std::optional<Tuple> BTreeFile::lookupPessimistic(const Layout &layout,
+                                                  const typename Layout::key_type &key) const {
+    auto node = latchLeaf(layout, key, false);
+    if (node == nullptr) {
+        return std::nullopt;
+    }
+    auto leaf = layout.leaf(node->page);
+    size_t slot = leaf.lower_bound(key);
+    if (slot == leaf.header->size || leaf.key(slot) != key) {
+        return std::nullopt;
+    }
+    return leaf.getTuple(slot);
+}
+
+Iterator BTreeFile::lowerBound(const std::vector<field_t> &key) const {
+    return withLayout([&](const auto &layout) {
+        auto encoded = layout.key(key);
+        auto node = latchLeaf(layout, encoded, false);
+        if (node == nullptr) {
+            return end();
+        }
+        auto leaf = layout.leaf(node->page);
+        Iterator it{*this, node->pid.page, leaf.lower_bound(encoded)};
+        const size_t size = leaf.header->size;
+        node.reset();
+        if (it.slot == size) {
+            // all keys of the leaf are less: let next() move past the last slot (wraps around for an empty leaf)
+            it.slot = size - 1;
+            next(it);
+        }
+        return it;
+    });
+}
+
+template<typename Layout>
+Iterator BTreeFile::subtreeStart(const Layout &layout, size_t page, bool index_page) const {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    while (index_page) {
+        PageLatch latch(bufferPool, {name, page}, false);
+        auto index = layout.index(latch.page);
+        page = index.child(0);
+        index_page = index.header->index_children;
+    }
+    Iterator it{*this, page, 0};
+    size_t size;
+    {
+        PageLatch latch(bufferPool, {name, page}, false);
+        size = layout.leaf(latch.page).header->size;
+    }
+    if (size == 0) {
+        // move to the first populated leaf, as next() does (wraps around for the empty leaf)
+        it.slot = size - 1;
+        next(it);
+    }
+    return it;
+}
+
+template<typename Layout>
+void BTreeFile::rangeBoundaries(const Layout &layout, size_t page, const typename Layout::key_type *lower,
+                                const typename Layout::key_type *upper, size_t depth,
+                                std::vector<Iterator> &boundaries) const {
+    std::vector<size_t> children;
+    bool index_children;
+    {
+        PageLatch latch(getDatabase().getBufferPool(), {name, page}, false);
+        auto index = layout.index(latch.page);
+        const size_t first = lower != nullptr ? index.child_of(*lower) : 0;
+        const size_t last = upper != nullptr ? index.child_of(*upper) : index.header->size;
+        for (size_t pos = first; pos <= last; pos++) {
+            children.push_back(index.child(pos));
+        }
+        index_children = index.header->index_children;
+    }
+    for (size_t i = 0; i < children.size(); i++) {
+        // the first child starts before the lower bound, the range starts inside it
+        if (i > 0) {
+            boundaries.push_back(subtreeStart(layout, children[i], index_children));
+        }
+        if (depth > 0 && index_children) {
+            rangeBoundaries(layout, children[i], i == 0 ? lower : nullptr, i + 1 == children.size() ? upper : nullptr,
+                            depth - 1, boundaries);
+        }
+    }
+}
+
+std::vector<Iterator> BTreeFile::splitRange(size_t parts, const std::vector<field_t> &lower,
+                                            const std::vector<field_t> &upper) const {
+    return withLayout([&](const auto &layout) {
+        using key_type = typename std::decay_t<decltype(layout)>::key_type;
+        std::optional<key_type> lower_key;
+        std::optional<key_type> upper_key;
+        if (!lower.empty()) {
+            lower_key = layout.key(lower);
+        }
+        if (!upper.empty()) {
+            upper_key = layout.key(upper);
+        }
+        std::vector<Iterator> result;
+        result.push_back(lower.empty() ? begin() : lowerBound(lower));
+        Iterator last = upper.empty() ? end() : lowerBound(upper);
+        if (result[0] == end() || (lower_key && upper_key && !(*lower_key < *upper_key))) {
+            result.push_back(result[0]);
+            return result;
+        }
+
+        size_t height = 0;
+        {
+            BufferPool &bufferPool = getDatabase().getBufferPool();
+            size_t page = root_id;
+            bool index_page = true;
+            while (index_page) {
+                PageLatch latch(bufferPool, {name, page}, false);
+                auto index = layout.index(latch.page);
+                page = index.child(0);
+                index_page = index.header->index_children;
+                height++;
+            }
+        }
+        // go down until the subtrees in the range give enough parts
+        std::vector<Iterator> boundaries;
+        for (size_t depth = 0; depth < height; depth++) {
+            boundaries.clear();
+            rangeBoundaries(layout, root_id, lower_key ? &*lower_key : nullptr, upper_key ? &*upper_key : nullptr,
+                            depth, boundaries);
+            if (boundaries.size() + 1 >= parts) {
+                break;
+            }
+        }
+        // the subtrees are assumed to have the same number of tuples
+        const size_t count = std::min(parts, boundaries.size() + 1);
+        for (size_t k = 1; k < count; k++) {
+            const Iterator &boundary = boundaries[k * (boundaries.size() + 1) / count - 1];
+            if (boundary != result.back() && boundary != last) {
+                result.push_back(boundary);
+            }
+        }
+        result.push_back(last);
+        return result;
+    });
 }
 
 Tuple BTreeFile::getTuple(const Iterator &it) const {
     // TODO pa2
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    PageLatch latch(bufferPool, {name, it.page}, false);
+    return withLayout([&](const auto &layout) { return layout.leaf(latch.page).getTuple(it.slot); });
 }
 
 void BTreeFile::next(Iterator &it) const {
     // TODO pa2
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    withLayout([&](const auto &layout) {
+        size_t next_leaf;
+        {
+            PageLatch latch(bufferPool, {name, it.page}, false);
+            auto leaf = layout.leaf(latch.page);
+            if (++it.slot < leaf.header->size) {
+                return;
+            }
+            next_leaf = leaf.header->next_leaf;
+        }
+        // the last leaf points to the root
+        while (next_leaf != root_id) {
+            PageLatch latch(bufferPool, {name, next_leaf}, false);
+            auto leaf = layout.leaf(latch.page);
+            if (leaf.header->size != 0) {
+                it.page = next_leaf;
+                it.slot = 0;
+                return;
+            }
+            next_leaf = leaf.header->next_leaf;
+        }
+        it.page = root_id;
+        it.slot = 0;
+    });
+}
+
+size_t BTreeFile::readTuples(Iterator &it, std::vector<uint8_t> &rows, const ScanFilter &filter) const {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    const size_t length = td.length();
+    size_t count = withLayout([&](const auto &layout) {
+        PageLatch latch(bufferPool, {name, it.page}, false);
+        auto leaf = layout.leaf(latch.page);
+        const size_t size = leaf.header->size;
+        const size_t first = std::min(it.slot, size);
+        const size_t offset = rows.size();
+        rows.resize(offset + (size - first) * length);
+        if constexpr (std::is_same_v<decltype(leaf), LeafPage>) {
+            memcpy(rows.data() + offset, leaf.data + first * length, (size - first) * length);
+        } else {
+            for (size_t slot = first; slot < size; slot++) {
+                td.serialize(rows.data() + offset + (slot - first) * length, leaf.getTuple(slot));
+            }
+        }
+        const size_t count = filter.compact(rows.data() + offset, size - first);
+        rows.resize(offset + count * length);
+        // continue from the last slot of the leaf
+        it.slot = size == 0 ? 0 : size - 1;
+        return count;
+    });
+    next(it);
+    return count;
+}
+
+bool BTreeFile::readPreviousLeaf(ReversePosition &position, std::vector<uint8_t> &rows,
+                                 const ScanFilter &filter) const {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    return withLayout([&](const auto &layout) {
+        auto &path = position.path;
+        if (!position.started) {
+            position.started = true;
+            PageLatch root(bufferPool, {name, root_id}, false);
+            auto index = layout.index(root.page);
+            if (index.child(0) != root_id) {
+                path.emplace_back(root_id, index.header->size + 1);
+            }
+        }
+        while (!path.empty()) {
+            auto &[page, remaining] = path.back();
+            if (remaining == 0) {
+                path.pop_back();
+                continue;
+            }
+            remaining--;
+            size_t child;
+            bool index_children;
+            {
+                PageLatch latch(bufferPool, {name, page}, false);
+                auto index = layout.index(latch.page);
+                child = index.child(remaining);
+                index_children = index.header->index_children;
+            }
+            if (index_children) {
+                PageLatch latch(bufferPool, {name, child}, false);
+                path.emplace_back(child, layout.index(latch.page).header->size + 1);
+                continue;
+            }
+            size_t size;
+            {
+                PageLatch latch(bufferPool, {name, child}, false);
+                size = layout.leaf(latch.page).header->size;
+            }
+            if (size != 0) {
+                Iterator it{*this, child, 0};
+                readTuples(it, rows, filter);
+                return true;
+            }
+        }
+        return false;
+    });
 }
 
 Iterator BTreeFile::begin() const {
     // TODO pa2
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    return withLayout([&](const auto &layout) {
+        size_t page;
+        {
+            PageLatch latch(bufferPool, {name, root_id}, false);
+            auto root = layout.index(latch.page);
+            page = root.child(0);
+            bool leaf_level = !root.header->index_children;
+            while (page != root_id && !leaf_level) {
+                PageLatch child(bufferPool, {name, page}, false);
+                auto index = layout.index(child.page);
+                page = index.child(0);
+                leaf_level = !index.header->index_children;
+            }
+        }
+        if (page == root_id) {
+            return end();
+        }
+        Iterator it{*this, page, 0};
+        bool empty;
+        {
+            PageLatch latch(bufferPool, {name, page}, false);
+            empty = layout.leaf(latch.page).header->size == 0;
+        }
+        if (empty) {
+            // the head leaf may be empty, move to the first populated leaf
+            next(it);
+        }
+        return it;
+    });
 }
 
 Iterator BTreeFile::end() const {
     // TODO pa2
+    // the root is never a leaf, so it can mark the end of the file
+    return {*this, root_id, 0};
+}
+
+size_t BTreeFile::getKeyIndex() const { return key_index; }
+
+std::vector<size_t> BTreeFile::getKeyIndices() const {
+    return key_desc.has_value() ? key_desc->fields() : std::vector<size_t>{key_index};
 }
@@ -0,0 +1,65 @@
+#include <db/BTreeScan.hpp>
+
+using namespace db;
+
+BTreeScan::BTreeScan(const BTreeFile &file, const Iterator &first, const Iterator &last)
+        : file(file), first(first), last(last), filter(file.getTupleDesc()), none(file.getTupleDesc()), count(0),
+          pos(0), current(nullptr) {}
+
+BTreeScan::BTreeScan(const BTreeFile &file) : BTreeScan(file, file.begin(), file.end()) {}
+
+std::vector<std::unique_ptr<Operator>> BTreeScan::create(const BTreeFile &file, size_t parts,
+                                                         const std::vector<field_t> &lower,
+                                                         const std::vector<field_t> &upper) {
+    const std::vector<Iterator> boundaries = file.splitRange(parts, lower, upper);
+    std::vector<std::unique_ptr<Operator>> scans;
+    for (size_t i = 0; i + 1 < boundaries.size(); i++) {
+        scans.push_back(std::make_unique<BTreeScan>(file, boundaries[i], boundaries[i + 1]));
+    }
+    return scans;
+}
+
+const TupleDesc &BTreeScan::getTupleDesc() const { return file.getTupleDesc(); }
+
+void BTreeScan::open() {
+    it.emplace(first);
+    count = 0;
+    pos = 0;
+    current = nullptr;
+}
+
+bool BTreeScan::next() {
+    const size_t length = file.getTupleDesc().length();
+    while (true) {
+        if (pos < count) {
+            current = rows.data() + pos++ * length;
+            return true;
+        }
+        if (!it.has_value() || *it == last || *it == file.end()) {
+            current = nullptr;
+            return false;
+        }
+        rows.clear();
+        pos = 0;
+        if (it->page != last.page) {
+            count = file.readTuples(*it, rows, filter);
+            continue;
+        }
+        // the part ends inside the leaf
+        const size_t slot = it->slot;
+        const size_t read = file.readTuples(*it, rows, none);
+        const size_t kept = std::min(read, last.slot - slot);
+        count = filter.compact(rows.data(), kept);
+        rows.resize(count * length);
+        it.emplace(last);
+    }
+}
+
+const uint8_t *BTreeScan::row() const { return current; }
+
+bool BTreeScan::pushDown(const Predicate &predicate) {
+    filter.add(predicate);
+    return true;
+}
+
+ScanFilter &BTreeScan::getFilter() { return filter; }
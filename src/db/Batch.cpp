@@ -0,0 +1,198 @@
+#include <cstring>
+#include <db/Batch.hpp>
+#include <numeric>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    /// Keep the selected rows whose value satisfies `keep`, without branches on the value
+    template<typename T, typename F>
+    void refine(const std::vector<T> &column, std::vector<uint32_t> &selection, size_t num_rows, F keep) {
+        size_t out = 0;
+        if (selection.size() == num_rows) {
+            // every row is selected: read the column sequentially
+            for (uint32_t row = 0; row < num_rows; row++) {
+                selection[out] = row;
+                out += keep(column[row]);
+            }
+        } else {
+            for (uint32_t row: selection) {
+                selection[out] = row;
+                out += keep(column[row]);
+            }
+        }
+        selection.resize(out);
+    }
+
+    template<typename T>
+    void refine(const std::vector<T> &column, std::vector<uint32_t> &selection, size_t num_rows, PredicateOp op,
+                const T &value) {
+        switch (op) {
+            case PredicateOp::EQ:
+                return refine(column, selection, num_rows, [&](const T &v) { return v == value; });
+            case PredicateOp::NE:
+                return refine(column, selection, num_rows, [&](const T &v) { return v != value; });
+            case PredicateOp::LT:
+                return refine(column, selection, num_rows, [&](const T &v) { return v < value; });
+            case PredicateOp::LE:
+                return refine(column, selection, num_rows, [&](const T &v) { return v <= value; });
+            case PredicateOp::GT:
+                return refine(column, selection, num_rows, [&](const T &v) { return v > value; });
+            case PredicateOp::GE:
+                return refine(column, selection, num_rows, [&](const T &v) { return v >= value; });
+        }
+    }
+
+    std::vector<size_t> allFields(const TupleDesc &td) {
+        std::vector<size_t> fields(td.size());
+        std::iota(fields.begin(), fields.end(), 0);
+        return fields;
+    }
+} // namespace
+
+Batch::Batch(const TupleDesc &td) : Batch(td, allFields(td)) {}
+
+Batch::Batch(const TupleDesc &td, const std::vector<size_t> &fields)
+        : td(td), fields(fields), num_rows(0), ints(td.size()), doubles(td.size()), strings(td.size()) {
+    for (size_t field: fields) {
+        if (field >= td.size()) {
+            throw std::logic_error("Batch field out of range");
+        }
+    }
+}
+
+size_t Batch::read(const DbFile &file, Iterator &it) { return read(file, it, ScanFilter(td)); }
+
+size_t Batch::read(const DbFile &file, Iterator &it, const ScanFilter &filter) {
+    const size_t length = td.length();
+    if (file.getTupleDesc().length() != length || file.getTupleDesc().size() != td.size()) {
+        throw std::logic_error("File does not match the batch");
+    }
+    rows.clear();
+    const Iterator last = file.end();
+    while (it != last && rows.size() < BATCH_SIZE * length) {
+        file.readTuples(it, rows, filter);
+    }
+    num_rows = rows.size() / length;
+    decode();
+    selection.resize(num_rows);
+    std::iota(selection.begin(), selection.end(), 0);
+    return num_rows;
+}
+
+void Batch::decode() {
+    const size_t length = td.length();
+    for (size_t field: fields) {
+        const uint8_t *data = rows.data() + td.offset_of(field);
+        switch (td.field_type(field)) {
+            case type_t::INT: {
+                std::vector<int> &column = ints[field];
+                column.resize(num_rows);
+                for (size_t row = 0; row < num_rows; row++) {
+                    memcpy(&column[row], data + row * length, sizeof(int));
+                }
+                break;
+            }
+            case type_t::DOUBLE: {
+                std::vector<double> &column = doubles[field];
+                column.resize(num_rows);
+                for (size_t row = 0; row < num_rows; row++) {
+                    memcpy(&column[row], data + row * length, sizeof(double));
+                }
+                break;
+            }
+            case type_t::CHAR: {
+                std::vector<std::string_view> &column = strings[field];
+                column.resize(num_rows);
+                for (size_t row = 0; row < num_rows; row++) {
+                    const char *chars = reinterpret_cast<const char *>(data + row * length);
+                    column[row] = {chars, strnlen(chars, CHAR_SIZE)};
+                }
+                break;
+            }
+        }
+    }
+}
+
+size_t Batch::size() const { return num_rows; }
+
+const std::vector<uint32_t> &Batch::getSelection() const { return selection; }
+
+const std::vector<int> &Batch::getInts(size_t field) const {
+    if (field >= td.size() || td.field_type(field) != type_t::INT || ints[field].size() != num_rows) {
+        throw std::logic_error("Field is not a decoded INT field");
+    }
+    return ints[field];
+}
+
+const std::vector<double> &Batch::getDoubles(size_t field) const {
+    if (field >= td.size() || td.field_type(field) != type_t::DOUBLE || doubles[field].size() != num_rows) {
+        throw std::logic_error("Field is not a decoded DOUBLE field");
+    }
+    return doubles[field];
+}
+
+const std::vector<std::string_view> &Batch::getStrings(size_t field) const {
+    if (field >= td.size() || td.field_type(field) != type_t::CHAR || strings[field].size() != num_rows) {
+        throw std::logic_error("Field is not a decoded CHAR field");
+    }
+    return strings[field];
+}
+
+Tuple Batch::getTuple(size_t row) const {
+    if (row >= num_rows) {
+        throw std::out_of_range("Row out of range");
+    }
+    return td.deserialize(rows.data() + row * td.length());
+}
+
+void Batch::filter(const Predicate &predicate) {
+    predicate.check(td);
+    switch (td.field_type(predicate.field)) {
+        case type_t::INT:
+            refine(getInts(predicate.field), selection, num_rows, predicate.op, std::get<int>(predicate.value));
+            break;
+        case type_t::DOUBLE:
+            refine(getDoubles(predicate.field), selection, num_rows, predicate.op, std::get<double>(predicate.value));
+            break;
+        case type_t::CHAR:
+            refine(getStrings(predicate.field), selection, num_rows, predicate.op,
+                   std::string_view(std::get<std::string>(predicate.value)));
+            break;
+    }
+}
+
+double Batch::sum(size_t field) const {
+    if (field < td.size() && td.field_type(field) == type_t::INT) {
+        const std::vector<int> &column = getInts(field);
+        int64_t sum = 0;
+        for (uint32_t row: selection) {
+            sum += column[row];
+        }
+        return static_cast<double>(sum);
+    }
+    const std::vector<double> &column = getDoubles(field);
+    double sum = 0;
+    for (uint32_t row: selection) {
+        sum += column[row];
+    }
+    return sum;
+}
+
+BatchScan::BatchScan(const DbFile &file) : file(file), filter(file.getTupleDesc()) {}
+
+const TupleDesc &BatchScan::getTupleDesc() const { return file.getTupleDesc(); }
+
+void BatchScan::open() { it.emplace(file.begin()); }
+
+bool BatchScan::next(Batch &batch) {
+    if (!it.has_value()) {
+        return false;
+    }
+    return batch.read(file, *it, filter) != 0;
+}
+
+void BatchScan::pushDown(const Predicate &predicate) { filter.add(predicate); }
+
+ScanFilter &BatchScan::getFilter() { return filter; }
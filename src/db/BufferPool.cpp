@@ -1,80 +1,282 @@
+#include <algorithm>
 #include <db/BufferPool.hpp>
 #include <db/Database.hpp>
+#include <db/LogManager.hpp>
+#include <db/Tracer.hpp>
 #include <numeric>
+#include <stdexcept>
 
 using namespace db;
 
-BufferPool::BufferPool() : available(DEFAULT_NUM_PAGES) {
+BufferPool::BufferPool()
+        : pages(DEFAULT_NUM_PAGES), pos_to_pid(DEFAULT_NUM_PAGES), available(DEFAULT_NUM_PAGES),
+          pins(DEFAULT_NUM_PAGES), reading(DEFAULT_NUM_PAGES), latches(DEFAULT_NUM_PAGES), versions(DEFAULT_NUM_PAGES),
+          frame_files(DEFAULT_NUM_PAGES), frame_pages(DEFAULT_NUM_PAGES) {
     // TODO pa0
     std::iota(available.rbegin(), available.rend(), 0);
 }
 
 BufferPool::~BufferPool() {
     // TODO pa0
+    if (log != nullptr) {
+        log->flush(log->getNextLsn());
+    }
     for (const size_t &pos: dirty) {
         const Page &page = pages[pos];
         const PageId &pid = pos_to_pid[pos];
         getDatabase().get(pid.file).writePage(page, pid.page);
+        getDatabase().getMetrics().pool_writebacks.add();
     }
 }
 
-Page &BufferPool::getPage(const PageId &pid) {
-    // TODO pa0
-    // If already in buffer pool, make it the most recent page and return it
-    if (contains(pid)) {
-        size_t pos = pid_to_pos.at(pid);
-        lru_list.splice(lru_list.begin(), lru_list, pos_to_lru[pos]);
-        pos_to_lru[pos] = lru_list.begin();
-        return pages[pos];
-    }
-
-    // If there are no available pages, evict the least recently used page. If the page is dirty, flush it to disk
-    if (available.empty()) {
-        size_t pos = lru_list.back();
-        const PageId &old_pid = pos_to_pid.at(pos);
-        if (isDirty(old_pid)) {
-            flushPage(old_pid);
+size_t BufferPool::fetch(const PageId &pid, std::unique_lock<std::recursive_mutex> &lock) {
+    Metrics &metrics = getDatabase().getMetrics();
+    while (true) {
+        // If already in buffer pool, make it the most recent page and return it once it is read
+        if (auto it = pid_to_pos.find(pid); it != pid_to_pos.end()) {
+            size_t pos = it->second;
+            if (reading[pos]) {
+                read_done.wait(lock);
+                continue;
+            }
+            metrics.pool_hits.add();
+            if (Tracer::enabled()) {
+                Tracer::countPage(false);
+            }
+            lru_list.splice(lru_list.begin(), lru_list, pos_to_lru[pos]);
+            pos_to_lru[pos] = lru_list.begin();
+            return pos;
+        }
+        if (!available.empty()) {
+            break;
+        }
+        // If there are no available pages, evict the least recently used unpinned page. A dirty page is written
+        // first, without the mutex: the pool may change meanwhile, the search starts again
+        auto victim = std::find_if(lru_list.rbegin(), lru_list.rend(),
+                                   [this](size_t pos) { return pins[pos] == 0 && !reading[pos]; });
+        if (victim == lru_list.rend()) {
+            throw std::runtime_error("All pages are pinned");
         }
-        discardPage(old_pid);
+        if (dirty.contains(*victim)) {
+            writeBack(*victim, lock);
+            continue;
+        }
+        discardPage(pos_to_pid[*victim]);
+        metrics.pool_evictions.add();
+    }
+    metrics.pool_misses.add();
+    if (Tracer::enabled()) {
+        Tracer::countPage(true);
     }
 
     // Read the page from disk to one of the available slots, make it the most recent page
     size_t pos = available.back();
     available.pop_back();
-
-    Page &page = pages[pos];
-    getDatabase().get(pid.file).readPage(page, pid.page);
+    const DbFile &file = getDatabase().get(pid.file);
     pid_to_pos[pid] = pos;
     pos_to_pid[pos] = pid;
-
     lru_list.push_front(pos);
     pos_to_lru[pos] = lru_list.begin();
 
-    return page;
+    // the frame is modified: optimistic readers of the previous page have to restart. An available frame is not
+    // pinned, no other thread holds its latch
+    std::unique_lock latch(latches[pos]);
+    versions[pos].fetch_add(1);
+    frame_files[pos].store(file.getGeneration(), std::memory_order_relaxed);
+    frame_pages[pos].store(pid.page, std::memory_order_relaxed);
+    reading[pos] = true;
+    lock.unlock();
+    try {
+        file.readPage(pages[pos], pid.page);
+    } catch (...) {
+        lock.lock();
+        reading[pos] = false;
+        versions[pos].fetch_add(1, std::memory_order_release);
+        latch.unlock();
+        discardPage(pid);
+        read_done.notify_all();
+        throw;
+    }
+    lock.lock();
+    if (log != nullptr) {
+        logged_pages[pos] = pages[pos];
+        page_lsns[pos] = 0;
+        rec_lsns[pos] = 0;
+    }
+    reading[pos] = false;
+    versions[pos].fetch_add(1, std::memory_order_release);
+    latch.unlock();
+    read_done.notify_all();
+    return pos;
+}
+
+Page &BufferPool::getPage(const PageId &pid) {
+    // TODO pa0
+    std::unique_lock lock(mutex);
+    return pages[fetch(pid, lock)];
+}
+
+Page &BufferPool::pinPage(const PageId &pid) {
+    std::unique_lock lock(mutex);
+    size_t pos = fetch(pid, lock);
+    pins[pos]++;
+    return pages[pos];
+}
+
+void BufferPool::unpinPage(const PageId &pid) {
+    std::lock_guard lock(mutex);
+    size_t pos = pid_to_pos.at(pid);
+    if (pins[pos] == 0) {
+        throw std::logic_error("Page is not pinned");
+    }
+    pins[pos]--;
+}
+
+std::shared_mutex &BufferPool::getLatch(const PageId &pid) {
+    std::lock_guard lock(mutex);
+    return latches[pid_to_pos.at(pid)];
+}
+
+std::atomic<uint64_t> &BufferPool::getVersion(const PageId &pid) {
+    std::lock_guard lock(mutex);
+    return versions[pid_to_pos.at(pid)];
+}
+
+uint64_t BufferPool::readOptimistic(const PageId &pid, const DbFile &file, size_t &hint) {
+    if (hint < versions.size()) {
+        uint64_t version = versions[hint].load(std::memory_order_acquire);
+        if (frame_files[hint].load(std::memory_order_relaxed) == file.getGeneration() &&
+            frame_pages[hint].load(std::memory_order_relaxed) == pid.page && validate(hint, version)) {
+            getDatabase().getMetrics().pool_hits.add();
+            if (Tracer::enabled()) {
+                Tracer::countPage(false);
+            }
+            return version;
+        }
+    }
+    std::unique_lock lock(mutex);
+    hint = fetch(pid, lock);
+    return versions[hint].load(std::memory_order_acquire);
+}
+
+bool BufferPool::validate(size_t pos, uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return versions[pos].load(std::memory_order_relaxed) == version;
+}
+
+Page &BufferPool::getFrame(size_t pos) { return pages[pos]; }
+
+void BufferPool::resize(size_t num_pages) {
+    std::lock_guard lock(mutex);
+    for (size_t pin: pins) {
+        if (pin != 0) {
+            throw std::logic_error("Cannot resize a buffer pool with pinned pages");
+        }
+    }
+    while (!lru_list.empty()) {
+        const PageId pid = pos_to_pid[lru_list.back()];
+        flushPage(pid);
+        discardPage(pid);
+    }
+    pages = std::vector<Page>(num_pages);
+    pos_to_pid = std::vector<PageId>(num_pages);
+    pins = std::vector<size_t>(num_pages);
+    reading = std::vector<bool>(num_pages);
+    latches = std::vector<std::shared_mutex>(num_pages);
+    versions = std::vector<std::atomic<uint64_t>>(num_pages);
+    frame_files = std::vector<std::atomic<uint64_t>>(num_pages);
+    frame_pages = std::vector<std::atomic<size_t>>(num_pages);
+    if (log != nullptr) {
+        logged_pages = std::vector<Page>(num_pages);
+        page_lsns = std::vector<uint64_t>(num_pages);
+        rec_lsns = std::vector<uint64_t>(num_pages);
+    }
+    available.resize(num_pages);
+    std::iota(available.rbegin(), available.rend(), 0);
+}
+
+size_t BufferPool::size() const {
+    std::lock_guard lock(mutex);
+    return pages.size();
+}
+
+void BufferPool::setLog(LogManager *new_log) {
+    std::lock_guard lock(mutex);
+    log = new_log;
+    if (log == nullptr) {
+        logged_pages = {};
+        page_lsns = {};
+        rec_lsns = {};
+        return;
+    }
+    logged_pages = pages;
+    page_lsns = std::vector<uint64_t>(pages.size());
+    rec_lsns = std::vector<uint64_t>(pages.size());
 }
 
 void BufferPool::markDirty(const PageId &pid) {
     // TODO pa0
+    std::lock_guard lock(mutex);
     size_t pos = pid_to_pos.at(pid);
     dirty.insert(pos);
+    if (log != nullptr) {
+        // the first change since the page was read or written carries the page: its next write may be torn
+        if (uint64_t lsn = log->logPage(pid, logged_pages[pos], pages[pos], rec_lsns[pos] == 0)) {
+            page_lsns[pos] = lsn;
+            if (rec_lsns[pos] == 0) {
+                rec_lsns[pos] = lsn;
+            }
+            logged_pages[pos] = pages[pos];
+        }
+    }
+}
+
+uint64_t BufferPool::getPageLsn(const PageId &pid) const {
+    std::lock_guard lock(mutex);
+    return log == nullptr ? 0 : page_lsns[pid_to_pos.at(pid)];
+}
+
+std::vector<DirtyPage> BufferPool::getDirtyPages(uint64_t &begin_lsn) const {
+    std::lock_guard lock(mutex);
+    if (log == nullptr) {
+        throw std::logic_error("Changes are not logged");
+    }
+    // pages are logged under the lock, no record can be appended while the table is read
+    begin_lsn = log->getNextLsn();
+    std::vector<DirtyPage> result;
+    for (const size_t &pos: dirty) {
+        if (rec_lsns[pos] != 0) {
+            result.push_back({pos_to_pid[pos], rec_lsns[pos]});
+        }
+    }
+    return result;
 }
 
 bool BufferPool::isDirty(const PageId &pid) const {
     // TODO pa0
+    std::lock_guard lock(mutex);
     size_t pos = pid_to_pos.at(pid);
     return dirty.contains(pos);
 }
 
 bool BufferPool::contains(const PageId &pid) const {
     // TODO pa0
+    std::lock_guard lock(mutex);
     return pid_to_pos.contains(pid);
 }
 
 void BufferPool::discardPage(const PageId &pid) {
     // TODO pa0
+    std::lock_guard lock(mutex);
     size_t pos = pid_to_pos.at(pid);
+    if (reading[pos]) {
+        throw std::logic_error("Cannot discard a page that is being read");
+    }
     pid_to_pos.erase(pid);
     pos_to_pid[pos] = {};
+    versions[pos].fetch_add(1);
+    frame_files[pos].store(0, std::memory_order_relaxed);
+    versions[pos].fetch_add(1, std::memory_order_release);
 
     lru_list.erase(pos_to_lru[pos]);
     pos_to_lru.erase(pos);
@@ -82,17 +284,70 @@ void BufferPool::discardPage(const PageId &pid) {
     available.push_back(pos);
 }
 
+void BufferPool::discardFile(const std::string &file) {
+    std::lock_guard lock(mutex);
+    std::vector<PageId> to_discard;
+    for (const auto &[pid, pos]: pid_to_pos) {
+        if (pid.file == file) {
+            if (pins[pos] != 0 || reading[pos]) {
+                throw std::logic_error("Cannot discard a pinned page");
+            }
+            to_discard.push_back(pid);
+        }
+    }
+    for (const PageId &pid: to_discard) {
+        discardPage(pid);
+    }
+}
+
 void BufferPool::flushPage(const PageId &pid) {
     // TODO pa0
-    size_t pos = pid_to_pos.at(pid);
-    if (dirty.erase(pos) == 0)
+    std::unique_lock lock(mutex);
+    writeBack(pid_to_pos.at(pid), lock);
+}
+
+void BufferPool::writeBack(size_t pos, std::unique_lock<std::recursive_mutex> &lock) {
+    if (!dirty.contains(pos)) {
         return;
-    const Page &page = pages[pos];
-    getDatabase().get(pid.file).writePage(page, pid.page);
+    }
+    const PageId pid = pos_to_pid[pos];
+    const DbFile &file = getDatabase().get(pid.file);
+    // the pin keeps the page in the frame while the mutex is released
+    pins[pos]++;
+    lock.unlock();
+    // the writers of the page log their changes before they release the latch: under the shared latch, the page is
+    // not modified and its LSN covers all of its changes
+    std::shared_lock latch(latches[pos]);
+    lock.lock();
+    // the page stays in the dirty page table until it is written, for the checkpoints that read the table meanwhile
+    const bool write = dirty.contains(pos);
+    LogManager *page_log = log;
+    const uint64_t lsn = log == nullptr ? 0 : page_lsns[pos];
+    lock.unlock();
+    try {
+        if (write) {
+            if (page_log != nullptr) {
+                // write-ahead: the changes of the page are durable in the log before the page is written
+                page_log->flush(lsn);
+            }
+            file.writePage(pages[pos], pid.page);
+            getDatabase().getMetrics().pool_writebacks.add();
+        }
+    } catch (...) {
+        lock.lock();
+        pins[pos]--;
+        throw;
+    }
+    lock.lock();
+    if (write && dirty.erase(pos) != 0 && log != nullptr) {
+        rec_lsns[pos] = 0;
+    }
+    pins[pos]--;
 }
 
 void BufferPool::flushFile(const std::string &file) {
     // TODO pa0
+    std::unique_lock lock(mutex);
     std::vector<size_t> to_flush;
     for (const size_t &pos: dirty) {
         const PageId &pid = pos_to_pid[pos];
@@ -101,6 +356,36 @@ void BufferPool::flushFile(const std::string &file) {
         }
     }
     for (const auto &page: to_flush) {
-        flushPage({file, page});
+        // the page may have been written and evicted while the mutex was released
+        if (auto it = pid_to_pos.find({file, page}); it != pid_to_pos.end()) {
+            writeBack(it->second, lock);
+        }
     }
 }
+
+PageLatch::PageLatch(BufferPool &pool, const PageId &pid, bool exclusive)
+        : pool(pool), exclusive(exclusive), dirty(false), pid(pid), page(pool.pinPage(pid)) {
+    latch = &pool.getLatch(pid);
+    version = &pool.getVersion(pid);
+    if (exclusive) {
+        latch->lock();
+        version->fetch_add(1);
+    } else {
+        latch->lock_shared();
+    }
+}
+
+PageLatch::~PageLatch() {
+    if (dirty) {
+        pool.markDirty(pid);
+    }
+    if (exclusive) {
+        version->fetch_add(1, std::memory_order_release);
+        latch->unlock();
+    } else {
+        latch->unlock_shared();
+    }
+    pool.unpinPage(pid);
+}
+
+void PageLatch::markDirty() { dirty = true; }
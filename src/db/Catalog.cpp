@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/Catalog.hpp>
+#include <db/HashFile.hpp>
+#include <db/SecondaryIndex.hpp>
+#include <db/VersionedHeapFile.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    const TupleDesc catalog_td({type_t::CHAR, type_t::INT, type_t::INT, type_t::CHAR, type_t::INT, type_t::DOUBLE},
+                               {"name", "seq", "kind", "text", "value", "number"});
+
+    void checkName(const std::string &name) {
+        if (name.size() >= CHAR_SIZE) {
+            throw std::logic_error("Name is too long for the catalog: " + name);
+        }
+    }
+
+    /// The row of a value in the statistics of a file, in the field of its type
+    Tuple statisticsRow(const std::string &name, int seq, const field_t &value) {
+        std::string text;
+        int number = 0;
+        double real = 0;
+        if (std::holds_alternative<std::string>(value)) {
+            text = std::get<std::string>(value);
+            checkName(text);
+        } else if (std::holds_alternative<int>(value)) {
+            number = std::get<int>(value);
+        } else {
+            real = std::get<double>(value);
+        }
+        return {{name, seq, static_cast<int>(value.index()), text, number, real}};
+    }
+
+    field_t statisticsValue(const Tuple &row) {
+        switch (std::get<int>(row.get_field(2))) {
+            case 0:
+                return row.get_field(4);
+            case 1:
+                return row.get_field(5);
+            default:
+                return row.get_field(3);
+        }
+    }
+
+    /// Call f with every row of a file in the catalog from a sequence number, in order of sequence number
+    template<typename F>
+    void forEachRow(const BTreeFile &file, const std::string &name, F &&f, int first = 0) {
+        for (Iterator it = file.lowerBound({name, first}); it != file.end(); file.next(it)) {
+            const Tuple row = file.getTuple(it);
+            if (std::get<std::string>(row.get_field(0)) != name) {
+                break;
+            }
+            f(row);
+        }
+    }
+} // namespace
+
+const TupleDesc &Catalog::getTupleDesc() { return catalog_td; }
+
+Catalog::Catalog(BTreeFile &file) : file(file) {
+    const TupleDesc &td = file.getTupleDesc();
+    bool compatible = td.size() == catalog_td.size() && file.getKeyIndices() == std::vector<size_t>{0, 1};
+    for (size_t i = 0; compatible && i < td.size(); i++) {
+        compatible = td.field_type(i) == catalog_td.field_type(i);
+    }
+    if (!compatible) {
+        throw std::logic_error("File is not a catalog");
+    }
+}
+
+const BTreeFile &Catalog::getFile() const { return file; }
+
+std::vector<int> Catalog::sequenceNumbers(const std::string &name, int first, int last) const {
+    std::vector<int> result;
+    forEachRow(
+            file, name,
+            [&](const Tuple &row) {
+                const int seq = std::get<int>(row.get_field(1));
+                if (seq < last) {
+                    result.push_back(seq);
+                }
+            },
+            first);
+    return result;
+}
+
+void Catalog::eraseRows(const std::string &name, int first, int last) {
+    for (int seq: sequenceNumbers(name, first, last)) {
+        file.deleteKey({name, seq});
+    }
+}
+
+bool Catalog::record(const DbFile &f) {
+    const std::string &name = f.getName();
+    FileKind kind;
+    std::vector<size_t> key_fields;
+    std::string table;
+    size_t field = 0;
+    std::chrono::milliseconds gc_interval{};
+    // the subclasses first
+    if (const auto *index = dynamic_cast<const SecondaryIndex *>(&f)) {
+        kind = FileKind::SECONDARY_INDEX;
+        table = index->getTable();
+        field = index->getField();
+    } else if (const auto *btree = dynamic_cast<const BTreeFile *>(&f)) {
+        kind = FileKind::BTREE;
+        key_fields = btree->getKeyIndices();
+    } else if (const auto *hash = dynamic_cast<const HashFile *>(&f)) {
+        kind = FileKind::HASH;
+        key_fields = hash->getKeyIndices();
+    } else if (const auto *versioned = dynamic_cast<const VersionedHeapFile *>(&f)) {
+        kind = FileKind::VERSIONED_HEAP;
+        gc_interval = versioned->getGcInterval();
+    } else if (dynamic_cast<const HeapFile *>(&f) != nullptr) {
+        kind = FileKind::HEAP;
+    } else {
+        return false;
+    }
+    checkName(name);
+    checkName(table);
+    const TupleDesc &td = f.getTupleDesc();
+    for (size_t i = 0; i < td.size(); i++) {
+        checkName(td.field_name(i));
+    }
+
+    eraseRows(name, 0, INDEX_SEQ);
+    file.insertTuple({{name, 0, static_cast<int>(kind), table, static_cast<int>(field),
+                       static_cast<double>(gc_interval.count())}});
+    for (size_t i = 0; i < td.size(); i++) {
+        const auto key_position = std::find(key_fields.begin(), key_fields.end(), i);
+        const int position =
+                key_position == key_fields.end() ? -1 : static_cast<int>(key_position - key_fields.begin());
+        file.insertTuple({{name, static_cast<int>(i + 1), static_cast<int>(td.field_type(i)), td.field_name(i),
+                           position, 0.0}});
+    }
+    return true;
+}
+
+void Catalog::addIndex(const std::string &table, const std::string &index) {
+    checkName(index);
+    int seq = INDEX_SEQ;
+    bool found = false;
+    forEachRow(file, table, [&](const Tuple &row) {
+        const int row_seq = std::get<int>(row.get_field(1));
+        if (row_seq >= INDEX_SEQ && row_seq < STATS_SEQ) {
+            found = found || std::get<std::string>(row.get_field(3)) == index;
+            seq = row_seq + 1;
+        }
+    });
+    if (!found) {
+        file.insertTuple({{table, seq, 0, index, 0, 0.0}});
+    }
+}
+
+void Catalog::dropIndexes(const std::string &table) { eraseRows(table, INDEX_SEQ, STATS_SEQ); }
+
+void Catalog::setStatistics(const std::string &name, const TableStatistics &stats) {
+    const std::optional<CatalogEntry> entry = find(name);
+    if (!entry.has_value()) {
+        throw std::logic_error("File is not in the catalog: " + name);
+    }
+    if (stats.columns.size() != entry->td.size()) {
+        throw std::logic_error("Statistics do not match the file");
+    }
+    std::vector<Tuple> rows;
+    rows.push_back({{name, STATS_SEQ, 0, std::string(), static_cast<int>(stats.pages), stats.rows}});
+    for (size_t i = 0; i < stats.columns.size(); i++) {
+        const ColumnStatistics &column = stats.columns[i];
+        if (column.bounds.size() > MAX_BUCKETS) {
+            throw std::logic_error("Histogram has too many buckets");
+        }
+        // the distinct count, then the smallest and largest values if there are values, then the bounds
+        const int seq = STATS_SEQ + static_cast<int>(i + 1) * STATS_COLUMN_ROWS;
+        rows.push_back({{name, seq, 0, std::string(), static_cast<int>(column.bounds.size()), column.distinct}});
+        if (column.min.has_value() && column.max.has_value()) {
+            rows.push_back(statisticsRow(name, seq + 1, *column.min));
+            rows.push_back(statisticsRow(name, seq + 2, *column.max));
+        }
+        for (size_t j = 0; j < column.bounds.size(); j++) {
+            rows.push_back(statisticsRow(name, seq + 3 + static_cast<int>(j), column.bounds[j]));
+        }
+    }
+
+    dropStatistics(name);
+    for (const Tuple &row: rows) {
+        file.insertTuple(row);
+    }
+}
+
+std::optional<TableStatistics> Catalog::getStatistics(const std::string &name) const {
+    std::optional<TableStatistics> stats;
+    forEachRow(
+            file, name,
+            [&](const Tuple &row) {
+                const int seq = std::get<int>(row.get_field(1));
+                if (seq == STATS_SEQ) {
+                    stats.emplace();
+                    stats->pages = std::get<int>(row.get_field(4));
+                    stats->rows = std::get<double>(row.get_field(5));
+                    return;
+                }
+                const int position = (seq - STATS_SEQ) % STATS_COLUMN_ROWS;
+                if (position == 0) {
+                    stats->columns.emplace_back().distinct = std::get<double>(row.get_field(5));
+                } else if (position == 1) {
+                    stats->columns.back().min = statisticsValue(row);
+                } else if (position == 2) {
+                    stats->columns.back().max = statisticsValue(row);
+                } else {
+                    stats->columns.back().bounds.push_back(statisticsValue(row));
+                }
+            },
+            STATS_SEQ);
+    return stats;
+}
+
+void Catalog::dropStatistics(const std::string &name) { eraseRows(name, STATS_SEQ); }
+
+std::optional<CatalogEntry> Catalog::find(const std::string &name) const {
+    std::optional<CatalogEntry> entry;
+    std::vector<type_t> types;
+    std::vector<std::string> names;
+    std::vector<std::pair<int, size_t>> key_positions;
+    forEachRow(file, name, [&](const Tuple &row) {
+        const int seq = std::get<int>(row.get_field(1));
+        const int kind = std::get<int>(row.get_field(2));
+        const auto &text = std::get<std::string>(row.get_field(3));
+        const int value = std::get<int>(row.get_field(4));
+        if (seq == 0) {
+            entry.emplace();
+            entry->name = name;
+            entry->kind = static_cast<FileKind>(kind);
+            entry->table = text;
+            entry->field = value;
+            entry->gc_interval = std::chrono::milliseconds(static_cast<int64_t>(std::get<double>(row.get_field(5))));
+        } else if (seq < INDEX_SEQ) {
+            types.push_back(static_cast<type_t>(kind));
+            names.push_back(text);
+            if (value >= 0) {
+                key_positions.emplace_back(value, types.size() - 1);
+            }
+        } else if (seq < STATS_SEQ && entry.has_value()) {
+            entry->indexes.push_back(text);
+        }
+    });
+    if (entry.has_value()) {
+        entry->td = TupleDesc(types, names);
+        std::sort(key_positions.begin(), key_positions.end());
+        for (const auto &[position, field]: key_positions) {
+            entry->key_fields.push_back(field);
+        }
+    }
+    return entry;
+}
+
+bool Catalog::erase(const std::string &name) {
+    const std::optional<CatalogEntry> entry = find(name);
+    if (!entry.has_value()) {
+        return false;
+    }
+    eraseRows(name, 0);
+    if (entry->kind == FileKind::SECONDARY_INDEX) {
+        std::vector<int> references;
+        forEachRow(file, entry->table, [&](const Tuple &row) {
+            const int seq = std::get<int>(row.get_field(1));
+            if (seq >= INDEX_SEQ && seq < STATS_SEQ && std::get<std::string>(row.get_field(3)) == name) {
+                references.push_back(std::get<int>(row.get_field(1)));
+            }
+        });
+        for (int seq: references) {
+            file.deleteKey({entry->table, seq});
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> Catalog::getNames() const {
+    std::vector<std::string> names;
+    for (Iterator it = file.begin(); it != file.end(); file.next(it)) {
+        const Tuple row = file.getTuple(it);
+        if (std::get<int>(row.get_field(1)) == 0) {
+            names.push_back(std::get<std::string>(row.get_field(0)));
+        }
+    }
+    return names;
+}
+
+std::unique_ptr<DbFile> Catalog::open(const CatalogEntry &entry) const {
+    switch (entry.kind) {
+        case FileKind::HEAP:
+            return std::make_unique<HeapFile>(entry.name, entry.td);
+        case FileKind::VERSIONED_HEAP:
+            return std::make_unique<VersionedHeapFile>(entry.name, entry.td, entry.gc_interval);
+        case FileKind::BTREE:
+            return std::make_unique<BTreeFile>(entry.name, entry.td, entry.key_fields);
+        case FileKind::HASH:
+            return std::make_unique<HashFile>(entry.name, entry.td, entry.key_fields);
+        case FileKind::SECONDARY_INDEX: {
+            const std::optional<CatalogEntry> table = find(entry.table);
+            if (!table.has_value()) {
+                throw std::logic_error("Table of the index is not in the catalog: " + entry.table);
+            }
+            return std::make_unique<SecondaryIndex>(entry.name, entry.table, table->td, entry.field);
+        }
+    }
+    throw std::logic_error("Unknown file kind");
+}
@@ -0,0 +1,118 @@
+#include <array>
+#include <cstring>
+#include <db/Crc32c.hpp>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DB_CRC_X86 1
+#include <nmmintrin.h>
+#endif
+
+using namespace db;
+
+namespace {
+    /// The Castagnoli polynomial, bit-reversed
+    constexpr uint32_t POLYNOMIAL = 0x82F63B78;
+
+    /// The bytes of each stream of a block of three interleaved streams, 3 blocks fit in a page
+    constexpr size_t STREAM_BYTES = 1360;
+
+    constexpr std::array<uint32_t, 256> makeTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t c = b;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? (c >> 1) ^ POLYNOMIAL : c >> 1;
+            }
+            table[b] = c;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> table = makeTable();
+
+    uint32_t updateScalar(uint32_t c, const uint8_t *data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+        }
+        return c;
+    }
+
+    /**
+     * The CRC of a stream is linear in its initial value: the CRC of `a || b` is the CRC of `b` started at 0, XORed
+     * with the CRC of `a` advanced over `|b|` zero bytes. The advance over STREAM_BYTES bytes is tabulated per byte of
+     * the value.
+     */
+    class StreamShift {
+        std::array<std::array<uint32_t, 256>, 4> bytes;
+
+    public:
+        StreamShift() {
+            std::array<uint32_t, 32> bits{};
+            const std::array<uint8_t, STREAM_BYTES> zeros{};
+            for (size_t i = 0; i < 32; i++) {
+                bits[i] = updateScalar(uint32_t{1} << i, zeros.data(), zeros.size());
+            }
+            for (size_t k = 0; k < 4; k++) {
+                for (size_t b = 0; b < 256; b++) {
+                    uint32_t c = 0;
+                    for (size_t i = 0; i < 8; i++) {
+                        if (b >> i & 1) {
+                            c ^= bits[8 * k + i];
+                        }
+                    }
+                    bytes[k][b] = c;
+                }
+            }
+        }
+
+        uint32_t operator()(uint32_t c) const {
+            return bytes[0][c & 0xFF] ^ bytes[1][c >> 8 & 0xFF] ^ bytes[2][c >> 16 & 0xFF] ^ bytes[3][c >> 24];
+        }
+    };
+
+#ifdef DB_CRC_X86
+    uint64_t load(const uint8_t *data) {
+        uint64_t v;
+        memcpy(&v, data, sizeof(v));
+        return v;
+    }
+
+    __attribute__((target("sse4.2")))
+    uint32_t updateSse42(uint32_t c, const uint8_t *data, size_t length) {
+        static const StreamShift shift;
+        // the instruction has a latency of 3 cycles and a throughput of 1 per cycle
+        while (length >= 3 * STREAM_BYTES) {
+            uint64_t c0 = c;
+            uint64_t c1 = 0;
+            uint64_t c2 = 0;
+            for (size_t i = 0; i < STREAM_BYTES; i += sizeof(uint64_t)) {
+                c0 = _mm_crc32_u64(c0, load(data + i));
+                c1 = _mm_crc32_u64(c1, load(data + STREAM_BYTES + i));
+                c2 = _mm_crc32_u64(c2, load(data + 2 * STREAM_BYTES + i));
+            }
+            c = shift(shift(static_cast<uint32_t>(c0)) ^ static_cast<uint32_t>(c1)) ^ static_cast<uint32_t>(c2);
+            data += 3 * STREAM_BYTES;
+            length -= 3 * STREAM_BYTES;
+        }
+        uint64_t c64 = c;
+        for (; length >= sizeof(uint64_t); data += sizeof(uint64_t), length -= sizeof(uint64_t)) {
+            c64 = _mm_crc32_u64(c64, load(data));
+        }
+        c = static_cast<uint32_t>(c64);
+        for (; length > 0; data++, length--) {
+            c = _mm_crc32_u8(c, *data);
+        }
+        return c;
+    }
+#endif
+} // namespace
+
+uint32_t db::crc32c(const void *data, size_t length, uint32_t crc) {
+    const auto *bytes = static_cast<const uint8_t *>(data);
+#ifdef DB_CRC_X86
+    if (__builtin_cpu_supports("sse4.2")) {
+        return ~updateSse42(~crc, bytes, length);
+    }
+#endif
+    return ~updateScalar(~crc, bytes, length);
+}
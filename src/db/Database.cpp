@@ -1,34 +1,240 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
 #include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/SecondaryIndex.hpp>
 
 using namespace db;
 
 BufferPool &Database::getBufferPool() { return bufferPool; }
 
+void Database::setLog(std::unique_ptr<LogManager> new_log) {
+    bufferPool.setLog(new_log.get());
+    // closing the previous log makes all its records durable, the dirty pages that it logged can still be written
+    log = std::move(new_log);
+}
+
+LogManager *Database::getLog() const { return log.get(); }
+
+std::shared_lock<std::shared_mutex> Database::startOperation() const {
+    return log == nullptr ? std::shared_lock<std::shared_mutex>() : log->startOperation();
+}
+
+VersionClock &Database::getVersionClock() { return versionClock; }
+
+Metrics &Database::getMetrics() { return metrics; }
+
+void Database::checkpoint() {
+    if (log == nullptr) {
+        throw std::logic_error("Changes are not logged");
+    }
+    uint64_t begin_lsn;
+    const std::vector<DirtyPage> dirty_pages = bufferPool.getDirtyPages(begin_lsn);
+    for (const auto &[name, file]: files) {
+        file->sync();
+    }
+    {
+        std::shared_lock lock(opened_mutex);
+        for (const auto &[name, file]: opened) {
+            file->sync();
+        }
+    }
+    log->checkpoint(dirty_pages, begin_lsn);
+}
+
 Database &db::getDatabase() {
     static Database instance;
     return instance;
 }
 
+void Database::openCatalog(const std::string &name) {
+    if (catalog != nullptr) {
+        throw std::logic_error("A catalog is open");
+    }
+    add(std::make_unique<BTreeFile>(name, Catalog::getTupleDesc(), std::vector<size_t>{0, 1}));
+    try {
+        catalog = std::make_unique<Catalog>(dynamic_cast<BTreeFile &>(*files.at(name)));
+    } catch (...) {
+        remove(name);
+        throw;
+    }
+}
+
+void Database::closeCatalog() {
+    if (catalog == nullptr) {
+        throw std::logic_error("There is no catalog");
+    }
+    std::vector<std::string> names;
+    {
+        std::shared_lock lock(opened_mutex);
+        for (const auto &[name, file]: opened) {
+            names.push_back(name);
+        }
+    }
+    for (const std::string &name: names) {
+        remove(name);
+    }
+    const std::string name = catalog->getFile().getName();
+    catalog.reset();
+    remove(name);
+}
+
+Catalog *Database::getCatalog() const { return catalog.get(); }
+
+TableStatistics Database::analyze(const std::string &name, size_t workers, double sample) {
+    TableStatistics stats = TableStatistics::collect(get(name), workers, sample);
+    if (catalog != nullptr && catalog->find(name).has_value()) {
+        catalog->setStatistics(name, stats);
+    }
+    return stats;
+}
+
 void Database::add(std::unique_ptr<DbFile> file) {
     // TODO pa0
     const std::string &name = file->getName();
-    if (files.contains(name)) {
+    if (find(name) != nullptr) {
         throw std::logic_error("File already exists");
     }
+    // a file that cannot be described is not added
+    if (catalog != nullptr) {
+        catalog->record(*file);
+    }
     files[name] = std::move(file);
 }
 
+void Database::addIndex(std::unique_ptr<SecondaryIndex> index) {
+    const std::string &table_name = index->getTable();
+    DbFile *file = find(table_name);
+    if (file == nullptr && catalog != nullptr && catalog->find(table_name).has_value()) {
+        file = &get(table_name);
+    }
+    auto *table = dynamic_cast<HeapFile *>(file);
+    if (table == nullptr) {
+        throw std::logic_error("Table is not a HeapFile");
+    }
+    SecondaryIndex &ref = *index;
+    const std::string index_name = ref.getName();
+    // the index is filled through the BufferPool, it must be registered first
+    add(std::move(index));
+    try {
+        table->addIndex(ref);
+    } catch (...) {
+        remove(index_name);
+        if (catalog != nullptr) {
+            catalog->erase(index_name);
+        }
+        throw;
+    }
+    if (catalog != nullptr) {
+        catalog->addIndex(table_name, ref.getName());
+    }
+}
+
 std::unique_ptr<DbFile> Database::remove(const std::string &name) {
     // TODO pa0
-    auto nh = files.extract(name);
-    if (nh.empty()) {
+    if (find(name) == nullptr) {
         throw std::logic_error("File does not exist");
     }
-    Database::getBufferPool().flushFile(nh.key());
-    return std::move(nh.mapped());
+    // dirty pages are written through the file, flush them while it is still registered. The frames are dropped: a
+    // file added later with the same name must read its own pages
+    Database::getBufferPool().flushFile(name);
+    Database::getBufferPool().discardFile(name);
+    std::unique_ptr<DbFile> file;
+    if (files.contains(name)) {
+        file = std::move(files.extract(name).mapped());
+    } else {
+        std::unique_lock lock(opened_mutex);
+        file = std::move(opened.extract(name).mapped());
+    }
+    if (auto *index = dynamic_cast<SecondaryIndex *>(file.get())) {
+        if (auto *table = dynamic_cast<HeapFile *>(find(index->getTable()))) {
+            table->removeIndex(*index);
+        }
+    }
+    return file;
+}
+
+DbFile *Database::find(const std::string &name) const {
+    if (auto it = files.find(name); it != files.end()) {
+        return it->second.get();
+    }
+    std::shared_lock lock(opened_mutex);
+    auto it = opened.find(name);
+    return it == opened.end() ? nullptr : it->second.get();
+}
+
+DbFile &Database::open(const std::string &name) const {
+    std::lock_guard lock(open_mutex);
+    if (DbFile *file = find(name)) {
+        // opened by another thread meanwhile
+        return *file;
+    }
+    const std::optional<CatalogEntry> entry = catalog->find(name);
+    if (entry.has_value()) {
+        // a table is opened with its indexes, which were kept up to date with it
+        const bool index = entry->kind == FileKind::SECONDARY_INDEX;
+        const std::string &table_name = index ? entry->table : name;
+        DbFile *table = find(table_name);
+        std::vector<std::unique_ptr<DbFile>> new_files;
+        if (table == nullptr) {
+            const std::optional<CatalogEntry> table_entry = index ? catalog->find(table_name) : entry;
+            if (!table_entry.has_value()) {
+                throw std::logic_error("Table of the index is not in the catalog: " + table_name);
+            }
+            new_files.push_back(catalog->open(*table_entry));
+            table = new_files.back().get();
+            for (const std::string &index_name: table_entry->indexes) {
+                const std::optional<CatalogEntry> index_entry = catalog->find(index_name);
+                if (index_entry.has_value() && find(index_name) == nullptr) {
+                    new_files.push_back(catalog->open(*index_entry));
+                    if (auto *heap = dynamic_cast<HeapFile *>(table)) {
+                        heap->addIndex(dynamic_cast<SecondaryIndex &>(*new_files.back()), false);
+                    }
+                }
+            }
+        }
+        // an index that was not opened with its table is filled with the tuples of the table once it is registered
+        std::unique_ptr<DbFile> lone_index;
+        const auto is_requested = [&](const auto &file) { return file->getName() == name; };
+        if (index && std::none_of(new_files.begin(), new_files.end(), is_requested)) {
+            lone_index = catalog->open(*entry);
+        }
+        SecondaryIndex *fill = dynamic_cast<SecondaryIndex *>(lone_index.get());
+        {
+            std::unique_lock opened_lock(opened_mutex);
+            for (auto &file: new_files) {
+                const std::string &file_name = file->getName();
+                opened[file_name] = std::move(file);
+            }
+            if (lone_index != nullptr) {
+                opened[name] = std::move(lone_index);
+            }
+        }
+        if (fill != nullptr) {
+            if (auto *heap = dynamic_cast<HeapFile *>(table)) {
+                heap->addIndex(*fill);
+            }
+        }
+    }
+    if (DbFile *file = find(name)) {
+        return *file;
+    }
+    throw std::out_of_range("File does not exist: " + name);
 }
 
 DbFile &Database::get(const std::string &name) const {
     // TODO pa0
+    if (auto it = files.find(name); it != files.end()) {
+        return *it->second;
+    }
+    if (catalog != nullptr) {
+        {
+            std::shared_lock lock(opened_mutex);
+            if (auto it = opened.find(name); it != opened.end()) {
+                return *it->second;
+            }
+        }
+        return open(name);
+    }
     return *files.at(name);
 }
@@ -1,4 +1,8 @@
+#include <db/Database.hpp>
 #include <db/DbFile.hpp>
+#include <db/PageFormat.hpp>
+#include <db/ScanFilter.hpp>
+#include <db/Tracer.hpp>
 #include <stdexcept>
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -6,9 +10,21 @@
 
 using namespace db;
 
+namespace {
+    std::atomic<uint64_t> next_generation{1};
+
+    void trace(std::mutex &mutex, std::vector<size_t> &ids, size_t first, size_t count) {
+        std::lock_guard lock(mutex);
+        for (size_t id = first; id < first + count && ids.size() < DbFile::TRACE_LIMIT; id++) {
+            ids.push_back(id);
+        }
+    }
+} // namespace
+
 const TupleDesc &DbFile::getTupleDesc() const { return td; }
 
-DbFile::DbFile(const std::string &name, const TupleDesc &td) : name(name), td(td) {
+DbFile::DbFile(const std::string &name, const TupleDesc &td)
+        : generation(next_generation.fetch_add(1, std::memory_order_relaxed)), name(name), td(td) {
     // TODO pa1: open file and initialize numPages
     // Hint: use open, fstat
     fd = open(name.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
@@ -19,7 +35,7 @@ DbFile::DbFile(const std::string &name, const TupleDesc &td) : name(name), td(td
     if (fstat(fd, &st) == -1) {
         throw std::runtime_error("fstat");
     }
-    numPages = st.st_size / DEFAULT_PAGE_SIZE;
+    numPages = storedPages(st.st_size);
     if (numPages == 0) {
         numPages = 1;
     }
@@ -33,19 +49,52 @@ DbFile::~DbFile() {
 
 const std::string &DbFile::getName() const { return name; }
 
+uint64_t DbFile::getGeneration() const { return generation; }
+
 void DbFile::readPage(Page &page, const size_t id) const {
-    reads.push_back(id);
     // TODO pa1: read page
     // Hint: use pread
-    std::fill(page.begin(), page.end(), 0);
-    pread(fd, page.data(), DEFAULT_PAGE_SIZE, id * DEFAULT_PAGE_SIZE);
+    readPages(page.data(), id, 1);
 }
 
 void DbFile::writePage(const Page &page, const size_t id) const {
-    writes.push_back(id);
     // TODO pa1: write page
     // Hint: use pwrite
-    pwrite(fd, page.data(), DEFAULT_PAGE_SIZE, id * DEFAULT_PAGE_SIZE);
+    writePages(page.data(), id, 1);
+}
+
+void DbFile::readPages(uint8_t *data, size_t first, size_t count) const {
+    trace(trace_mutex, reads, first, count);
+    Metrics &metrics = getDatabase().getMetrics();
+    {
+        TraceSpan span("read", "io");
+        span.arg("page", first);
+        span.arg("pages", count);
+        LatencyTimer timer(metrics.read_latency);
+        readStoredPages(fd, name, data, first, count);
+    }
+    metrics.pages_read.add(count);
+    metrics.bytes_read.add(count * (DEFAULT_PAGE_SIZE + PAGE_HEADER_SIZE));
+}
+
+void DbFile::writePages(const uint8_t *data, size_t first, size_t count) const {
+    trace(trace_mutex, writes, first, count);
+    Metrics &metrics = getDatabase().getMetrics();
+    {
+        TraceSpan span("write", "io");
+        span.arg("page", first);
+        span.arg("pages", count);
+        LatencyTimer timer(metrics.write_latency);
+        writeStoredPages(fd, data, first, count);
+    }
+    metrics.pages_written.add(count);
+    metrics.bytes_written.add(count * (DEFAULT_PAGE_SIZE + PAGE_HEADER_SIZE));
+}
+
+void DbFile::sync() const {
+    if (fdatasync(fd) == -1) {
+        throw std::runtime_error("fdatasync");
+    }
 }
 
 const std::vector<size_t> &DbFile::getReads() const { return reads; }
@@ -64,4 +113,23 @@ Iterator DbFile::begin() const { throw std::runtime_error("Not implemented"); }
 
 Iterator DbFile::end() const { throw std::runtime_error("Not implemented"); }
 
+size_t DbFile::readTuples(Iterator &it, std::vector<uint8_t> &rows, const ScanFilter &filter) const {
+    const size_t length = td.length();
+    const size_t page = it.page;
+    const Iterator last = end();
+    size_t count = 0;
+    do {
+        const size_t offset = rows.size();
+        rows.resize(offset + length);
+        td.serialize(rows.data() + offset, getTuple(it));
+        if (filter.test(rows.data() + offset)) {
+            count++;
+        } else {
+            rows.resize(offset);
+        }
+        next(it);
+    } while (it != last && it.page == page);
+    return count;
+}
+
 size_t DbFile::getNumPages() const { return numPages; }
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstring>
+#include <db/Database.hpp>
+#include <db/ExternalSort.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+ExternalSort::ExternalSort(std::unique_ptr<Operator> child, const std::vector<SortField> &fields,
+                           size_t memory_budget, size_t block_pages)
+        : child(std::move(child)), memory_budget(memory_budget), block_pages(std::max<size_t>(block_pages, 1)),
+          sort_key(this->child->getTupleDesc(), fields), key_length(sort_key.length()), num_runs(0), pending(false),
+          pos(0) {}
+
+size_t ExternalSort::defaultBudget() { return getDatabase().getBufferPool().size() * DEFAULT_PAGE_SIZE / 4; }
+
+const TupleDesc &ExternalSort::getTupleDesc() const { return child->getTupleDesc(); }
+
+void ExternalSort::sortRows() {
+    const size_t count = rows.size() / getTupleDesc().length();
+    order.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = {sort_key.prefix(keys.data() + i * key_length), static_cast<uint32_t>(i)};
+    }
+    const size_t rest = key_length > 8 ? key_length - 8 : 0;
+    std::sort(order.begin(), order.end(), [&](const auto &a, const auto &b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        if (rest > 0) {
+            int cmp = memcmp(keys.data() + a.second * key_length + 8, keys.data() + b.second * key_length + 8, rest);
+            if (cmp != 0) {
+                return cmp < 0;
+            }
+        }
+        // the rows keep the order of the input
+        return a.second < b.second;
+    });
+}
+
+void ExternalSort::writeRun() {
+    sortRows();
+    const size_t length = getTupleDesc().length();
+    auto run = std::make_unique<TempFile>(TempFile::uniqueName("sort"), getTupleDesc(), block_pages);
+    for (const auto &[prefix, index]: order) {
+        run->append(rows.data() + index * length);
+    }
+    run->flush();
+    runs.push_back(std::move(run));
+    rows.clear();
+    keys.clear();
+    order.clear();
+}
+
+bool ExternalSort::less(size_t a, size_t b) const {
+    // an exhausted run is larger than every row
+    if (cursors[a].count == 0) {
+        return false;
+    }
+    if (cursors[b].count == 0) {
+        return true;
+    }
+    int cmp = memcmp(cursors[a].key.data(), cursors[b].key.data(), key_length);
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    // the earlier run holds the earlier rows of the input
+    return a < b;
+}
+
+void ExternalSort::loadBlock(RunCursor &cursor) const {
+    cursor.rows.clear();
+    cursor.count = cursor.file->readPages(cursor.next_page, block_pages, cursor.rows);
+    cursor.next_page += block_pages;
+    cursor.pos = 0;
+    if (cursor.count > 0) {
+        sort_key.encode(cursor.rows.data(), cursor.key.data());
+    }
+}
+
+void ExternalSort::advance(size_t run) {
+    RunCursor &cursor = cursors[run];
+    if (++cursor.pos == cursor.count) {
+        loadBlock(cursor);
+    } else {
+        sort_key.encode(cursor.rows.data() + cursor.pos * getTupleDesc().length(), cursor.key.data());
+    }
+    // replay the matches on the path from the run to the root, each node keeps the loser
+    size_t winner = run;
+    for (size_t node = (run + cursors.size()) / 2; node > 0; node /= 2) {
+        if (less(tree[node], winner)) {
+            std::swap(tree[node], winner);
+        }
+    }
+    tree[0] = winner;
+}
+
+size_t ExternalSort::buildTree(size_t node) {
+    // the runs are the leaves, at positions k to 2k - 1
+    if (node >= cursors.size()) {
+        return node - cursors.size();
+    }
+    size_t left = buildTree(2 * node);
+    size_t right = buildTree(2 * node + 1);
+    if (less(right, left)) {
+        std::swap(left, right);
+    }
+    tree[node] = right;
+    return left;
+}
+
+void ExternalSort::startMerge(const std::vector<std::unique_ptr<TempFile>> &inputs, size_t first, size_t count) {
+    cursors.assign(count, {});
+    for (size_t i = 0; i < count; i++) {
+        cursors[i].file = inputs[first + i].get();
+        cursors[i].next_page = 0;
+        cursors[i].key.resize(key_length);
+        loadBlock(cursors[i]);
+    }
+    tree.assign(count, 0);
+    tree[0] = buildTree(1);
+    pending = false;
+}
+
+size_t ExternalSort::nextMerged() {
+    if (pending) {
+        advance(tree[0]);
+    }
+    pending = true;
+    return cursors[tree[0]].count == 0 ? cursors.size() : tree[0];
+}
+
+void ExternalSort::open() {
+    runs.clear();
+    cursors.clear();
+    rows.clear();
+    keys.clear();
+    order.clear();
+    pending = false;
+    pos = 0;
+
+    const size_t length = getTupleDesc().length();
+    child->open();
+    while (child->next()) {
+        rows.insert(rows.end(), child->row(), child->row() + length);
+        keys.resize(keys.size() + key_length);
+        sort_key.encode(child->row(), keys.data() + keys.size() - key_length);
+        const size_t used = rows.size() + keys.size() + rows.size() / length * sizeof(order[0]);
+        if (used >= memory_budget) {
+            writeRun();
+        }
+    }
+    num_runs = runs.size();
+    if (runs.empty()) {
+        sortRows();
+        return;
+    }
+    if (!rows.empty()) {
+        writeRun();
+        num_runs = runs.size();
+    }
+    // the memory of the runs is used by the blocks of the merge
+    rows.shrink_to_fit();
+    keys.shrink_to_fit();
+    order.shrink_to_fit();
+
+    // a merge holds a block of each run and a block of its output
+    const size_t fan_in = std::max<size_t>(memory_budget / (block_pages * DEFAULT_PAGE_SIZE), 3) - 1;
+    while (runs.size() > fan_in) {
+        std::vector<std::unique_ptr<TempFile>> merged;
+        for (size_t first = 0; first < runs.size(); first += fan_in) {
+            const size_t count = std::min(fan_in, runs.size() - first);
+            auto run = std::make_unique<TempFile>(TempFile::uniqueName("sort"), getTupleDesc(), block_pages);
+            startMerge(runs, first, count);
+            for (size_t r = nextMerged(); r < count; r = nextMerged()) {
+                run->append(cursors[r].rows.data() + cursors[r].pos * length);
+            }
+            run->flush();
+            merged.push_back(std::move(run));
+        }
+        cursors.clear();
+        runs = std::move(merged);
+    }
+    startMerge(runs, 0, runs.size());
+}
+
+bool ExternalSort::next() {
+    if (runs.empty()) {
+        if (pending) {
+            pos++;
+        }
+        pending = true;
+        return pos < order.size();
+    }
+    return nextMerged() < cursors.size();
+}
+
+const uint8_t *ExternalSort::row() const {
+    const size_t length = getTupleDesc().length();
+    if (runs.empty()) {
+        return rows.data() + order[pos].second * length;
+    }
+    const RunCursor &cursor = cursors[tree[0]];
+    return cursor.rows.data() + cursor.pos * length;
+}
+
+bool ExternalSort::pushDown(const Predicate &predicate) { return child->pushDown(predicate); }
+
+size_t ExternalSort::numRuns() const { return num_runs; }
@@ -0,0 +1,60 @@
+#include <cstring>
+#include <db/FieldKey.hpp>
+#include <functional>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    int loadInt(const uint8_t *data) {
+        int v;
+        memcpy(&v, data, sizeof(v));
+        return v;
+    }
+
+    /// The finalizer of MurmurHash3, so that every bit of the hash depends on every bit of the key
+    uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+} // namespace
+
+FieldKey::FieldKey(const TupleDesc &td, size_t field) {
+    if (field >= td.size()) {
+        throw std::logic_error("Key field out of range");
+    }
+    type = td.field_type(field);
+    if (type == type_t::DOUBLE) {
+        throw std::logic_error("Key field must be an INT or CHAR field");
+    }
+    offset = td.offset_of(field);
+}
+
+std::string_view FieldKey::bytes(const uint8_t *row) const {
+    const char *data = reinterpret_cast<const char *>(row + offset);
+    return {data, type == type_t::INT ? INT_SIZE : strnlen(data, CHAR_SIZE)};
+}
+
+uint64_t FieldKey::hash(const uint8_t *row) const {
+    if (type == type_t::INT) {
+        return mix(static_cast<uint32_t>(loadInt(row + offset)));
+    }
+    return mix(std::hash<std::string_view>{}(bytes(row)));
+}
+
+int FieldKey::compare(const uint8_t *row, const FieldKey &other, const uint8_t *other_row) const {
+    if (type == type_t::INT) {
+        const int a = loadInt(row + offset);
+        const int b = loadInt(other_row + other.offset);
+        return (a > b) - (a < b);
+    }
+    return bytes(row).compare(other.bytes(other_row));
+}
+
+bool FieldKey::equal(const uint8_t *row, const FieldKey &other, const uint8_t *other_row) const {
+    return bytes(row) == other.bytes(other_row);
+}
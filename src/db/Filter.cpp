@@ -0,0 +1,35 @@
+#include <algorithm>
+#include <db/Filter.hpp>
+
+using namespace db;
+
+Filter::Filter(std::unique_ptr<Operator> child, const std::vector<Predicate> &predicates) : child(std::move(child)) {
+    for (const Predicate &predicate: predicates) {
+        pushDown(predicate);
+    }
+}
+
+const TupleDesc &Filter::getTupleDesc() const { return child->getTupleDesc(); }
+
+void Filter::open() { child->open(); }
+
+bool Filter::next() {
+    const TupleDesc &td = child->getTupleDesc();
+    while (child->next()) {
+        const uint8_t *row = child->row();
+        if (std::all_of(predicates.begin(), predicates.end(), [&](const Predicate &p) { return p.test(td, row); })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const uint8_t *Filter::row() const { return child->row(); }
+
+bool Filter::pushDown(const Predicate &predicate) {
+    predicate.check(child->getTupleDesc());
+    if (!child->pushDown(predicate)) {
+        predicates.push_back(predicate);
+    }
+    return true;
+}
@@ -0,0 +1,147 @@
+#include <db/Gather.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    bool sameRows(const TupleDesc &a, const TupleDesc &b) {
+        bool same = a.size() == b.size();
+        for (size_t i = 0; same && i < a.size(); i++) {
+            same = a.field_type(i) == b.field_type(i) && a.field_name(i) == b.field_name(i);
+        }
+        return same;
+    }
+} // namespace
+
+Gather::Gather(std::vector<std::unique_ptr<Operator>> inputs, size_t max_batches, bool ordered)
+        : inputs(std::move(inputs)), ordered(ordered),
+          max_batches(max_batches > 0 ? max_batches : ordered ? 64 : 4 * this->inputs.size()),
+          queues(ordered ? this->inputs.size() : 1), finished(this->inputs.size()), source(0), running(0),
+          stopped(false), count(0), pos(0), current(nullptr) {
+    if (this->inputs.empty()) {
+        throw std::logic_error("Gather needs an input");
+    }
+    for (const auto &input: this->inputs) {
+        if (!sameRows(input->getTupleDesc(), getTupleDesc())) {
+            throw std::logic_error("Inputs of Gather have different tuple descriptors");
+        }
+    }
+}
+
+Gather::~Gather() { stop(); }
+
+const TupleDesc &Gather::getTupleDesc() const { return inputs[0]->getTupleDesc(); }
+
+bool Gather::push(size_t input, std::vector<uint8_t> &rows) {
+    auto &queue = queues[ordered ? input : 0];
+    std::unique_lock lock(mutex);
+    consumed.wait(lock, [&] { return stopped || queue.size() < max_batches; });
+    if (stopped) {
+        return false;
+    }
+    queue.push_back(std::move(rows));
+    produced.notify_one();
+    return true;
+}
+
+void Gather::produce(size_t index) {
+    Operator &input = *inputs[index];
+    try {
+        const size_t length = getTupleDesc().length();
+        std::vector<uint8_t> rows;
+        rows.reserve(BATCH_ROWS * length);
+        input.open();
+        bool open = true;
+        while (open && input.next()) {
+            rows.insert(rows.end(), input.row(), input.row() + length);
+            if (rows.size() == BATCH_ROWS * length) {
+                open = push(index, rows);
+                rows.clear();
+                rows.reserve(BATCH_ROWS * length);
+            }
+        }
+        if (open && !rows.empty()) {
+            push(index, rows);
+        }
+    } catch (...) {
+        std::lock_guard lock(mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    }
+    std::lock_guard lock(mutex);
+    finished[index] = true;
+    running--;
+    produced.notify_one();
+}
+
+void Gather::stop() {
+    {
+        std::lock_guard lock(mutex);
+        stopped = true;
+    }
+    // the threads wait for the queues of their inputs
+    consumed.notify_all();
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    threads.clear();
+}
+
+void Gather::open() {
+    stop();
+    for (auto &queue: queues) {
+        queue.clear();
+    }
+    std::fill(finished.begin(), finished.end(), false);
+    source = 0;
+    error = nullptr;
+    stopped = false;
+    running = inputs.size();
+    count = 0;
+    pos = 0;
+    current = nullptr;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        threads.emplace_back([this, i] { produce(i); });
+    }
+}
+
+bool Gather::next() {
+    const size_t length = getTupleDesc().length();
+    if (pos < count) {
+        current = batch.data() + pos++ * length;
+        return true;
+    }
+    std::unique_lock lock(mutex);
+    while (true) {
+        auto &queue = queues[source];
+        produced.wait(lock, [&] { return !queue.empty() || (ordered ? finished[source] : running == 0); });
+        if (!queue.empty()) {
+            batch = std::move(queue.front());
+            queue.pop_front();
+            consumed.notify_all();
+            count = batch.size() / length;
+            current = batch.data();
+            pos = 1;
+            return true;
+        }
+        if (!ordered || ++source == queues.size()) {
+            break;
+        }
+    }
+    current = nullptr;
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return false;
+}
+
+const uint8_t *Gather::row() const { return current; }
+
+bool Gather::pushDown(const Predicate &predicate) {
+    bool accepted = true;
+    for (auto &input: inputs) {
+        accepted = input->pushDown(predicate) && accepted;
+    }
+    return accepted;
+}
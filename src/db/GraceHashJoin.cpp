@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <db/Database.hpp>
+#include <db/GraceHashJoin.hpp>
+#include <db/HeapFile.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    /// The number of probe rows that are looked up together
+    constexpr size_t probe_chunk = 4096;
+
+    /// Distinguishes the temporary files of the joins of this process
+    std::atomic<size_t> next_join_id{0};
+
+    void createFile(const std::string &name, const TupleDesc &td) {
+        std::remove(name.c_str());
+        getDatabase().add(std::make_unique<HeapFile>(name, td));
+    }
+
+    /// Remove a temporary file without writing its dirty pages
+    void dropFile(const std::string &name) {
+        Database &db = getDatabase();
+        BufferPool &pool = db.getBufferPool();
+        const size_t num_pages = db.get(name).getNumPages();
+        for (size_t page = 0; page < num_pages; page++) {
+            PageId pid{name, page};
+            if (pool.contains(pid)) {
+                pool.discardPage(pid);
+            }
+        }
+        db.remove(name);
+        std::remove(name.c_str());
+    }
+
+    void appendRow(const std::string &name, const uint8_t *row) {
+        DbFile &file = getDatabase().get(name);
+        file.insertTuple(file.getTupleDesc().deserialize(row));
+    }
+} // namespace
+
+GraceHashJoin::GraceHashJoin(std::unique_ptr<Operator> build, std::unique_ptr<Operator> probe, size_t build_field,
+                             size_t probe_field, size_t memory_budget, size_t fan_out)
+        : build_child(std::move(build)), probe_child(std::move(probe)),
+          build_key(build_child->getTupleDesc(), build_field), probe_key(probe_child->getTupleDesc(), probe_field),
+          memory_budget(memory_budget), fan_out(fan_out),
+          td(TupleDesc::merge(build_child->getTupleDesc(), probe_child->getTupleDesc())),
+          table(build_child->getTupleDesc(), build_field), partition(0), probe_source(nullptr), probe_count(0),
+          probe_done(true), pos(0) {
+    if (build_key.type != probe_key.type) {
+        throw std::logic_error("Join keys have different types");
+    }
+    if (fan_out == 0) {
+        throw std::logic_error("Fan out must be positive");
+    }
+}
+
+GraceHashJoin::~GraceHashJoin() { dropFiles(); }
+
+size_t GraceHashJoin::partitionOf(uint64_t hash) const {
+    // the low bits of the hash partition the JoinHashTable
+    return (hash >> 32) % fan_out;
+}
+
+void GraceHashJoin::spill() {
+    const std::string prefix = "grace_join_" + std::to_string(next_join_id++) + "_";
+    for (size_t p = 0; p < fan_out; p++) {
+        build_files.push_back(prefix + "build_" + std::to_string(p) + ".tmp");
+        createFile(build_files.back(), build_child->getTupleDesc());
+        probe_files.push_back(prefix + "probe_" + std::to_string(p) + ".tmp");
+        createFile(probe_files.back(), probe_child->getTupleDesc());
+    }
+    for (size_t i = 0; i < table.size(); i++) {
+        const uint8_t *row = table.row(i);
+        appendRow(build_files[partitionOf(build_key.hash(row))], row);
+    }
+    table.clear();
+}
+
+void GraceHashJoin::loadPartition(size_t p) {
+    table.clear();
+    SeqScan build_scan(getDatabase().get(build_files[p]));
+    build_scan.open();
+    while (build_scan.next()) {
+        table.insert(build_scan.row());
+    }
+    table.build();
+    probe_scan = std::make_unique<SeqScan>(getDatabase().get(probe_files[p]));
+    probe_scan->open();
+    probe_source = probe_scan.get();
+    probe_done = false;
+}
+
+void GraceHashJoin::dropFiles() {
+    probe_scan.reset();
+    for (const auto &name: build_files) {
+        dropFile(name);
+    }
+    for (const auto &name: probe_files) {
+        dropFile(name);
+    }
+    build_files.clear();
+    probe_files.clear();
+}
+
+const TupleDesc &GraceHashJoin::getTupleDesc() const { return td; }
+
+void GraceHashJoin::open() {
+    dropFiles();
+    table.clear();
+    matches.clear();
+    pos = 0;
+
+    const size_t build_length = build_child->getTupleDesc().length();
+    build_child->open();
+    while (build_child->next()) {
+        const uint8_t *row = build_child->row();
+        if (build_files.empty() && table.bytes() + build_length > memory_budget) {
+            spill();
+        }
+        if (build_files.empty()) {
+            table.insert(row);
+        } else {
+            appendRow(build_files[partitionOf(build_key.hash(row))], row);
+        }
+    }
+
+    probe_child->open();
+    if (build_files.empty()) {
+        table.build();
+        probe_source = probe_child.get();
+        probe_done = false;
+        return;
+    }
+    while (probe_child->next()) {
+        const uint8_t *row = probe_child->row();
+        appendRow(probe_files[partitionOf(probe_key.hash(row))], row);
+    }
+    partition = 0;
+    loadPartition(partition);
+}
+
+bool GraceHashJoin::next() {
+    const TupleDesc &probe_td = probe_child->getTupleDesc();
+    while (pos == matches.size()) {
+        if (probe_done) {
+            if (build_files.empty() || partition + 1 == fan_out) {
+                return false;
+            }
+            loadPartition(++partition);
+        }
+        probe_rows.clear();
+        for (probe_count = 0; probe_count < probe_chunk; probe_count++) {
+            if (!probe_source->next()) {
+                probe_done = true;
+                break;
+            }
+            const uint8_t *row = probe_source->row();
+            probe_rows.insert(probe_rows.end(), row, row + probe_td.length());
+        }
+        matches.clear();
+        pos = 0;
+        table.probe(probe_rows.data(), probe_count, probe_td, probe_key, matches);
+    }
+    const auto [probe_index, build_index] = matches[pos++];
+    const size_t build_length = build_child->getTupleDesc().length();
+    const uint8_t *probe_row = probe_rows.data() + probe_index * probe_td.length();
+    current.resize(td.length());
+    std::copy_n(table.row(build_index), build_length, current.data());
+    std::copy_n(probe_row, probe_td.length(), current.data() + build_length);
+    return true;
+}
+
+const uint8_t *GraceHashJoin::row() const { return current.data(); }
+
+bool GraceHashJoin::pushDown(const Predicate &predicate) {
+    predicate.check(td);
+    const size_t build_size = build_child->getTupleDesc().size();
+    if (predicate.field < build_size) {
+        return build_child->pushDown(predicate);
+    }
+    Predicate input = predicate;
+    input.field -= build_size;
+    return probe_child->pushDown(input);
+}
+
+bool GraceHashJoin::spilled() const { return !build_files.empty(); }
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cstring>
+#include <db/HashAggregate.hpp>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+using namespace db;
+
+namespace {
+    std::vector<std::unique_ptr<Operator>> single(std::unique_ptr<Operator> input) {
+        std::vector<std::unique_ptr<Operator>> inputs;
+        inputs.push_back(std::move(input));
+        return inputs;
+    }
+
+    const TupleDesc &inputDesc(const std::vector<std::unique_ptr<Operator>> &inputs) {
+        if (inputs.empty()) {
+            throw std::logic_error("HashAggregate needs an input");
+        }
+        const TupleDesc &td = inputs[0]->getTupleDesc();
+        for (const auto &input: inputs) {
+            const TupleDesc &other = input->getTupleDesc();
+            bool same = other.size() == td.size();
+            for (size_t i = 0; same && i < td.size(); i++) {
+                same = other.field_type(i) == td.field_type(i) && other.field_name(i) == td.field_name(i);
+            }
+            if (!same) {
+                throw std::logic_error("Inputs of HashAggregate have different tuple descriptors");
+            }
+        }
+        return td;
+    }
+} // namespace
+
+HashAggregate::HashAggregate(std::unique_ptr<Operator> input, const std::vector<size_t> &group_fields,
+                             const std::vector<Aggregate> &aggregates, size_t memory_budget, size_t fan_out)
+        : HashAggregate(single(std::move(input)), group_fields, aggregates, memory_budget, fan_out) {}
+
+HashAggregate::HashAggregate(std::vector<std::unique_ptr<Operator>> inputs, const std::vector<size_t> &group_fields,
+                             const std::vector<Aggregate> &aggregates, size_t memory_budget, size_t fan_out)
+        : inputs(std::move(inputs)), layout(inputDesc(this->inputs), group_fields, aggregates),
+          memory_budget(memory_budget), fan_out(fan_out), table(layout.keyLength(), layout.stateLength()),
+          partition_table(layout.keyLength(), layout.stateLength()), partition(0), current_table(&table), pos(0),
+          current(layout.getTupleDesc().length()) {
+    if (fan_out == 0) {
+        throw std::logic_error("Fan out must be positive");
+    }
+}
+
+size_t HashAggregate::partitionOf(uint64_t hash) const {
+    // the low bits of the hash select the slots of the tables
+    return (hash >> 32) % fan_out;
+}
+
+void HashAggregate::aggregateInput(Operator &input, AggregateTable &local,
+                                   std::vector<std::unique_ptr<TempFile>> &files, size_t budget) const {
+    const size_t key_length = layout.keyLength();
+    std::vector<uint8_t> key(std::max<size_t>(key_length, 1));
+    input.open();
+    while (input.next()) {
+        const uint8_t *row = input.row();
+        layout.key(row, key.data());
+        const uint64_t hash = layout.hash(key.data());
+        if (files.empty()) {
+            bool inserted;
+            uint8_t *entry = local.findOrInsert(key.data(), hash, inserted);
+            if (!inserted) {
+                layout.update(entry + key_length, row);
+                continue;
+            }
+            layout.init(entry + key_length, row);
+            if (local.bytes() > budget) {
+                // the groups in the table stay in memory, new groups are written to disk
+                for (size_t p = 0; p < fan_out; p++) {
+                    files.push_back(std::make_unique<TempFile>(TempFile::uniqueName("aggregate"),
+                                                               input.getTupleDesc()));
+                }
+            }
+        } else if (uint8_t *entry = local.find(key.data(), hash)) {
+            layout.update(entry + key_length, row);
+        } else {
+            files[partitionOf(hash)]->append(row);
+        }
+    }
+    for (auto &file: files) {
+        file->flush();
+    }
+}
+
+void HashAggregate::loadPartition(size_t p) {
+    const size_t key_length = layout.keyLength();
+    const size_t length = inputs[0]->getTupleDesc().length();
+    std::vector<uint8_t> key(std::max<size_t>(key_length, 1));
+    std::vector<uint8_t> rows;
+    partition_table.clear();
+    for (const auto &files: spills) {
+        if (files.empty()) {
+            continue;
+        }
+        for (size_t page = 0; page < files[p]->numPages(); page++) {
+            rows.clear();
+            const size_t count = files[p]->readPage(page, rows);
+            for (size_t i = 0; i < count; i++) {
+                const uint8_t *row = rows.data() + i * length;
+                layout.key(row, key.data());
+                bool inserted;
+                uint8_t *entry = partition_table.findOrInsert(key.data(), layout.hash(key.data()), inserted);
+                if (inserted) {
+                    layout.init(entry + key_length, row);
+                } else {
+                    layout.update(entry + key_length, row);
+                }
+            }
+        }
+    }
+    // a group may be in the table of another input: it is completed there and produced with the table
+    merged.assign(partition_table.size(), false);
+    for (size_t i = 0; i < partition_table.size(); i++) {
+        uint8_t *entry = partition_table.entry(i);
+        if (uint8_t *group = table.find(entry, partition_table.hash(i))) {
+            layout.merge(group + key_length, entry + key_length);
+            merged[i] = true;
+        }
+    }
+    current_table = &partition_table;
+    pos = 0;
+}
+
+const TupleDesc &HashAggregate::getTupleDesc() const { return layout.getTupleDesc(); }
+
+void HashAggregate::open() {
+    const size_t key_length = layout.keyLength();
+    const size_t state_length = layout.stateLength();
+    table.clear();
+    partition_table.clear();
+    spills.clear();
+    spills.resize(inputs.size());
+
+    if (inputs.size() == 1) {
+        aggregateInput(*inputs[0], table, spills[0], memory_budget);
+    } else {
+        std::vector<AggregateTable> locals(inputs.size(), AggregateTable(key_length, state_length));
+        std::vector<std::exception_ptr> errors(inputs.size());
+        std::vector<std::thread> threads;
+        const size_t budget = memory_budget / inputs.size();
+        for (size_t i = 0; i < inputs.size(); i++) {
+            threads.emplace_back([&, i] {
+                try {
+                    aggregateInput(*inputs[i], locals[i], spills[i], budget);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        for (const auto &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        for (auto &local: locals) {
+            for (size_t i = 0; i < local.size(); i++) {
+                const uint8_t *entry = local.entry(i);
+                bool inserted;
+                uint8_t *group = table.findOrInsert(entry, local.hash(i), inserted);
+                if (inserted) {
+                    memcpy(group + key_length, entry + key_length, state_length);
+                } else {
+                    layout.merge(group + key_length, entry + key_length);
+                }
+            }
+        }
+    }
+
+    if (layout.getGroupFields().empty() && table.size() == 0 && !spilled()) {
+        // an aggregate without group fields has a row even over an empty input
+        const std::vector<uint8_t> key(1);
+        bool inserted;
+        uint8_t *entry = table.findOrInsert(key.data(), layout.hash(key.data()), inserted);
+        layout.initEmpty(entry + key_length);
+    }
+
+    partition = 0;
+    if (spilled()) {
+        loadPartition(partition);
+    } else {
+        current_table = &table;
+        pos = 0;
+    }
+}
+
+bool HashAggregate::next() {
+    const size_t key_length = layout.keyLength();
+    while (true) {
+        while (pos < current_table->size()) {
+            const size_t i = pos++;
+            if (current_table == &partition_table && merged[i]) {
+                continue;
+            }
+            const uint8_t *entry = current_table->entry(i);
+            layout.finalize(entry, entry + key_length, current.data());
+            return true;
+        }
+        if (current_table == &table) {
+            return false;
+        }
+        if (++partition < fan_out) {
+            loadPartition(partition);
+        } else {
+            current_table = &table;
+            pos = 0;
+        }
+    }
+}
+
+const uint8_t *HashAggregate::row() const { return current.data(); }
+
+bool HashAggregate::pushDown(const Predicate &predicate) {
+    predicate.check(getTupleDesc());
+    const auto &group_fields = layout.getGroupFields();
+    if (predicate.field >= group_fields.size()) {
+        return false;
+    }
+    Predicate input = predicate;
+    input.field = group_fields[predicate.field];
+    bool accepted = true;
+    for (auto &child: inputs) {
+        accepted = child->pushDown(input) && accepted;
+    }
+    return accepted;
+}
+
+bool HashAggregate::spilled() const {
+    return std::any_of(spills.begin(), spills.end(), [](const auto &files) { return !files.empty(); });
+}
@@ -0,0 +1,194 @@
+#include <db/Crc32c.hpp>
+#include <db/Database.hpp>
+#include <db/HashFile.hpp>
+#include <db/HashPage.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    /// The largest depth of a bucket: the directory has at most 2^20 entries (8 MiB), enough for 4 GiB of evenly
+    /// split buckets, and a few keys with the same low bits of their hash cannot make it double up to 2^32 entries
+    constexpr uint8_t max_depth = 20;
+} // namespace
+
+HashFile::HashFile(const std::string &name, const TupleDesc &td, size_t key_index)
+        : HashFile(name, td, std::vector<size_t>{key_index}) {}
+
+HashFile::HashFile(const std::string &name, const TupleDesc &td, const std::vector<size_t> &key_indices)
+        : DbFile(name, td), key_desc(this->td, key_indices), global_depth(0) {
+    Page page;
+    if (HashPage(page, this->td).capacity < 2) {
+        throw std::logic_error("Tuples are too large for a HashFile");
+    }
+    // the file is not registered in the database yet, read the headers of the buckets directly
+    std::vector<HashPageHeader> headers(numPages);
+    for (size_t id = 0; id < numPages; id++) {
+        readPage(page, id);
+        headers[id] = *HashPage(page, this->td).header;
+        global_depth = std::max(global_depth, headers[id].depth);
+    }
+    directory.resize(size_t{1} << global_depth);
+    for (size_t id = 0; id < numPages; id++) {
+        for (size_t pos = headers[id].pattern; pos < directory.size(); pos += size_t{1} << headers[id].depth) {
+            directory[pos] = id;
+        }
+    }
+}
+
+uint32_t HashFile::hash(std::string_view key) const {
+    // the buckets store the low bits of the hashes: the hash function is part of the file format
+    return crc32c(key.data(), key.size());
+}
+
+size_t HashFile::bucketOf(uint32_t hash) const {
+    return directory[hash & ((size_t{1} << global_depth) - 1)];
+}
+
+void HashFile::split(size_t page) {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    PageLatch old_latch(bufferPool, {name, page}, true);
+    HashPage old_bucket(old_latch.page, td);
+    if (old_bucket.header->depth == max_depth) {
+        throw std::runtime_error("Bucket cannot be split");
+    }
+    if (old_bucket.header->depth == global_depth) {
+        // the bucket is referenced by a single entry, double the directory
+        const size_t size = directory.size();
+        directory.resize(2 * size);
+        std::copy(directory.begin(), directory.begin() + size, directory.begin() + size);
+        global_depth++;
+    }
+    PageLatch new_latch(bufferPool, {name, numPages++}, true);
+    new_latch.page.fill(0);
+    HashPage new_bucket(new_latch.page, td);
+    old_bucket.split(new_bucket);
+    old_latch.markDirty();
+    new_latch.markDirty();
+    for (size_t pos = new_bucket.header->pattern; pos < directory.size(); pos += size_t{1} << new_bucket.header->depth) {
+        directory[pos] = new_latch.pid.page;
+    }
+}
+
+void HashFile::insertTuple(const Tuple &t) {
+    if (!td.compatible(t)) {
+        throw std::runtime_error("Tuple not compatible with TupleDesc");
+    }
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    const std::string key = key_desc.encode(t);
+    const uint32_t h = hash(key);
+    while (true) {
+        size_t page;
+        {
+            std::shared_lock lock(directory_mutex);
+            page = bucketOf(h);
+            PageLatch latch(bufferPool, {name, page}, true);
+            HashPage bucket(latch.page, td);
+            size_t slot = bucket.find(h, key, key_desc);
+            if (slot < bucket.header->size) {
+                bucket.replaceTuple(slot, t);
+                latch.markDirty();
+                return;
+            }
+            if (bucket.insertTuple(t, h)) {
+                latch.markDirty();
+                return;
+            }
+        }
+        // a split is committed or undone as a whole, the buckets are logged before the operation ends
+        const auto operation = getDatabase().startOperation();
+        std::unique_lock lock(directory_mutex);
+        // another thread may have split the bucket in the meantime
+        if (bucketOf(h) == page) {
+            split(page);
+        }
+    }
+}
+
+void HashFile::deleteTuple(const Iterator &it) {
+    erase(key_desc.encode(getTuple(it)));
+}
+
+bool HashFile::deleteKey(int key) { return erase(key_desc.encode(std::vector<field_t>{key})); }
+
+bool HashFile::deleteKey(const std::vector<field_t> &key) {
+    if (key.size() != key_desc.fields().size()) {
+        throw std::logic_error("Key does not match the key fields");
+    }
+    return erase(key_desc.encode(key));
+}
+
+bool HashFile::erase(std::string_view key) {
+    const uint32_t h = hash(key);
+    std::shared_lock lock(directory_mutex);
+    PageLatch latch(getDatabase().getBufferPool(), {name, bucketOf(h)}, true);
+    HashPage bucket(latch.page, td);
+    size_t slot = bucket.find(h, key, key_desc);
+    if (slot == bucket.header->size) {
+        return false;
+    }
+    bucket.deleteTuple(slot);
+    latch.markDirty();
+    return true;
+}
+
+std::optional<Tuple> HashFile::lookup(int key) const { return find(key_desc.encode(std::vector<field_t>{key})); }
+
+std::optional<Tuple> HashFile::lookup(const std::vector<field_t> &key) const {
+    if (key.size() != key_desc.fields().size()) {
+        throw std::logic_error("Key does not match the key fields");
+    }
+    return find(key_desc.encode(key));
+}
+
+std::optional<Tuple> HashFile::find(std::string_view key) const {
+    const uint32_t h = hash(key);
+    std::shared_lock lock(directory_mutex);
+    PageLatch latch(getDatabase().getBufferPool(), {name, bucketOf(h)}, false);
+    HashPage bucket(latch.page, td);
+    size_t slot = bucket.find(h, key, key_desc);
+    if (slot == bucket.header->size) {
+        return std::nullopt;
+    }
+    return bucket.getTuple(slot);
+}
+
+Tuple HashFile::getTuple(const Iterator &it) const {
+    PageLatch latch(getDatabase().getBufferPool(), {name, it.page}, false);
+    return HashPage(latch.page, td).getTuple(it.slot);
+}
+
+void HashFile::next(Iterator &it) const {
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    std::shared_lock lock(directory_mutex);
+    while (it.page < numPages) {
+        PageLatch latch(bufferPool, {name, it.page}, false);
+        if (++it.slot < HashPage(latch.page, td).header->size) {
+            return;
+        }
+        it.page++;
+        // the slot is incremented before it is compared with the size of the next bucket
+        it.slot = -1;
+    }
+    it.slot = 0;
+}
+
+Iterator HashFile::begin() const {
+    Iterator it{*this, 0, 0};
+    bool empty;
+    {
+        PageLatch latch(getDatabase().getBufferPool(), {name, 0}, false);
+        empty = HashPage(latch.page, td).header->size == 0;
+    }
+    if (empty) {
+        next(it);
+    }
+    return it;
+}
+
+Iterator HashFile::end() const {
+    std::shared_lock lock(directory_mutex);
+    return {*this, numPages, 0};
+}
+
+const std::vector<size_t> &HashFile::getKeyIndices() const { return key_desc.fields(); }
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <db/HashJoin.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    /// The number of probe rows that are looked up together
+    constexpr size_t probe_chunk = 4096;
+} // namespace
+
+HashJoin::HashJoin(std::unique_ptr<Operator> build, std::unique_ptr<Operator> probe, size_t build_field,
+                   size_t probe_field)
+        : build_child(std::move(build)), probe_child(std::move(probe)),
+          probe_key(probe_child->getTupleDesc(), probe_field),
+          td(TupleDesc::merge(build_child->getTupleDesc(), probe_child->getTupleDesc())),
+          table(build_child->getTupleDesc(), build_field), probe_count(0), probe_done(true), pos(0) {
+    if (build_child->getTupleDesc().field_type(build_field) != probe_key.type) {
+        throw std::logic_error("Join keys have different types");
+    }
+}
+
+const TupleDesc &HashJoin::getTupleDesc() const { return td; }
+
+void HashJoin::open() {
+    table.clear();
+    build_child->open();
+    while (build_child->next()) {
+        table.insert(build_child->row());
+    }
+    table.build();
+    probe_child->open();
+    probe_done = false;
+    probe_count = 0;
+    matches.clear();
+    pos = 0;
+}
+
+bool HashJoin::next() {
+    const TupleDesc &probe_td = probe_child->getTupleDesc();
+    while (pos == matches.size()) {
+        if (probe_done) {
+            return false;
+        }
+        probe_rows.clear();
+        for (probe_count = 0; probe_count < probe_chunk; probe_count++) {
+            if (!probe_child->next()) {
+                probe_done = true;
+                break;
+            }
+            const uint8_t *row = probe_child->row();
+            probe_rows.insert(probe_rows.end(), row, row + probe_td.length());
+        }
+        matches.clear();
+        pos = 0;
+        table.probe(probe_rows.data(), probe_count, probe_td, probe_key, matches);
+    }
+    const auto [probe_index, build_index] = matches[pos++];
+    const size_t build_length = build_child->getTupleDesc().length();
+    const uint8_t *probe_row = probe_rows.data() + probe_index * probe_td.length();
+    current.resize(td.length());
+    std::copy_n(table.row(build_index), build_length, current.data());
+    std::copy_n(probe_row, probe_td.length(), current.data() + build_length);
+    return true;
+}
+
+const uint8_t *HashJoin::row() const { return current.data(); }
+
+bool HashJoin::pushDown(const Predicate &predicate) {
+    predicate.check(td);
+    const size_t build_size = build_child->getTupleDesc().size();
+    if (predicate.field < build_size) {
+        return build_child->pushDown(predicate);
+    }
+    Predicate input = predicate;
+    input.field -= build_size;
+    return probe_child->pushDown(input);
+}
@@ -0,0 +1,78 @@
+#include <cstring>
+#include <db/HashPage.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+HashPage::HashPage(Page &page, const TupleDesc &td) : td(td) {
+    header = reinterpret_cast<HashPageHeader *>(page.data());
+    capacity = (DEFAULT_PAGE_SIZE - sizeof(HashPageHeader)) / (sizeof(uint32_t) + td.length());
+    hashes = reinterpret_cast<uint32_t *>(page.data() + sizeof(HashPageHeader));
+    data = reinterpret_cast<uint8_t *>(hashes + capacity);
+}
+
+size_t HashPage::find(uint32_t hash, std::string_view key, const KeyDesc &kd) const {
+    for (size_t slot = 0; slot < header->size; slot++) {
+        if (hashes[slot] == hash && kd.encode(getTuple(slot)) == key) {
+            return slot;
+        }
+    }
+    return header->size;
+}
+
+bool HashPage::insertTuple(const Tuple &t, uint32_t hash) {
+    if (header->size == capacity) {
+        return false;
+    }
+    hashes[header->size] = hash;
+    td.serialize(data + header->size * td.length(), t);
+    header->size++;
+    return true;
+}
+
+void HashPage::replaceTuple(size_t slot, const Tuple &t) {
+    if (slot >= header->size) {
+        throw std::out_of_range("Slot out of range");
+    }
+    td.serialize(data + slot * td.length(), t);
+}
+
+void HashPage::deleteTuple(size_t slot) {
+    if (slot >= header->size) {
+        throw std::out_of_range("Slot out of range");
+    }
+    const size_t length = td.length();
+    const size_t last = header->size - 1;
+    hashes[slot] = hashes[last];
+    memmove(data + slot * length, data + last * length, length);
+    header->size--;
+}
+
+Tuple HashPage::getTuple(size_t slot) const {
+    if (slot >= header->size) {
+        throw std::out_of_range("Slot out of range");
+    }
+    return td.deserialize(data + slot * td.length());
+}
+
+void HashPage::split(HashPage &new_page) {
+    const uint32_t bit = 1u << header->depth;
+    const size_t length = td.length();
+    new_page.header->depth = header->depth + 1;
+    new_page.header->pattern = header->pattern | bit;
+    new_page.header->size = 0;
+    header->depth++;
+    size_t slot = 0;
+    while (slot < header->size) {
+        if (hashes[slot] & bit) {
+            uint16_t &size = new_page.header->size;
+            new_page.hashes[size] = hashes[slot];
+            memcpy(new_page.data + size * length, data + slot * length, length);
+            size++;
+            // the last tuple moves to the slot, examine the slot again
+            deleteTuple(slot);
+        } else {
+            slot++;
+        }
+    }
+}
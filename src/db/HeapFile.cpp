@@ -1,40 +1,76 @@
 #include <db/Database.hpp>
 #include <db/HeapFile.hpp>
 #include <db/HeapPage.hpp>
+#include <db/SecondaryIndex.hpp>
 #include <stdexcept>
 
 using namespace db;
 
 HeapFile::HeapFile(const std::string &name, const TupleDesc &td) : DbFile(name, td) {}
 
+void HeapFile::addIndex(SecondaryIndex &index, bool fill) {
+    std::unique_lock lock(index_mutex);
+    indexes.push_back(&index);
+    // without a fill, the table is not read: it may not be registered in the database yet
+    if (!fill) {
+        return;
+    }
+    try {
+        for (auto it = begin(); it != end(); next(it)) {
+            index.insertEntry(getTuple(it), it.page, it.slot);
+        }
+    } catch (...) {
+        indexes.pop_back();
+        throw;
+    }
+}
+
+void HeapFile::removeIndex(const SecondaryIndex &index) {
+    std::unique_lock lock(index_mutex);
+    std::erase(indexes, &index);
+}
+
+const std::vector<SecondaryIndex *> &HeapFile::getIndexes() const { return indexes; }
+
 void HeapFile::insertTuple(const Tuple &t) {
     // TODO pa1
     if (!td.compatible(t)) {
         throw std::runtime_error("Tuple not compatible with TupleDesc");
     }
+    std::shared_lock lock(index_mutex);
     BufferPool &bufferPool = getDatabase().getBufferPool();
-    PageId pid{name, 0};
-    pid.page = numPages - 1;
-    Page &p = bufferPool.getPage(pid);
-    HeapPage hp(p, td);
-    if (!hp.insertTuple(t)) {
-        numPages++;
-        pid.page++;
-        Page &np = bufferPool.getPage(pid);
-        HeapPage nhp(np, td);
-        nhp.insertTuple(t);
+    size_t page = numPages - 1;
+    size_t slot;
+    while (true) {
+        // the page is pinned and latched, so that several threads can insert into the file
+        PageLatch latch(bufferPool, {name, page}, true);
+        if (HeapPage(latch.page, td).insertTuple(t, slot)) {
+            latch.markDirty();
+            break;
+        }
+        // the page is full, another thread may have added the next page already
+        size_t last = page + 1;
+        numPages.compare_exchange_strong(last, last + 1);
+        page++;
+    }
+    for (SecondaryIndex *index: indexes) {
+        index->insertEntry(t, page, slot);
     }
-    bufferPool.markDirty(pid);
 }
 
 void HeapFile::deleteTuple(const Iterator &it) {
     // TODO pa1
-    BufferPool &bufferPool = getDatabase().getBufferPool();
-    PageId pid{name, it.page};
-    Page &p = bufferPool.getPage(pid);
-    HeapPage hp(p, td);
-    bufferPool.markDirty(pid);
-    hp.deleteTuple(it.slot);
+    std::shared_lock lock(index_mutex);
+    if (!indexes.empty()) {
+        // the entries are found by the values of the tuple
+        Tuple t = getTuple(it);
+        for (SecondaryIndex *index: indexes) {
+            index->deleteEntry(t, it.page, it.slot);
+        }
+    }
+    PageLatch latch(getDatabase().getBufferPool(), {name, it.page}, true);
+    HeapPage(latch.page, td).deleteTuple(it.slot);
+    latch.markDirty();
 }
 
 Tuple HeapFile::getTuple(const Iterator &it) const {
@@ -92,3 +128,17 @@ Iterator HeapFile::end() const {
     // TODO pa1
     return {*this, numPages, 0};
 }
+
+size_t HeapFile::readTuples(Iterator &it, std::vector<uint8_t> &rows, const ScanFilter &filter) const {
+    // the page is pinned and latched, so that several threads can scan the file
+    const PageLatch latch(getDatabase().getBufferPool(), {name, it.page}, false);
+    const HeapPage hp(latch.page, td);
+    const size_t offset = rows.size();
+    rows.resize(offset + (hp.end() - it.slot) * td.length());
+    size_t count = hp.readTuples(it.slot, rows.data() + offset, filter);
+    rows.resize(offset + count * td.length());
+    // continue from the last slot of the page
+    it.slot = hp.end() - 1;
+    next(it);
+    return count;
+}
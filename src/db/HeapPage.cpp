@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
 #include <db/Database.hpp>
 #include <db/HeapPage.hpp>
+#include <db/ScanFilter.hpp>
 #include <stdexcept>
 
 using namespace db;
@@ -28,8 +32,13 @@ size_t HeapPage::end() const {
 }
 
 bool HeapPage::insertTuple(const Tuple &t) {
+    size_t slot;
+    return insertTuple(t, slot);
+}
+
+bool HeapPage::insertTuple(const Tuple &t, size_t &slot) {
     // TODO pa1
-    size_t slot = 0;
+    slot = 0;
     while (slot < capacity && (header[slot / 8] & (1 << (7 - slot % 8)))) {
         slot++;
     }
@@ -42,6 +51,17 @@ bool HeapPage::insertTuple(const Tuple &t) {
     return true;
 }
 
+void HeapPage::putTuple(size_t slot, const Tuple &t) {
+    if (slot >= capacity) {
+        throw std::runtime_error("Out of index");
+    }
+    if (!empty(slot)) {
+        throw std::runtime_error("Slot occupied");
+    }
+    td.serialize(data + slot * td.length(), t);
+    header[slot / 8] |= 1 << (7 - slot % 8);
+}
+
 void HeapPage::deleteTuple(size_t slot) {
     // TODO pa1
     if (slot >= capacity) {
@@ -62,6 +82,74 @@ Tuple HeapPage::getTuple(size_t slot) const {
     return td.deserialize(slotData);
 }
 
+void HeapPage::occupancy(uint64_t *bitmap) const {
+    const size_t words = (capacity + 63) / 64;
+    std::fill(bitmap, bitmap + words, 0);
+    for (size_t byte = 0; byte < (capacity + 7) / 8; byte++) {
+        // the header stores slot 8 * byte + k in bit 7 - k of the byte
+        uint8_t bits = header[byte];
+        bits = (bits & 0xF0) >> 4 | (bits & 0x0F) << 4;
+        bits = (bits & 0xCC) >> 2 | (bits & 0x33) << 2;
+        bits = (bits & 0xAA) >> 1 | (bits & 0x55) << 1;
+        bitmap[byte / 8] |= static_cast<uint64_t>(bits) << (byte % 8 * 8);
+    }
+    if (capacity % 64 != 0) {
+        bitmap[words - 1] &= (uint64_t{1} << capacity % 64) - 1;
+    }
+}
+
+size_t HeapPage::readTuples(size_t slot, uint8_t *rows, const ScanFilter &filter) const {
+    std::array<uint64_t, DEFAULT_PAGE_SIZE / 64> bitmap;
+    occupancy(bitmap.data());
+    if (!filter.empty()) {
+        filter.apply(data, capacity, bitmap.data());
+    }
+    const size_t length = td.length();
+    size_t count = 0;
+    for (size_t word = slot / 64; word * 64 < capacity; word++) {
+        uint64_t bits = bitmap[word];
+        if (word == slot / 64) {
+            bits &= ~uint64_t{0} << slot % 64;
+        }
+        while (bits != 0) {
+            const size_t s = word * 64 + std::countr_zero(bits);
+            memcpy(rows + count * length, data + s * length, length);
+            count++;
+            bits &= bits - 1;
+        }
+    }
+    return count;
+}
+
+size_t HeapPage::readTuples(const uint64_t *bitmap, uint8_t *rows, const ScanFilter &filter) const {
+    const size_t length = td.length();
+    size_t count = 0;
+    for (size_t word = 0; word * 64 < capacity; word++) {
+        for (uint64_t bits = bitmap[word]; bits != 0; bits &= bits - 1) {
+            const size_t s = word * 64 + std::countr_zero(bits);
+            memcpy(rows + count * length, data + s * length, length);
+            count++;
+        }
+    }
+    if (filter.empty()) {
+        return count;
+    }
+    // the copies are consecutive, the filter is evaluated on them with the scan kernels
+    std::array<uint64_t, DEFAULT_PAGE_SIZE / 64> selected;
+    std::fill(selected.begin(), selected.end(), ~uint64_t{0});
+    filter.apply(rows, count, selected.data());
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (selected[i / 64] >> i % 64 & 1) {
+            if (kept != i) {
+                memcpy(rows + kept * length, rows + i * length, length);
+            }
+            kept++;
+        }
+    }
+    return kept;
+}
+
 void HeapPage::next(size_t &slot) const {
     // TODO pa1
     while (++slot < capacity && empty(slot));
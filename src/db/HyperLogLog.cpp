@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <db/HyperLogLog.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+HyperLogLog::HyperLogLog(uint8_t precision) : precision(precision) {
+    if (precision < 4 || precision > 18) {
+        throw std::logic_error("HyperLogLog precision out of range");
+    }
+    registers.resize(size_t{1} << precision);
+}
+
+void HyperLogLog::add(uint64_t hash) {
+    const uint64_t rest = hash << precision;
+    // the position of the first set bit of the rest of the hash, past its end if there is none
+    const auto rank = static_cast<uint8_t>(rest == 0 ? 65 - precision : std::countl_zero(rest) + 1);
+    uint8_t &reg = registers[hash >> (64 - precision)];
+    if (rank > reg) {
+        reg = rank;
+    }
+}
+
+void HyperLogLog::merge(const HyperLogLog &other) {
+    if (other.precision != precision) {
+        throw std::logic_error("HyperLogLog precisions do not match");
+    }
+    for (size_t i = 0; i < registers.size(); i++) {
+        registers[i] = std::max(registers[i], other.registers[i]);
+    }
+}
+
+double HyperLogLog::estimate() const {
+    const auto m = static_cast<double>(registers.size());
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t reg: registers) {
+        sum += std::ldexp(1.0, -reg);
+        zeros += reg == 0;
+    }
+    const double alpha = 0.7213 / (1 + 1.079 / m);
+    const double estimate = alpha * m * m / sum;
+    if (estimate <= 2.5 * m && zeros != 0) {
+        return m * std::log(m / static_cast<double>(zeros));
+    }
+    return estimate;
+}
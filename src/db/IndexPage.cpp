@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <db/IndexPage.hpp>
 #include <stdexcept>
 
@@ -5,12 +7,105 @@ using namespace db;
 
 IndexPage::IndexPage(Page &page) {
     // TODO pa2
+    header = reinterpret_cast<IndexPageHeader *>(page.data());
+    capacity = (DEFAULT_PAGE_SIZE - sizeof(IndexPageHeader) - sizeof(size_t)) / (sizeof(int) + sizeof(size_t));
+    keys = reinterpret_cast<int *>(page.data() + sizeof(IndexPageHeader));
+    // children are aligned to the end of the page
+    children = reinterpret_cast<size_t *>(page.data() + DEFAULT_PAGE_SIZE) - (capacity + 1);
+}
+
+void IndexPage::init(size_t first_child, bool index_children) {
+    header->size = 0;
+    header->index_children = index_children;
+    children[0] = first_child;
+}
+
+int IndexPage::key(size_t pos) const { return keys[pos]; }
+
+size_t IndexPage::child(size_t pos) const { return children[pos]; }
+
+void IndexPage::setChild(size_t pos, size_t child) { children[pos] = child; }
+
+size_t IndexPage::child_of(int key) const {
+    return std::upper_bound(keys, keys + header->size, key) - keys;
 }
 
 bool IndexPage::insert(int key, size_t child) {
     // TODO pa2
+    if (header->size == capacity) {
+        throw std::logic_error("Index page is full");
+    }
+    size_t pos = child_of(key);
+    memmove(keys + pos + 1, keys + pos, (header->size - pos) * sizeof(int));
+    memmove(children + pos + 2, children + pos + 1, (header->size - pos) * sizeof(size_t));
+    keys[pos] = key;
+    children[pos + 1] = child;
+    header->size++;
+    return header->size == capacity;
+}
+
+void IndexPage::erase(size_t pos) {
+    if (pos >= header->size) {
+        throw std::out_of_range("Key out of range");
+    }
+    memmove(keys + pos, keys + pos + 1, (header->size - pos - 1) * sizeof(int));
+    memmove(children + pos + 1, children + pos + 2, (header->size - pos - 1) * sizeof(size_t));
+    header->size--;
+}
+
+void IndexPage::merge(int key, IndexPage &right) {
+    if (header->size + right.header->size + 1 > capacity) {
+        throw std::logic_error("Index pages do not fit in one page");
+    }
+    keys[header->size] = key;
+    memcpy(keys + header->size + 1, right.keys, right.header->size * sizeof(int));
+    memcpy(children + header->size + 1, right.children, (right.header->size + 1) * sizeof(size_t));
+    header->size += right.header->size + 1;
+    right.header->size = 0;
+}
+
+bool IndexPage::canMerge(int, const IndexPage &right) const {
+    return header->size + right.header->size + 1 <= capacity;
+}
+
+bool IndexPage::rotateFromLeft(IndexPage &left, IndexPage &parent, size_t pos) {
+    uint16_t &size = header->size;
+    memmove(keys + 1, keys, size * sizeof(int));
+    memmove(children + 1, children, (size + 1) * sizeof(size_t));
+    keys[0] = parent.keys[pos - 1];
+    children[0] = left.children[left.header->size];
+    size++;
+    parent.keys[pos - 1] = left.keys[left.header->size - 1];
+    left.header->size--;
+    return true;
 }
 
+bool IndexPage::rotateFromRight(IndexPage &right, IndexPage &parent, size_t pos) {
+    uint16_t &size = header->size;
+    keys[size] = parent.keys[pos];
+    children[size + 1] = right.children[0];
+    size++;
+    parent.keys[pos] = right.keys[0];
+    memmove(right.keys, right.keys + 1, (right.header->size - 1) * sizeof(int));
+    memmove(right.children, right.children + 1, right.header->size * sizeof(size_t));
+    right.header->size--;
+    return true;
+}
+
+bool IndexPage::mayOverflow() const { return header->size + 1 >= capacity; }
+
+bool IndexPage::underflows() const { return header->size < (capacity - 1) / 2; }
+
+bool IndexPage::canLend() const { return header->size > (capacity - 1) / 2; }
+
 int IndexPage::split(IndexPage &new_page) {
     // TODO pa2
+    uint16_t keep = header->size / 2;
+    int mid = keys[keep];
+    new_page.header->size = header->size - keep - 1;
+    new_page.header->index_children = header->index_children;
+    memcpy(new_page.keys, keys + keep + 1, new_page.header->size * sizeof(int));
+    memcpy(new_page.children, children + keep + 1, (new_page.header->size + 1) * sizeof(size_t));
+    header->size = keep;
+    return mid;
 }
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <db/IndexScan.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+IndexScan::IndexScan(const HeapFile &table, const SecondaryIndex &index, const field_t &low, const field_t &high)
+    : table(table), index(index), low(low), high(high), filter(table.getTupleDesc()), pos(0),
+      buffer(table.getTupleDesc().length()), current(nullptr) {
+    if (index.getTable() != table.getName()) {
+        throw std::logic_error("Index is not an index of the table");
+    }
+}
+
+const TupleDesc &IndexScan::getTupleDesc() const { return table.getTupleDesc(); }
+
+void IndexScan::open() {
+    positions.clear();
+    for (const Iterator &it: index.findRange(low, high)) {
+        positions.emplace_back(it.page, it.slot);
+    }
+    std::sort(positions.begin(), positions.end());
+    pos = 0;
+    current = nullptr;
+}
+
+bool IndexScan::next() {
+    while (pos < positions.size()) {
+        const auto [page, slot] = positions[pos++];
+        table.getTupleDesc().serialize(buffer.data(), table.getTuple({table, page, slot}));
+        if (filter.test(buffer.data())) {
+            current = buffer.data();
+            return true;
+        }
+    }
+    current = nullptr;
+    return false;
+}
+
+const uint8_t *IndexScan::row() const { return current; }
+
+bool IndexScan::pushDown(const Predicate &predicate) {
+    filter.add(predicate);
+    return true;
+}
+
+ScanFilter &IndexScan::getFilter() { return filter; }
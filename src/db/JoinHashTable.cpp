@@ -0,0 +1,130 @@
+#include <bit>
+#include <cstring>
+#include <db/JoinHashTable.hpp>
+
+using namespace db;
+
+namespace {
+    /// The size of a partition and its table that fits in the L2 cache of a core next to the probe chunk
+    constexpr size_t partition_bytes = 128 * 1024;
+
+    constexpr size_t max_radix_bits = 10;
+} // namespace
+
+JoinHashTable::JoinHashTable(const TupleDesc &td, size_t field)
+        : td(td), key(td, field), count(0), radix_bits(0), tables{0, 0} {}
+
+void JoinHashTable::clear() {
+    rows.clear();
+    hashes.clear();
+    count = 0;
+    radix_bits = 0;
+    tables.assign(2, 0);
+    slots.clear();
+}
+
+void JoinHashTable::insert(const uint8_t *row) {
+    rows.insert(rows.end(), row, row + td.length());
+    hashes.push_back(key.hash(row));
+    count++;
+}
+
+size_t JoinHashTable::size() const { return count; }
+
+size_t JoinHashTable::bytes() const {
+    return rows.capacity() + hashes.capacity() * sizeof(uint64_t) + slots.capacity() * sizeof(uint32_t);
+}
+
+void JoinHashTable::build() {
+    const size_t length = td.length();
+    // every row takes its bytes, its hash and two slots
+    const size_t total = count * (length + sizeof(uint64_t) + 2 * sizeof(uint32_t));
+    radix_bits = std::min<size_t>(std::bit_width(total / partition_bytes), max_radix_bits);
+    const size_t partitions = size_t{1} << radix_bits;
+    const uint64_t radix_mask = partitions - 1;
+
+    if (partitions > 1) {
+        std::vector<size_t> offsets(partitions + 1, 0);
+        for (size_t i = 0; i < count; i++) {
+            offsets[(hashes[i] & radix_mask) + 1]++;
+        }
+        for (size_t p = 0; p < partitions; p++) {
+            offsets[p + 1] += offsets[p];
+        }
+        std::vector<uint8_t> partitioned_rows(rows.size());
+        std::vector<uint64_t> partitioned_hashes(count);
+        for (size_t i = 0; i < count; i++) {
+            const size_t dst = offsets[hashes[i] & radix_mask]++;
+            memcpy(partitioned_rows.data() + dst * length, rows.data() + i * length, length);
+            partitioned_hashes[dst] = hashes[i];
+        }
+        rows.swap(partitioned_rows);
+        hashes.swap(partitioned_hashes);
+    }
+
+    // the rows of partition p are [first, first + n), the table of p has at least 2n slots
+    tables.assign(partitions + 1, 0);
+    std::vector<size_t> firsts(partitions + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        firsts[(hashes[i] & radix_mask) + 1]++;
+    }
+    for (size_t p = 0; p < partitions; p++) {
+        const size_t n = firsts[p + 1];
+        tables[p + 1] = tables[p] + (n == 0 ? 0 : std::bit_ceil(2 * n));
+        firsts[p + 1] = firsts[p] + n;
+    }
+    slots.assign(tables[partitions], 0);
+    for (size_t p = 0; p < partitions; p++) {
+        uint32_t *table = slots.data() + tables[p];
+        const size_t mask = tables[p + 1] - tables[p] - 1;
+        for (size_t i = firsts[p]; i < firsts[p + 1]; i++) {
+            size_t pos = (hashes[i] >> radix_bits) & mask;
+            while (table[pos] != 0) {
+                pos = (pos + 1) & mask;
+            }
+            table[pos] = i + 1;
+        }
+    }
+}
+
+void JoinHashTable::probe(const uint8_t *probe_rows, size_t probe_count, const TupleDesc &probe_td,
+                          const FieldKey &probe_key, std::vector<std::pair<uint32_t, uint32_t>> &matches) const {
+    const size_t length = td.length();
+    const size_t probe_length = probe_td.length();
+    const size_t partitions = size_t{1} << radix_bits;
+    const uint64_t radix_mask = partitions - 1;
+
+    // group the probe rows by partition, so that the table of a partition is only brought into the cache once
+    probe_hashes.resize(probe_count);
+    probe_offsets.assign(partitions + 1, 0);
+    for (size_t i = 0; i < probe_count; i++) {
+        probe_hashes[i] = probe_key.hash(probe_rows + i * probe_length);
+        probe_offsets[(probe_hashes[i] & radix_mask) + 1]++;
+    }
+    for (size_t p = 0; p < partitions; p++) {
+        probe_offsets[p + 1] += probe_offsets[p];
+    }
+    probe_order.resize(probe_count);
+    for (size_t i = 0; i < probe_count; i++) {
+        probe_order[probe_offsets[probe_hashes[i] & radix_mask]++] = i;
+    }
+
+    for (uint32_t i: probe_order) {
+        const uint64_t h = probe_hashes[i];
+        const size_t p = h & radix_mask;
+        if (tables[p] == tables[p + 1]) {
+            continue;
+        }
+        const uint32_t *table = slots.data() + tables[p];
+        const size_t mask = tables[p + 1] - tables[p] - 1;
+        const uint8_t *probe_row = probe_rows + i * probe_length;
+        for (size_t pos = (h >> radix_bits) & mask; table[pos] != 0; pos = (pos + 1) & mask) {
+            const uint32_t r = table[pos] - 1;
+            if (hashes[r] == h && key.equal(rows.data() + r * length, probe_key, probe_row)) {
+                matches.emplace_back(i, r);
+            }
+        }
+    }
+}
+
+const uint8_t *JoinHashTable::row(size_t index) const { return rows.data() + index * td.length(); }
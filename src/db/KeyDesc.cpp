@@ -0,0 +1,195 @@
+#include <cstring>
+#include <db/KeyDesc.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    size_t fieldLength(type_t type) {
+        switch (type) {
+            case type_t::INT:
+                return INT_SIZE;
+            case type_t::DOUBLE:
+                return DOUBLE_SIZE;
+            case type_t::CHAR:
+                return CHAR_SIZE;
+        }
+        throw std::logic_error("Unknown field type");
+    }
+
+    void appendBigEndian(std::string &out, uint64_t value, size_t bytes) {
+        for (size_t i = bytes; i-- > 0;) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    uint64_t readBigEndian(std::string_view &in, size_t bytes) {
+        if (in.size() < bytes) {
+            throw std::logic_error("Truncated key");
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value = value << 8 | static_cast<uint8_t>(in[i]);
+        }
+        in.remove_prefix(bytes);
+        return value;
+    }
+
+    void appendField(std::string &out, type_t type, const field_t &field) {
+        switch (type) {
+            case type_t::INT:
+                appendBigEndian(out, static_cast<uint32_t>(std::get<int>(field)) ^ 0x80000000u, INT_SIZE);
+                break;
+            case type_t::DOUBLE: {
+                uint64_t bits;
+                double value = std::get<double>(field);
+                memcpy(&bits, &value, sizeof(bits));
+                // negative numbers sort in reverse order of their magnitude
+                bits = bits >> 63 ? ~bits : bits | 1ull << 63;
+                appendBigEndian(out, bits, DOUBLE_SIZE);
+                break;
+            }
+            case type_t::CHAR: {
+                // the same bytes that TupleDesc::serialize stores
+                const std::string &value = std::get<std::string>(field);
+                out.append(value.c_str(), strnlen(value.c_str(), CHAR_SIZE));
+                out.push_back('\0');
+                break;
+            }
+        }
+    }
+
+    field_t readField(std::string_view &in, type_t type) {
+        switch (type) {
+            case type_t::INT:
+                return static_cast<int>(static_cast<uint32_t>(readBigEndian(in, INT_SIZE)) ^ 0x80000000u);
+            case type_t::DOUBLE: {
+                uint64_t bits = readBigEndian(in, DOUBLE_SIZE);
+                bits = bits >> 63 ? bits & ~(1ull << 63) : ~bits;
+                double value;
+                memcpy(&value, &bits, sizeof(value));
+                return value;
+            }
+            case type_t::CHAR: {
+                size_t end = in.find('\0');
+                if (end == std::string_view::npos) {
+                    throw std::logic_error("Truncated key");
+                }
+                std::string value(in.substr(0, end));
+                in.remove_prefix(end + 1);
+                return value;
+            }
+        }
+        throw std::logic_error("Unknown field type");
+    }
+} // namespace
+
+KeyDesc::KeyDesc(const TupleDesc &td, const std::vector<size_t> &indices) : td(td), indices(indices) {
+    if (indices.empty()) {
+        throw std::logic_error("A key needs at least one field");
+    }
+    std::vector<bool> is_key(td.size());
+    for (size_t index: indices) {
+        if (index >= td.size()) {
+            throw std::logic_error("Key field out of range");
+        }
+        if (is_key[index]) {
+            throw std::logic_error("Duplicate key field");
+        }
+        is_key[index] = true;
+        // CHAR fields need a terminator
+        max_length += fieldLength(td.field_type(index)) + (td.field_type(index) == type_t::CHAR);
+    }
+    if (max_length > MAX_KEY_LENGTH) {
+        throw std::logic_error("Key is too long");
+    }
+    for (size_t i = 0; i < td.size(); i++) {
+        if (!is_key[i]) {
+            rest_fields.push_back(i);
+            rest_length += fieldLength(td.field_type(i));
+        }
+    }
+}
+
+const std::vector<size_t> &KeyDesc::fields() const { return indices; }
+
+size_t KeyDesc::maxLength() const { return max_length; }
+
+size_t KeyDesc::restLength() const { return rest_length; }
+
+std::string KeyDesc::encode(const Tuple &t) const {
+    std::string key;
+    key.reserve(max_length);
+    for (size_t index: indices) {
+        appendField(key, td.field_type(index), t.get_field(index));
+    }
+    return key;
+}
+
+std::string KeyDesc::encode(const std::vector<field_t> &key) const {
+    if (key.empty() || key.size() > indices.size()) {
+        throw std::logic_error("Key does not match the key fields");
+    }
+    std::string out;
+    out.reserve(max_length);
+    for (size_t i = 0; i < key.size(); i++) {
+        if (Tuple({key[i]}).field_type(0) != td.field_type(indices[i])) {
+            throw std::logic_error("Key does not match the key fields");
+        }
+        appendField(out, td.field_type(indices[i]), key[i]);
+    }
+    return out;
+}
+
+std::vector<field_t> KeyDesc::decode(std::string_view key) const {
+    std::vector<field_t> fields;
+    fields.reserve(indices.size());
+    for (size_t index: indices) {
+        fields.push_back(readField(key, td.field_type(index)));
+    }
+    return fields;
+}
+
+void KeyDesc::extractRest(const Tuple &t, uint8_t *rest) const {
+    std::vector<uint8_t> data(td.length());
+    td.serialize(data.data(), t);
+    for (size_t index: rest_fields) {
+        size_t length = fieldLength(td.field_type(index));
+        memcpy(rest, data.data() + td.offset_of(index), length);
+        rest += length;
+    }
+}
+
+Tuple KeyDesc::join(std::string_view key, const uint8_t *rest) const {
+    // the key fields are left zeroed and replaced by the decoded key
+    std::vector<uint8_t> data(td.length());
+    for (size_t index: rest_fields) {
+        size_t length = fieldLength(td.field_type(index));
+        memcpy(data.data() + td.offset_of(index), rest, length);
+        rest += length;
+    }
+    Tuple t = td.deserialize(data.data());
+    std::vector<field_t> fields;
+    fields.reserve(td.size());
+    for (size_t i = 0; i < td.size(); i++) {
+        fields.push_back(t.get_field(i));
+    }
+    std::vector<field_t> key_fields = decode(key);
+    for (size_t i = 0; i < indices.size(); i++) {
+        fields[indices[i]] = std::move(key_fields[i]);
+    }
+    return {fields};
+}
+
+std::string KeyDesc::separator(std::string_view left, std::string_view right) {
+    return std::string(right.substr(0, commonPrefix(left, right) + 1));
+}
+
+size_t KeyDesc::commonPrefix(std::string_view a, std::string_view b) {
+    size_t length = std::min(a.size(), b.size());
+    size_t i = 0;
+    while (i < length && a[i] == b[i]) {
+        i++;
+    }
+    return i;
+}
@@ -0,0 +1,207 @@
+#include <cstring>
+#include <db/KeyIndexPage.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    /// A record holds the child on the right of the key and the length of the key, followed by the key
+    constexpr size_t record_header = sizeof(size_t) + sizeof(uint16_t);
+} // namespace
+
+KeyIndexPage::KeyIndexPage(Page &page, const KeyDesc &kd) : kd(kd) {
+    header = reinterpret_cast<KeyIndexPageHeader *>(page.data());
+    slots = reinterpret_cast<uint16_t *>(page.data() + sizeof(KeyIndexPageHeader));
+    data = page.data();
+}
+
+void KeyIndexPage::init(size_t first_child, bool index_children) {
+    header->first_child = first_child;
+    header->size = 0;
+    header->heap = DEFAULT_PAGE_SIZE;
+    header->used = 0;
+    header->index_children = index_children;
+}
+
+size_t KeyIndexPage::heap() const {
+    // a zeroed page is empty
+    return header->heap == 0 ? DEFAULT_PAGE_SIZE : header->heap;
+}
+
+size_t KeyIndexPage::freeSpace() const {
+    return DEFAULT_PAGE_SIZE - sizeof(KeyIndexPageHeader) - header->size * sizeof(uint16_t) - header->used;
+}
+
+size_t KeyIndexPage::maxEntry() const { return sizeof(uint16_t) + record_header + kd.maxLength(); }
+
+size_t KeyIndexPage::recordLength(size_t pos) const { return record_header + key(pos).size(); }
+
+std::string_view KeyIndexPage::key(size_t pos) const {
+    uint16_t length;
+    memcpy(&length, data + slots[pos] + sizeof(size_t), sizeof(length));
+    return {reinterpret_cast<const char *>(data + slots[pos] + record_header), length};
+}
+
+size_t KeyIndexPage::child(size_t pos) const {
+    if (pos == 0) {
+        return header->first_child;
+    }
+    size_t child;
+    memcpy(&child, data + slots[pos - 1], sizeof(child));
+    return child;
+}
+
+void KeyIndexPage::setChild(size_t pos, size_t child) {
+    if (pos == 0) {
+        header->first_child = child;
+    } else {
+        memcpy(data + slots[pos - 1], &child, sizeof(child));
+    }
+}
+
+size_t KeyIndexPage::child_of(std::string_view key) const {
+    // upper bound: keys equal to a separator belong to the child on its right
+    size_t lo = 0;
+    size_t hi = header->size;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (this->key(mid) <= key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+void KeyIndexPage::compact() {
+    Page copy;
+    memcpy(copy.data(), data, DEFAULT_PAGE_SIZE);
+    size_t offset = DEFAULT_PAGE_SIZE;
+    for (size_t pos = 0; pos < header->size; pos++) {
+        uint16_t key_length;
+        memcpy(&key_length, copy.data() + slots[pos] + sizeof(size_t), sizeof(key_length));
+        size_t length = record_header + key_length;
+        offset -= length;
+        memcpy(data + offset, copy.data() + slots[pos], length);
+        slots[pos] = offset;
+    }
+    header->heap = offset;
+}
+
+void KeyIndexPage::insertAt(size_t pos, std::string_view key, size_t child) {
+    const size_t length = record_header + key.size();
+    if (heap() < sizeof(KeyIndexPageHeader) + (header->size + 1) * sizeof(uint16_t) + length) {
+        compact();
+    }
+    const size_t offset = heap() - length;
+    const uint16_t key_length = key.size();
+    memcpy(data + offset, &child, sizeof(child));
+    memcpy(data + offset + sizeof(child), &key_length, sizeof(key_length));
+    memcpy(data + offset + record_header, key.data(), key.size());
+    memmove(slots + pos + 1, slots + pos, (header->size - pos) * sizeof(uint16_t));
+    slots[pos] = offset;
+    header->heap = offset;
+    header->size++;
+    header->used += length;
+}
+
+bool KeyIndexPage::insert(std::string_view key, size_t child) {
+    if (freeSpace() < sizeof(uint16_t) + record_header + key.size()) {
+        throw std::logic_error("Index page is full");
+    }
+    insertAt(child_of(key), key, child);
+    return freeSpace() < maxEntry();
+}
+
+void KeyIndexPage::erase(size_t pos) {
+    if (pos >= header->size) {
+        throw std::out_of_range("Key out of range");
+    }
+    header->used -= recordLength(pos);
+    memmove(slots + pos, slots + pos + 1, (header->size - pos - 1) * sizeof(uint16_t));
+    header->size--;
+}
+
+bool KeyIndexPage::canSetKey(size_t pos, std::string_view key) const {
+    return freeSpace() + this->key(pos).size() >= key.size();
+}
+
+bool KeyIndexPage::setKey(size_t pos, std::string_view key) {
+    if (!canSetKey(pos, key)) {
+        return false;
+    }
+    // the key may be a view of this page
+    std::string copy(key);
+    size_t right = child(pos + 1);
+    erase(pos);
+    insertAt(pos, copy, right);
+    return true;
+}
+
+bool KeyIndexPage::canMerge(std::string_view key, const KeyIndexPage &right) const {
+    return freeSpace() >= sizeof(uint16_t) + record_header + key.size() + right.header->size * sizeof(uint16_t) +
+                                  right.header->used;
+}
+
+void KeyIndexPage::merge(std::string_view key, KeyIndexPage &right) {
+    if (!canMerge(key, right)) {
+        throw std::logic_error("Index pages do not fit in one page");
+    }
+    insertAt(header->size, key, right.header->first_child);
+    for (size_t pos = 0; pos < right.header->size; pos++) {
+        insertAt(header->size, right.key(pos), right.child(pos + 1));
+    }
+    right.header->size = 0;
+    right.header->used = 0;
+}
+
+std::string KeyIndexPage::split(KeyIndexPage &new_page) {
+    uint16_t keep = header->size / 2;
+    std::string mid(key(keep));
+    new_page.init(child(keep + 1), header->index_children);
+    for (size_t pos = keep + 1; pos < header->size; pos++) {
+        new_page.insertAt(new_page.header->size, key(pos), child(pos + 1));
+    }
+    for (size_t pos = keep; pos < header->size; pos++) {
+        header->used -= recordLength(pos);
+    }
+    header->size = keep;
+    return mid;
+}
+
+bool KeyIndexPage::rotateFromLeft(KeyIndexPage &left, KeyIndexPage &parent, size_t pos) {
+    std::string separator(parent.key(pos - 1));
+    std::string up(left.key(left.header->size - 1));
+    if (freeSpace() < sizeof(uint16_t) + record_header + separator.size() || !parent.canSetKey(pos - 1, up)) {
+        return false;
+    }
+    insertAt(0, separator, header->first_child);
+    header->first_child = left.child(left.header->size);
+    parent.setKey(pos - 1, up);
+    left.erase(left.header->size - 1);
+    return true;
+}
+
+bool KeyIndexPage::rotateFromRight(KeyIndexPage &right, KeyIndexPage &parent, size_t pos) {
+    std::string separator(parent.key(pos));
+    std::string up(right.key(0));
+    if (freeSpace() < sizeof(uint16_t) + record_header + separator.size() || !parent.canSetKey(pos, up)) {
+        return false;
+    }
+    insertAt(header->size, separator, right.header->first_child);
+    parent.setKey(pos, up);
+    right.header->first_child = right.child(1);
+    right.erase(0);
+    return true;
+}
+
+bool KeyIndexPage::mayOverflow() const { return freeSpace() < 2 * maxEntry(); }
+
+bool KeyIndexPage::underflows() const {
+    return freeSpace() > (DEFAULT_PAGE_SIZE - sizeof(KeyIndexPageHeader)) * 2 / 3;
+}
+
+bool KeyIndexPage::canLend() const {
+    return freeSpace() + maxEntry() <= (DEFAULT_PAGE_SIZE - sizeof(KeyIndexPageHeader)) * 2 / 3;
+}
@@ -0,0 +1,284 @@
+#include <cstring>
+#include <db/KeyLeafPage.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    size_t fencePrefix(std::string_view low, std::string_view high) {
+        // an unbounded range has no common prefix
+        return low.empty() || high.empty() ? 0 : KeyDesc::commonPrefix(low, high);
+    }
+
+    constexpr size_t usable = DEFAULT_PAGE_SIZE - sizeof(KeyLeafPageHeader);
+} // namespace
+
+KeyLeafPage::KeyLeafPage(Page &page, const KeyDesc &kd) : kd(kd) {
+    header = reinterpret_cast<KeyLeafPageHeader *>(page.data());
+    slots = reinterpret_cast<uint16_t *>(page.data() + sizeof(KeyLeafPageHeader));
+    data = page.data();
+}
+
+bool KeyLeafPage::supports(const KeyDesc &kd) {
+    const size_t fences = 2 * (sizeof(uint16_t) + kd.maxLength());
+    const size_t record = 2 * sizeof(uint16_t) + kd.maxLength() + kd.restLength();
+    return fences + 4 * record <= usable;
+}
+
+size_t KeyLeafPage::heap() const {
+    // a zeroed page is empty
+    return header->heap == 0 ? DEFAULT_PAGE_SIZE : header->heap;
+}
+
+size_t KeyLeafPage::freeSpace() const { return usable - header->size * sizeof(uint16_t) - header->used; }
+
+size_t KeyLeafPage::maxRecord() const { return 2 * sizeof(uint16_t) + kd.maxLength() + kd.restLength(); }
+
+std::string_view KeyLeafPage::lowFence() const {
+    if (header->low == 0) {
+        return {};
+    }
+    uint16_t length;
+    memcpy(&length, data + header->low, sizeof(length));
+    return {reinterpret_cast<const char *>(data + header->low + sizeof(length)), length};
+}
+
+std::string_view KeyLeafPage::highFence() const {
+    if (header->high == 0) {
+        return {};
+    }
+    uint16_t length;
+    memcpy(&length, data + header->high, sizeof(length));
+    return {reinterpret_cast<const char *>(data + header->high + sizeof(length)), length};
+}
+
+std::string_view KeyLeafPage::prefix() const { return lowFence().substr(0, header->prefix); }
+
+std::string_view KeyLeafPage::suffix(size_t slot) const {
+    uint16_t length;
+    memcpy(&length, data + slots[slot], sizeof(length));
+    return {reinterpret_cast<const char *>(data + slots[slot] + sizeof(length)), length};
+}
+
+const uint8_t *KeyLeafPage::rest(size_t slot) const {
+    return data + slots[slot] + sizeof(uint16_t) + suffix(slot).size();
+}
+
+std::string KeyLeafPage::key(size_t slot) const {
+    std::string key(prefix());
+    key += suffix(slot);
+    return key;
+}
+
+int KeyLeafPage::compare(size_t slot, std::string_view key) const {
+    std::string_view prefix = this->prefix();
+    if (int c = prefix.compare(key.substr(0, prefix.size())); c != 0) {
+        return c;
+    }
+    return suffix(slot).compare(key.substr(prefix.size()));
+}
+
+size_t KeyLeafPage::lower_bound(std::string_view key) const {
+    size_t lo = 0;
+    size_t hi = header->size;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (compare(mid, key) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+std::vector<KeyLeafPage::Entry> KeyLeafPage::entries() const {
+    std::vector<Entry> entries;
+    entries.reserve(header->size);
+    for (size_t slot = 0; slot < header->size; slot++) {
+        entries.push_back({key(slot), std::string(reinterpret_cast<const char *>(rest(slot)), kd.restLength())});
+    }
+    return entries;
+}
+
+size_t KeyLeafPage::required(const std::vector<Entry> &entries, std::string_view low, std::string_view high) const {
+    const size_t prefix = fencePrefix(low, high);
+    size_t total = sizeof(KeyLeafPageHeader);
+    for (std::string_view fence: {low, high}) {
+        if (!fence.empty()) {
+            total += sizeof(uint16_t) + fence.size();
+        }
+    }
+    for (const Entry &entry: entries) {
+        total += 2 * sizeof(uint16_t) + entry.key.size() - prefix + kd.restLength();
+    }
+    return total;
+}
+
+uint16_t KeyLeafPage::writeFence(std::string_view key) {
+    if (key.empty()) {
+        return 0;
+    }
+    const uint16_t length = key.size();
+    header->heap = heap() - sizeof(length) - length;
+    memcpy(data + header->heap, &length, sizeof(length));
+    memcpy(data + header->heap + sizeof(length), key.data(), length);
+    header->used += sizeof(length) + length;
+    return header->heap;
+}
+
+void KeyLeafPage::build(const std::vector<Entry> &entries, std::string_view low, std::string_view high) {
+    if (required(entries, low, high) > DEFAULT_PAGE_SIZE) {
+        throw std::logic_error("Leaf page is full");
+    }
+    // the fences may be views of this page, write the new contents to a copy first
+    Page copy{};
+    KeyLeafPage page(copy, kd);
+    page.header->next_leaf = header->next_leaf;
+    page.header->low = page.writeFence(low);
+    page.header->high = page.writeFence(high);
+    page.header->prefix = fencePrefix(low, high);
+    for (const Entry &entry: entries) {
+        page.insertAt(page.header->size, std::string_view(entry.key).substr(page.header->prefix),
+                      reinterpret_cast<const uint8_t *>(entry.rest.data()));
+    }
+    memcpy(data, copy.data(), DEFAULT_PAGE_SIZE);
+}
+
+void KeyLeafPage::insertAt(size_t slot, std::string_view suffix, const uint8_t *rest) {
+    const size_t length = sizeof(uint16_t) + suffix.size() + kd.restLength();
+    if (heap() < sizeof(KeyLeafPageHeader) + (header->size + 1) * sizeof(uint16_t) + length) {
+        // reclaim the holes left by deleted records
+        build(entries(), lowFence(), highFence());
+    }
+    const size_t offset = heap() - length;
+    const uint16_t suffix_length = suffix.size();
+    memcpy(data + offset, &suffix_length, sizeof(suffix_length));
+    memcpy(data + offset + sizeof(suffix_length), suffix.data(), suffix.size());
+    memcpy(data + offset + sizeof(suffix_length) + suffix.size(), rest, kd.restLength());
+    memmove(slots + slot + 1, slots + slot, (header->size - slot) * sizeof(uint16_t));
+    slots[slot] = offset;
+    header->heap = offset;
+    header->size++;
+    header->used += length;
+}
+
+bool KeyLeafPage::insertTuple(const Tuple &t) {
+    const std::string key = kd.encode(t);
+    const size_t prefix = header->prefix;
+    if (key.compare(0, prefix, this->prefix()) != 0) {
+        throw std::logic_error("Key outside of the leaf range");
+    }
+    size_t slot = lower_bound(key);
+    bool exists = slot < header->size && compare(slot, key) == 0;
+    const size_t length = sizeof(uint16_t) + key.size() - prefix + kd.restLength();
+    size_t available = freeSpace();
+    if (exists) {
+        available += sizeof(uint16_t) + sizeof(uint16_t) + suffix(slot).size() + kd.restLength();
+    }
+    if (available < sizeof(uint16_t) + length) {
+        throw std::logic_error("Leaf page is full");
+    }
+    if (exists) {
+        deleteTuple(slot);
+    }
+    std::vector<uint8_t> rest(kd.restLength());
+    kd.extractRest(t, rest.data());
+    insertAt(slot, std::string_view(key).substr(prefix), rest.data());
+    return freeSpace() < sizeof(uint16_t) + maxRecord();
+}
+
+void KeyLeafPage::deleteTuple(size_t slot) {
+    if (slot >= header->size) {
+        throw std::out_of_range("Slot out of range");
+    }
+    header->used -= sizeof(uint16_t) + suffix(slot).size() + kd.restLength();
+    memmove(slots + slot, slots + slot + 1, (header->size - slot - 1) * sizeof(uint16_t));
+    header->size--;
+}
+
+Tuple KeyLeafPage::getTuple(size_t slot) const {
+    if (slot >= header->size) {
+        throw std::out_of_range("Slot out of range");
+    }
+    return kd.join(key(slot), rest(slot));
+}
+
+std::string KeyLeafPage::split(KeyLeafPage &new_page) {
+    std::vector<Entry> all = entries();
+    const size_t keep = all.size() / 2;
+    std::string separator = KeyDesc::separator(all[keep - 1].key, all[keep].key);
+    std::string low(lowFence());
+    std::string high(highFence());
+    new_page.header->next_leaf = header->next_leaf;
+    new_page.build({all.begin() + keep, all.end()}, separator, high);
+    build({all.begin(), all.begin() + keep}, low, separator);
+    return separator;
+}
+
+bool KeyLeafPage::canMerge(const KeyLeafPage &right) const {
+    std::vector<Entry> all = entries();
+    std::vector<Entry> more = right.entries();
+    all.insert(all.end(), more.begin(), more.end());
+    return required(all, lowFence(), right.highFence()) <= DEFAULT_PAGE_SIZE;
+}
+
+void KeyLeafPage::merge(KeyLeafPage &right) {
+    std::vector<Entry> all = entries();
+    std::vector<Entry> more = right.entries();
+    all.insert(all.end(), more.begin(), more.end());
+    header->next_leaf = right.header->next_leaf;
+    build(all, lowFence(), right.highFence());
+    right.header->size = 0;
+    right.header->used = 0;
+}
+
+bool KeyLeafPage::borrowFromLeft(KeyLeafPage &left, KeyIndexPage &parent, size_t pos) {
+    std::vector<Entry> from = left.entries();
+    if (from.size() < 2) {
+        return false;
+    }
+    std::vector<Entry> to = entries();
+    to.insert(to.begin(), std::move(from.back()));
+    from.pop_back();
+    std::string separator = KeyDesc::separator(from.back().key, to.front().key);
+    // the range of the page grows, and its prefix may shrink
+    if (required(to, separator, highFence()) > DEFAULT_PAGE_SIZE || !parent.canSetKey(pos - 1, separator)) {
+        return false;
+    }
+    left.build(from, left.lowFence(), separator);
+    build(to, separator, highFence());
+    parent.setKey(pos - 1, separator);
+    return true;
+}
+
+bool KeyLeafPage::borrowFromRight(KeyLeafPage &right, KeyIndexPage &parent, size_t pos) {
+    std::vector<Entry> from = right.entries();
+    if (from.size() < 2) {
+        return false;
+    }
+    std::vector<Entry> to = entries();
+    to.push_back(std::move(from.front()));
+    from.erase(from.begin());
+    std::string separator = KeyDesc::separator(to.back().key, from.front().key);
+    if (required(to, lowFence(), separator) > DEFAULT_PAGE_SIZE || !parent.canSetKey(pos, separator)) {
+        return false;
+    }
+    right.build(from, separator, right.highFence());
+    build(to, lowFence(), separator);
+    parent.setKey(pos, separator);
+    return true;
+}
+
+bool KeyLeafPage::mayOverflow() const { return freeSpace() < 2 * (sizeof(uint16_t) + maxRecord()); }
+
+bool KeyLeafPage::filledTo(double fill_factor) const {
+    const size_t used = usable - freeSpace() + header->size * header->prefix;
+    return static_cast<double>(used) >= usable * fill_factor;
+}
+
+bool KeyLeafPage::underflows() const { return freeSpace() > usable * 2 / 3; }
+
+bool KeyLeafPage::canLend() const { return freeSpace() + sizeof(uint16_t) + maxRecord() <= usable * 2 / 3; }
+
+void KeyLeafPage::setFences(std::string_view low, std::string_view high) { build(entries(), low, high); }
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <db/LeafPage.hpp>
 #include <stdexcept>
 
@@ -5,16 +6,108 @@ using namespace db;
 
 LeafPage::LeafPage(Page &page, const TupleDesc &td, size_t key_index) : td(td), key_index(key_index) {
     // TODO pa2
+    header = reinterpret_cast<LeafPageHeader *>(page.data());
+    data = page.data() + sizeof(LeafPageHeader);
+    capacity = (DEFAULT_PAGE_SIZE - sizeof(LeafPageHeader)) / td.length();
+}
+
+int LeafPage::key(size_t slot) const {
+    int key;
+    memcpy(&key, data + slot * td.length() + td.offset_of(key_index), INT_SIZE);
+    return key;
+}
+
+size_t LeafPage::lower_bound(int key) const {
+    size_t lo = 0;
+    size_t hi = header->size;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (this->key(mid) < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
 }
 
 bool LeafPage::insertTuple(const Tuple &t) {
     // TODO pa2
+    const size_t length = td.length();
+    int key = std::get<int>(t.get_field(key_index));
+    size_t pos = lower_bound(key);
+    if (pos == header->size || this->key(pos) != key) {
+        if (header->size == capacity) {
+            throw std::logic_error("Leaf page is full");
+        }
+        uint8_t *slot = data + pos * length;
+        memmove(slot + length, slot, (header->size - pos) * length);
+        header->size++;
+    }
+    td.serialize(data + pos * length, t);
+    return header->size == capacity;
 }
 
 int LeafPage::split(LeafPage &new_page) {
     // TODO pa2
+    const size_t length = td.length();
+    uint16_t keep = header->size / 2;
+    new_page.header->size = header->size - keep;
+    memcpy(new_page.data, data + keep * length, new_page.header->size * length);
+    new_page.header->next_leaf = header->next_leaf;
+    header->size = keep;
+    return new_page.key(0);
 }
 
+void LeafPage::deleteTuple(size_t slot) {
+    if (slot >= header->size) {
+        throw std::out_of_range("Slot out of range");
+    }
+    const size_t length = td.length();
+    uint8_t *data_slot = data + slot * length;
+    memmove(data_slot, data_slot + length, (header->size - slot - 1) * length);
+    header->size--;
+}
+
+void LeafPage::merge(LeafPage &right) {
+    if (header->size + right.header->size > capacity) {
+        throw std::logic_error("Leaf pages do not fit in one page");
+    }
+    const size_t length = td.length();
+    memcpy(data + header->size * length, right.data, right.header->size * length);
+    header->size += right.header->size;
+    header->next_leaf = right.header->next_leaf;
+    right.header->size = 0;
+}
+
+bool LeafPage::canMerge(const LeafPage &right) const { return header->size + right.header->size <= capacity; }
+
+bool LeafPage::borrowFromLeft(LeafPage &left, IndexPage &parent, size_t pos) {
+    insertTuple(left.getTuple(left.header->size - 1));
+    left.deleteTuple(left.header->size - 1);
+    parent.keys[pos - 1] = key(0);
+    return true;
+}
+
+bool LeafPage::borrowFromRight(LeafPage &right, IndexPage &parent, size_t pos) {
+    insertTuple(right.getTuple(0));
+    right.deleteTuple(0);
+    parent.keys[pos] = right.key(0);
+    return true;
+}
+
+bool LeafPage::mayOverflow() const { return header->size + 1 >= capacity; }
+
+bool LeafPage::filledTo(double fill_factor) const { return header->size >= capacity * fill_factor; }
+
+bool LeafPage::underflows() const { return header->size < capacity / 2; }
+
+bool LeafPage::canLend() const { return header->size > capacity / 2; }
+
 Tuple LeafPage::getTuple(size_t slot) const {
     // TODO pa2
+    if (slot >= header->size) {
+        throw std::out_of_range("Slot out of range");
+    }
+    return td.deserialize(data + slot * td.length());
 }
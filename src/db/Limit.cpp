@@ -0,0 +1,33 @@
+#include <db/Limit.hpp>
+
+using namespace db;
+
+Limit::Limit(std::unique_ptr<Operator> child, size_t limit, size_t offset)
+        : child(std::move(child)), limit(limit), offset(offset), skipped(0), produced(0) {}
+
+const TupleDesc &Limit::getTupleDesc() const { return child->getTupleDesc(); }
+
+void Limit::open() {
+    child->open();
+    skipped = 0;
+    produced = 0;
+}
+
+bool Limit::next() {
+    // the rows to skip are not pulled if no row is produced after them
+    if (produced == limit) {
+        return false;
+    }
+    for (; skipped < offset; skipped++) {
+        if (!child->next()) {
+            return false;
+        }
+    }
+    if (!child->next()) {
+        return false;
+    }
+    produced++;
+    return true;
+}
+
+const uint8_t *Limit::row() const { return child->row(); }
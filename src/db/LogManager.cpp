@@ -0,0 +1,541 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <db/Crc32c.hpp>
+#include <db/LogManager.hpp>
+#include <db/PageFormat.hpp>
+#include <exception>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace db;
+
+namespace {
+    constexpr uint64_t LOG_MAGIC = 0x324c41572d6264; // "db-WAL2"
+    /// The log starts with the magic number and the LSN of the last checkpoint record, so no record has the LSN 0
+    constexpr size_t LOG_HEADER_SIZE = 16;
+    /// A record starts with the CRC-32C of the rest of the record, its length and its type
+    constexpr size_t RECORD_HEADER_SIZE = 9;
+    /// Changed bytes separated by fewer unchanged bytes are logged as a single range
+    constexpr size_t MERGE_GAP = 8;
+
+    enum class RecordType : uint8_t {
+        PAGE = 1, COMMIT = 2, CHECKPOINT = 3, PAGE_IMAGE = 4
+    };
+
+    template<typename T>
+    void put(std::vector<uint8_t> &out, T value) {
+        const size_t offset = out.size();
+        out.resize(offset + sizeof(T));
+        memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    template<typename T>
+    T get(const uint8_t *data) {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+    /// The checksum detects the records that were only partially written when the process stopped
+    bool validRecord(const uint8_t *record, size_t length) {
+        return crc32c(record + 4, length - 4) == get<uint32_t>(record);
+    }
+
+    std::vector<uint8_t> startRecord(RecordType type) {
+        std::vector<uint8_t> record(RECORD_HEADER_SIZE);
+        record[8] = static_cast<uint8_t>(type);
+        return record;
+    }
+
+    void sealRecord(std::vector<uint8_t> &record) {
+        const auto length = static_cast<uint32_t>(record.size());
+        memcpy(record.data() + 4, &length, sizeof(length));
+        const uint32_t sum = crc32c(record.data() + 4, record.size() - 4);
+        memcpy(record.data(), &sum, sizeof(sum));
+    }
+
+    bool writeAll(int fd, const uint8_t *data, size_t size, uint64_t offset) {
+        while (size > 0) {
+            const ssize_t written = pwrite(fd, data, size, static_cast<off_t>(offset));
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            size -= written;
+            offset += written;
+        }
+        return true;
+    }
+
+    bool readAll(int fd, uint8_t *data, size_t size, uint64_t offset) {
+        while (size > 0) {
+            const ssize_t read = pread(fd, data, size, static_cast<off_t>(offset));
+            if (read <= 0) {
+                return false;
+            }
+            data += read;
+            size -= read;
+            offset += read;
+        }
+        return true;
+    }
+
+    void putPageId(std::vector<uint8_t> &out, const PageId &pid) {
+        put(out, static_cast<uint16_t>(pid.file.size()));
+        out.insert(out.end(), pid.file.begin(), pid.file.end());
+        put(out, static_cast<uint64_t>(pid.page));
+    }
+
+    PageId getPageId(const uint8_t *&data, const uint8_t *end) {
+        if (data + sizeof(uint16_t) > end || data + sizeof(uint16_t) + get<uint16_t>(data) + sizeof(uint64_t) > end) {
+            throw std::runtime_error("Corrupted log record");
+        }
+        const auto name_length = get<uint16_t>(data);
+        PageId pid{std::string(reinterpret_cast<const char *>(data + 2), name_length),
+                   get<uint64_t>(data + 2 + name_length)};
+        data += 2 + name_length + sizeof(uint64_t);
+        return pid;
+    }
+
+    /// The changes of a page found in the log
+    struct PageRecord {
+        uint64_t lsn;
+        PageId pid;
+        /// The contents of the page before the changes, for the first record of a page since it was written
+        const uint8_t *image;
+        const uint8_t *ranges;
+        const uint8_t *end;
+    };
+
+    PageRecord readPageRecord(uint64_t lsn, const uint8_t *body, const uint8_t *end, bool image) {
+        PageId pid = getPageId(body, end);
+        if (!image) {
+            return {lsn, std::move(pid), nullptr, body, end};
+        }
+        if (body + DEFAULT_PAGE_SIZE > end) {
+            throw std::runtime_error("Corrupted log record");
+        }
+        return {lsn, std::move(pid), body, body + DEFAULT_PAGE_SIZE, end};
+    }
+
+    /// The contents of a checkpoint record
+    struct Checkpoint {
+        /// Every page dirtied after this LSN has records from it
+        uint64_t begin;
+        /// The end of the last commit record when the checkpoint was taken
+        uint64_t commit_end;
+        /// The dirty pages and the LSN of the first record since they were last written
+        std::unordered_map<const PageId, uint64_t> dirty_pages;
+    };
+
+    Checkpoint readCheckpoint(const uint8_t *body, const uint8_t *end) {
+        if (body + 2 * sizeof(uint64_t) + sizeof(uint32_t) > end) {
+            throw std::runtime_error("Corrupted log checkpoint");
+        }
+        Checkpoint checkpoint{get<uint64_t>(body), get<uint64_t>(body + sizeof(uint64_t)), {}};
+        const auto count = get<uint32_t>(body + 2 * sizeof(uint64_t));
+        body += 2 * sizeof(uint64_t) + sizeof(uint32_t);
+        for (uint32_t i = 0; i < count; i++) {
+            PageId pid = getPageId(body, end);
+            if (body + sizeof(uint64_t) > end) {
+                throw std::runtime_error("Corrupted log checkpoint");
+            }
+            checkpoint.dirty_pages.emplace(std::move(pid), get<uint64_t>(body));
+            body += sizeof(uint64_t);
+        }
+        return checkpoint;
+    }
+
+    /// The files changed by the records of the log, opened for recovery
+    class RecoveredFiles {
+        std::unordered_map<std::string, int> fds;
+
+    public:
+        RecoveredFiles() = default;
+
+        RecoveredFiles(const RecoveredFiles &) = delete;
+
+        RecoveredFiles &operator=(const RecoveredFiles &) = delete;
+
+        ~RecoveredFiles() {
+            for (const auto &[name, fd]: fds) {
+                close(fd);
+            }
+        }
+
+        void open(const std::string &name) {
+            if (fds.contains(name)) {
+                return;
+            }
+            const int fd = ::open(name.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+            if (fd == -1) {
+                throw std::runtime_error("open");
+            }
+            fds.emplace(name, fd);
+        }
+
+        int fd(const std::string &name) const { return fds.at(name); }
+
+        void sync() const {
+            for (const auto &[name, fd]: fds) {
+                if (fdatasync(fd) == -1) {
+                    throw std::runtime_error("Cannot write the recovered pages");
+                }
+            }
+        }
+    };
+
+    /// Set the changed ranges of a page to their new contents (redo) or to their old contents (undo)
+    void applyRanges(Page &page, const PageRecord &record, bool redo) {
+        for (const uint8_t *range = record.ranges; range < record.end;) {
+            const auto offset = get<uint16_t>(range);
+            const auto length = get<uint16_t>(range + 2);
+            if (offset + length > DEFAULT_PAGE_SIZE || range + 4 + 2 * length > record.end) {
+                throw std::runtime_error("Corrupted log record");
+            }
+            const uint8_t *contents = range + 4 + (redo ? length : 0);
+            memcpy(page.data() + offset, contents, length);
+            range += 4 + 2 * length;
+        }
+    }
+} // namespace
+
+LogManager::LogManager(const std::string &name, std::chrono::microseconds group_delay, size_t redo_threads)
+        : name(name), group_delay(group_delay), redo_threads(std::max<size_t>(redo_threads, 1)),
+          buffer_lsn(LOG_HEADER_SIZE), next_lsn(LOG_HEADER_SIZE), flushed_lsn(LOG_HEADER_SIZE),
+          commit_end(LOG_HEADER_SIZE), flushing(false), failed(false), num_syncs(0), num_commits(0),
+          num_checkpoints(0), num_redone(0) {
+    fd = open(name.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd == -1) {
+        throw std::runtime_error("open");
+    }
+    try {
+        recover();
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+}
+
+LogManager::~LogManager() {
+    try {
+        flush(next_lsn);
+    } catch (const std::runtime_error &) {
+        // the records that cannot be written are lost, as if the process had stopped
+    }
+    close(fd);
+}
+
+const std::string &LogManager::getName() const { return name; }
+
+void LogManager::recover() {
+    struct stat st{};
+    if (fstat(fd, &st) == -1) {
+        throw std::runtime_error("fstat");
+    }
+    const auto size = static_cast<uint64_t>(st.st_size);
+    std::array<uint8_t, LOG_HEADER_SIZE> header{};
+    if (size > 0 && (size < LOG_HEADER_SIZE || !readAll(fd, header.data(), LOG_HEADER_SIZE, 0) ||
+                     get<uint64_t>(header.data()) != LOG_MAGIC)) {
+        throw std::runtime_error("Not a log file");
+    }
+
+    // the checkpoint tells where the records that may be missing from the files start
+    const auto checkpoint_lsn = get<uint64_t>(header.data() + sizeof(uint64_t));
+    Checkpoint checkpoint{LOG_HEADER_SIZE, LOG_HEADER_SIZE, {}};
+    uint64_t start = LOG_HEADER_SIZE;
+    if (checkpoint_lsn != 0) {
+        std::array<uint8_t, RECORD_HEADER_SIZE> record_header{};
+        if (!readAll(fd, record_header.data(), RECORD_HEADER_SIZE, checkpoint_lsn)) {
+            throw std::runtime_error("Corrupted log checkpoint");
+        }
+        std::vector<uint8_t> record(get<uint32_t>(record_header.data() + 4));
+        if (record.size() < RECORD_HEADER_SIZE || !readAll(fd, record.data(), record.size(), checkpoint_lsn) ||
+            !validRecord(record.data(), record.size()) ||
+            static_cast<RecordType>(record[8]) != RecordType::CHECKPOINT) {
+            throw std::runtime_error("Corrupted log checkpoint");
+        }
+        checkpoint = readCheckpoint(record.data() + RECORD_HEADER_SIZE, record.data() + record.size());
+        start = std::min(checkpoint.begin, checkpoint.commit_end);
+        for (const auto &[pid, rec_lsn]: checkpoint.dirty_pages) {
+            start = std::min(start, rec_lsn);
+        }
+    }
+    std::vector<uint8_t> log(size > start ? size - start : 0);
+    if (!readAll(fd, log.data(), log.size(), start)) {
+        throw std::runtime_error("pread");
+    }
+
+    // analysis: the log ends at the first record that is incomplete, the pages dirtied after the checkpoint started
+    // are added to its dirty page table
+    std::vector<PageRecord> records;
+    size_t committed = 0;
+    for (uint64_t offset = 0; offset + RECORD_HEADER_SIZE <= log.size();) {
+        const uint8_t *record = log.data() + offset;
+        const auto length = get<uint32_t>(record + 4);
+        if (length < RECORD_HEADER_SIZE || length > log.size() - offset || !validRecord(record, length)) {
+            break;
+        }
+        const uint64_t lsn = start + offset;
+        const auto type = static_cast<RecordType>(record[8]);
+        if (type == RecordType::PAGE || type == RecordType::PAGE_IMAGE) {
+            records.push_back(readPageRecord(lsn, record + RECORD_HEADER_SIZE, record + length,
+                                             type == RecordType::PAGE_IMAGE));
+            if (lsn < checkpoint.commit_end) {
+                committed = records.size();
+            }
+            if (lsn >= checkpoint.begin) {
+                checkpoint.dirty_pages.try_emplace(records.back().pid, lsn);
+            }
+        } else if (type == RecordType::COMMIT) {
+            committed = records.size();
+        }
+        offset += length;
+    }
+
+    // redo and undo are partitioned by page: the records of a page are applied in order by a single worker
+    RecoveredFiles files;
+    for (const PageRecord &record: records) {
+        files.open(record.pid.file);
+    }
+    const size_t workers = std::max<size_t>(std::min(redo_threads, records.size()), 1);
+    std::vector<std::vector<size_t>> partitions(workers);
+    for (size_t i = 0; i < records.size(); i++) {
+        partitions[std::hash<const PageId>()(records[i].pid) % workers].push_back(i);
+    }
+    std::atomic<size_t> redone{0};
+    auto recoverPartition = [&](const std::vector<size_t> &partition) {
+        std::unordered_map<const PageId, Page> pages;
+        auto load = [&](const PageId &pid) -> Page & {
+            auto [it, inserted] = pages.try_emplace(pid);
+            if (inserted) {
+                readStoredPages(files.fd(pid.file), pid.file, it->second.data(), pid.page, 1);
+            }
+            return it->second;
+        };
+        size_t count = 0;
+        for (size_t i: partition) {
+            // the changes made before the page was last dirtied are in the file
+            const PageRecord &record = records[i];
+            auto dirty = checkpoint.dirty_pages.find(record.pid);
+            if (checkpoint_lsn == 0 || (dirty != checkpoint.dirty_pages.end() && record.lsn >= dirty->second)) {
+                if (record.image != nullptr) {
+                    // the page is redone from its image: the file may hold a write of the page that was torn
+                    memcpy(pages[record.pid].data(), record.image, DEFAULT_PAGE_SIZE);
+                }
+                applyRanges(load(record.pid), record, true);
+                count++;
+            }
+        }
+        for (auto i = partition.rbegin(); i != partition.rend() && *i >= committed; ++i) {
+            applyRanges(load(records[*i].pid), records[*i], false);
+        }
+        for (const auto &[pid, page]: pages) {
+            writeStoredPages(files.fd(pid.file), page.data(), pid.page, 1);
+        }
+        redone += count;
+    };
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; w++) {
+        threads.emplace_back([&, w] {
+            try {
+                recoverPartition(partitions[w]);
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    try {
+        recoverPartition(partitions[0]);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    for (const auto &error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    files.sync();
+    num_redone = redone;
+
+    // every change is in the files, the log starts again empty
+    std::vector<uint8_t> empty;
+    put(empty, LOG_MAGIC);
+    put(empty, uint64_t{0});
+    if (ftruncate(fd, 0) == -1 || !writeAll(fd, empty.data(), empty.size(), 0) || fdatasync(fd) == -1) {
+        throw std::runtime_error("Cannot reset the log");
+    }
+}
+
+uint64_t LogManager::append(const std::vector<uint8_t> &record) {
+    std::lock_guard lock(mutex);
+    const uint64_t lsn = next_lsn;
+    buffer.insert(buffer.end(), record.begin(), record.end());
+    next_lsn += record.size();
+    return lsn;
+}
+
+uint64_t LogManager::logPage(const PageId &pid, const Page &before, const Page &after, bool image) {
+    std::vector<uint8_t> record = startRecord(image ? RecordType::PAGE_IMAGE : RecordType::PAGE);
+    putPageId(record, pid);
+    if (image) {
+        record.insert(record.end(), before.begin(), before.end());
+    }
+    const size_t header_size = record.size();
+
+    size_t pos = 0;
+    while (pos < DEFAULT_PAGE_SIZE) {
+        while (pos + sizeof(uint64_t) <= DEFAULT_PAGE_SIZE &&
+               memcmp(before.data() + pos, after.data() + pos, sizeof(uint64_t)) == 0) {
+            pos += sizeof(uint64_t);
+        }
+        while (pos < DEFAULT_PAGE_SIZE && before[pos] == after[pos]) {
+            pos++;
+        }
+        if (pos == DEFAULT_PAGE_SIZE) {
+            break;
+        }
+        // extend the range until MERGE_GAP bytes in a row are unchanged
+        const size_t start = pos;
+        size_t end = pos;
+        for (; pos < DEFAULT_PAGE_SIZE && pos - end < MERGE_GAP; pos++) {
+            if (before[pos] != after[pos]) {
+                end = pos + 1;
+            }
+        }
+        put(record, static_cast<uint16_t>(start));
+        put(record, static_cast<uint16_t>(end - start));
+        record.insert(record.end(), before.begin() + start, before.begin() + end);
+        record.insert(record.end(), after.begin() + start, after.begin() + end);
+    }
+    if (record.size() == header_size) {
+        return 0;
+    }
+    sealRecord(record);
+    return append(record);
+}
+
+uint64_t LogManager::commit() {
+    std::vector<uint8_t> record = startRecord(RecordType::COMMIT);
+    sealRecord(record);
+    uint64_t lsn;
+    {
+        // the operations in progress end before the commit record
+        std::unique_lock operation_lock(operation_mutex);
+        lsn = append(record);
+        std::lock_guard lock(mutex);
+        num_commits++;
+        commit_end = std::max(commit_end, lsn + record.size());
+    }
+    flushUntil(lsn, group_delay);
+    return lsn;
+}
+
+std::shared_lock<std::shared_mutex> LogManager::startOperation() { return std::shared_lock(operation_mutex); }
+
+uint64_t LogManager::checkpoint(const std::vector<DirtyPage> &dirty_pages, uint64_t begin_lsn) {
+    std::lock_guard checkpoint_lock(checkpoint_mutex);
+    std::vector<uint8_t> record = startRecord(RecordType::CHECKPOINT);
+    put(record, begin_lsn);
+    {
+        std::lock_guard lock(mutex);
+        put(record, commit_end);
+    }
+    put(record, static_cast<uint32_t>(dirty_pages.size()));
+    for (const auto &[pid, rec_lsn]: dirty_pages) {
+        putPageId(record, pid);
+        put(record, rec_lsn);
+    }
+    sealRecord(record);
+    const uint64_t lsn = append(record);
+    flush(lsn);
+    // the header points to the checkpoint once the checkpoint is durable
+    std::vector<uint8_t> master;
+    put(master, lsn);
+    if (!writeAll(fd, master.data(), master.size(), sizeof(uint64_t)) || fdatasync(fd) == -1) {
+        throw std::runtime_error("Cannot write the log checkpoint");
+    }
+    std::lock_guard lock(mutex);
+    num_checkpoints++;
+    return lsn;
+}
+
+void LogManager::flush(uint64_t lsn) { flushUntil(lsn, {}); }
+
+void LogManager::flushUntil(uint64_t lsn, std::chrono::microseconds delay) {
+    std::unique_lock lock(mutex);
+    while (flushed_lsn <= lsn && flushed_lsn < next_lsn) {
+        if (failed) {
+            throw std::runtime_error("Cannot write the log after a failed write");
+        }
+        if (flushing) {
+            // another thread is writing the log, the records buffered since then are written by the next group
+            flushed_cv.wait(lock);
+            continue;
+        }
+        flushing = true;
+        if (delay.count() > 0) {
+            lock.unlock();
+            std::this_thread::sleep_for(delay);
+            lock.lock();
+        }
+        const std::vector<uint8_t> data = std::move(buffer);
+        buffer.clear();
+        const uint64_t offset = buffer_lsn;
+        const uint64_t end = next_lsn;
+        buffer_lsn = end;
+        lock.unlock();
+        const bool written = writeAll(fd, data.data(), data.size(), offset) && fdatasync(fd) == 0;
+        lock.lock();
+        flushing = false;
+        if (written) {
+            flushed_lsn = end;
+            num_syncs++;
+        } else {
+            // the records are not in the buffer anymore, and after a failed fdatasync the kernel may have dropped
+            // the dirty pages of the log: no later write can make them durable
+            failed = true;
+        }
+        flushed_cv.notify_all();
+        if (!written) {
+            throw std::runtime_error("Cannot write the log");
+        }
+    }
+}
+
+uint64_t LogManager::getFlushedLsn() const {
+    std::lock_guard lock(mutex);
+    return flushed_lsn;
+}
+
+uint64_t LogManager::getNextLsn() const {
+    std::lock_guard lock(mutex);
+    return next_lsn;
+}
+
+size_t LogManager::getNumSyncs() const {
+    std::lock_guard lock(mutex);
+    return num_syncs;
+}
+
+size_t LogManager::getNumCommits() const {
+    std::lock_guard lock(mutex);
+    return num_commits;
+}
+
+size_t LogManager::getNumCheckpoints() const {
+    std::lock_guard lock(mutex);
+    return num_checkpoints;
+}
+
+size_t LogManager::getNumRedone() const { return num_redone; }
@@ -0,0 +1,177 @@
+#include <bit>
+#include <cmath>
+#include <db/Metrics.hpp>
+
+using namespace db;
+
+namespace {
+    std::atomic<size_t> next_shard{0};
+
+    const std::array<std::pair<const char *, double>, 4> exported_percentiles{
+            {{"p50", 50}, {"p90", 90}, {"p99", 99}, {"p999", 99.9}}};
+} // namespace
+
+size_t db::metricShard() {
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return shard;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const Shard &shard: shards) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::reset() {
+    for (Shard &shard: shards) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+double HistogramSnapshot::mean() const { return count == 0 ? 0 : static_cast<double>(sum) / count; }
+
+uint64_t HistogramSnapshot::percentile(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    // the rank of the value, from 1 to count
+    const auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(p * static_cast<double>(count) / 100)), 1);
+    uint64_t seen = 0;
+    for (const auto &[highest, n]: buckets) {
+        seen += n;
+        if (seen >= rank) {
+            return std::min(highest, max);
+        }
+    }
+    return max;
+}
+
+size_t Histogram::bucket(uint64_t value) {
+    if (value < uint64_t{1} << SUB_BITS) {
+        return value;
+    }
+    // the power of two of the value, and the SUB_BITS bits after its leading bit
+    const size_t magnitude = std::bit_width(value) - 1;
+    const size_t sub = (value >> (magnitude - SUB_BITS)) & ((uint64_t{1} << SUB_BITS) - 1);
+    return ((magnitude - SUB_BITS + 1) << SUB_BITS) + sub;
+}
+
+uint64_t Histogram::highestValue(size_t bucket) {
+    if (bucket < size_t{1} << SUB_BITS) {
+        return bucket;
+    }
+    const size_t group = bucket >> SUB_BITS;
+    const uint64_t sub = bucket & ((size_t{1} << SUB_BITS) - 1);
+    const uint64_t lowest = ((uint64_t{1} << SUB_BITS) + sub) << (group - 1);
+    return lowest + ((uint64_t{1} << (group - 1)) - 1);
+}
+
+Histogram::Histogram() : shards(std::make_unique<Shard[]>(METRIC_SHARDS)) {}
+
+void Histogram::record(uint64_t value) {
+    Shard &shard = shards[metricShard()];
+    shard.buckets[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t max = shard.max.load(std::memory_order_relaxed);
+    while (value > max && !shard.max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot result;
+    std::vector<uint64_t> counts(NUM_BUCKETS);
+    for (size_t s = 0; s < METRIC_SHARDS; s++) {
+        const Shard &shard = shards[s];
+        for (size_t b = 0; b < NUM_BUCKETS; b++) {
+            counts[b] += shard.buckets[b].load(std::memory_order_relaxed);
+        }
+        result.sum += shard.sum.load(std::memory_order_relaxed);
+        result.max = std::max(result.max, shard.max.load(std::memory_order_relaxed));
+    }
+    for (size_t b = 0; b < NUM_BUCKETS; b++) {
+        if (counts[b] != 0) {
+            result.count += counts[b];
+            result.buckets.emplace_back(highestValue(b), counts[b]);
+        }
+    }
+    return result;
+}
+
+void Histogram::reset() {
+    for (size_t s = 0; s < METRIC_SHARDS; s++) {
+        for (auto &count: shards[s].buckets) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        shards[s].sum.store(0, std::memory_order_relaxed);
+        shards[s].max.store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricsSnapshot::writeJson(std::ostream &out) const {
+    out << "{\"counters\": {";
+    const char *separator = "";
+    for (const auto &[name, value]: counters) {
+        out << separator << "\"" << name << "\": " << value;
+        separator = ", ";
+    }
+    out << "}, \"histograms\": {";
+    separator = "";
+    for (const auto &[name, histogram]: histograms) {
+        out << separator << "\"" << name << "\": {\"count\": " << histogram.count << ", \"sum\": " << histogram.sum
+            << ", \"mean\": " << histogram.mean() << ", \"max\": " << histogram.max;
+        for (const auto &[label, p]: exported_percentiles) {
+            out << ", \"" << label << "\": " << histogram.percentile(p);
+        }
+        out << "}";
+        separator = ", ";
+    }
+    out << "}}\n";
+}
+
+void MetricsSnapshot::writePrometheus(std::ostream &out) const {
+    for (const auto &[name, value]: counters) {
+        out << "# TYPE db_" << name << " counter\n";
+        out << "db_" << name << " " << value << "\n";
+    }
+    for (const auto &[name, histogram]: histograms) {
+        out << "# TYPE db_" << name << " summary\n";
+        for (const auto &[label, p]: exported_percentiles) {
+            out << "db_" << name << "{quantile=\"" << p / 100 << "\"} " << histogram.percentile(p) << "\n";
+        }
+        out << "db_" << name << "_sum " << histogram.sum << "\n";
+        out << "db_" << name << "_count " << histogram.count << "\n";
+    }
+}
+
+MetricsSnapshot Metrics::snapshot() const {
+    MetricsSnapshot result;
+    result.counters = {{"pool_hits", pool_hits.value()},
+                       {"pool_misses", pool_misses.value()},
+                       {"pool_evictions", pool_evictions.value()},
+                       {"pool_writebacks", pool_writebacks.value()},
+                       {"pages_read", pages_read.value()},
+                       {"pages_written", pages_written.value()},
+                       {"bytes_read", bytes_read.value()},
+                       {"bytes_written", bytes_written.value()}};
+    result.histograms.emplace("read_latency_ns", read_latency.snapshot());
+    result.histograms.emplace("write_latency_ns", write_latency.snapshot());
+    return result;
+}
+
+void Metrics::reset() {
+    for (Counter *counter: {&pool_hits, &pool_misses, &pool_evictions, &pool_writebacks, &pages_read,
+                            &pages_written, &bytes_read, &bytes_written}) {
+        counter->reset();
+    }
+    read_latency.reset();
+    write_latency.reset();
+}
+
+LatencyTimer::LatencyTimer(Histogram &histogram) : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+LatencyTimer::~LatencyTimer() {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
@@ -0,0 +1,68 @@
+#include <db/MorselQueue.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+MorselQueue::MorselQueue(size_t workers, size_t morsel_pages)
+        : morsel_pages(morsel_pages), ranges(workers), epoch(0), steals(0) {
+    if (workers == 0) {
+        throw std::logic_error("A parallel scan needs at least one worker");
+    }
+    if (morsel_pages == 0) {
+        throw std::logic_error("Morsels must have at least one page");
+    }
+}
+
+void MorselQueue::start(size_t epoch, size_t num_pages) {
+    std::lock_guard lock(mutex);
+    if (epoch <= this->epoch) {
+        return;
+    }
+    this->epoch = epoch;
+    // the ranges start on morsel boundaries
+    const size_t num_morsels = (num_pages + morsel_pages - 1) / morsel_pages;
+    for (size_t w = 0; w < ranges.size(); w++) {
+        std::lock_guard range_lock(ranges[w].mutex);
+        ranges[w].next = std::min(num_morsels * w / ranges.size() * morsel_pages, num_pages);
+        ranges[w].end = std::min(num_morsels * (w + 1) / ranges.size() * morsel_pages, num_pages);
+    }
+}
+
+std::optional<std::pair<size_t, size_t>> MorselQueue::take(size_t worker) {
+    {
+        Range &own = ranges[worker];
+        std::lock_guard lock(own.mutex);
+        if (own.next < own.end) {
+            const size_t first = own.next;
+            own.next = std::min(first + morsel_pages, own.end);
+            return std::make_pair(first, own.next);
+        }
+    }
+    while (true) {
+        // the victim is the range with the most pages left, the sizes may change while they are compared
+        size_t victim = ranges.size();
+        size_t most = 0;
+        for (size_t w = 0; w < ranges.size(); w++) {
+            std::lock_guard lock(ranges[w].mutex);
+            if (ranges[w].end - ranges[w].next > most) {
+                most = ranges[w].end - ranges[w].next;
+                victim = w;
+            }
+        }
+        if (victim == ranges.size()) {
+            return std::nullopt;
+        }
+        Range &range = ranges[victim];
+        std::lock_guard lock(range.mutex);
+        if (range.next < range.end) {
+            const size_t last = range.end;
+            range.end = last - std::min(morsel_pages, last - range.next);
+            steals++;
+            return std::make_pair(range.end, last);
+        }
+    }
+}
+
+size_t MorselQueue::numWorkers() const { return ranges.size(); }
+
+size_t MorselQueue::numSteals() const { return steals; }
@@ -0,0 +1,70 @@
+#include <db/MorselScan.hpp>
+#include <stdexcept>
+#include <thread>
+
+using namespace db;
+
+MorselScan::MorselScan(const HeapFile &file, std::shared_ptr<MorselQueue> queue, size_t worker)
+        : file(file), queue(std::move(queue)), worker(worker), filter(file.getTupleDesc()), epoch(0), page(0),
+          last(0), count(0), pos(0), current(nullptr) {
+    if (worker >= this->queue->numWorkers()) {
+        throw std::logic_error("Worker out of range");
+    }
+}
+
+std::vector<std::unique_ptr<Operator>> MorselScan::create(const HeapFile &file, size_t workers,
+                                                          size_t morsel_pages) {
+    auto queue = std::make_shared<MorselQueue>(workers, morsel_pages);
+    std::vector<std::unique_ptr<Operator>> scans;
+    for (size_t w = 0; w < workers; w++) {
+        scans.push_back(std::make_unique<MorselScan>(file, queue, w));
+    }
+    return scans;
+}
+
+size_t MorselScan::defaultWorkers() { return std::max(std::thread::hardware_concurrency(), 1u); }
+
+const TupleDesc &MorselScan::getTupleDesc() const { return file.getTupleDesc(); }
+
+void MorselScan::open() {
+    queue->start(++epoch, file.getNumPages());
+    page = 0;
+    last = 0;
+    count = 0;
+    pos = 0;
+    current = nullptr;
+}
+
+bool MorselScan::next() {
+    const size_t length = file.getTupleDesc().length();
+    while (true) {
+        if (pos < count) {
+            current = rows.data() + pos++ * length;
+            return true;
+        }
+        if (page == last) {
+            auto morsel = queue->take(worker);
+            if (!morsel.has_value()) {
+                current = nullptr;
+                return false;
+            }
+            std::tie(page, last) = *morsel;
+        }
+        // the deleted slots of the page are skipped by the occupancy bitmap
+        Iterator it{file, page++, 0};
+        rows.clear();
+        count = file.readTuples(it, rows, filter);
+        pos = 0;
+    }
+}
+
+const uint8_t *MorselScan::row() const { return current; }
+
+bool MorselScan::pushDown(const Predicate &predicate) {
+    filter.add(predicate);
+    return true;
+}
+
+ScanFilter &MorselScan::getFilter() { return filter; }
+
+const MorselQueue &MorselScan::getQueue() const { return *queue; }
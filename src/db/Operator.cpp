@@ -0,0 +1,82 @@
+#include <cstring>
+#include <db/Operator.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    template<typename T>
+    bool compare(const T &lhs, PredicateOp op, const T &rhs) {
+        switch (op) {
+            case PredicateOp::EQ:
+                return lhs == rhs;
+            case PredicateOp::NE:
+                return lhs != rhs;
+            case PredicateOp::LT:
+                return lhs < rhs;
+            case PredicateOp::LE:
+                return lhs <= rhs;
+            case PredicateOp::GT:
+                return lhs > rhs;
+            case PredicateOp::GE:
+                return lhs >= rhs;
+        }
+        return false;
+    }
+
+    std::string_view readString(const uint8_t *data) {
+        const char *chars = reinterpret_cast<const char *>(data);
+        return {chars, strnlen(chars, CHAR_SIZE)};
+    }
+} // namespace
+
+void Predicate::check(const TupleDesc &td) const {
+    if (field >= td.size()) {
+        throw std::logic_error("Predicate field out of range");
+    }
+    const type_t type = td.field_type(field);
+    if ((type == type_t::INT && !std::holds_alternative<int>(value)) ||
+        (type == type_t::DOUBLE && !std::holds_alternative<double>(value)) ||
+        (type == type_t::CHAR && !std::holds_alternative<std::string>(value))) {
+        throw std::logic_error("Predicate value does not match the field type");
+    }
+}
+
+bool Predicate::test(const TupleDesc &td, const uint8_t *row) const {
+    const uint8_t *data = row + td.offset_of(field);
+    switch (td.field_type(field)) {
+        case type_t::INT: {
+            int v;
+            memcpy(&v, data, sizeof(v));
+            return compare(v, op, std::get<int>(value));
+        }
+        case type_t::DOUBLE: {
+            double v;
+            memcpy(&v, data, sizeof(v));
+            return compare(v, op, std::get<double>(value));
+        }
+        case type_t::CHAR:
+            return compare(readString(data), op, std::string_view(std::get<std::string>(value)));
+    }
+    return false;
+}
+
+bool Operator::pushDown(const Predicate &) { return false; }
+
+Tuple Operator::getTuple() const { return getTupleDesc().deserialize(row()); }
+
+int Operator::getInt(size_t field) const {
+    int v;
+    memcpy(&v, row() + getTupleDesc().offset_of(field), sizeof(v));
+    return v;
+}
+
+double Operator::getDouble(size_t field) const {
+    double v;
+    memcpy(&v, row() + getTupleDesc().offset_of(field), sizeof(v));
+    return v;
+}
+
+std::string_view Operator::getString(size_t field) const {
+    return readString(row() + getTupleDesc().offset_of(field));
+}
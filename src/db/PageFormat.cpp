@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <db/Crc32c.hpp>
+#include <db/MorselQueue.hpp>
+#include <db/PageFormat.hpp>
+#include <exception>
+#include <fcntl.h>
+#include <mutex>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace db;
+
+namespace {
+    /// The headers of the format with a header before every page did not keep the pages aligned
+    constexpr uint32_t PAGE_FORMAT = 2;
+
+    /// The pages that a thread of verifyFile reads at a time
+    constexpr size_t VERIFY_MORSEL_PAGES = 64;
+
+    uint32_t zeroPageChecksum() {
+        static const uint32_t checksum = [] {
+            const Page zero{};
+            return crc32c(zero.data(), zero.size());
+        }();
+        return checksum;
+    }
+
+    /// The checksum of a page also covers its page number, so a page written at the wrong place does not match
+    uint32_t pageChecksum(uint32_t page_crc, size_t id) {
+        const auto page_number = static_cast<uint64_t>(id);
+        return crc32c(&page_number, sizeof(page_number), page_crc);
+    }
+
+    void stamp(uint8_t *header, const uint8_t *page, size_t id) {
+        const uint32_t checksum = pageChecksum(crc32c(page, DEFAULT_PAGE_SIZE), id);
+        memcpy(header, &checksum, sizeof(checksum));
+        memcpy(header + sizeof(checksum), &PAGE_FORMAT, sizeof(PAGE_FORMAT));
+    }
+
+    bool valid(const uint8_t *header, const uint8_t *page, size_t id) {
+        uint32_t checksum;
+        uint32_t format;
+        memcpy(&checksum, header, sizeof(checksum));
+        memcpy(&format, header + sizeof(checksum), sizeof(format));
+        const uint32_t page_crc = crc32c(page, DEFAULT_PAGE_SIZE);
+        if (checksum == 0 && format == 0) {
+            // a hole: the page was allocated but never written
+            return page_crc == zeroPageChecksum();
+        }
+        return format == PAGE_FORMAT && checksum == pageChecksum(page_crc, id);
+    }
+
+    /// Call `f(done, count)` for the runs of consecutive pages that belong to the same group
+    template<typename F>
+    void forEachGroup(size_t first, size_t count, F &&f) {
+        for (size_t done = 0; done < count;) {
+            const size_t run = std::min(count - done, GROUP_PAGES - (first + done) % GROUP_PAGES);
+            f(done, run);
+            done += run;
+        }
+    }
+
+    /**
+     * Read pages with their headers, two system calls per group, the pages past the end of the file are filled with
+     * zeros. `bad` is called with the index of every page that is torn or corrupted.
+     */
+    template<typename F>
+    void readChunk(int fd, uint8_t *data, size_t first, size_t count, F &&bad) {
+        std::array<uint8_t, GROUP_PAGES * PAGE_HEADER_SIZE> headers;
+        forEachGroup(first, count, [&](size_t done, size_t run) {
+            const size_t id = first + done;
+            uint8_t *pages = data + done * DEFAULT_PAGE_SIZE;
+            const ssize_t header_read = pread(fd, headers.data(), run * PAGE_HEADER_SIZE,
+                                              static_cast<off_t>(headerOffset(id)));
+            const ssize_t read = pread(fd, pages, run * DEFAULT_PAGE_SIZE, static_cast<off_t>(pageOffset(id)));
+            if (header_read == -1 || read == -1) {
+                throw std::runtime_error("pread");
+            }
+            // the headers of the pages past the end of the file are holes
+            std::fill(headers.begin() + header_read, headers.begin() + run * PAGE_HEADER_SIZE, 0);
+            const auto size = static_cast<size_t>(read);
+            for (size_t i = 0; i < run; i++) {
+                uint8_t *page = pages + i * DEFAULT_PAGE_SIZE;
+                if (size >= (i + 1) * DEFAULT_PAGE_SIZE) {
+                    if (!valid(headers.data() + i * PAGE_HEADER_SIZE, page, id + i)) {
+                        bad(done + i);
+                    }
+                    continue;
+                }
+                if (size > i * DEFAULT_PAGE_SIZE) {
+                    // the file ends in the middle of the page
+                    bad(done + i);
+                }
+                std::fill(page, page + DEFAULT_PAGE_SIZE, 0);
+            }
+        });
+    }
+} // namespace
+
+size_t db::storedPages(size_t file_size) {
+    // a group that only has its block of headers has no page
+    const size_t rest = file_size % GROUP_SIZE;
+    return file_size / GROUP_SIZE * GROUP_PAGES + (rest == 0 ? 0 : (rest - 1) / DEFAULT_PAGE_SIZE);
+}
+
+void db::readStoredPages(int fd, const std::string &name, uint8_t *data, size_t first, size_t count) {
+    readChunk(fd, data, first, count, [&](size_t i) {
+        throw std::runtime_error("Corrupted page " + std::to_string(first + i) + " of " + name);
+    });
+}
+
+void db::writeStoredPages(int fd, const uint8_t *data, size_t first, size_t count) {
+    std::array<uint8_t, GROUP_PAGES * PAGE_HEADER_SIZE> headers;
+    forEachGroup(first, count, [&](size_t done, size_t run) {
+        const size_t id = first + done;
+        const uint8_t *pages = data + done * DEFAULT_PAGE_SIZE;
+        for (size_t i = 0; i < run; i++) {
+            stamp(headers.data() + i * PAGE_HEADER_SIZE, pages + i * DEFAULT_PAGE_SIZE, id + i);
+        }
+        // the headers are written last: until then, the pages do not match them
+        const ssize_t written = pwrite(fd, pages, run * DEFAULT_PAGE_SIZE, static_cast<off_t>(pageOffset(id)));
+        if (written != static_cast<ssize_t>(run * DEFAULT_PAGE_SIZE)) {
+            throw std::runtime_error("pwrite");
+        }
+        const ssize_t header_written = pwrite(fd, headers.data(), run * PAGE_HEADER_SIZE,
+                                              static_cast<off_t>(headerOffset(id)));
+        if (header_written != static_cast<ssize_t>(run * PAGE_HEADER_SIZE)) {
+            throw std::runtime_error("pwrite");
+        }
+    });
+}
+
+std::vector<size_t> db::verifyFile(const std::string &name, size_t threads) {
+    const int fd = open(name.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("open");
+    }
+    struct stat st{};
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error("fstat");
+    }
+    const size_t pages = storedPages(st.st_size);
+    const size_t workers = std::max<size_t>(std::min(threads, pages / VERIFY_MORSEL_PAGES + 1), 1);
+    MorselQueue queue(workers, VERIFY_MORSEL_PAGES);
+    queue.start(1, pages);
+
+    std::mutex mutex;
+    std::vector<size_t> bad_pages;
+    auto verify = [&](size_t worker) {
+        std::vector<uint8_t> data(VERIFY_MORSEL_PAGES * DEFAULT_PAGE_SIZE);
+        std::vector<size_t> bad;
+        while (auto morsel = queue.take(worker)) {
+            const auto [begin, end] = *morsel;
+            readChunk(fd, data.data(), begin, end - begin, [&](size_t i) { bad.push_back(begin + i); });
+        }
+        std::lock_guard lock(mutex);
+        bad_pages.insert(bad_pages.end(), bad.begin(), bad.end());
+    };
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < workers; w++) {
+        pool.emplace_back([&, w] {
+            try {
+                verify(w);
+            } catch (...) {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    try {
+        verify(0);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto &thread: pool) {
+        thread.join();
+    }
+    close(fd);
+    for (const auto &error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    std::sort(bad_pages.begin(), bad_pages.end());
+    return bad_pages;
+}
@@ -0,0 +1,47 @@
+#include <db/Profile.hpp>
+
+using namespace db;
+
+Profile::Profile(std::unique_ptr<Operator> child, std::string name)
+        : child(std::move(child)), name(std::move(name)), running(false), start(0), rows(0) {}
+
+Profile::~Profile() { finish(); }
+
+void Profile::finish() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    const Tracer::PageCounts &now = Tracer::getPageCounts();
+    Tracer::record(name, "operator", start,
+                   {{"rows", rows}, {"pages", now.accessed - pages.accessed}, {"misses", now.missed - pages.missed}});
+}
+
+const TupleDesc &Profile::getTupleDesc() const { return child->getTupleDesc(); }
+
+void Profile::open() {
+    finish();
+    if (Tracer::enabled()) {
+        running = true;
+        start = Tracer::now();
+        rows = 0;
+        pages = Tracer::getPageCounts();
+    }
+    child->open();
+}
+
+bool Profile::next() {
+    const bool more = child->next();
+    if (running) {
+        if (more) {
+            rows++;
+        } else {
+            finish();
+        }
+    }
+    return more;
+}
+
+const uint8_t *Profile::row() const { return child->row(); }
+
+bool Profile::pushDown(const Predicate &predicate) { return child->pushDown(predicate); }
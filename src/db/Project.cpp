@@ -0,0 +1,50 @@
+#include <cstring>
+#include <db/Project.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    TupleDesc projectDesc(const TupleDesc &input, const std::vector<size_t> &fields) {
+        std::vector<type_t> types;
+        std::vector<std::string> names;
+        for (size_t field: fields) {
+            if (field >= input.size()) {
+                throw std::logic_error("Projected field out of range");
+            }
+            types.push_back(input.field_type(field));
+            names.push_back(input.field_name(field));
+        }
+        return {types, names};
+    }
+} // namespace
+
+Project::Project(std::unique_ptr<Operator> child, const std::vector<size_t> &fields)
+        : child(std::move(child)), fields(fields), td(projectDesc(this->child->getTupleDesc(), fields)),
+          buffer(td.length()) {}
+
+const TupleDesc &Project::getTupleDesc() const { return td; }
+
+void Project::open() { child->open(); }
+
+bool Project::next() {
+    if (!child->next()) {
+        return false;
+    }
+    const TupleDesc &input = child->getTupleDesc();
+    const uint8_t *row = child->row();
+    for (size_t i = 0; i < fields.size(); i++) {
+        const size_t length = (i + 1 < fields.size() ? td.offset_of(i + 1) : td.length()) - td.offset_of(i);
+        memcpy(buffer.data() + td.offset_of(i), row + input.offset_of(fields[i]), length);
+    }
+    return true;
+}
+
+const uint8_t *Project::row() const { return buffer.data(); }
+
+bool Project::pushDown(const Predicate &predicate) {
+    predicate.check(td);
+    Predicate input = predicate;
+    input.field = fields[predicate.field];
+    return child->pushDown(input);
+}
@@ -0,0 +1,38 @@
+#include <db/ReverseBTreeScan.hpp>
+
+using namespace db;
+
+ReverseBTreeScan::ReverseBTreeScan(const BTreeFile &file)
+        : file(file), filter(file.getTupleDesc()), remaining(0), current(nullptr) {
+    // the scan is at the end until it is opened
+    position.started = true;
+}
+
+const TupleDesc &ReverseBTreeScan::getTupleDesc() const { return file.getTupleDesc(); }
+
+void ReverseBTreeScan::open() {
+    position = {};
+    remaining = 0;
+    current = nullptr;
+}
+
+bool ReverseBTreeScan::next() {
+    const size_t length = file.getTupleDesc().length();
+    while (remaining == 0) {
+        rows.clear();
+        if (!file.readPreviousLeaf(position, rows, filter)) {
+            current = nullptr;
+            return false;
+        }
+        remaining = rows.size() / length;
+    }
+    current = rows.data() + --remaining * length;
+    return true;
+}
+
+const uint8_t *ReverseBTreeScan::row() const { return current; }
+
+bool ReverseBTreeScan::pushDown(const Predicate &predicate) {
+    filter.add(predicate);
+    return true;
+}
@@ -0,0 +1,244 @@
+#include <cmath>
+#include <cstring>
+#include <db/ScanFilter.hpp>
+#include <db/ScanKernels.hpp>
+#include <limits>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    /// The number of tuples evaluated at a time by ScanFilter::apply
+    constexpr size_t chunk_size = 4096;
+    constexpr size_t chunk_words = chunk_size / 64;
+
+    template<typename T>
+    bool inRanges(const uint8_t *data, const std::vector<std::pair<T, T>> &ranges) {
+        T v;
+        memcpy(&v, data, sizeof(v));
+        for (const auto &[low, high]: ranges) {
+            if (v >= low && v <= high) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename T>
+    std::vector<std::pair<T, T>> ranges(PredicateOp op, T v) {
+        constexpr T min = std::numeric_limits<T>::lowest();
+        constexpr T max = std::numeric_limits<T>::max();
+        if constexpr (std::is_floating_point_v<T>) {
+            constexpr T inf = std::numeric_limits<T>::infinity();
+            switch (op) {
+                case PredicateOp::EQ:
+                case PredicateOp::NE:
+                    return {{v, v}};
+                case PredicateOp::LT:
+                    return v == -inf ? std::vector<std::pair<T, T>>{} : std::vector<std::pair<T, T>>{{-inf, std::nextafter(v, -inf)}};
+                case PredicateOp::LE:
+                    return {{-inf, v}};
+                case PredicateOp::GT:
+                    return v == inf ? std::vector<std::pair<T, T>>{} : std::vector<std::pair<T, T>>{{std::nextafter(v, inf), inf}};
+                case PredicateOp::GE:
+                    return {{v, inf}};
+            }
+        } else {
+            switch (op) {
+                case PredicateOp::EQ:
+                case PredicateOp::NE:
+                    return {{v, v}};
+                case PredicateOp::LT:
+                    return v == min ? std::vector<std::pair<T, T>>{} : std::vector<std::pair<T, T>>{{min, v - 1}};
+                case PredicateOp::LE:
+                    return {{min, v}};
+                case PredicateOp::GT:
+                    return v == max ? std::vector<std::pair<T, T>>{} : std::vector<std::pair<T, T>>{{v + 1, max}};
+                case PredicateOp::GE:
+                    return {{v, max}};
+            }
+        }
+        return {};
+    }
+} // namespace
+
+ScanFilter::ScanFilter(const TupleDesc &td) : td(td) {}
+
+ScanFilter::Term &ScanFilter::addTerm(size_t field, bool negate) {
+    Term &term = terms.emplace_back();
+    term.field = field;
+    term.offset = td.offset_of(field);
+    term.type = td.field_type(field);
+    term.negate = negate;
+    return term;
+}
+
+void ScanFilter::add(const Predicate &predicate) {
+    predicate.check(td);
+    const bool negate = predicate.op == PredicateOp::NE;
+    switch (td.field_type(predicate.field)) {
+        case type_t::INT:
+            addTerm(predicate.field, negate).int_ranges = ranges(predicate.op, std::get<int>(predicate.value));
+            break;
+        case type_t::DOUBLE: {
+            const double v = std::get<double>(predicate.value);
+            // NaN is not equal, less or greater than any value: no range contains it
+            addTerm(predicate.field, negate).double_ranges =
+                    std::isnan(v) ? std::vector<std::pair<double, double>>{} : ranges(predicate.op, v);
+            break;
+        }
+        case type_t::CHAR:
+            if (predicate.op == PredicateOp::EQ || negate) {
+                addMatch(predicate.field, std::get<std::string>(predicate.value), false, negate);
+            } else {
+                addTerm(predicate.field, false).predicate = predicate;
+            }
+            break;
+    }
+}
+
+void ScanFilter::addBetween(size_t field, const field_t &low, const field_t &high) {
+    Predicate{field, PredicateOp::GE, low}.check(td);
+    Predicate{field, PredicateOp::LE, high}.check(td);
+    switch (td.field_type(field)) {
+        case type_t::INT:
+            addTerm(field, false).int_ranges = {{std::get<int>(low), std::get<int>(high)}};
+            break;
+        case type_t::DOUBLE:
+            addTerm(field, false).double_ranges = {{std::get<double>(low), std::get<double>(high)}};
+            break;
+        case type_t::CHAR:
+            throw std::logic_error("BETWEEN is not supported on CHAR fields");
+    }
+}
+
+void ScanFilter::addIn(size_t field, const std::vector<field_t> &values) {
+    for (const field_t &value: values) {
+        Predicate{field, PredicateOp::EQ, value}.check(td);
+    }
+    if (field >= td.size() || td.field_type(field) == type_t::CHAR) {
+        throw std::logic_error("IN is only supported on INT and DOUBLE fields");
+    }
+    Term &term = addTerm(field, false);
+    for (const field_t &value: values) {
+        if (term.type == type_t::INT) {
+            term.int_ranges.emplace_back(std::get<int>(value), std::get<int>(value));
+        } else if (!std::isnan(std::get<double>(value))) {
+            term.double_ranges.emplace_back(std::get<double>(value), std::get<double>(value));
+        }
+    }
+}
+
+void ScanFilter::addPrefix(size_t field, const std::string &prefix) {
+    Predicate{field, PredicateOp::EQ, prefix}.check(td);
+    addMatch(field, prefix, true, false);
+}
+
+void ScanFilter::addMatch(size_t field, const std::string &value, bool prefix, bool negate) {
+    Term &term = addTerm(field, negate);
+    // the bytes of the field past the end of the string are 0, longer strings never match
+    if (value.size() > CHAR_SIZE) {
+        return;
+    }
+    term.match.assign(2 * CHAR_SIZE, 0);
+    memcpy(term.match.data(), value.data(), value.size());
+    const size_t compared = prefix ? value.size() : std::min(value.size() + 1, CHAR_SIZE);
+    std::fill(term.match.begin() + CHAR_SIZE, term.match.begin() + CHAR_SIZE + compared, 0xFF);
+}
+
+bool ScanFilter::empty() const { return terms.empty(); }
+
+void ScanFilter::apply(const uint8_t *rows, size_t count, uint64_t *bitmap) const {
+    const size_t stride = td.length();
+    std::array<uint64_t, chunk_words> result{};
+    std::array<uint64_t, chunk_words> other{};
+    for (size_t first = 0; first < count; first += chunk_size) {
+        const size_t n = std::min(chunk_size, count - first);
+        const size_t words = (n + 63) / 64;
+        uint64_t *out = bitmap + first / 64;
+        for (const Term &term: terms) {
+            const uint8_t *data = rows + first * stride + term.offset;
+            if (term.predicate.has_value()) {
+                result.fill(0);
+                for (size_t i = 0; i < n; i++) {
+                    result[i / 64] |= static_cast<uint64_t>(term.predicate->test(td, data - term.offset + i * stride))
+                            << i % 64;
+                }
+            } else if (!term.int_ranges.empty() || !term.double_ranges.empty()) {
+                for (size_t r = 0; r < term.int_ranges.size() + term.double_ranges.size(); r++) {
+                    uint64_t *target = r == 0 ? result.data() : other.data();
+                    if (term.type == type_t::INT) {
+                        selectIntRange(data, stride, n, term.int_ranges[r].first, term.int_ranges[r].second, target);
+                    } else {
+                        selectDoubleRange(data, stride, n, term.double_ranges[r].first,
+                                          term.double_ranges[r].second, target);
+                    }
+                    for (size_t w = 0; r != 0 && w < words; w++) {
+                        result[w] |= other[w];
+                    }
+                }
+            } else if (!term.match.empty()) {
+                selectCharMatch(data, stride, n, term.match.data(), term.match.data() + CHAR_SIZE, result.data());
+            } else {
+                // nothing can match
+                result.fill(0);
+            }
+            uint64_t any = 0;
+            for (size_t w = 0; w < words; w++) {
+                out[w] &= term.negate ? ~result[w] : result[w];
+                any |= out[w];
+            }
+            if (any == 0) {
+                break;
+            }
+        }
+        if (n % 64 != 0) {
+            // the bits of negated terms past the last tuple
+            out[words - 1] &= (uint64_t{1} << n % 64) - 1;
+        }
+    }
+}
+
+bool ScanFilter::test(const Term &term, const uint8_t *row) const {
+    const uint8_t *data = row + term.offset;
+    bool match;
+    if (term.predicate.has_value()) {
+        match = term.predicate->test(td, row);
+    } else if (term.type == type_t::INT) {
+        match = inRanges(data, term.int_ranges);
+    } else if (term.type == type_t::DOUBLE) {
+        match = inRanges(data, term.double_ranges);
+    } else {
+        match = !term.match.empty();
+        for (size_t j = 0; match && j < CHAR_SIZE; j++) {
+            match = ((data[j] ^ term.match[j]) & term.match[CHAR_SIZE + j]) == 0;
+        }
+    }
+    return match != term.negate;
+}
+
+bool ScanFilter::test(const uint8_t *row) const {
+    for (const Term &term: terms) {
+        if (!test(term, row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ScanFilter::compact(uint8_t *rows, size_t count) const {
+    if (terms.empty()) {
+        return count;
+    }
+    const size_t length = td.length();
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (test(rows + i * length)) {
+            if (kept != i) {
+                memcpy(rows + kept * length, rows + i * length, length);
+            }
+            kept++;
+        }
+    }
+    return kept;
+}
@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <db/ScanKernels.hpp>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DB_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+using namespace db;
+
+namespace {
+    int loadInt(const uint8_t *data) {
+        int v;
+        memcpy(&v, data, sizeof(v));
+        return v;
+    }
+
+    double loadDouble(const uint8_t *data) {
+        double v;
+        memcpy(&v, data, sizeof(v));
+        return v;
+    }
+
+    bool inRange(int v, int low, int high) {
+        // a single unsigned comparison: values below low wrap around to large numbers
+        return static_cast<uint32_t>(v) - static_cast<uint32_t>(low) <=
+               static_cast<uint32_t>(high) - static_cast<uint32_t>(low);
+    }
+
+    bool matches(const uint8_t *field, const uint8_t *pattern, const uint8_t *mask) {
+        uint64_t diff = 0;
+        for (size_t j = 0; j < CHAR_SIZE; j += sizeof(uint64_t)) {
+            uint64_t f, p, m;
+            memcpy(&f, field + j, sizeof(f));
+            memcpy(&p, pattern + j, sizeof(p));
+            memcpy(&m, mask + j, sizeof(m));
+            diff |= (f ^ p) & m;
+        }
+        return diff == 0;
+    }
+
+    void clear(size_t count, uint64_t *bitmap) { std::fill(bitmap, bitmap + (count + 63) / 64, 0); }
+
+    void intRangeScalar(const uint8_t *data, size_t stride, size_t count, int low, int high, uint64_t *bitmap) {
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; i++) {
+                bits |= static_cast<uint64_t>(inRange(loadInt(data + (first + i) * stride), low, high)) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+    void doubleRangeScalar(const uint8_t *data, size_t stride, size_t count, double low, double high,
+                           uint64_t *bitmap) {
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; i++) {
+                const double v = loadDouble(data + (first + i) * stride);
+                bits |= static_cast<uint64_t>(v >= low && v <= high) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+    void charMatchScalar(const uint8_t *data, size_t stride, size_t count, const uint8_t *pattern,
+                         const uint8_t *mask, uint64_t *bitmap) {
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; i++) {
+                bits |= static_cast<uint64_t>(matches(data + (first + i) * stride, pattern, mask)) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+#ifdef DB_SIMD_X86
+    /*
+     * The fields are strided, so the vector kernels gather them: lane k of a chunk reads the field of tuple
+     * first + i + k at offset k * stride from the first tuple of the chunk.
+     */
+
+    __attribute__((target("avx2")))
+    void intRangeAvx2(const uint8_t *data, size_t stride, size_t count, int low, int high, uint64_t *bitmap) {
+        const int s = static_cast<int>(stride);
+        const __m256i offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+        const __m256i lo = _mm256_set1_epi32(low);
+        const __m256i hi = _mm256_set1_epi32(high);
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const auto *base = reinterpret_cast<const int *>(data + (first + i) * stride);
+                const __m256i v = _mm256_i32gather_epi32(base, offsets, 1);
+                const __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+                const auto mask = static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(out)));
+                bits |= (~mask & 0xFF) << i;
+            }
+            for (; i < n; i++) {
+                bits |= static_cast<uint64_t>(inRange(loadInt(data + (first + i) * stride), low, high)) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void doubleRangeAvx2(const uint8_t *data, size_t stride, size_t count, double low, double high,
+                         uint64_t *bitmap) {
+        const int s = static_cast<int>(stride);
+        const __m128i offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+        const __m256d lo = _mm256_set1_pd(low);
+        const __m256d hi = _mm256_set1_pd(high);
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) {
+                const auto *base = reinterpret_cast<const double *>(data + (first + i) * stride);
+                const __m256d v = _mm256_i32gather_pd(base, offsets, 1);
+                const __m256d in = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ), _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+                bits |= static_cast<uint64_t>(_mm256_movemask_pd(in)) << i;
+            }
+            for (; i < n; i++) {
+                const double v = loadDouble(data + (first + i) * stride);
+                bits |= static_cast<uint64_t>(v >= low && v <= high) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+    __attribute__((target("avx2")))
+    void charMatchAvx2(const uint8_t *data, size_t stride, size_t count, const uint8_t *pattern,
+                       const uint8_t *mask, uint64_t *bitmap) {
+        const __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pattern));
+        const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pattern + 32));
+        const __m256i m0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask));
+        const __m256i m1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + 32));
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; i++) {
+                const uint8_t *field = data + (first + i) * stride;
+                const __m256i f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(field));
+                const __m256i f1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(field + 32));
+                const __m256i diff = _mm256_or_si256(_mm256_and_si256(_mm256_xor_si256(f0, p0), m0),
+                                                     _mm256_and_si256(_mm256_xor_si256(f1, p1), m1));
+                bits |= static_cast<uint64_t>(_mm256_testz_si256(diff, diff)) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void intRangeAvx512(const uint8_t *data, size_t stride, size_t count, int low, int high, uint64_t *bitmap) {
+        const __m512i offsets = _mm512_mullo_epi32(
+                _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                _mm512_set1_epi32(static_cast<int>(stride)));
+        const __m512i lo = _mm512_set1_epi32(low);
+        const __m512i hi = _mm512_set1_epi32(high);
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                const __m512i v = _mm512_i32gather_epi32(offsets, data + (first + i) * stride, 1);
+                const __mmask16 in = _mm512_cmpge_epi32_mask(v, lo) & _mm512_cmple_epi32_mask(v, hi);
+                bits |= static_cast<uint64_t>(in) << i;
+            }
+            for (; i < n; i++) {
+                bits |= static_cast<uint64_t>(inRange(loadInt(data + (first + i) * stride), low, high)) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void doubleRangeAvx512(const uint8_t *data, size_t stride, size_t count, double low, double high,
+                           uint64_t *bitmap) {
+        const int s = static_cast<int>(stride);
+        const __m256i offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+        const __m512d lo = _mm512_set1_pd(low);
+        const __m512d hi = _mm512_set1_pd(high);
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8) {
+                const __m512d v = _mm512_i32gather_pd(offsets, data + (first + i) * stride, 1);
+                const __mmask8 in = _mm512_cmp_pd_mask(v, lo, _CMP_GE_OQ) & _mm512_cmp_pd_mask(v, hi, _CMP_LE_OQ);
+                bits |= static_cast<uint64_t>(in) << i;
+            }
+            for (; i < n; i++) {
+                const double v = loadDouble(data + (first + i) * stride);
+                bits |= static_cast<uint64_t>(v >= low && v <= high) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void charMatchAvx512(const uint8_t *data, size_t stride, size_t count, const uint8_t *pattern,
+                         const uint8_t *mask, uint64_t *bitmap) {
+        const __m512i p = _mm512_loadu_si512(pattern);
+        const __m512i m = _mm512_loadu_si512(mask);
+        for (size_t first = 0; first < count; first += 64) {
+            const size_t n = std::min<size_t>(64, count - first);
+            uint64_t bits = 0;
+            for (size_t i = 0; i < n; i++) {
+                const __m512i f = _mm512_loadu_si512(data + (first + i) * stride);
+                bits |= static_cast<uint64_t>(_mm512_test_epi64_mask(_mm512_xor_si512(f, p), m) == 0) << i;
+            }
+            bitmap[first / 64] = bits;
+        }
+    }
+#endif
+
+    SimdLevel bestLevel() {
+        if (simdSupported(SimdLevel::AVX512)) {
+            return SimdLevel::AVX512;
+        }
+        if (simdSupported(SimdLevel::AVX2)) {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::SCALAR;
+    }
+
+    std::atomic<SimdLevel> &currentLevel() {
+        static std::atomic<SimdLevel> level{bestLevel()};
+        return level;
+    }
+} // namespace
+
+bool db::simdSupported(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR:
+            return true;
+#ifdef DB_SIMD_X86
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+SimdLevel db::getSimdLevel() { return currentLevel().load(std::memory_order_relaxed); }
+
+void db::setSimdLevel(SimdLevel level) {
+    if (!simdSupported(level)) {
+        throw std::logic_error("Instruction set not supported");
+    }
+    currentLevel().store(level, std::memory_order_relaxed);
+}
+
+void db::selectIntRange(const uint8_t *data, size_t stride, size_t count, int low, int high, uint64_t *bitmap) {
+    if (low > high) {
+        return clear(count, bitmap);
+    }
+    switch (getSimdLevel()) {
+#ifdef DB_SIMD_X86
+        case SimdLevel::AVX512:
+            return intRangeAvx512(data, stride, count, low, high, bitmap);
+        case SimdLevel::AVX2:
+            return intRangeAvx2(data, stride, count, low, high, bitmap);
+#endif
+        default:
+            return intRangeScalar(data, stride, count, low, high, bitmap);
+    }
+}
+
+void db::selectDoubleRange(const uint8_t *data, size_t stride, size_t count, double low, double high,
+                           uint64_t *bitmap) {
+    switch (getSimdLevel()) {
+#ifdef DB_SIMD_X86
+        case SimdLevel::AVX512:
+            return doubleRangeAvx512(data, stride, count, low, high, bitmap);
+        case SimdLevel::AVX2:
+            return doubleRangeAvx2(data, stride, count, low, high, bitmap);
+#endif
+        default:
+            return doubleRangeScalar(data, stride, count, low, high, bitmap);
+    }
+}
+
+void db::selectCharMatch(const uint8_t *data, size_t stride, size_t count, const uint8_t *pattern,
+                         const uint8_t *mask, uint64_t *bitmap) {
+    switch (getSimdLevel()) {
+#ifdef DB_SIMD_X86
+        case SimdLevel::AVX512:
+            return charMatchAvx512(data, stride, count, pattern, mask, bitmap);
+        case SimdLevel::AVX2:
+            return charMatchAvx2(data, stride, count, pattern, mask, bitmap);
+#endif
+        default:
+            return charMatchScalar(data, stride, count, pattern, mask, bitmap);
+    }
+}
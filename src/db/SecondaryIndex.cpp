@@ -0,0 +1,41 @@
+#include <db/Database.hpp>
+#include <db/SecondaryIndex.hpp>
+
+using namespace db;
+
+namespace {
+    TupleDesc entryDesc(const TupleDesc &td, size_t field) {
+        return {{td.field_type(field), type_t::INT, type_t::INT}, {"key", "page", "slot"}};
+    }
+} // namespace
+
+SecondaryIndex::SecondaryIndex(const std::string &name, const std::string &table, const TupleDesc &td, size_t field)
+        : BTreeFile(name, entryDesc(td, field), std::vector<size_t>{0, 1, 2}), table(table), field(field) {}
+
+const std::string &SecondaryIndex::getTable() const { return table; }
+
+size_t SecondaryIndex::getField() const { return field; }
+
+void SecondaryIndex::insertEntry(const Tuple &t, size_t page, size_t slot) {
+    insertTuple({{t.get_field(field), static_cast<int>(page), static_cast<int>(slot)}});
+}
+
+void SecondaryIndex::deleteEntry(const Tuple &t, size_t page, size_t slot) {
+    deleteKey({t.get_field(field), static_cast<int>(page), static_cast<int>(slot)});
+}
+
+std::vector<Iterator> SecondaryIndex::find(const field_t &value) const { return findRange(value, value); }
+
+std::vector<Iterator> SecondaryIndex::findRange(const field_t &low, const field_t &high) const {
+    const DbFile &file = getDatabase().get(table);
+    std::vector<Iterator> result;
+    // the entries with the smallest value start at the first entry whose key starts with it
+    for (Iterator it = lowerBound({low}); it != end(); next(it)) {
+        Tuple entry = getTuple(it);
+        if (high < entry.get_field(0)) {
+            break;
+        }
+        result.emplace_back(file, std::get<int>(entry.get_field(1)), std::get<int>(entry.get_field(2)));
+    }
+    return result;
+}
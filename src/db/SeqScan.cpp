@@ -0,0 +1,40 @@
+#include <db/SeqScan.hpp>
+
+using namespace db;
+
+SeqScan::SeqScan(const DbFile &file) : file(file), filter(file.getTupleDesc()), count(0), pos(0), current(nullptr) {}
+
+const TupleDesc &SeqScan::getTupleDesc() const { return file.getTupleDesc(); }
+
+void SeqScan::open() {
+    it.emplace(file.begin());
+    count = 0;
+    pos = 0;
+    current = nullptr;
+}
+
+bool SeqScan::next() {
+    const size_t length = file.getTupleDesc().length();
+    while (true) {
+        if (pos < count) {
+            current = rows.data() + pos++ * length;
+            return true;
+        }
+        if (!it.has_value() || *it == file.end()) {
+            current = nullptr;
+            return false;
+        }
+        rows.clear();
+        count = file.readTuples(*it, rows, filter);
+        pos = 0;
+    }
+}
+
+const uint8_t *SeqScan::row() const { return current; }
+
+bool SeqScan::pushDown(const Predicate &predicate) {
+    filter.add(predicate);
+    return true;
+}
+
+ScanFilter &SeqScan::getFilter() { return filter; }
@@ -0,0 +1,53 @@
+#include <db/Database.hpp>
+#include <db/SnapshotScan.hpp>
+
+using namespace db;
+
+SnapshotScan::SnapshotScan(const VersionedHeapFile &file, const ReadView *view)
+        : file(file), shared_view(view), filter(file.getTupleDesc()), view(nullptr), page(0), num_pages(0), count(0),
+          pos(0), current(nullptr) {}
+
+const TupleDesc &SnapshotScan::getTupleDesc() const { return file.getTupleDesc(); }
+
+void SnapshotScan::open() {
+    if (shared_view != nullptr) {
+        view = shared_view;
+    } else {
+        own_view.reset();
+        view = &own_view.emplace(getDatabase().getVersionClock());
+    }
+    // the pages added after the snapshot only have newer versions
+    num_pages = file.getNumVisiblePages();
+    page = 0;
+    count = 0;
+    pos = 0;
+    current = nullptr;
+}
+
+bool SnapshotScan::next() {
+    const size_t length = file.getTupleDesc().length();
+    while (true) {
+        if (pos < count) {
+            current = rows.data() + pos++ * length;
+            return true;
+        }
+        if (view == nullptr || page == num_pages) {
+            own_view.reset();
+            view = nullptr;
+            current = nullptr;
+            return false;
+        }
+        rows.clear();
+        count = file.readSnapshot(page++, *view, rows, filter);
+        pos = 0;
+    }
+}
+
+const uint8_t *SnapshotScan::row() const { return current; }
+
+bool SnapshotScan::pushDown(const Predicate &predicate) {
+    filter.add(predicate);
+    return true;
+}
+
+ScanFilter &SnapshotScan::getFilter() { return filter; }
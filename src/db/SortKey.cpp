@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstring>
+#include <db/SortKey.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    void storeBigEndian(uint8_t *out, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) {
+            out[i] = static_cast<uint8_t>(value >> (8 * (bytes - 1 - i)));
+        }
+    }
+
+    size_t keyWidth(type_t type) {
+        switch (type) {
+            case type_t::INT:
+                return INT_SIZE;
+            case type_t::DOUBLE:
+                return DOUBLE_SIZE;
+            case type_t::CHAR:
+                return CHAR_SIZE;
+        }
+        throw std::logic_error("Unknown field type");
+    }
+} // namespace
+
+SortKey::SortKey(const TupleDesc &td, const std::vector<SortField> &fields) : key_length(0) {
+    if (fields.empty()) {
+        throw std::logic_error("A sort needs at least one field");
+    }
+    for (const SortField &field: fields) {
+        if (field.field >= td.size()) {
+            throw std::logic_error("Sort field out of range");
+        }
+        this->fields.push_back({td.offset_of(field.field), td.field_type(field.field), field.descending});
+        key_length += keyWidth(td.field_type(field.field));
+    }
+}
+
+size_t SortKey::length() const { return key_length; }
+
+void SortKey::encode(const uint8_t *row, uint8_t *key) const {
+    for (const KeyField &field: fields) {
+        const uint8_t *value = row + field.offset;
+        const size_t width = keyWidth(field.type);
+        switch (field.type) {
+            case type_t::INT: {
+                int v;
+                memcpy(&v, value, sizeof(v));
+                storeBigEndian(key, static_cast<uint32_t>(v) ^ 0x80000000u, INT_SIZE);
+                break;
+            }
+            case type_t::DOUBLE: {
+                uint64_t bits;
+                memcpy(&bits, value, sizeof(bits));
+                // negative numbers sort in reverse order of their magnitude
+                bits = bits >> 63 ? ~bits : bits | 1ull << 63;
+                storeBigEndian(key, bits, DOUBLE_SIZE);
+                break;
+            }
+            case type_t::CHAR: {
+                // the padding sorts a string before every longer string that starts with it
+                const size_t length = strnlen(reinterpret_cast<const char *>(value), CHAR_SIZE);
+                memcpy(key, value, length);
+                std::fill(key + length, key + CHAR_SIZE, 0);
+                break;
+            }
+        }
+        if (field.descending) {
+            for (size_t i = 0; i < width; i++) {
+                key[i] = ~key[i];
+            }
+        }
+        key += width;
+    }
+}
+
+uint64_t SortKey::prefix(const uint8_t *key) const {
+    uint64_t prefix = 0;
+    for (size_t b = 0; b < 8; b++) {
+        prefix = prefix << 8 | (b < key_length ? key[b] : 0);
+    }
+    return prefix;
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/SortMergeJoin.hpp>
+#include <stdexcept>
+
+using namespace db;
+
+SortMergeJoin::SortMergeJoin(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right, size_t left_field,
+                             size_t right_field)
+        : left_child(std::move(left)), right_child(std::move(right)),
+          left_key(left_child->getTupleDesc(), left_field), right_key(right_child->getTupleDesc(), right_field),
+          td(TupleDesc::merge(left_child->getTupleDesc(), right_child->getTupleDesc())), right_valid(false),
+          group_count(0), group_pos(0) {
+    if (left_key.type != right_key.type) {
+        throw std::logic_error("Join keys have different types");
+    }
+}
+
+bool SortMergeJoin::nextLeft() {
+    if (!left_child->next()) {
+        return false;
+    }
+    const uint8_t *row = left_child->row();
+    if (!last_left.empty() && left_key.compare(row, left_key, last_left.data()) < 0) {
+        throw std::runtime_error("Left input of the merge join is not sorted");
+    }
+    last_left.assign(row, row + left_child->getTupleDesc().length());
+    return true;
+}
+
+bool SortMergeJoin::nextRight() {
+    if (!right_child->next()) {
+        return false;
+    }
+    const uint8_t *row = right_child->row();
+    if (!last_right.empty() && right_key.compare(row, right_key, last_right.data()) < 0) {
+        throw std::runtime_error("Right input of the merge join is not sorted");
+    }
+    last_right.assign(row, row + right_child->getTupleDesc().length());
+    return true;
+}
+
+const TupleDesc &SortMergeJoin::getTupleDesc() const { return td; }
+
+void SortMergeJoin::open() {
+    left_child->open();
+    right_child->open();
+    last_left.clear();
+    last_right.clear();
+    group.clear();
+    group_count = 0;
+    group_pos = 0;
+    right_valid = nextRight();
+}
+
+bool SortMergeJoin::next() {
+    const size_t left_length = left_child->getTupleDesc().length();
+    const size_t right_length = right_child->getTupleDesc().length();
+    while (true) {
+        if (group_pos < group_count) {
+            current.resize(td.length());
+            std::copy_n(left_child->row(), left_length, current.data());
+            std::copy_n(group.data() + group_pos * right_length, right_length, current.data() + left_length);
+            group_pos++;
+            return true;
+        }
+        if (!nextLeft()) {
+            return false;
+        }
+        const uint8_t *left = left_child->row();
+        group_pos = 0;
+        if (group_count > 0 && left_key.compare(left, right_key, group.data()) == 0) {
+            // a duplicate left key joins the same group
+            continue;
+        }
+        group.clear();
+        group_count = 0;
+        while (right_valid && left_key.compare(left, right_key, right_child->row()) > 0) {
+            right_valid = nextRight();
+        }
+        if (!right_valid) {
+            return false;
+        }
+        while (right_valid && left_key.compare(left, right_key, right_child->row()) == 0) {
+            const uint8_t *right = right_child->row();
+            group.insert(group.end(), right, right + right_length);
+            group_count++;
+            right_valid = nextRight();
+        }
+    }
+}
+
+const uint8_t *SortMergeJoin::row() const { return current.data(); }
+
+bool SortMergeJoin::pushDown(const Predicate &predicate) {
+    predicate.check(td);
+    const size_t left_size = left_child->getTupleDesc().size();
+    if (predicate.field < left_size) {
+        return left_child->pushDown(predicate);
+    }
+    Predicate input = predicate;
+    input.field -= left_size;
+    return right_child->pushDown(input);
+}
+
+bool SortMergeJoin::sortedOn(const DbFile &file, size_t field) {
+    const auto *btree = dynamic_cast<const BTreeFile *>(&file);
+    return btree != nullptr && btree->getKeyIndex() == field &&
+           file.getTupleDesc().field_type(field) != type_t::DOUBLE;
+}
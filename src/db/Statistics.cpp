@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <db/BTreeScan.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HyperLogLog.hpp>
+#include <db/SeqScan.hpp>
+#include <db/Statistics.hpp>
+#include <exception>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using namespace db;
+
+namespace {
+    /// The finalizer of MurmurHash3, so that every bit of the hash depends on every bit of the value
+    uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    std::string_view readString(const uint8_t *data) {
+        const char *chars = reinterpret_cast<const char *>(data);
+        return {chars, strnlen(chars, CHAR_SIZE)};
+    }
+
+    field_t readField(const TupleDesc &td, size_t field, const uint8_t *row) {
+        const uint8_t *data = row + td.offset_of(field);
+        switch (td.field_type(field)) {
+            case type_t::INT: {
+                int v;
+                memcpy(&v, data, sizeof(v));
+                return v;
+            }
+            case type_t::DOUBLE: {
+                double v;
+                memcpy(&v, data, sizeof(v));
+                return v;
+            }
+            case type_t::CHAR:
+                return std::string(readString(data));
+        }
+        return {};
+    }
+
+    double toNumber(const field_t &value) {
+        return std::holds_alternative<int>(value) ? std::get<int>(value) : std::get<double>(value);
+    }
+
+    /// Whether a page of a HeapFile is in a sample, the first page always is
+    bool sampled(size_t page, double sample) {
+        return page == 0 || sample >= 1 || static_cast<double>(mix(page)) < sample * 0x1p64;
+    }
+
+    /// The statistics of the rows read by a thread
+    struct Collector {
+        const TupleDesc &td;
+        size_t rows = 0;
+        std::vector<HyperLogLog> distinct;
+        /// The smallest and largest values of the INT and DOUBLE columns, and of the CHAR columns
+        std::vector<double> min_numbers;
+        std::vector<double> max_numbers;
+        std::vector<std::string> min_strings;
+        std::vector<std::string> max_strings;
+        /// A uniform sample of the rows, TableStatistics::SAMPLE_ROWS at most (reservoir sampling)
+        std::vector<uint8_t> sample;
+        std::mt19937_64 random;
+
+        Collector(const TupleDesc &td, size_t seed)
+            : td(td), distinct(td.size()), min_numbers(td.size(), INFINITY), max_numbers(td.size(), -INFINITY),
+              min_strings(td.size()), max_strings(td.size()), random(seed) {}
+
+        void add(const uint8_t *row) {
+            for (size_t i = 0; i < td.size(); i++) {
+                const uint8_t *data = row + td.offset_of(i);
+                switch (td.field_type(i)) {
+                    case type_t::INT: {
+                        int v;
+                        memcpy(&v, data, sizeof(v));
+                        distinct[i].add(mix(static_cast<uint32_t>(v)));
+                        min_numbers[i] = std::min(min_numbers[i], static_cast<double>(v));
+                        max_numbers[i] = std::max(max_numbers[i], static_cast<double>(v));
+                        break;
+                    }
+                    case type_t::DOUBLE: {
+                        double v;
+                        memcpy(&v, data, sizeof(v));
+                        uint64_t bits;
+                        memcpy(&bits, data, sizeof(bits));
+                        distinct[i].add(mix(bits));
+                        min_numbers[i] = std::min(min_numbers[i], v);
+                        max_numbers[i] = std::max(max_numbers[i], v);
+                        break;
+                    }
+                    case type_t::CHAR: {
+                        const std::string_view v = readString(data);
+                        distinct[i].add(mix(std::hash<std::string_view>{}(v)));
+                        if (rows == 0 || v < min_strings[i]) {
+                            min_strings[i] = v;
+                        }
+                        if (rows == 0 || v > max_strings[i]) {
+                            max_strings[i] = v;
+                        }
+                        break;
+                    }
+                }
+            }
+            const size_t length = td.length();
+            if (rows < TableStatistics::SAMPLE_ROWS) {
+                sample.insert(sample.end(), row, row + length);
+            } else if (const size_t j = std::uniform_int_distribution<size_t>(0, rows)(random);
+                       j < TableStatistics::SAMPLE_ROWS) {
+                memcpy(sample.data() + j * length, row, length);
+            }
+            rows++;
+        }
+    };
+
+    /// The bounds of the buckets of an equi-depth histogram of weighted values
+    std::vector<field_t> equiDepth(std::vector<std::pair<field_t, double>> values, size_t buckets) {
+        std::sort(values.begin(), values.end());
+        double total = 0;
+        for (const auto &[value, weight]: values) {
+            total += weight;
+        }
+        buckets = std::min(buckets, values.size());
+        std::vector<field_t> bounds;
+        // the rows of a bucket, less a rounding error so that the last value ends the last bucket
+        const double depth = total / static_cast<double>(buckets) * (1 - 1e-9);
+        double cumulative = 0;
+        for (const auto &[value, weight]: values) {
+            cumulative += weight;
+            // a value that fills several buckets bounds each of them
+            while (bounds.size() < buckets && cumulative >= depth * static_cast<double>(bounds.size() + 1)) {
+                bounds.push_back(value);
+            }
+        }
+        return bounds;
+    }
+} // namespace
+
+double ColumnStatistics::fractionBelow(const field_t &value) const {
+    if (bounds.empty()) {
+        return 0;
+    }
+    // the buckets before the first bound that is not less than the value are below it
+    const auto first = std::lower_bound(bounds.begin(), bounds.end(), value);
+    const auto i = static_cast<size_t>(first - bounds.begin());
+    if (i == bounds.size()) {
+        return 1;
+    }
+    const field_t &low = i == 0 ? *min : bounds[i - 1];
+    double partial = 0;
+    if (low < value && (first + 1 == bounds.end() || *(first + 1) != value)) {
+        if (std::holds_alternative<std::string>(value)) {
+            partial = 0.5;
+        } else {
+            partial = (toNumber(value) - toNumber(low)) / (toNumber(bounds[i]) - toNumber(low));
+        }
+    }
+    return (static_cast<double>(i) + partial) / static_cast<double>(bounds.size());
+}
+
+double ColumnStatistics::fractionEqual(const field_t &value) const {
+    if (!min.has_value() || value < *min || *max < value) {
+        return 0;
+    }
+    const double one = distinct > 0 ? 1 / distinct : 0;
+    // the value fills at least the buckets between its first and last bounds
+    const auto [first, last] = std::equal_range(bounds.begin(), bounds.end(), value);
+    if (last - first >= 2) {
+        return std::max(one, static_cast<double>(last - first - 1) / static_cast<double>(bounds.size()));
+    }
+    return one;
+}
+
+double ColumnStatistics::selectivity(PredicateOp op, const field_t &value) const {
+    double result = 0;
+    switch (op) {
+        case PredicateOp::EQ:
+            result = fractionEqual(value);
+            break;
+        case PredicateOp::NE:
+            result = 1 - fractionEqual(value);
+            break;
+        case PredicateOp::LT:
+            result = fractionBelow(value);
+            break;
+        case PredicateOp::LE:
+            result = fractionBelow(value) + fractionEqual(value);
+            break;
+        case PredicateOp::GT:
+            result = 1 - fractionBelow(value) - fractionEqual(value);
+            break;
+        case PredicateOp::GE:
+            result = 1 - fractionBelow(value);
+            break;
+    }
+    return std::clamp(result, 0.0, 1.0);
+}
+
+TableStatistics TableStatistics::collect(const DbFile &file, size_t workers, double sample, size_t buckets) {
+    if (workers == 0 || buckets == 0 || !(sample > 0 && sample <= 1)) {
+        throw std::logic_error("Invalid statistics parameters");
+    }
+    const TupleDesc &td = file.getTupleDesc();
+    const size_t length = td.length();
+    const size_t num_pages = file.getNumPages();
+    const auto *heap_file = dynamic_cast<const HeapFile *>(&file);
+
+    std::vector<std::function<void(Collector &)>> tasks;
+    std::atomic<size_t> next_page = 0;
+    std::atomic<size_t> sampled_pages = 0;
+    std::vector<std::unique_ptr<Operator>> scans;
+    if (heap_file != nullptr) {
+        for (size_t i = 0; i < workers; i++) {
+            tasks.emplace_back([&](Collector &collector) {
+                const ScanFilter none(td);
+                std::vector<uint8_t> rows;
+                for (size_t page; (page = next_page++) < num_pages;) {
+                    if (!sampled(page, sample)) {
+                        continue;
+                    }
+                    sampled_pages++;
+                    rows.clear();
+                    Iterator it{file, page, 0};
+                    const size_t count = heap_file->readTuples(it, rows, none);
+                    for (size_t j = 0; j < count; j++) {
+                        collector.add(rows.data() + j * length);
+                    }
+                }
+            });
+        }
+    } else {
+        if (const auto *btree = dynamic_cast<const BTreeFile *>(&file)) {
+            scans = BTreeScan::create(*btree, workers);
+        } else {
+            scans.push_back(std::make_unique<SeqScan>(file));
+        }
+        for (auto &scan: scans) {
+            tasks.emplace_back([&scan](Collector &collector) {
+                scan->open();
+                while (scan->next()) {
+                    collector.add(scan->row());
+                }
+            });
+        }
+    }
+
+    std::vector<Collector> collectors;
+    collectors.reserve(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        collectors.emplace_back(td, i);
+    }
+    if (tasks.size() == 1) {
+        tasks[0](collectors[0]);
+    } else {
+        std::vector<std::exception_ptr> errors(tasks.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            threads.emplace_back([&, i] {
+                try {
+                    tasks[i](collectors[i]);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        for (const auto &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    TableStatistics stats;
+    stats.pages = num_pages;
+    size_t seen = 0;
+    for (const Collector &collector: collectors) {
+        seen += collector.rows;
+    }
+    const bool partial = heap_file != nullptr && sample < 1 && seen > 0;
+    stats.rows = static_cast<double>(seen);
+    if (partial) {
+        stats.rows *= static_cast<double>(num_pages) / static_cast<double>(sampled_pages);
+    }
+    for (size_t i = 0; i < td.size(); i++) {
+        ColumnStatistics &column = stats.columns.emplace_back();
+        HyperLogLog distinct;
+        std::vector<std::pair<field_t, double>> values;
+        for (const Collector &collector: collectors) {
+            if (collector.rows == 0) {
+                continue;
+            }
+            distinct.merge(collector.distinct[i]);
+            if (td.field_type(i) == type_t::CHAR) {
+                if (!column.min.has_value() || collector.min_strings[i] < std::get<std::string>(*column.min)) {
+                    column.min = collector.min_strings[i];
+                }
+                if (!column.max.has_value() || collector.max_strings[i] > std::get<std::string>(*column.max)) {
+                    column.max = collector.max_strings[i];
+                }
+            } else {
+                const double low = column.min.has_value() ? std::min(toNumber(*column.min), collector.min_numbers[i])
+                                                          : collector.min_numbers[i];
+                const double high = column.max.has_value() ? std::max(toNumber(*column.max), collector.max_numbers[i])
+                                                           : collector.max_numbers[i];
+                if (td.field_type(i) == type_t::INT) {
+                    column.min = static_cast<int>(low);
+                    column.max = static_cast<int>(high);
+                } else {
+                    column.min = low;
+                    column.max = high;
+                }
+            }
+            // every row of the sample of a thread stands for the same number of rows of the thread
+            const size_t sample_rows = collector.sample.size() / length;
+            const double weight = static_cast<double>(collector.rows) / static_cast<double>(sample_rows);
+            for (size_t j = 0; j < sample_rows; j++) {
+                values.emplace_back(readField(td, i, collector.sample.data() + j * length), weight);
+            }
+        }
+        column.distinct = distinct.estimate();
+        if (partial) {
+            // the values of a column that are mostly distinct in the sample are mostly distinct in the file, the values
+            // that repeat in the sample were mostly seen
+            const double ratio = column.distinct / static_cast<double>(seen);
+            column.distinct *= std::pow(stats.rows / static_cast<double>(seen), std::min(ratio, 1.0));
+        }
+        column.distinct = std::min(column.distinct, stats.rows);
+        column.bounds = equiDepth(std::move(values), buckets);
+        if (column.max.has_value()) {
+            // the largest value may not be in the samples
+            column.bounds.back() = *column.max;
+        }
+    }
+    return stats;
+}
+
+double TableStatistics::selectivity(const std::vector<Predicate> &predicates) const {
+    double result = 1;
+    for (const Predicate &predicate: predicates) {
+        if (predicate.field >= columns.size()) {
+            throw std::logic_error("No statistics for the predicate field");
+        }
+        result *= columns[predicate.field].selectivity(predicate.op, predicate.value);
+    }
+    return result;
+}
@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <cstring>
+#include <db/BTreeFile.hpp>
+#include <db/StreamAggregate.hpp>
+
+using namespace db;
+
+StreamAggregate::StreamAggregate(std::unique_ptr<Operator> child, const std::vector<size_t> &group_fields,
+                                 const std::vector<Aggregate> &aggregates)
+        : child(std::move(child)), layout(this->child->getTupleDesc(), group_fields, aggregates), has_row(false),
+          produced(false), key(std::max<size_t>(layout.keyLength(), 1)), next_key(key.size()),
+          state(layout.stateLength()), current(layout.getTupleDesc().length()) {}
+
+const TupleDesc &StreamAggregate::getTupleDesc() const { return layout.getTupleDesc(); }
+
+void StreamAggregate::open() {
+    child->open();
+    has_row = child->next();
+    produced = false;
+}
+
+bool StreamAggregate::next() {
+    if (!has_row) {
+        if (produced || !layout.getGroupFields().empty()) {
+            return false;
+        }
+        // an aggregate without group fields has a row even over an empty input
+        layout.initEmpty(state.data());
+        layout.finalize(key.data(), state.data(), current.data());
+        produced = true;
+        return true;
+    }
+    produced = true;
+    const uint8_t *row = child->row();
+    layout.key(row, key.data());
+    layout.init(state.data(), row);
+    while ((has_row = child->next())) {
+        row = child->row();
+        layout.key(row, next_key.data());
+        if (memcmp(next_key.data(), key.data(), layout.keyLength()) != 0) {
+            break;
+        }
+        layout.update(state.data(), row);
+    }
+    layout.finalize(key.data(), state.data(), current.data());
+    return true;
+}
+
+const uint8_t *StreamAggregate::row() const { return current.data(); }
+
+bool StreamAggregate::pushDown(const Predicate &predicate) {
+    predicate.check(getTupleDesc());
+    const auto &group_fields = layout.getGroupFields();
+    if (predicate.field >= group_fields.size()) {
+        return false;
+    }
+    Predicate input = predicate;
+    input.field = group_fields[predicate.field];
+    return child->pushDown(input);
+}
+
+bool StreamAggregate::sortedOn(const DbFile &file, const std::vector<size_t> &group_fields) {
+    if (group_fields.empty()) {
+        return true;
+    }
+    const auto *btree = dynamic_cast<const BTreeFile *>(&file);
+    if (btree == nullptr) {
+        return false;
+    }
+    std::vector<size_t> key = btree->getKeyIndices();
+    if (key.size() < group_fields.size()) {
+        return false;
+    }
+    key.resize(group_fields.size());
+    return std::is_permutation(key.begin(), key.end(), group_fields.begin());
+}
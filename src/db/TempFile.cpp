@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <db/TempFile.hpp>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace db;
+
+namespace {
+    std::atomic<size_t> next_id{0};
+
+    const std::string &truncate(const std::string &name) {
+        std::remove(name.c_str());
+        return name;
+    }
+} // namespace
+
+TempFile::TempFile(const std::string &name, const TupleDesc &td, size_t block_pages)
+        : file(truncate(name), td), rows_per_page(DEFAULT_PAGE_SIZE / td.length()),
+          block_pages(std::max<size_t>(block_pages, 1)), buffer(this->block_pages * DEFAULT_PAGE_SIZE),
+          buffer_rows(0), num_pages(0), num_rows(0), flushed(false) {}
+
+TempFile::~TempFile() { std::remove(file.getName().c_str()); }
+
+std::string TempFile::uniqueName(const std::string &prefix) {
+    return prefix + "_" + std::to_string(getpid()) + "_" + std::to_string(next_id++) + ".tmp";
+}
+
+const std::string &TempFile::getName() const { return file.getName(); }
+
+void TempFile::writeBuffer() {
+    const size_t pages = (buffer_rows + rows_per_page - 1) / rows_per_page;
+    file.writePages(buffer.data(), num_pages, pages);
+    num_pages += pages;
+    buffer_rows = 0;
+}
+
+void TempFile::append(const uint8_t *row) {
+    if (flushed) {
+        throw std::logic_error("Cannot append to a flushed TempFile");
+    }
+    const size_t length = file.getTupleDesc().length();
+    const size_t page = buffer_rows / rows_per_page;
+    const size_t slot = buffer_rows % rows_per_page;
+    std::copy_n(row, length, buffer.data() + page * DEFAULT_PAGE_SIZE + slot * length);
+    num_rows++;
+    if (++buffer_rows == block_pages * rows_per_page) {
+        writeBuffer();
+    }
+}
+
+void TempFile::flush() {
+    flushed = true;
+    if (buffer_rows > 0) {
+        writeBuffer();
+    }
+    buffer = {};
+}
+
+size_t TempFile::size() const { return num_rows; }
+
+size_t TempFile::numPages() const { return num_pages; }
+
+size_t TempFile::readPage(size_t id, std::vector<uint8_t> &rows) const { return readPages(id, 1, rows); }
+
+size_t TempFile::readPages(size_t first, size_t count, std::vector<uint8_t> &rows) const {
+    if (first >= num_pages) {
+        return 0;
+    }
+    count = std::min(count, num_pages - first);
+    std::vector<uint8_t> pages(count * DEFAULT_PAGE_SIZE);
+    file.readPages(pages.data(), first, count);
+    const size_t length = file.getTupleDesc().length();
+    // every page but the last one is full
+    const size_t total = std::min(count * rows_per_page, num_rows - first * rows_per_page);
+    for (size_t page = 0, read = 0; read < total; page++) {
+        const size_t page_rows = std::min(rows_per_page, total - read);
+        const uint8_t *data = pages.data() + page * DEFAULT_PAGE_SIZE;
+        rows.insert(rows.end(), data, data + page_rows * length);
+        read += page_rows;
+    }
+    return total;
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstring>
+#include <db/BTreeFile.hpp>
+#include <db/Limit.hpp>
+#include <db/ReverseBTreeScan.hpp>
+#include <db/SeqScan.hpp>
+#include <db/TopK.hpp>
+
+using namespace db;
+
+TopK::TopK(std::unique_ptr<Operator> child, const std::vector<SortField> &fields, size_t k)
+        : child(std::move(child)), sort_key(this->child->getTupleDesc(), fields), k(k), pos(0), pending(false) {}
+
+const TupleDesc &TopK::getTupleDesc() const { return child->getTupleDesc(); }
+
+size_t TopK::slotLength() const { return sort_key.length() + getTupleDesc().length(); }
+
+bool TopK::less(uint32_t a, uint32_t b) const {
+    const size_t length = slotLength();
+    int cmp = memcmp(slots.data() + a * length, slots.data() + b * length, sort_key.length());
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    return positions[a] < positions[b];
+}
+
+void TopK::open() {
+    heap.clear();
+    pos = 0;
+    pending = false;
+    if (k == 0) {
+        return;
+    }
+    const size_t key_length = sort_key.length();
+    const size_t row_length = getTupleDesc().length();
+    const size_t length = slotLength();
+    // one more slot holds the key of the row being compared
+    const size_t capacity = k + 1;
+    slots.resize(std::min(capacity, size_t{1024}) * length);
+    positions.resize(slots.size() / length);
+    // the greatest row kept is at the front of the heap
+    auto order = [this](uint32_t a, uint32_t b) { return less(a, b); };
+
+    size_t position = 0;
+    child->open();
+    while (child->next()) {
+        const uint8_t *row = child->row();
+        if (heap.size() < k) {
+            const auto slot = static_cast<uint32_t>(heap.size());
+            if ((slot + 1) * length > slots.size()) {
+                slots.resize(std::min(capacity, 2 * positions.size()) * length);
+                positions.resize(slots.size() / length);
+            }
+            sort_key.encode(row, slots.data() + slot * length);
+            memcpy(slots.data() + slot * length + key_length, row, row_length);
+            positions[slot] = position++;
+            heap.push_back(slot);
+            std::push_heap(heap.begin(), heap.end(), order);
+            continue;
+        }
+        // the key is encoded in the spare slot, the row is only copied if it replaces the greatest row kept
+        const auto spare = static_cast<uint32_t>(k);
+        if (positions.size() < capacity) {
+            slots.resize(capacity * length);
+            positions.resize(capacity);
+        }
+        sort_key.encode(row, slots.data() + spare * length);
+        positions[spare] = position++;
+        if (!less(spare, heap.front())) {
+            continue;
+        }
+        std::pop_heap(heap.begin(), heap.end(), order);
+        const uint32_t slot = heap.back();
+        memcpy(slots.data() + slot * length, slots.data() + spare * length, key_length);
+        memcpy(slots.data() + slot * length + key_length, row, row_length);
+        positions[slot] = positions[spare];
+        std::push_heap(heap.begin(), heap.end(), order);
+    }
+    std::sort_heap(heap.begin(), heap.end(), order);
+}
+
+bool TopK::next() {
+    if (pending) {
+        pos++;
+    }
+    pending = true;
+    return pos < heap.size();
+}
+
+const uint8_t *TopK::row() const { return slots.data() + heap[pos] * slotLength() + sort_key.length(); }
+
+bool TopK::pushDown(const Predicate &predicate) { return child->pushDown(predicate); }
+
+std::unique_ptr<Operator> db::topK(const DbFile &file, const std::vector<SortField> &fields, size_t k,
+                                   const std::vector<Predicate> &predicates) {
+    // check the sort fields
+    const SortKey sort_key(file.getTupleDesc(), fields);
+    std::unique_ptr<Operator> scan;
+    if (const auto *tree = dynamic_cast<const BTreeFile *>(&file)) {
+        const std::vector<size_t> key = tree->getKeyIndices();
+        bool prefix = fields.size() <= key.size();
+        for (size_t i = 0; prefix && i < fields.size(); i++) {
+            prefix = fields[i].field == key[i] && fields[i].descending == fields[0].descending;
+        }
+        if (prefix && fields[0].descending) {
+            scan = std::make_unique<ReverseBTreeScan>(*tree);
+        } else if (prefix) {
+            scan = std::make_unique<SeqScan>(file);
+        }
+    }
+    const bool ordered = scan != nullptr;
+    if (!ordered) {
+        scan = std::make_unique<SeqScan>(file);
+    }
+    for (const Predicate &predicate: predicates) {
+        scan->pushDown(predicate);
+    }
+    if (ordered) {
+        return std::make_unique<Limit>(std::move(scan), k);
+    }
+    return std::make_unique<TopK>(std::move(scan), fields, k);
+}
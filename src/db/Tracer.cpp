@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <db/Tracer.hpp>
+#include <iomanip>
+#include <mutex>
+#include <tuple>
+
+using namespace db;
+
+std::atomic<bool> Tracer::active{false};
+
+namespace {
+    struct ThreadBuffer;
+
+    std::mutex registry_mutex;
+    /// The buffers of the running threads
+    std::vector<ThreadBuffer *> buffers;
+    /// The spans of the threads that have exited
+    std::vector<TraceEvent> retired;
+    std::atomic<uint32_t> next_thread{1};
+    std::atomic<std::chrono::steady_clock::rep> epoch{0};
+
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+        const uint32_t thread = next_thread.fetch_add(1, std::memory_order_relaxed);
+
+        ThreadBuffer() {
+            std::lock_guard lock(registry_mutex);
+            buffers.push_back(this);
+        }
+
+        ~ThreadBuffer() {
+            std::lock_guard lock(registry_mutex);
+            buffers.erase(std::find(buffers.begin(), buffers.end(), this));
+            std::lock_guard events_lock(mutex);
+            std::move(events.begin(), events.end(), std::back_inserter(retired));
+        }
+    };
+
+    ThreadBuffer &threadBuffer() {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+
+    thread_local Tracer::PageCounts page_counts;
+
+    void writeString(std::ostream &out, const std::string &s) {
+        out << '"';
+        for (char c: s) {
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                const char fill = out.fill('0');
+                out << "\\u" << std::hex << std::setw(4) << static_cast<int>(c) << std::dec;
+                out.fill(fill);
+            } else {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+
+    /// Write nanoseconds as the microseconds of the trace event format
+    void writeMicros(std::ostream &out, uint64_t ns) {
+        const char fill = out.fill('0');
+        out << ns / 1000 << '.' << std::setw(3) << ns % 1000;
+        out.fill(fill);
+    }
+} // namespace
+
+void Tracer::start() {
+    std::lock_guard lock(registry_mutex);
+    retired.clear();
+    for (ThreadBuffer *buffer: buffers) {
+        std::lock_guard events_lock(buffer->mutex);
+        buffer->events.clear();
+    }
+    epoch.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    active.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() { active.store(false, std::memory_order_relaxed); }
+
+uint64_t Tracer::now() {
+    const auto ticks = std::chrono::steady_clock::now().time_since_epoch().count() -
+                       epoch.load(std::memory_order_relaxed);
+    return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::duration(ticks)).count());
+}
+
+void Tracer::record(std::string name, const char *category, uint64_t start,
+                    std::vector<std::pair<const char *, uint64_t>> args) {
+    const uint64_t end = now();
+    ThreadBuffer &buffer = threadBuffer();
+    std::lock_guard lock(buffer.mutex);
+    buffer.events.push_back({std::move(name), category, buffer.thread, start, end - std::min(start, end),
+                             std::move(args)});
+}
+
+void Tracer::countPage(bool missed) {
+    page_counts.accessed++;
+    page_counts.missed += missed;
+}
+
+const Tracer::PageCounts &Tracer::getPageCounts() { return page_counts; }
+
+std::vector<TraceEvent> Tracer::getEvents() {
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard lock(registry_mutex);
+        events = retired;
+        for (ThreadBuffer *buffer: buffers) {
+            std::lock_guard events_lock(buffer->mutex);
+            events.insert(events.end(), buffer->events.begin(), buffer->events.end());
+        }
+    }
+    // a span ends after the spans nested in it, so the longest span comes first among spans with the same start
+    std::sort(events.begin(), events.end(), [](const TraceEvent &a, const TraceEvent &b) {
+        return std::tie(a.thread, a.start, b.duration) < std::tie(b.thread, b.start, a.duration);
+    });
+    return events;
+}
+
+void Tracer::writeChromeTrace(std::ostream &out) {
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    const char *separator = "\n";
+    for (const TraceEvent &event: getEvents()) {
+        out << separator << "{\"name\": ";
+        writeString(out, event.name);
+        out << ", \"cat\": \"" << event.category << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread
+            << ", \"ts\": ";
+        writeMicros(out, event.start);
+        out << ", \"dur\": ";
+        writeMicros(out, event.duration);
+        out << ", \"args\": {";
+        const char *arg_separator = "";
+        for (const auto &[key, value]: event.args) {
+            out << arg_separator << "\"" << key << "\": " << value;
+            arg_separator = ", ";
+        }
+        out << "}}";
+        separator = ",\n";
+    }
+    out << "\n]}\n";
+}
+
+void TraceSpan::finish() {
+    if (Tracer::enabled()) {
+        Tracer::record(name, category, start, std::move(args));
+    }
+}
+
+void TraceSpan::arg(const char *key, uint64_t value) {
+    if (start != UINT64_MAX) {
+        args.emplace_back(key, value);
+    }
+}
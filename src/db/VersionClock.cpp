@@ -0,0 +1,44 @@
+#include <db/VersionClock.hpp>
+
+using namespace db;
+
+VersionClock::VersionClock() : now(1) {}
+
+uint64_t VersionClock::getTimestamp() const {
+    std::lock_guard lock(mutex);
+    return now;
+}
+
+uint64_t VersionClock::commit(const std::function<void(uint64_t)> &stamp) {
+    std::lock_guard lock(mutex);
+    // snapshots are opened under the mutex, none of them can be at the new timestamp before it is published
+    stamp(now + 1);
+    return ++now;
+}
+
+uint64_t VersionClock::openSnapshot() {
+    std::lock_guard lock(mutex);
+    snapshots.insert(now);
+    return now;
+}
+
+void VersionClock::closeSnapshot(uint64_t timestamp) {
+    std::lock_guard lock(mutex);
+    snapshots.erase(snapshots.find(timestamp));
+}
+
+uint64_t VersionClock::horizon() const {
+    std::lock_guard lock(mutex);
+    return snapshots.empty() ? now : *snapshots.begin();
+}
+
+size_t VersionClock::getNumSnapshots() const {
+    std::lock_guard lock(mutex);
+    return snapshots.size();
+}
+
+ReadView::ReadView(VersionClock &clock) : clock(clock), ts(clock.openSnapshot()) {}
+
+ReadView::~ReadView() { clock.closeSnapshot(ts); }
+
+uint64_t ReadView::timestamp() const { return ts; }
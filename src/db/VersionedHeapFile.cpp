@@ -0,0 +1,188 @@
+#include <bit>
+#include <db/Database.hpp>
+#include <db/HeapPage.hpp>
+#include <db/ScanFilter.hpp>
+#include <db/SecondaryIndex.hpp>
+#include <db/VersionedHeapFile.hpp>
+#include <optional>
+#include <stdexcept>
+
+using namespace db;
+
+namespace {
+    size_t slotsPerPage(const TupleDesc &td) {
+        Page page{};
+        return HeapPage(page, td).end();
+    }
+} // namespace
+
+VersionedHeapFile::VersionedHeapFile(const std::string &name, const TupleDesc &td,
+                                     std::chrono::milliseconds gc_interval)
+        : HeapFile(name, td), clock(getDatabase().getVersionClock()), capacity(slotsPerPage(td)), visible_pages(0),
+          num_reclaimed(0), gc_interval(gc_interval), stopping(false) {
+    // the pages of the file are added again, their tuples were committed before any snapshot. The file is not in the
+    // Database yet, the pages are read directly.
+    const size_t pages = numPages;
+    numPages = 0;
+    Page p;
+    for (size_t page = 0; page < pages; page++) {
+        addPage();
+        readPage(p, page);
+        const HeapPage hp(p, td);
+        for (size_t slot = capacity; slot-- > 0;) {
+            if (hp.empty(slot)) {
+                free_slots.emplace_back(page, slot);
+            } else {
+                version(page, slot).begin.store(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    if (gc_interval.count() > 0) {
+        collector = std::thread([this] {
+            std::unique_lock lock(collector_mutex);
+            while (!collector_cv.wait_for(lock, this->gc_interval, [this] { return stopping; })) {
+                lock.unlock();
+                collectGarbage();
+                lock.lock();
+            }
+        });
+    }
+}
+
+VersionedHeapFile::~VersionedHeapFile() {
+    if (collector.joinable()) {
+        {
+            std::lock_guard lock(collector_mutex);
+            stopping = true;
+        }
+        collector_cv.notify_one();
+        collector.join();
+    }
+}
+
+VersionedHeapFile::Version &VersionedHeapFile::version(size_t page, size_t slot) const {
+    const size_t segment = std::bit_width(page + 1) - 1;
+    return segments[segment][(page + 1 - (size_t{1} << segment)) * capacity + slot];
+}
+
+void VersionedHeapFile::addPage() {
+    const size_t page = numPages;
+    const size_t segment = std::bit_width(page + 1) - 1;
+    if (page + 1 == size_t{1} << segment) {
+        segments[segment] = std::make_unique<Version[]>((size_t{1} << segment) * capacity);
+    }
+    numPages++;
+    visible_pages.store(numPages, std::memory_order_release);
+}
+
+void VersionedHeapFile::insertTuple(const Tuple &t) {
+    if (!td.compatible(t)) {
+        throw std::runtime_error("Tuple not compatible with TupleDesc");
+    }
+    std::lock_guard lock(write_mutex);
+    if (free_slots.empty()) {
+        addPage();
+        // the slots of the new page are used in order
+        for (size_t slot = capacity; slot-- > 0;) {
+            free_slots.emplace_back(numPages - 1, slot);
+        }
+    }
+    const auto [page, slot] = free_slots.back();
+    {
+        PageLatch latch(getDatabase().getBufferPool(), {name, page}, true);
+        HeapPage(latch.page, td).putTuple(slot, t);
+        latch.markDirty();
+    }
+    free_slots.pop_back();
+    for (SecondaryIndex *index: getIndexes()) {
+        index->insertEntry(t, page, slot);
+    }
+    Version &v = version(page, slot);
+    // the bytes of the tuple are written before its begin is published
+    clock.commit([&v](uint64_t ts) { v.begin.store(ts, std::memory_order_release); });
+}
+
+void VersionedHeapFile::deleteTuple(const Iterator &it) {
+    std::lock_guard lock(write_mutex);
+    if (it.page >= numPages) {
+        throw std::runtime_error("Out of index");
+    }
+    std::optional<Tuple> t;
+    {
+        PageLatch latch(getDatabase().getBufferPool(), {name, it.page}, true);
+        HeapPage hp(latch.page, td);
+        if (!getIndexes().empty()) {
+            t = hp.getTuple(it.slot);
+        }
+        // the bytes of the tuple stay in the page until the slot is reclaimed
+        hp.deleteTuple(it.slot);
+        latch.markDirty();
+    }
+    for (SecondaryIndex *index: getIndexes()) {
+        index->deleteEntry(*t, it.page, it.slot);
+    }
+    Version &v = version(it.page, it.slot);
+    const uint64_t end = clock.commit([&v](uint64_t ts) { v.end.store(ts, std::memory_order_release); });
+    garbage.push_back({end, it.page, it.slot});
+}
+
+size_t VersionedHeapFile::getNumVisiblePages() const { return visible_pages.load(std::memory_order_acquire); }
+
+size_t VersionedHeapFile::readSnapshot(size_t page, const ReadView &view, std::vector<uint8_t> &rows,
+                                       const ScanFilter &filter) const {
+    std::array<uint64_t, DEFAULT_PAGE_SIZE / 64> bitmap{};
+    size_t visible = 0;
+    const Version *versions = &version(page, 0);
+    for (size_t slot = 0; slot < capacity; slot++) {
+        // the end is read first: a slot that is reclaimed gets an infinite end after its begin is cleared
+        const uint64_t end = versions[slot].end.load(std::memory_order_acquire);
+        const uint64_t begin = versions[slot].begin.load(std::memory_order_acquire);
+        if (view.sees(begin, end)) {
+            bitmap[slot / 64] |= uint64_t{1} << slot % 64;
+            visible++;
+        }
+    }
+    if (visible == 0) {
+        return 0;
+    }
+    BufferPool &bufferPool = getDatabase().getBufferPool();
+    const PageId pid{name, page};
+    Page &p = bufferPool.pinPage(pid);
+    const HeapPage hp(p, td);
+    const size_t offset = rows.size();
+    rows.resize(offset + visible * td.length());
+    const size_t count = hp.readTuples(bitmap.data(), rows.data() + offset, filter);
+    bufferPool.unpinPage(pid);
+    rows.resize(offset + count * td.length());
+    return count;
+}
+
+size_t VersionedHeapFile::collectGarbage() {
+    // the horizon only moves forward, a stale one reclaims less
+    const uint64_t horizon = clock.horizon();
+    std::lock_guard lock(write_mutex);
+    size_t count = 0;
+    while (!garbage.empty() && garbage.front().end <= horizon) {
+        const Garbage &g = garbage.front();
+        Version &v = version(g.page, g.slot);
+        v.begin.store(0, std::memory_order_relaxed);
+        v.end.store(VersionClock::infinity, std::memory_order_release);
+        free_slots.emplace_back(g.page, g.slot);
+        garbage.pop_front();
+        count++;
+    }
+    num_reclaimed += count;
+    return count;
+}
+
+size_t VersionedHeapFile::getNumGarbage() const {
+    std::lock_guard lock(write_mutex);
+    return garbage.size();
+}
+
+size_t VersionedHeapFile::getNumReclaimed() const {
+    std::lock_guard lock(write_mutex);
+    return num_reclaimed;
+}
+
+std::chrono::milliseconds VersionedHeapFile::getGcInterval() const { return gc_interval; }
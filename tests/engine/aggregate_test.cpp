@@ -0,0 +1,257 @@
+#include <db/Aggregate.hpp>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/HashAggregate.hpp>
+#include <db/HeapFile.hpp>
+#include <db/SeqScan.hpp>
+#include <db/StreamAggregate.hpp>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <map>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE, db::type_t::INT},
+                           {"id", "name", "price", "qty"});
+
+    db::Tuple item(int i) {
+        return {{i, "name" + std::to_string(i % 23), (i % 100) / 4.0, i % 7 - 3}};
+    }
+
+    template<typename File, typename... Args>
+    db::DbFile &createFile(const char *name, int first, int last, Args... args) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<File>(name, td, args...));
+        auto &file = db::getDatabase().get(name);
+        for (int i = first; i < last; i++) {
+            file.insertTuple(item(i));
+        }
+        return file;
+    }
+
+    const std::vector<db::Aggregate> aggregates = {
+            {db::AggregateOp::COUNT, 0},
+            {db::AggregateOp::SUM, 2},
+            {db::AggregateOp::AVG, 2},
+            {db::AggregateOp::MIN, 0},
+            {db::AggregateOp::MAX, 1},
+    };
+
+    /// The result of grouping items [0, count) on (qty, name) with the aggregates above
+    std::map<std::pair<int, std::string>, std::vector<db::field_t>> expected(int count) {
+        std::map<std::pair<int, std::string>, std::vector<db::field_t>> groups;
+        for (int i = 0; i < count; i++) {
+            const db::Tuple t = item(i);
+            const std::string name = std::get<std::string>(t.get_field(1));
+            const double price = std::get<double>(t.get_field(2));
+            auto [it, inserted] = groups.try_emplace({std::get<int>(t.get_field(3)), name},
+                                                     std::vector<db::field_t>{0, 0.0, 0.0, i, name});
+            auto &values = it->second;
+            values[0] = std::get<int>(values[0]) + 1;
+            values[1] = std::get<double>(values[1]) + price;
+            values[3] = std::min(std::get<int>(values[3]), i);
+            values[4] = std::max(std::get<std::string>(values[4]), name);
+        }
+        for (auto &[key, values]: groups) {
+            values[2] = std::get<double>(values[1]) / std::get<int>(values[0]);
+        }
+        return groups;
+    }
+
+    std::map<std::pair<int, std::string>, std::vector<db::field_t>> collect(db::Operator &op) {
+        std::map<std::pair<int, std::string>, std::vector<db::field_t>> groups;
+        op.open();
+        while (op.next()) {
+            const db::Tuple t = op.getTuple();
+            std::pair<int, std::string> key{std::get<int>(t.get_field(0)), std::get<std::string>(t.get_field(1))};
+            EXPECT_FALSE(groups.contains(key));
+            auto &values = groups[key];
+            for (size_t i = 2; i < t.size(); i++) {
+                values.push_back(t.get_field(i));
+            }
+        }
+        return groups;
+    }
+
+    void expectGroups(const std::map<std::pair<int, std::string>, std::vector<db::field_t>> &actual,
+                      const std::map<std::pair<int, std::string>, std::vector<db::field_t>> &expected) {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (const auto &[key, values]: expected) {
+            ASSERT_TRUE(actual.contains(key));
+            const auto &other = actual.at(key);
+            EXPECT_EQ(other[0], values[0]);
+            EXPECT_DOUBLE_EQ(std::get<double>(other[1]), std::get<double>(values[1]));
+            EXPECT_DOUBLE_EQ(std::get<double>(other[2]), std::get<double>(values[2]));
+            EXPECT_EQ(other[3], values[3]);
+            EXPECT_EQ(other[4], values[4]);
+        }
+    }
+
+    size_t tempFiles() {
+        size_t count = 0;
+        for (const auto &entry: std::filesystem::directory_iterator(".")) {
+            const std::string name = entry.path().filename().string();
+            count += name.starts_with("aggregate_") && name.ends_with(".tmp");
+        }
+        return count;
+    }
+} // namespace
+
+TEST(AggregateTest, HashAggregate) {
+    auto &file = createFile<db::HeapFile>("aggregate_heap.db", 0, 5000);
+    db::HashAggregate aggregate(std::make_unique<db::SeqScan>(file), {3, 1}, aggregates);
+    const db::TupleDesc &out = aggregate.getTupleDesc();
+    ASSERT_EQ(out.size(), 7);
+    EXPECT_EQ(out.field_name(0), "qty");
+    EXPECT_EQ(out.field_name(2), "count_id");
+    EXPECT_EQ(out.field_name(3), "sum_price");
+    EXPECT_EQ(out.field_type(4), db::type_t::DOUBLE);
+    EXPECT_EQ(out.field_type(6), db::type_t::CHAR);
+    expectGroups(collect(aggregate), expected(5000));
+    EXPECT_FALSE(aggregate.spilled());
+    // an aggregation can be opened again
+    expectGroups(collect(aggregate), expected(5000));
+
+    // a predicate on a group field is pushed into the scan, not a predicate on an aggregate
+    db::HashAggregate filtered(std::make_unique<db::SeqScan>(file), {3, 1}, aggregates);
+    EXPECT_TRUE(filtered.pushDown({0, db::PredicateOp::EQ, 2}));
+    EXPECT_FALSE(filtered.pushDown({2, db::PredicateOp::GT, 10}));
+    auto groups = collect(filtered);
+    EXPECT_EQ(groups.size(), 23);
+    for (const auto &[key, values]: groups) {
+        EXPECT_EQ(key.first, 2);
+    }
+
+    db::HashAggregate total(std::make_unique<db::SeqScan>(file), {}, {{db::AggregateOp::COUNT, 0},
+                                                                       {db::AggregateOp::MAX, 0}});
+    total.open();
+    ASSERT_TRUE(total.next());
+    EXPECT_EQ(total.getInt(0), 5000);
+    EXPECT_EQ(total.getInt(1), 4999);
+    EXPECT_FALSE(total.next());
+
+    EXPECT_THROW(db::HashAggregate(std::make_unique<db::SeqScan>(file), {2}, aggregates), std::logic_error);
+    EXPECT_THROW(db::HashAggregate(std::make_unique<db::SeqScan>(file), {0}, {{db::AggregateOp::SUM, 1}}),
+                 std::logic_error);
+    EXPECT_THROW(db::HashAggregate(std::make_unique<db::SeqScan>(file), {0}, {{db::AggregateOp::MIN, 4}}),
+                 std::logic_error);
+}
+
+TEST(AggregateTest, Spill) {
+    auto &file = createFile<db::HeapFile>("aggregate_spill.db", 0, 20000);
+    {
+        db::HashAggregate aggregate(std::make_unique<db::SeqScan>(file), {3, 1}, aggregates, 4096, 4);
+        expectGroups(collect(aggregate), expected(20000));
+        EXPECT_TRUE(aggregate.spilled());
+        EXPECT_EQ(tempFiles(), 4);
+    }
+    EXPECT_EQ(tempFiles(), 0);
+}
+
+TEST(AggregateTest, Parallel) {
+    std::vector<std::unique_ptr<db::Operator>> inputs;
+    const std::vector<const char *> names = {"aggregate_part0.db", "aggregate_part1.db", "aggregate_part2.db",
+                                             "aggregate_part3.db"};
+    for (int i = 0; i < 4; i++) {
+        inputs.push_back(std::make_unique<db::SeqScan>(
+                createFile<db::HeapFile>(names[i], i * 5000, (i + 1) * 5000)));
+    }
+    db::HashAggregate aggregate(std::move(inputs), {3, 1}, aggregates);
+    expectGroups(collect(aggregate), expected(20000));
+    EXPECT_FALSE(aggregate.spilled());
+
+    // every thread spills some groups, which may also be in memory in the tables of other threads
+    std::vector<std::unique_ptr<db::Operator>> spilling;
+    for (const char *name: names) {
+        spilling.push_back(std::make_unique<db::SeqScan>(db::getDatabase().get(name)));
+    }
+    db::HashAggregate small(std::move(spilling), {3, 1}, aggregates, 4 * 4096, 8);
+    expectGroups(collect(small), expected(20000));
+    EXPECT_TRUE(small.spilled());
+
+    std::vector<std::unique_ptr<db::Operator>> mismatched;
+    mismatched.push_back(std::make_unique<db::SeqScan>(db::getDatabase().get(names[0])));
+    mismatched.push_back(std::make_unique<db::HashAggregate>(std::make_unique<db::SeqScan>(
+            db::getDatabase().get(names[0])), std::vector<size_t>{0}, std::vector<db::Aggregate>{}));
+    EXPECT_THROW(db::HashAggregate(std::move(mismatched), {0}, aggregates), std::logic_error);
+    EXPECT_THROW(db::HashAggregate(std::vector<std::unique_ptr<db::Operator>>{}, {0}, aggregates),
+                 std::logic_error);
+}
+
+TEST(AggregateTest, StreamAggregate) {
+    auto &btree = createFile<db::BTreeFile>("aggregate_btree.db", 0, 5000, std::vector<size_t>{3, 1, 0});
+    auto &heap = createFile<db::HeapFile>("aggregate_stream_heap.db", 0, 100);
+    EXPECT_TRUE(db::StreamAggregate::sortedOn(btree, {3}));
+    EXPECT_TRUE(db::StreamAggregate::sortedOn(btree, {1, 3}));
+    EXPECT_FALSE(db::StreamAggregate::sortedOn(btree, {1}));
+    EXPECT_FALSE(db::StreamAggregate::sortedOn(heap, {3}));
+    EXPECT_TRUE(db::StreamAggregate::sortedOn(heap, {}));
+
+    auto stream = db::groupBy(btree, {3, 1}, aggregates, 1 << 20);
+    EXPECT_NE(dynamic_cast<db::StreamAggregate *>(stream.get()), nullptr);
+    expectGroups(collect(*stream), expected(5000));
+    auto hash = db::groupBy(heap, {3, 1}, aggregates, 1 << 20);
+    EXPECT_NE(dynamic_cast<db::HashAggregate *>(hash.get()), nullptr);
+    expectGroups(collect(*hash), expected(100));
+
+    // the groups are produced in key order
+    db::StreamAggregate by_qty(std::make_unique<db::SeqScan>(btree), {3}, {{db::AggregateOp::COUNT, 0},
+                                                                          {db::AggregateOp::MIN, 1}});
+    EXPECT_TRUE(by_qty.pushDown({0, db::PredicateOp::GE, 0}));
+    by_qty.open();
+    for (int qty = 0; qty <= 3; qty++) {
+        ASSERT_TRUE(by_qty.next());
+        EXPECT_EQ(by_qty.getInt(0), qty);
+        EXPECT_EQ(by_qty.getInt(1), 5000 / 7 + (5000 % 7 > qty + 3));
+        EXPECT_EQ(by_qty.getString(2), "name0");
+    }
+    EXPECT_FALSE(by_qty.next());
+}
+
+TEST(AggregateTest, EmptyInput) {
+    auto &heap = createFile<db::HeapFile>("aggregate_empty.db", 0, 0);
+    auto &btree = createFile<db::BTreeFile>("aggregate_empty_btree.db", 0, 0, std::vector<size_t>{3, 1, 0});
+    std::vector<std::unique_ptr<db::Operator>> operators;
+    operators.push_back(std::make_unique<db::HashAggregate>(std::make_unique<db::SeqScan>(heap),
+                                                            std::vector<size_t>{}, aggregates, 1 << 20));
+    std::vector<std::unique_ptr<db::Operator>> inputs;
+    inputs.push_back(std::make_unique<db::SeqScan>(heap));
+    inputs.push_back(std::make_unique<db::SeqScan>(heap));
+    operators.push_back(std::make_unique<db::HashAggregate>(std::move(inputs), std::vector<size_t>{}, aggregates,
+                                                            1 << 20));
+    operators.push_back(std::make_unique<db::StreamAggregate>(std::make_unique<db::SeqScan>(btree),
+                                                              std::vector<size_t>{}, aggregates));
+    for (auto &op: operators) {
+        // one row without group fields, every time the operator is opened
+        for (int run = 0; run < 2; run++) {
+            op->open();
+            ASSERT_TRUE(op->next());
+            EXPECT_EQ(op->getInt(0), 0);
+            EXPECT_EQ(op->getDouble(1), 0);
+            EXPECT_TRUE(std::isnan(op->getDouble(2)));
+            EXPECT_EQ(op->getInt(3), 0);
+            EXPECT_EQ(op->getString(4), "");
+            EXPECT_FALSE(op->next());
+        }
+    }
+    // no rows with group fields
+    db::HashAggregate hash(std::make_unique<db::SeqScan>(heap), {3}, aggregates, 1 << 20);
+    EXPECT_TRUE(collect(hash).empty());
+    db::StreamAggregate stream(std::make_unique<db::SeqScan>(btree), {3}, aggregates);
+    stream.open();
+    EXPECT_FALSE(stream.next());
+}
+
+TEST(AggregateTest, CountOverflow) {
+    const db::AggregateLayout layout(td, {}, {{db::AggregateOp::COUNT, 0}});
+    std::vector<uint8_t> state(layout.stateLength());
+    std::vector<uint8_t> out(layout.getTupleDesc().length());
+    layout.initEmpty(state.data());
+    int64_t count = std::numeric_limits<int>::max();
+    memcpy(state.data(), &count, sizeof(count));
+    layout.finalize(nullptr, state.data(), out.data());
+    count++;
+    memcpy(state.data(), &count, sizeof(count));
+    EXPECT_THROW(layout.finalize(nullptr, state.data(), out.data()), std::runtime_error);
+}
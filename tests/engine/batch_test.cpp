@@ -0,0 +1,92 @@
+#include <db/BTreeFile.hpp>
+#include <db/Batch.hpp>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int id) { return {{id, "item" + std::to_string(id % 100), static_cast<double>(id % 1000)}}; }
+} // namespace
+
+TEST(BatchTest, Columns) {
+    const char *name = "batch_heap.db";
+    std::remove(name);
+    db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = db::getDatabase().get(name);
+    constexpr int num_tuples = 5000;
+    for (int i = 0; i < num_tuples; i++) {
+        file.insertTuple(item(i));
+    }
+    db::Batch batch(td);
+    auto it = file.begin();
+    int next_id = 0;
+    size_t num_batches = 0;
+    while (batch.read(file, it) != 0) {
+        num_batches++;
+        EXPECT_GE(batch.size(), num_batches * db::BATCH_SIZE <= num_tuples ? db::BATCH_SIZE : 1);
+        EXPECT_EQ(batch.getSelection().size(), batch.size());
+        const auto &ids = batch.getInts(0);
+        const auto &names = batch.getStrings(1);
+        const auto &prices = batch.getDoubles(2);
+        for (size_t row = 0; row < batch.size(); row++) {
+            EXPECT_EQ(ids[row], next_id);
+            EXPECT_EQ(names[row], "item" + std::to_string(next_id % 100));
+            EXPECT_EQ(prices[row], next_id % 1000);
+            next_id++;
+        }
+        EXPECT_EQ(std::get<int>(batch.getTuple(batch.size() - 1).get_field(0)), next_id - 1);
+    }
+    EXPECT_EQ(next_id, num_tuples);
+    EXPECT_EQ(num_batches, (num_tuples + db::BATCH_SIZE - 1) / db::BATCH_SIZE);
+    EXPECT_THROW(batch.getInts(1), std::logic_error);
+
+    // only the decoded fields are available
+    db::Batch pruned(td, {2});
+    auto begin = file.begin();
+    pruned.read(file, begin);
+    EXPECT_THROW(pruned.getInts(0), std::logic_error);
+    EXPECT_EQ(pruned.getDoubles(2)[1], 1.0);
+}
+
+TEST(BatchTest, FilterSum) {
+    const char *name = "batch_btree.db";
+    std::remove(name);
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &file = db::getDatabase().get(name);
+    constexpr int num_tuples = 10000;
+    // insert in reverse order, the batches are read in key order
+    for (int i = num_tuples - 1; i >= 0; i--) {
+        file.insertTuple(item(i));
+    }
+    db::BatchScan scan(file);
+    scan.pushDown({0, db::PredicateOp::GE, 2500});
+    scan.pushDown({2, db::PredicateOp::LT, 100.0});
+    scan.pushDown({1, db::PredicateOp::NE, std::string("item42")});
+    db::Batch batch(td);
+    double sum = 0;
+    int count = 0;
+    int last = -1;
+    scan.open();
+    while (scan.next(batch)) {
+        const auto &ids = batch.getInts(0);
+        for (uint32_t row: batch.getSelection()) {
+            EXPECT_GT(ids[row], last);
+            last = ids[row];
+            count++;
+        }
+        sum += batch.sum(2);
+    }
+    double expected_sum = 0;
+    int expected_count = 0;
+    for (int i = 2500; i < num_tuples; i++) {
+        if (i % 1000 < 100 && i % 100 != 42) {
+            expected_sum += i % 1000;
+            expected_count++;
+        }
+    }
+    EXPECT_EQ(count, expected_count);
+    EXPECT_EQ(sum, expected_sum);
+    EXPECT_THROW(scan.pushDown({0, db::PredicateOp::EQ, 1.0}), std::logic_error);
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+TEST(BTreeConcurrencyTest, Lookup) {
+    const char *name = "lookup.db";
+    std::remove(name);
+    db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+    EXPECT_FALSE(file.lookup(0).has_value());
+    for (int i = 0; i < 10000; i++) {
+        file.insertTuple({{i * 2, "apple", 1.0}});
+    }
+    for (int i = 0; i < 10000; i++) {
+        auto t = file.lookup(i * 2);
+        ASSERT_TRUE(t.has_value());
+        EXPECT_EQ(std::get<int>(t->get_field(0)), i * 2);
+        EXPECT_FALSE(file.lookup(i * 2 + 1).has_value());
+    }
+}
+
+TEST(BTreeConcurrencyTest, ConcurrentInsert) {
+    const char *name = "concurrent_insert.db";
+    std::remove(name);
+    db::getDatabase().getBufferPool().resize(256);
+    db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &file = db::getDatabase().get(name);
+    constexpr int num_threads = 8;
+    constexpr int num_keys = 100000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&file, t] {
+            // interleave the keys of the threads so that they compete for the same leaves
+            for (int i = t; i < num_keys; i += num_threads) {
+                file.insertTuple({{i, "apple", 1.0}});
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    int i = 0;
+    for (const auto &t: file) {
+        EXPECT_EQ(std::get<int>(t.get_field(0)), i);
+        i++;
+    }
+    EXPECT_EQ(i, num_keys);
+}
+
+TEST(BTreeConcurrencyTest, ConcurrentLookupInsert) {
+    const char *name = "concurrent_lookup.db";
+    std::remove(name);
+    db::getDatabase().getBufferPool().resize(256);
+    db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+    constexpr int num_keys = 50000;
+    for (int i = 0; i < num_keys; i += 2) {
+        file.insertTuple({{i, "apple", 1.0}});
+    }
+    std::thread writer([&file] {
+        for (int i = 1; i < num_keys; i += 2) {
+            file.insertTuple({{i, "orange", 2.0}});
+        }
+    });
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&file] {
+            // keys inserted before the writer started are always visible
+            for (int i = 0; i < num_keys; i += 2) {
+                auto tuple = file.lookup(i);
+                ASSERT_TRUE(tuple.has_value());
+                EXPECT_EQ(std::get<std::string>(tuple->get_field(1)), "apple");
+            }
+        });
+    }
+    writer.join();
+    for (auto &reader: readers) {
+        reader.join();
+    }
+    for (int i = 0; i < num_keys; i++) {
+        EXPECT_TRUE(file.lookup(i).has_value());
+    }
+}
+
+TEST(BTreeConcurrencyTest, ConcurrentEviction) {
+    const char *name = "concurrent_eviction.db";
+    std::remove(name);
+    db::BufferPool &pool = db::getDatabase().getBufferPool();
+    pool.resize(16);
+    db::TupleDesc td({db::type_t::INT}, {"id"});
+    db::getDatabase().add(std::make_unique<db::DbFile>(name, td));
+    constexpr size_t num_pages = 200;
+    // every page is filled with a single byte, a page read while it is loaded or written would be mixed
+    const auto fill = [](size_t page, int round) { return static_cast<uint8_t>(page * 7 + round); };
+    for (size_t page = 0; page < num_pages; page++) {
+        db::PageLatch latch(pool, {name, page}, true);
+        latch.page.fill(fill(page, 0));
+        latch.markDirty();
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&pool, &fill, name, t] {
+            // half of the threads dirty the pages, the pool is too small for them: most misses evict a dirty page
+            for (size_t i = 0; i < 2000; i++) {
+                const size_t page = (i * 31 + t * 17) % num_pages;
+                db::PageLatch latch(pool, {name, page}, t % 2 == 0);
+                const uint8_t value = latch.page[0];
+                ASSERT_TRUE(std::all_of(latch.page.begin(), latch.page.end(), [&](uint8_t b) { return b == value; }));
+                if (t % 2 == 0) {
+                    latch.page.fill(value + 1);
+                    latch.markDirty();
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    // every page was incremented the same number of times by the writers
+    pool.flushFile(name);
+    std::vector<size_t> increments(num_pages);
+    for (int t = 0; t < 8; t += 2) {
+        for (size_t i = 0; i < 2000; i++) {
+            increments[(i * 31 + t * 17) % num_pages]++;
+        }
+    }
+    db::Page page;
+    for (size_t id = 0; id < num_pages; id++) {
+        db::getDatabase().get(name).readPage(page, id);
+        EXPECT_EQ(page[0], fill(id, static_cast<int>(increments[id])));
+    }
+    pool.resize(db::DEFAULT_NUM_PAGES);
+}
+
+TEST(BTreeConcurrencyTest, RemovedFileAddress) {
+    const char *old_name = "removed_address_old.db";
+    const char *new_name = "removed_address_new.db";
+    std::remove(old_name);
+    std::remove(new_name);
+    // the root of the empty old file is read first, into the first frame
+    db::getDatabase().getBufferPool().resize(db::DEFAULT_NUM_PAGES);
+    db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(old_name, td, 0));
+    EXPECT_FALSE(dynamic_cast<db::BTreeFile &>(db::getDatabase().get(old_name)).lookup(1).has_value());
+    // the new file takes the address of the removed one, its pages have the same numbers
+    auto *storage = static_cast<db::BTreeFile *>(db::getDatabase().remove(old_name).release());
+    std::destroy_at(storage);
+    db::getDatabase().add(std::unique_ptr<db::DbFile>(new (storage) db::BTreeFile(new_name, td, 0)));
+    auto &new_file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(new_name));
+    ASSERT_EQ(&new_file, storage);
+    for (int i = 1; i < 2000; i += 2) {
+        new_file.insertTuple({{i, "orange", 2.0}});
+    }
+    for (int i = 0; i < 2000; i++) {
+        EXPECT_EQ(new_file.lookup(i).has_value(), i % 2 == 1);
+    }
+    std::remove(old_name);
+}
+
+TEST(BTreeConcurrencyTest, RemovedFileName) {
+    const char *name = "removed_name.db";
+    std::remove(name);
+    db::getDatabase().getBufferPool().resize(db::DEFAULT_NUM_PAGES);
+    db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &old_file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+    for (int i = 0; i < 200; i++) {
+        old_file.insertTuple({{i, "apple", 1.0}});
+    }
+    // the pages of the removed file are not cached for a new file with the same name
+    db::getDatabase().remove(name);
+    std::remove(name);
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &new_file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+    EXPECT_FALSE(new_file.lookup(100).has_value());
+    EXPECT_EQ(new_file.begin(), new_file.end());
+}
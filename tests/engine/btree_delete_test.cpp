@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace {
+    db::BTreeFile &createFile(const char *name) {
+        std::remove(name);
+        db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+        db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+        return dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+    }
+} // namespace
+
+TEST(BTreeDeleteTest, DeleteTuple) {
+    auto &file = createFile("delete_tuple.db");
+    for (int i = 0; i < 100; i++) {
+        file.insertTuple({{i, "apple", 1.0}});
+    }
+    file.deleteTuple(file.begin());
+    EXPECT_EQ(std::get<int>((*file.begin()).get_field(0)), 1);
+    EXPECT_FALSE(file.lookup(0).has_value());
+    EXPECT_FALSE(file.deleteKey(0));
+    EXPECT_FALSE(file.deleteKey(1000));
+    EXPECT_TRUE(file.deleteKey(50));
+    int count = 0;
+    for (const auto &t: file) {
+        EXPECT_NE(std::get<int>(t.get_field(0)), 50);
+        count++;
+    }
+    EXPECT_EQ(count, 98);
+}
+
+TEST(BTreeDeleteTest, DeleteRandom) {
+    auto &file = createFile("delete_random.db");
+    constexpr int num_keys = 200000;
+    std::vector<int> keys(num_keys);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(660));
+    for (int key: keys) {
+        file.insertTuple({{key, "apple", 1.0}});
+    }
+    // delete three quarters of the keys, the tree has to merge leaves and index pages
+    for (int i = 0; i < num_keys * 3 / 4; i++) {
+        EXPECT_TRUE(file.deleteKey(keys[i]));
+    }
+    std::vector<int> remaining(keys.begin() + num_keys * 3 / 4, keys.end());
+    std::sort(remaining.begin(), remaining.end());
+    size_t i = 0;
+    for (const auto &t: file) {
+        ASSERT_LT(i, remaining.size());
+        EXPECT_EQ(std::get<int>(t.get_field(0)), remaining[i]);
+        i++;
+    }
+    EXPECT_EQ(i, remaining.size());
+    for (int key: remaining) {
+        EXPECT_TRUE(file.lookup(key).has_value());
+    }
+    for (int j = 0; j < num_keys * 3 / 4; j++) {
+        EXPECT_FALSE(file.lookup(keys[j]).has_value());
+    }
+}
+
+TEST(BTreeDeleteTest, RecyclePages) {
+    auto &file = createFile("delete_recycle.db");
+    constexpr int num_keys = 100000;
+    for (int i = 0; i < num_keys; i++) {
+        file.insertTuple({{i, "apple", 1.0}});
+    }
+    size_t num_pages = file.getNumPages();
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < num_keys; i++) {
+            EXPECT_TRUE(file.deleteKey(i));
+        }
+        EXPECT_EQ(file.begin(), file.end());
+        for (int i = 0; i < num_keys; i++) {
+            file.insertTuple({{i, "apple", 1.0}});
+        }
+        EXPECT_EQ(file.getNumPages(), num_pages);
+    }
+    int i = 0;
+    for (const auto &t: file) {
+        EXPECT_EQ(std::get<int>(t.get_field(0)), i);
+        i++;
+    }
+    EXPECT_EQ(i, num_keys);
+}
+
+TEST(BTreeDeleteTest, ScanMergedLeaf) {
+    auto &file = createFile("delete_scan_merged.db");
+    constexpr int num_keys = 3000;
+    for (int i = 0; i < num_keys; i++) {
+        file.insertTuple({{i, "apple", 1.0}});
+    }
+    // a scan position at the start of every leaf
+    std::vector<db::Iterator> positions;
+    for (auto it = file.begin(); it != file.end(); file.next(it)) {
+        if (it.slot == 0) {
+            positions.push_back(it);
+        }
+    }
+    // the leaves in the middle are merged and freed
+    for (int i = num_keys / 3; i < 2 * num_keys / 3; i++) {
+        EXPECT_TRUE(file.deleteKey(i));
+    }
+    size_t freed = 0;
+    for (db::Iterator it: positions) {
+        // a freed leaf is empty
+        try {
+            file.getTuple(it);
+        } catch (const std::out_of_range &) {
+            freed++;
+        }
+        // every scan continues to the remaining keys after its leaf
+        file.next(it);
+        ASSERT_NE(it, file.end());
+        const int key = std::get<int>(file.getTuple(it).get_field(0));
+        EXPECT_TRUE(key < num_keys / 3 || key >= 2 * num_keys / 3) << key;
+    }
+    EXPECT_GT(freed, 0);
+}
+
+TEST(BTreeDeleteTest, ReopenFreePages) {
+    const char *name = "delete_reopen.db";
+    auto &database = db::getDatabase();
+    auto &file = createFile(name);
+    constexpr int num_keys = 20000;
+    for (int i = 0; i < num_keys; i++) {
+        file.insertTuple({{i, "apple", 1.0}});
+    }
+    for (int i = 0; i < num_keys / 2; i++) {
+        EXPECT_TRUE(file.deleteKey(i));
+    }
+    const size_t num_pages = file.getNumPages();
+    const db::TupleDesc td = file.getTupleDesc();
+    database.remove(name);
+
+    // the pages freed before the file was closed are found again and reused
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &reopened = dynamic_cast<db::BTreeFile &>(database.get(name));
+    for (int i = 0; i < num_keys / 2; i++) {
+        reopened.insertTuple({{i, "apple", 1.0}});
+    }
+    EXPECT_EQ(reopened.getNumPages(), num_pages);
+    int i = 0;
+    for (const auto &t: reopened) {
+        EXPECT_EQ(std::get<int>(t.get_field(0)), i);
+        i++;
+    }
+    EXPECT_EQ(i, num_keys);
+    database.remove(name);
+}
+
+TEST(BTreeDeleteTest, ConcurrentInsertDelete) {
+    db::getDatabase().getBufferPool().resize(256);
+    auto &file = createFile("delete_concurrent.db");
+    constexpr int num_threads = 4;
+    constexpr int num_keys = 40000;
+    for (int i = 0; i < num_keys; i++) {
+        file.insertTuple({{i, "apple", 1.0}});
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&file, t] {
+            // every thread deletes its existing keys and inserts new ones
+            for (int i = t; i < num_keys; i += num_threads) {
+                EXPECT_TRUE(file.deleteKey(i));
+                file.insertTuple({{num_keys + i, "orange", 2.0}});
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    int i = num_keys;
+    for (const auto &t: file) {
+        EXPECT_EQ(std::get<int>(t.get_field(0)), i);
+        i++;
+    }
+    EXPECT_EQ(i, 2 * num_keys);
+}
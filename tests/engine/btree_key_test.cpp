@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/KeyDesc.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace {
+    db::BTreeFile &createFile(const char *name, const db::TupleDesc &td, const std::vector<size_t> &key) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, key));
+        return dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+    }
+
+    std::string customer(int i) {
+        std::string digits = std::to_string(i);
+        return "Customer#" + std::string(9 - digits.size(), '0') + digits;
+    }
+} // namespace
+
+TEST(KeyDescTest, Order) {
+    db::TupleDesc td({db::type_t::INT, db::type_t::DOUBLE, db::type_t::CHAR}, {"i", "d", "s"});
+    db::KeyDesc ints(td, {0});
+    db::KeyDesc doubles(td, {1});
+    db::KeyDesc strings(td, {2});
+    std::vector<int> int_values{std::numeric_limits<int>::min(), -100, -1, 0, 1, 100, std::numeric_limits<int>::max()};
+    for (size_t i = 1; i < int_values.size(); i++) {
+        EXPECT_LT(ints.encode({int_values[i - 1]}), ints.encode({int_values[i]}));
+    }
+    std::vector<double> double_values{-1e300, -2.5, -1.0, -1e-300, 0.0, 1e-300, 1.0, 2.5, 1e300};
+    for (size_t i = 1; i < double_values.size(); i++) {
+        EXPECT_LT(doubles.encode({double_values[i - 1]}), doubles.encode({double_values[i]}));
+    }
+    std::vector<std::string> string_values{"", "a", "a\x01", "ab", "abc", "b", "\xff"};
+    for (size_t i = 1; i < string_values.size(); i++) {
+        EXPECT_LT(strings.encode({string_values[i - 1]}), strings.encode({string_values[i]}));
+    }
+    // composite keys compare field by field
+    db::KeyDesc composite(td, {2, 0});
+    EXPECT_LT(composite.encode({"a", 5}), composite.encode({"ab", -5}));
+    EXPECT_LT(composite.encode({"ab", -5}), composite.encode({"ab", 5}));
+    EXPECT_THROW(composite.encode({5, "a"}), std::logic_error);
+    EXPECT_THROW(db::KeyDesc(td, {}), std::logic_error);
+    EXPECT_THROW(db::KeyDesc(td, {0, 0}), std::logic_error);
+}
+
+TEST(KeyDescTest, RoundTrip) {
+    db::TupleDesc td({db::type_t::INT, db::type_t::DOUBLE, db::type_t::CHAR}, {"i", "d", "s"});
+    db::KeyDesc kd(td, {2, 1});
+    db::Tuple t({-42, -3.25, "hello"});
+    std::string key = kd.encode(t);
+    EXPECT_EQ(kd.decode(key), (std::vector<db::field_t>{"hello", -3.25}));
+    std::vector<uint8_t> rest(kd.restLength());
+    kd.extractRest(t, rest.data());
+    db::Tuple joined = kd.join(key, rest.data());
+    for (size_t i = 0; i < td.size(); i++) {
+        EXPECT_EQ(joined.get_field(i), t.get_field(i));
+    }
+}
+
+TEST(KeyDescTest, Separator) {
+    EXPECT_EQ(db::KeyDesc::separator("apple", "apricot"), "apr");
+    EXPECT_EQ(db::KeyDesc::separator("app", "apple"), "appl");
+    EXPECT_EQ(db::KeyDesc::commonPrefix("apple", "apricot"), 2);
+}
+
+TEST(BTreeKeyTest, CharKey) {
+    db::TupleDesc td({db::type_t::CHAR, db::type_t::INT, db::type_t::DOUBLE}, {"name", "id", "balance"});
+    auto &file = createFile("btree_char_key.db", td, {0});
+    constexpr int num_keys = 50000;
+    std::vector<int> ids(num_keys);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(660));
+    for (int id: ids) {
+        file.insertTuple({{customer(id), id, id * 0.5}});
+    }
+    int i = 0;
+    for (const auto &t: file) {
+        EXPECT_EQ(std::get<std::string>(t.get_field(0)), customer(i));
+        EXPECT_EQ(std::get<int>(t.get_field(1)), i);
+        EXPECT_EQ(std::get<double>(t.get_field(2)), i * 0.5);
+        i++;
+    }
+    EXPECT_EQ(i, num_keys);
+    // the keys share long prefixes: leaves hold many more tuples than uncompressed tuples would fit
+    size_t uncompressed_leaves = num_keys / ((db::DEFAULT_PAGE_SIZE - 16) / td.length());
+    EXPECT_LT(file.getNumPages(), uncompressed_leaves);
+
+    auto t = file.lookup({customer(1234)});
+    ASSERT_TRUE(t.has_value());
+    EXPECT_EQ(std::get<int>(t->get_field(1)), 1234);
+    EXPECT_FALSE(file.lookup({"Customer#"}).has_value());
+    EXPECT_FALSE(file.lookup({customer(num_keys)}).has_value());
+    EXPECT_THROW(file.lookup(5), std::logic_error);
+}
+
+TEST(BTreeKeyTest, DoubleKey) {
+    db::TupleDesc td({db::type_t::INT, db::type_t::DOUBLE}, {"id", "price"});
+    auto &file = createFile("btree_double_key.db", td, {1});
+    std::mt19937 gen(660);
+    std::uniform_real_distribution<double> price(-1e6, 1e6);
+    std::map<double, int> expected;
+    for (int i = 0; i < 20000; i++) {
+        double p = price(gen);
+        file.insertTuple({{i, p}});
+        expected[p] = i;
+    }
+    auto it = expected.begin();
+    for (const auto &t: file) {
+        ASSERT_NE(it, expected.end());
+        EXPECT_EQ(std::get<double>(t.get_field(1)), it->first);
+        EXPECT_EQ(std::get<int>(t.get_field(0)), it->second);
+        ++it;
+    }
+    EXPECT_EQ(it, expected.end());
+}
+
+TEST(BTreeKeyTest, CompositeKeyDelete) {
+    db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::INT}, {"warehouse", "name", "stock"});
+    auto &file = createFile("btree_composite_key.db", td, {1, 0});
+    std::vector<std::pair<std::string, int>> keys;
+    for (int w = 0; w < 20; w++) {
+        for (int i = 0; i < 2000; i++) {
+            keys.emplace_back(customer(i), w);
+        }
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(660));
+    for (const auto &[name, w]: keys) {
+        file.insertTuple({{w, name, w + 1}});
+    }
+    // updating a key replaces the tuple
+    file.insertTuple({{3, customer(7), -1}});
+    EXPECT_EQ(std::get<int>(file.lookup({customer(7), 3})->get_field(2)), -1);
+    // a prefix of the key is a range, not a tuple
+    EXPECT_THROW(file.lookup({customer(7)}), std::logic_error);
+    EXPECT_THROW(file.deleteKey({customer(7)}), std::logic_error);
+    EXPECT_THROW(file.lookup({customer(7), 3, 0}), std::logic_error);
+    EXPECT_EQ(std::get<int>(file.getTuple(file.lowerBound({customer(7)})).get_field(0)), 0);
+
+    // delete three quarters of the keys, the tree has to merge leaves and index pages
+    const size_t num_deleted = keys.size() * 3 / 4;
+    for (size_t i = 0; i < num_deleted; i++) {
+        EXPECT_TRUE(file.deleteKey({keys[i].first, keys[i].second}));
+    }
+    EXPECT_FALSE(file.deleteKey({keys[0].first, keys[0].second}));
+    std::vector<std::pair<std::string, int>> remaining(keys.begin() + num_deleted, keys.end());
+    std::sort(remaining.begin(), remaining.end());
+    size_t i = 0;
+    for (const auto &t: file) {
+        ASSERT_LT(i, remaining.size());
+        EXPECT_EQ(std::get<std::string>(t.get_field(1)), remaining[i].first);
+        EXPECT_EQ(std::get<int>(t.get_field(0)), remaining[i].second);
+        i++;
+    }
+    EXPECT_EQ(i, remaining.size());
+    for (const auto &[name, w]: remaining) {
+        EXPECT_TRUE(file.lookup({name, w}).has_value());
+    }
+    for (size_t j = 0; j < num_deleted; j++) {
+        EXPECT_FALSE(file.deleteKey({keys[j].first, keys[j].second}));
+    }
+    for (const auto &[name, w]: remaining) {
+        EXPECT_TRUE(file.deleteKey({name, w}));
+    }
+    EXPECT_EQ(file.begin(), file.end());
+}
+
+TEST(BTreeKeyTest, ConcurrentCharKey) {
+    db::getDatabase().getBufferPool().resize(256);
+    db::TupleDesc td({db::type_t::CHAR, db::type_t::INT}, {"name", "id"});
+    auto &file = createFile("btree_concurrent_key.db", td, {0});
+    constexpr int num_threads = 4;
+    constexpr int num_keys = 40000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&file, t] {
+            for (int i = t; i < num_keys; i += num_threads) {
+                file.insertTuple({{customer(i), i}});
+                // lookups of keys inserted by this thread race with the inserts of the others
+                auto found = file.lookup({customer(i / 2 / num_threads * num_threads + t)});
+                EXPECT_TRUE(found.has_value());
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    int i = 0;
+    for (const auto &t: file) {
+        EXPECT_EQ(std::get<int>(t.get_field(1)), i);
+        i++;
+    }
+    EXPECT_EQ(i, num_keys);
+}
+
+TEST(BTreeKeyTest, LowerBound) {
+    db::TupleDesc td({db::type_t::INT, db::type_t::CHAR}, {"id", "name"});
+    auto &ints = createFile("btree_lower_bound_int.db", td, {0});
+    auto &strings = createFile("btree_lower_bound_char.db", td, {1, 0});
+    EXPECT_EQ(ints.lowerBound({0}), ints.end());
+    for (int i = 0; i < 20000; i += 2) {
+        ints.insertTuple({{i, "apple"}});
+        strings.insertTuple({{i % 100, customer(i / 100)}});
+    }
+    EXPECT_EQ(std::get<int>((*ints.lowerBound({-5})).get_field(0)), 0);
+    EXPECT_EQ(std::get<int>((*ints.lowerBound({1001})).get_field(0)), 1002);
+    EXPECT_EQ(ints.lowerBound({20000}), ints.end());
+    // a prefix of a composite key finds the first tuple that starts with it
+    auto it = strings.lowerBound({customer(42)});
+    EXPECT_EQ(std::get<std::string>((*it).get_field(1)), customer(42));
+    EXPECT_EQ(std::get<int>((*it).get_field(0)), 0);
+    EXPECT_EQ(std::get<int>((*strings.lowerBound({customer(42), 51})).get_field(0)), 52);
+}
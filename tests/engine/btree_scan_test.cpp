@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/BTreeScan.hpp>
+#include <db/Database.hpp>
+#include <db/Gather.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int i) { return {{i, "name" + std::to_string(i % 100), i / 4.0}}; }
+
+    db::BTreeFile &createTree(const char *name, const std::vector<size_t> &key, int count) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, key));
+        auto &file = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+        for (int i = 0; i < count; i++) {
+            // the keys are inserted out of order
+            file.insertTuple(item(static_cast<int>(static_cast<int64_t>(i) * 7919 % count)));
+        }
+        return file;
+    }
+
+    std::vector<std::vector<db::field_t>> collect(db::Operator &op) {
+        std::vector<std::vector<db::field_t>> result;
+        op.open();
+        while (op.next()) {
+            const db::Tuple t = op.getTuple();
+            result.push_back({t.get_field(0), t.get_field(1), t.get_field(2)});
+        }
+        return result;
+    }
+
+    /// The tuples of the file from a position up to another, with the iterators of the file
+    std::vector<std::vector<db::field_t>> expected(const db::BTreeFile &file, const db::Iterator &first,
+                                                   const db::Iterator &last) {
+        std::vector<std::vector<db::field_t>> result;
+        for (db::Iterator it = first; it != last; file.next(it)) {
+            const db::Tuple t = file.getTuple(it);
+            result.push_back({t.get_field(0), t.get_field(1), t.get_field(2)});
+        }
+        return result;
+    }
+
+    std::vector<std::vector<db::field_t>> parallel(const db::BTreeFile &file, size_t parts,
+                                                   const std::vector<db::field_t> &lower = {},
+                                                   const std::vector<db::field_t> &upper = {}) {
+        db::Gather gather(db::BTreeScan::create(file, parts, lower, upper), 2, true);
+        return collect(gather);
+    }
+} // namespace
+
+TEST(BTreeScanTest, SplitRange) {
+    constexpr int count = 20000;
+    auto &file = createTree("btree_scan_split.db", {0}, count);
+    // some leaves become empty
+    for (int i = 3000; i < 4000; i++) {
+        file.deleteKey(i);
+    }
+    const auto all = expected(file, file.begin(), file.end());
+    ASSERT_EQ(all.size(), count - 1000);
+
+    for (size_t parts: {1, 2, 3, 8, 64}) {
+        const auto boundaries = file.splitRange(parts);
+        ASSERT_GE(boundaries.size(), 2);
+        EXPECT_LE(boundaries.size(), parts + 1);
+        if (parts > 1) {
+            EXPECT_GT(boundaries.size(), 2);
+        }
+        EXPECT_TRUE(boundaries.front() == file.begin());
+        EXPECT_TRUE(boundaries.back() == file.end());
+        EXPECT_EQ(parallel(file, parts), all);
+    }
+    // the parts have about the same size
+    const auto boundaries = file.splitRange(4);
+    ASSERT_EQ(boundaries.size(), 5);
+    for (size_t i = 0; i + 1 < boundaries.size(); i++) {
+        const size_t size = expected(file, boundaries[i], boundaries[i + 1]).size();
+        EXPECT_GT(size, all.size() / 8);
+        EXPECT_LT(size, all.size() / 2);
+    }
+
+    for (auto [lower, upper]: std::vector<std::pair<int, int>>{
+            {0, count}, {10, 20}, {2500, 3500}, {3100, 3200}, {5000, 15000}, {-10, 1}, {count - 1, count + 10},
+            {count, count + 10}, {100, 100}, {200, 100}}) {
+        std::vector<std::vector<db::field_t>> range;
+        if (lower < upper) {
+            range = expected(file, file.lowerBound({lower}), file.lowerBound({upper}));
+        }
+        EXPECT_EQ(parallel(file, 6, {lower}, {upper}), range) << lower << " " << upper;
+    }
+    EXPECT_EQ(parallel(file, 5, {15000}), expected(file, file.lowerBound({15000}), file.end()));
+    EXPECT_EQ(parallel(file, 5, {}, {15000}), expected(file, file.begin(), file.lowerBound({15000})));
+
+    // pushed down predicates are evaluated in every part
+    db::Gather gather(db::BTreeScan::create(file, 4, {1000}, {9000}), 0, true);
+    EXPECT_TRUE(gather.pushDown({1, db::PredicateOp::EQ, std::string("name7")}));
+    std::vector<std::vector<db::field_t>> filtered;
+    for (const auto &row: expected(file, file.lowerBound({1000}), file.lowerBound({9000}))) {
+        if (row[1] == db::field_t{std::string("name7")}) {
+            filtered.push_back(row);
+        }
+    }
+    EXPECT_EQ(collect(gather), filtered);
+}
+
+TEST(BTreeScanTest, CompositeKey) {
+    auto &file = createTree("btree_scan_composite.db", {1, 0}, 15000);
+    const auto all = expected(file, file.begin(), file.end());
+    EXPECT_EQ(parallel(file, 7), all);
+    const std::vector<db::field_t> lower = {std::string("name3")};
+    const std::vector<db::field_t> upper = {std::string("name5"), 105};
+    EXPECT_EQ(parallel(file, 7, lower, upper), expected(file, file.lowerBound(lower), file.lowerBound(upper)));
+    EXPECT_EQ(parallel(file, 3, upper, lower), std::vector<std::vector<db::field_t>>{});
+
+    // the unordered gather produces the same tuples
+    db::Gather gather(db::BTreeScan::create(file, 7));
+    auto rows = collect(gather);
+    std::sort(rows.begin(), rows.end());
+    auto sorted = all;
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(rows, sorted);
+}
+
+TEST(BTreeScanTest, Empty) {
+    auto &file = createTree("btree_scan_empty.db", {0}, 0);
+    const auto boundaries = file.splitRange(4);
+    ASSERT_EQ(boundaries.size(), 2);
+    EXPECT_TRUE(boundaries[0] == file.end());
+    EXPECT_TRUE(parallel(file, 4).empty());
+    db::BTreeScan scan(file);
+    EXPECT_TRUE(collect(scan).empty());
+}
@@ -0,0 +1,136 @@
+#include <db/BTreeFile.hpp>
+#include <db/Catalog.hpp>
+#include <db/Database.hpp>
+#include <db/HashFile.hpp>
+#include <db/HeapFile.hpp>
+#include <db/SecondaryIndex.hpp>
+#include <db/VersionedHeapFile.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "city", "age"});
+
+    const std::vector<std::string> names{"catalog_people.db", "catalog_people_city.db", "catalog_btree.db",
+                                         "catalog_hash.db",   "catalog_versioned.db",   "catalog.db"};
+
+    db::Tuple person(int id) { return {{id, "city" + std::to_string(id % 17), static_cast<double>(id % 50)}}; }
+
+    void removeFiles() {
+        for (const std::string &name: names) {
+            std::remove(name.c_str());
+        }
+    }
+
+    std::vector<db::field_t> types(const db::TupleDesc &desc) {
+        std::vector<db::field_t> result;
+        for (size_t i = 0; i < desc.size(); i++) {
+            result.emplace_back(static_cast<int>(desc.field_type(i)));
+            result.emplace_back(desc.field_name(i));
+        }
+        return result;
+    }
+} // namespace
+
+TEST(CatalogTest, Reopen) {
+    removeFiles();
+    db::Database &database = db::getDatabase();
+    constexpr int num_tuples = 500;
+    database.openCatalog("catalog.db");
+    database.add(std::make_unique<db::HeapFile>("catalog_people.db", td));
+    database.addIndex(std::make_unique<db::SecondaryIndex>("catalog_people_city.db", "catalog_people.db", td, 1));
+    database.add(std::make_unique<db::BTreeFile>("catalog_btree.db", td, std::vector<size_t>{1, 0}));
+    database.add(std::make_unique<db::HashFile>("catalog_hash.db", td, std::vector<size_t>{0}));
+    database.add(std::make_unique<db::VersionedHeapFile>("catalog_versioned.db", td, std::chrono::milliseconds(25)));
+    for (int i = 0; i < num_tuples; i++) {
+        database.get("catalog_people.db").insertTuple(person(i));
+        database.get("catalog_btree.db").insertTuple(person(i));
+        database.get("catalog_hash.db").insertTuple(person(i));
+    }
+    EXPECT_EQ(database.getCatalog()->getNames(),
+              (std::vector<std::string>{"catalog_btree.db", "catalog_hash.db", "catalog_people.db",
+                                        "catalog_people_city.db", "catalog_versioned.db"}));
+    for (const std::string &name: names) {
+        if (name != "catalog.db") {
+            database.remove(name);
+        }
+    }
+    database.closeCatalog();
+    EXPECT_EQ(database.getCatalog(), nullptr);
+    EXPECT_THROW(database.get("catalog_people.db"), std::out_of_range);
+
+    database.openCatalog("catalog.db");
+    const db::Catalog &catalog = *database.getCatalog();
+    const auto entry = catalog.find("catalog_people.db");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->kind, db::FileKind::HEAP);
+    EXPECT_EQ(entry->indexes, std::vector<std::string>{"catalog_people_city.db"});
+    EXPECT_EQ(types(entry->td), types(td));
+    EXPECT_FALSE(catalog.find("catalog_missing.db").has_value());
+
+    // the table is opened with its index
+    auto &table = dynamic_cast<db::HeapFile &>(database.get("catalog_people.db"));
+    EXPECT_EQ(types(table.getTupleDesc()), types(td));
+    ASSERT_EQ(table.getIndexes().size(), 1);
+    auto &by_city = dynamic_cast<db::SecondaryIndex &>(database.get("catalog_people_city.db"));
+    EXPECT_EQ(table.getIndexes()[0], &by_city);
+    table.insertTuple(person(num_tuples));
+    EXPECT_EQ(by_city.find("city0").size(), num_tuples / 17 + 1);
+
+    auto &btree = dynamic_cast<db::BTreeFile &>(database.get("catalog_btree.db"));
+    EXPECT_EQ(btree.getKeyIndices(), (std::vector<size_t>{1, 0}));
+    EXPECT_EQ(std::get<int>(btree.lookup({"city3", 20})->get_field(0)), 20);
+    auto &hash = dynamic_cast<db::HashFile &>(database.get("catalog_hash.db"));
+    EXPECT_EQ(hash.getKeyIndices(), std::vector<size_t>{0});
+    EXPECT_EQ(std::get<std::string>(hash.lookup(42)->get_field(1)), "city8");
+    auto &versioned = dynamic_cast<db::VersionedHeapFile &>(database.get("catalog_versioned.db"));
+    EXPECT_EQ(versioned.getGcInterval(), std::chrono::milliseconds(25));
+
+    // a removed index is no longer in the catalog
+    database.remove("catalog_people_city.db");
+    EXPECT_TRUE(database.getCatalog()->erase("catalog_people_city.db"));
+    EXPECT_FALSE(database.getCatalog()->erase("catalog_people_city.db"));
+    EXPECT_TRUE(database.getCatalog()->find("catalog_people.db")->indexes.empty());
+    EXPECT_THROW(database.get("catalog_people_city.db"), std::out_of_range);
+    database.closeCatalog();
+    removeFiles();
+}
+
+TEST(CatalogTest, Record) {
+    std::remove("catalog_record.db");
+    db::Database &database = db::getDatabase();
+    database.openCatalog("catalog_record.db");
+    EXPECT_THROW(database.openCatalog("catalog_record.db"), std::logic_error);
+    db::Catalog &catalog = *database.getCatalog();
+
+    // a plain DbFile cannot be described
+    database.add(std::make_unique<db::DbFile>("catalog_record_people.db", td));
+    EXPECT_FALSE(catalog.find("catalog_record_people.db").has_value());
+    database.remove("catalog_record_people.db");
+
+    const std::string long_name(db::CHAR_SIZE, 'x');
+    EXPECT_THROW(catalog.record(db::HeapFile(long_name, td)), std::logic_error);
+    std::remove(long_name.c_str());
+
+    // a description is replaced, the indexes are kept until they are dropped
+    EXPECT_TRUE(catalog.record(db::HeapFile("catalog_record_people.db", td)));
+    catalog.addIndex("catalog_record_people.db", "catalog_record_city.db");
+    catalog.addIndex("catalog_record_people.db", "catalog_record_city.db");
+    EXPECT_EQ(catalog.find("catalog_record_people.db")->indexes.size(), 1);
+    std::remove("catalog_record_people.db");
+    EXPECT_TRUE(catalog.record(db::BTreeFile("catalog_record_people.db", td, std::vector<size_t>{0})));
+    const auto entry = catalog.find("catalog_record_people.db");
+    EXPECT_EQ(entry->kind, db::FileKind::BTREE);
+    EXPECT_EQ(entry->indexes, std::vector<std::string>{"catalog_record_city.db"});
+    EXPECT_EQ(entry->key_fields, std::vector<size_t>{0});
+    catalog.dropIndexes("catalog_record_people.db");
+    EXPECT_TRUE(catalog.find("catalog_record_people.db")->indexes.empty());
+    EXPECT_EQ(catalog.find("catalog_record_people.db")->kind, db::FileKind::BTREE);
+
+    // a file that the catalog rejects is not added
+    EXPECT_THROW(database.add(std::make_unique<db::HeapFile>(long_name, td)), std::logic_error);
+    EXPECT_THROW(database.get(long_name), std::out_of_range);
+    std::remove(long_name.c_str());
+    database.closeCatalog();
+    std::remove("catalog_record_people.db");
+    std::remove("catalog_record.db");
+}
@@ -0,0 +1,178 @@
+#include <db/Crc32c.hpp>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/PageFormat.hpp>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Page pattern(size_t id) {
+        db::Page page;
+        for (size_t i = 0; i < page.size(); i++) {
+            page[i] = static_cast<uint8_t>(i * 31 + id);
+        }
+        return page;
+    }
+
+    /// Read bytes of a file
+    std::string read(const char *name, size_t offset, size_t size) {
+        std::string bytes(size, '\0');
+        std::ifstream in(name, std::ios::binary);
+        in.seekg(static_cast<std::streamoff>(offset));
+        in.read(bytes.data(), static_cast<std::streamsize>(size));
+        return bytes;
+    }
+
+    /// Overwrite bytes of a file in place
+    void overwrite(const char *name, size_t offset, const std::string &bytes) {
+        std::fstream out(name, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(static_cast<std::streamoff>(offset));
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+} // namespace
+
+TEST(ChecksumTest, Crc32c) {
+    const std::string check = "123456789";
+    EXPECT_EQ(db::crc32c(check.data(), check.size()), 0xE3069283);
+    EXPECT_EQ(db::crc32c(check.data(), 0), 0);
+
+    // the interleaved streams and the tail give the same checksum as a chain of small pieces
+    std::vector<uint8_t> data(3 * db::DEFAULT_PAGE_SIZE + 13);
+    std::iota(data.begin(), data.end(), 7);
+    for (size_t length: {size_t{0}, size_t{5}, size_t{4080}, size_t{4096}, size_t{8192}, data.size()}) {
+        uint32_t chained = 0;
+        for (size_t offset = 0; offset < length; offset += 3) {
+            chained = db::crc32c(data.data() + offset, std::min<size_t>(3, length - offset), chained);
+        }
+        EXPECT_EQ(db::crc32c(data.data(), length), chained) << length;
+    }
+}
+
+TEST(ChecksumTest, DetectCorruption) {
+    const char *name = "checksum_pages.db";
+    std::remove(name);
+    {
+        db::DbFile file(name, td);
+        for (size_t id = 0; id < 8; id++) {
+            file.writePage(pattern(id), id);
+        }
+        // a page past the end of the file leaves a hole
+        file.writePage(pattern(10), 10);
+    }
+    EXPECT_EQ(std::filesystem::file_size(name), 12 * db::DEFAULT_PAGE_SIZE);
+    EXPECT_TRUE(db::verifyFile(name, 3).empty());
+
+    // a flipped bit, and a page copied to the wrong place with its header
+    overwrite(name, db::pageOffset(2) + 100, "x");
+    overwrite(name, db::pageOffset(6), read(name, db::pageOffset(5), db::DEFAULT_PAGE_SIZE));
+    overwrite(name, db::headerOffset(6), read(name, db::headerOffset(5), db::PAGE_HEADER_SIZE));
+
+    db::DbFile file(name, td);
+    EXPECT_EQ(file.getNumPages(), 11);
+    db::Page page;
+    file.readPage(page, 1);
+    EXPECT_EQ(page, pattern(1));
+    file.readPage(page, 8);
+    EXPECT_EQ(page, db::Page{});
+    EXPECT_THROW(file.readPage(page, 2), std::runtime_error);
+    EXPECT_THROW(file.readPage(page, 6), std::runtime_error);
+    std::vector<uint8_t> pages(4 * db::DEFAULT_PAGE_SIZE);
+    EXPECT_THROW(file.readPages(pages.data(), 4, 4), std::runtime_error);
+    EXPECT_EQ(db::verifyFile(name, 3), (std::vector<size_t>{2, 6}));
+    std::remove(name);
+}
+
+TEST(ChecksumTest, TornWrite) {
+    const char *name = "checksum_torn.db";
+    std::remove(name);
+    {
+        db::DbFile file(name, td);
+        for (size_t id = 0; id < 3; id++) {
+            file.writePage(pattern(id), id);
+        }
+    }
+    // only the first sectors of the last page reached the file
+    std::filesystem::resize_file(name, db::pageOffset(2) + 1024);
+    db::DbFile file(name, td);
+    EXPECT_EQ(file.getNumPages(), 3);
+    db::Page page;
+    EXPECT_THROW(file.readPage(page, 2), std::runtime_error);
+    EXPECT_EQ(db::verifyFile(name, 2), std::vector<size_t>{2});
+
+    // a write of which only the first half reached the file, the second half has the old contents
+    file.writePage(pattern(2), 2);
+    std::filesystem::copy_file(name, "checksum_torn.old", std::filesystem::copy_options::overwrite_existing);
+    file.writePage(pattern(100), 1);
+    const size_t half = db::DEFAULT_PAGE_SIZE / 2;
+    overwrite(name, db::pageOffset(1) + half, read("checksum_torn.old", db::pageOffset(1) + half, half));
+    file.readPage(page, 2);
+    EXPECT_EQ(page, pattern(2));
+    EXPECT_THROW(file.readPage(page, 1), std::runtime_error);
+
+    // a crash between the write of a page and of its header
+    file.writePage(pattern(200), 2);
+    overwrite(name, db::headerOffset(2), read("checksum_torn.old", db::headerOffset(2), db::PAGE_HEADER_SIZE));
+    EXPECT_THROW(file.readPage(page, 2), std::runtime_error);
+    std::remove("checksum_torn.old");
+    std::remove(name);
+}
+
+TEST(ChecksumTest, AlignedPages) {
+    const char *name = "checksum_aligned.db";
+    std::remove(name);
+    // the pages of two groups and of the start of a third one, written at once and one by one
+    constexpr size_t count = 2 * db::GROUP_PAGES + 3;
+    std::vector<uint8_t> data(count * db::DEFAULT_PAGE_SIZE);
+    for (size_t id = 0; id < count; id++) {
+        const db::Page page = pattern(id);
+        std::copy(page.begin(), page.end(), data.begin() + id * db::DEFAULT_PAGE_SIZE);
+    }
+    {
+        db::DbFile file(name, td);
+        file.writePages(data.data() + db::DEFAULT_PAGE_SIZE, 1, count - 1);
+        file.writePage(pattern(0), 0);
+    }
+    EXPECT_EQ(std::filesystem::file_size(name), db::pageOffset(count));
+    EXPECT_EQ(db::pageOffset(db::GROUP_PAGES) % db::DEFAULT_PAGE_SIZE, 0);
+    EXPECT_EQ(db::storedPages(db::pageOffset(count)), count);
+    EXPECT_EQ(db::storedPages(db::headerOffset(db::GROUP_PAGES) + db::DEFAULT_PAGE_SIZE), db::GROUP_PAGES);
+    EXPECT_EQ(read(name, db::pageOffset(db::GROUP_PAGES + 1), db::DEFAULT_PAGE_SIZE),
+              std::string(data.begin() + (db::GROUP_PAGES + 1) * db::DEFAULT_PAGE_SIZE,
+                          data.begin() + (db::GROUP_PAGES + 2) * db::DEFAULT_PAGE_SIZE));
+    EXPECT_TRUE(db::verifyFile(name, 3).empty());
+
+    db::DbFile file(name, td);
+    EXPECT_EQ(file.getNumPages(), count);
+    std::vector<uint8_t> pages(count * db::DEFAULT_PAGE_SIZE);
+    file.readPages(pages.data(), 0, count);
+    EXPECT_EQ(pages, data);
+    std::remove(name);
+}
+
+TEST(ChecksumTest, HeapFileRoundTrip) {
+    const char *name = "checksum_heap.db";
+    std::remove(name);
+    auto &database = db::getDatabase();
+    database.add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = database.get(name);
+    for (int i = 0; i < 2000; i++) {
+        file.insertTuple({{i, "name", i / 2.0}});
+    }
+    const size_t pages = file.getNumPages();
+    database.remove(name);
+    EXPECT_TRUE(db::verifyFile(name).empty());
+
+    database.add(std::make_unique<db::HeapFile>(name, td));
+    auto &reopened = database.get(name);
+    EXPECT_EQ(reopened.getNumPages(), pages);
+    int count = 0;
+    for (auto it = reopened.begin(); it != reopened.end(); reopened.next(it)) {
+        count++;
+    }
+    EXPECT_EQ(count, 2000);
+    database.remove(name);
+}
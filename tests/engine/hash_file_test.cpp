@@ -0,0 +1,139 @@
+#include <db/Crc32c.hpp>
+#include <db/Database.hpp>
+#include <db/HashFile.hpp>
+#include <db/HashPage.hpp>
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::HashFile &createFile(const char *name, const std::vector<size_t> &key) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::HashFile>(name, td, key));
+        return dynamic_cast<db::HashFile &>(db::getDatabase().get(name));
+    }
+} // namespace
+
+TEST(HashFileTest, InsertLookupDelete) {
+    auto &file = createFile("hash_basic.db", {0});
+    EXPECT_FALSE(file.lookup(0).has_value());
+    EXPECT_EQ(file.begin(), file.end());
+    constexpr int num_keys = 20000;
+    for (int i = 0; i < num_keys; i++) {
+        file.insertTuple({{i * 2, "apple", 1.0}});
+    }
+    EXPECT_GT(file.getNumPages(), 1);
+    for (int i = 0; i < num_keys; i++) {
+        auto t = file.lookup(i * 2);
+        ASSERT_TRUE(t.has_value());
+        EXPECT_EQ(std::get<int>(t->get_field(0)), i * 2);
+        EXPECT_FALSE(file.lookup(i * 2 + 1).has_value());
+    }
+
+    // an existing key is replaced
+    file.insertTuple({{10, "orange", 2.0}});
+    EXPECT_EQ(std::get<std::string>(file.lookup(10)->get_field(1)), "orange");
+
+    for (int i = 0; i < num_keys; i += 3) {
+        EXPECT_TRUE(file.deleteKey(i * 2));
+        EXPECT_FALSE(file.deleteKey(i * 2));
+    }
+    std::set<int> keys;
+    for (const auto &t: file) {
+        EXPECT_TRUE(keys.insert(std::get<int>(t.get_field(0))).second);
+    }
+    EXPECT_EQ(keys.size(), num_keys - (num_keys + 2) / 3);
+    for (int i = 0; i < num_keys; i++) {
+        EXPECT_EQ(file.lookup(i * 2).has_value(), i % 3 != 0);
+    }
+}
+
+TEST(HashFileTest, CompositeKey) {
+    auto &file = createFile("hash_composite.db", {1, 0});
+    for (int i = 0; i < 5000; i++) {
+        file.insertTuple({{i % 10, "name" + std::to_string(i / 10), static_cast<double>(i)}});
+    }
+    for (int i = 0; i < 5000; i++) {
+        auto t = file.lookup({"name" + std::to_string(i / 10), i % 10});
+        ASSERT_TRUE(t.has_value());
+        EXPECT_EQ(std::get<double>(t->get_field(2)), i);
+    }
+    EXPECT_FALSE(file.lookup({"name0", 10}).has_value());
+    EXPECT_THROW(file.lookup({"name0"}), std::logic_error);
+
+    // delete every tuple through iterators
+    while (file.begin() != file.end()) {
+        file.deleteTuple(file.begin());
+    }
+    EXPECT_FALSE(file.lookup({"name0", 0}).has_value());
+}
+
+TEST(HashFileTest, Reopen) {
+    const char *name = "hash_reopen.db";
+    auto &file = createFile(name, {0});
+    for (int i = 0; i < 10000; i++) {
+        file.insertTuple({{i, "apple", static_cast<double>(i)}});
+    }
+    const size_t num_pages = file.getNumPages();
+    auto removed = db::getDatabase().remove(name);
+    auto &bufferPool = db::getDatabase().getBufferPool();
+    for (size_t page = 0; page < num_pages; page++) {
+        if (bufferPool.contains({name, page})) {
+            bufferPool.discardPage({name, page});
+        }
+    }
+
+    // the directory is rebuilt from the buckets
+    db::getDatabase().add(std::make_unique<db::HashFile>(name, td, 0));
+    auto &reopened = dynamic_cast<db::HashFile &>(db::getDatabase().get(name));
+    EXPECT_EQ(reopened.getNumPages(), num_pages);
+    for (int i = 0; i < 10000; i++) {
+        auto t = reopened.lookup(i);
+        ASSERT_TRUE(t.has_value());
+        EXPECT_EQ(std::get<double>(t->get_field(2)), i);
+    }
+    reopened.insertTuple({{10000, "apple", 1.0}});
+    EXPECT_TRUE(reopened.lookup(10000).has_value());
+
+    // the buckets on disk are selected by the CRC-32C of the keys, which does not depend on the build
+    bufferPool.flushFile(name);
+    const db::KeyDesc kd(td, {0});
+    db::Page page;
+    for (size_t id = 0; id < reopened.getNumPages(); id++) {
+        reopened.readPage(page, id);
+        const db::HashPage bucket(page, td);
+        const uint32_t mask = (uint32_t{1} << bucket.header->depth) - 1;
+        for (size_t slot = 0; slot < bucket.header->size; slot++) {
+            const std::string key = kd.encode(bucket.getTuple(slot));
+            EXPECT_EQ(db::crc32c(key.data(), key.size()) & mask, bucket.header->pattern);
+        }
+    }
+}
+
+TEST(HashFileTest, ConcurrentInsertLookup) {
+    db::getDatabase().getBufferPool().resize(256);
+    auto &file = createFile("hash_concurrent.db", {0});
+    constexpr int num_threads = 8;
+    constexpr int num_keys = 80000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&file, t] {
+            for (int i = t; i < num_keys; i += num_threads) {
+                file.insertTuple({{i, "apple", 1.0}});
+                // a key is visible as soon as it is inserted, even while buckets are split
+                ASSERT_TRUE(file.lookup(i).has_value());
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    std::set<int> keys;
+    for (const auto &t: file) {
+        keys.insert(std::get<int>(t.get_field(0)));
+    }
+    EXPECT_EQ(keys.size(), num_keys);
+    EXPECT_EQ(*keys.rbegin(), num_keys - 1);
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/FieldKey.hpp>
+#include <db/GraceHashJoin.hpp>
+#include <db/HashJoin.hpp>
+#include <db/HeapFile.hpp>
+#include <db/SeqScan.hpp>
+#include <db/SortMergeJoin.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <unordered_map>
+
+namespace {
+    const db::TupleDesc left_td({db::type_t::INT, db::type_t::CHAR, db::type_t::INT}, {"l_key", "l_name", "l_id"});
+    const db::TupleDesc right_td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE},
+                                 {"r_key", "r_name", "r_value"});
+
+    db::DbFile &createFile(std::unique_ptr<db::DbFile> file) {
+        std::string name = file->getName();
+        db::getDatabase().add(std::move(file));
+        return db::getDatabase().get(name);
+    }
+
+    db::DbFile &createLeft(const char *name, int count, int modulo) {
+        std::remove(name);
+        auto &file = createFile(std::make_unique<db::HeapFile>(name, left_td));
+        for (int i = 0; i < count; i++) {
+            file.insertTuple({{i % modulo, "name" + std::to_string(i % 13), i}});
+        }
+        return file;
+    }
+
+    db::DbFile &createRight(const char *name, int count, int modulo) {
+        std::remove(name);
+        auto &file = createFile(std::make_unique<db::HeapFile>(name, right_td));
+        for (int i = 0; i < count; i++) {
+            file.insertTuple({{i % modulo - 5, "name" + std::to_string(i % 17), static_cast<double>(i)}});
+        }
+        return file;
+    }
+
+    /// The serialized rows of an operator, sorted
+    std::vector<std::string> collect(db::Operator &op) {
+        std::vector<std::string> result;
+        op.open();
+        while (op.next()) {
+            result.emplace_back(reinterpret_cast<const char *>(op.row()), op.getTupleDesc().length());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    /// The serialized rows of a file, by the bytes of their key
+    std::unordered_multimap<std::string, std::string> rowsByKey(const db::DbFile &file, size_t field) {
+        const db::FieldKey key(file.getTupleDesc(), field);
+        std::unordered_multimap<std::string, std::string> result;
+        db::SeqScan scan(file);
+        scan.open();
+        while (scan.next()) {
+            result.emplace(key.bytes(scan.row()),
+                           std::string(reinterpret_cast<const char *>(scan.row()), file.getTupleDesc().length()));
+        }
+        return result;
+    }
+
+    /// The join of two files computed with a multimap, sorted
+    std::vector<std::string> expectedJoin(const db::DbFile &left, size_t left_field, const db::DbFile &right,
+                                          size_t right_field) {
+        const auto right_rows = rowsByKey(right, right_field);
+        std::vector<std::string> result;
+        for (const auto &[key, left_row]: rowsByKey(left, left_field)) {
+            auto [begin, end] = right_rows.equal_range(key);
+            for (auto it = begin; it != end; ++it) {
+                result.push_back(left_row + it->second);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<std::string> tempFiles() {
+        std::vector<std::string> result;
+        for (const auto &entry: std::filesystem::directory_iterator(".")) {
+            if (entry.path().filename().string().starts_with("grace_join_")) {
+                result.push_back(entry.path().string());
+            }
+        }
+        return result;
+    }
+} // namespace
+
+TEST(JoinTest, HashJoin) {
+    auto &left = createLeft("join_hash_left.db", 600, 37);
+    auto &right = createRight("join_hash_right.db", 900, 53);
+
+    db::HashJoin join(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 0);
+    EXPECT_EQ(join.getTupleDesc().size(), 6);
+    auto expected = expectedJoin(left, 0, right, 0);
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(collect(join), expected);
+    // a join can be opened again
+    EXPECT_EQ(collect(join), expected);
+
+    db::HashJoin char_join(std::make_unique<db::SeqScan>(right), std::make_unique<db::SeqScan>(left), 1, 1);
+    EXPECT_EQ(collect(char_join), expectedJoin(right, 1, left, 1));
+
+    // predicates are pushed into the inputs
+    db::HashJoin filtered(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 0);
+    EXPECT_TRUE(filtered.pushDown({4, db::PredicateOp::EQ, std::string("name3")}));
+    EXPECT_TRUE(filtered.pushDown({2, db::PredicateOp::LT, 100}));
+    size_t count = 0;
+    filtered.open();
+    while (filtered.next()) {
+        EXPECT_EQ(filtered.getString(4), "name3");
+        EXPECT_LT(filtered.getInt(2), 100);
+        EXPECT_EQ(filtered.getInt(0), filtered.getInt(3));
+        count++;
+    }
+    EXPECT_GT(count, 0);
+
+    EXPECT_THROW(db::HashJoin(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 1),
+                 std::logic_error);
+    EXPECT_THROW(db::HashJoin(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 2),
+                 std::logic_error);
+    EXPECT_THROW(db::HashJoin(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(left), 0, 0),
+                 std::logic_error);
+}
+
+TEST(JoinTest, HashJoinPartitions) {
+    // a build side of a few MB is radix partitioned
+    auto &left = createLeft("join_partition_left.db", 40000, 20011);
+    auto &right = createRight("join_partition_right.db", 30000, 30000);
+    db::HashJoin join(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 0);
+    auto rows = collect(join);
+    EXPECT_EQ(rows, expectedJoin(left, 0, right, 0));
+    EXPECT_EQ(rows.size(), 40000);
+}
+
+TEST(JoinTest, GraceHashJoin) {
+    auto &left = createLeft("join_grace_left.db", 3000, 101);
+    auto &right = createRight("join_grace_right.db", 2000, 131);
+    auto expected = expectedJoin(left, 0, right, 0);
+    {
+        db::GraceHashJoin join(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 0,
+                               16 * 1024, 8);
+        EXPECT_EQ(collect(join), expected);
+        EXPECT_TRUE(join.spilled());
+        EXPECT_EQ(tempFiles().size(), 16);
+        EXPECT_EQ(collect(join), expected);
+        EXPECT_EQ(tempFiles().size(), 16);
+    }
+    EXPECT_TRUE(tempFiles().empty());
+
+    db::GraceHashJoin in_memory(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 0,
+                                size_t{1} << 30);
+    EXPECT_EQ(collect(in_memory), expected);
+    EXPECT_FALSE(in_memory.spilled());
+    EXPECT_TRUE(tempFiles().empty());
+
+    db::GraceHashJoin char_join(std::make_unique<db::SeqScan>(right), std::make_unique<db::SeqScan>(left), 1, 1,
+                                4096, 3);
+    EXPECT_EQ(collect(char_join), expectedJoin(right, 1, left, 1));
+    EXPECT_TRUE(char_join.spilled());
+}
+
+TEST(JoinTest, SortMergeJoin) {
+    const char *left_name = "join_merge_left.db";
+    const char *right_name = "join_merge_right.db";
+    std::remove(left_name);
+    std::remove(right_name);
+    auto &left = createFile(std::make_unique<db::BTreeFile>(left_name, left_td, size_t{0}));
+    // duplicate keys on the right, sorted on (r_key, r_value)
+    auto &right = createFile(std::make_unique<db::BTreeFile>(right_name, right_td, std::vector<size_t>{0, 2}));
+    for (int i = 0; i < 2000; i += 3) {
+        left.insertTuple({{i, "name" + std::to_string(i % 13), i}});
+    }
+    for (int i = 0; i < 3000; i++) {
+        right.insertTuple({{(i * 7) % 1500 - 200, "name", static_cast<double>(i)}});
+    }
+    EXPECT_TRUE(db::SortMergeJoin::sortedOn(left, 0));
+    EXPECT_TRUE(db::SortMergeJoin::sortedOn(right, 0));
+    EXPECT_FALSE(db::SortMergeJoin::sortedOn(right, 2));
+
+    db::SortMergeJoin join(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(right), 0, 0);
+    std::vector<int> keys;
+    join.open();
+    while (join.next()) {
+        keys.push_back(join.getInt(0));
+        EXPECT_EQ(join.getInt(0), join.getInt(3));
+    }
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    EXPECT_EQ(collect(join), expectedJoin(left, 0, right, 0));
+
+    // duplicates on both sides, the right side is exhausted first
+    db::SortMergeJoin self(std::make_unique<db::SeqScan>(right), std::make_unique<db::SeqScan>(left), 0, 0);
+    EXPECT_EQ(collect(self), expectedJoin(right, 0, left, 0));
+
+    auto &heap = createRight("join_merge_heap.db", 100, 7);
+    EXPECT_FALSE(db::SortMergeJoin::sortedOn(heap, 0));
+    db::SortMergeJoin unsorted(std::make_unique<db::SeqScan>(left), std::make_unique<db::SeqScan>(heap), 0, 0);
+    EXPECT_THROW(collect(unsorted), std::runtime_error);
+}
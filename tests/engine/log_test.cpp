@@ -0,0 +1,504 @@
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/LogManager.hpp>
+#include <db/PageFormat.hpp>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <sys/resource.h>
+#include <thread>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int i) { return {{i, "name" + std::to_string(i % 37), i / 2.0}}; }
+
+    std::vector<int> ids(const db::DbFile &file) {
+        std::vector<int> result;
+        for (auto it = file.begin(); it != file.end(); file.next(it)) {
+            const db::Tuple t = file.getTuple(it);
+            EXPECT_EQ(t.get_field(2), item(std::get<int>(t.get_field(0))).get_field(2));
+            result.push_back(std::get<int>(t.get_field(0)));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    void deleteIds(db::DbFile &file, int modulo) {
+        for (auto it = file.begin(); it != file.end(); file.next(it)) {
+            if (std::get<int>(file.getTuple(it).get_field(0)) % modulo == 0) {
+                file.deleteTuple(it);
+            }
+        }
+    }
+
+    /// Stop as if the process had crashed: the dirty pages of the file are lost and the log is closed
+    void crash(const std::string &name) {
+        auto &database = db::getDatabase();
+        auto &pool = database.getBufferPool();
+        for (size_t page = 0; page < database.get(name).getNumPages(); page++) {
+            if (pool.contains({name, page})) {
+                pool.discardPage({name, page});
+            }
+        }
+        database.remove(name);
+        database.setLog(nullptr);
+    }
+
+    std::string readBytes(const char *name, size_t offset, size_t size) {
+        std::string bytes(size, '\0');
+        std::ifstream in(name, std::ios::binary);
+        in.seekg(static_cast<std::streamoff>(offset));
+        in.read(bytes.data(), static_cast<std::streamsize>(size));
+        return bytes;
+    }
+
+    void writeBytes(const char *name, size_t offset, const std::string &bytes) {
+        std::fstream out(name, std::ios::binary | std::ios::in | std::ios::out);
+        out.seekp(static_cast<std::streamoff>(offset));
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    size_t fileSize(const char *name) {
+        std::ifstream in(name, std::ios::binary | std::ios::ate);
+        return static_cast<size_t>(in.tellg());
+    }
+} // namespace
+
+TEST(LogTest, HeapRecovery) {
+    const char *name = "log_heap.db";
+    const char *log_name = "log_heap.log";
+    std::remove(name);
+    std::remove(log_name);
+    auto &database = db::getDatabase();
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = database.get(name);
+    for (int i = 0; i < 1000; i++) {
+        file.insertTuple(item(i));
+    }
+    deleteIds(file, 7);
+    database.getLog()->commit();
+    const std::vector<int> committed = ids(file);
+
+    // changes that are not committed, some of them are written to the file
+    for (int i = 1000; i < 1500; i++) {
+        file.insertTuple(item(i));
+    }
+    deleteIds(file, 3);
+    database.getBufferPool().flushFile(name);
+    for (int i = 1500; i < 1600; i++) {
+        file.insertTuple(item(i));
+    }
+    crash(name);
+    {
+        // a record that was only partially written
+        std::ofstream out(log_name, std::ios::binary | std::ios::app);
+        out << "partial record";
+    }
+
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    EXPECT_EQ(fileSize(log_name), 16);
+    database.add(std::make_unique<db::HeapFile>(name, td));
+    EXPECT_EQ(ids(database.get(name)), committed);
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, BTreeRecovery) {
+    const char *name = "log_btree.db";
+    const char *log_name = "log_btree.log";
+    std::remove(name);
+    std::remove(log_name);
+    auto &database = db::getDatabase();
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &tree = dynamic_cast<db::BTreeFile &>(database.get(name));
+    for (int i = 0; i < 3000; i++) {
+        tree.insertTuple(item(i * 7919 % 3000));
+    }
+    database.getLog()->commit();
+    std::vector<int> committed = ids(tree);
+
+    // splits, merges and evictions that are not committed
+    for (int i = 3000; i < 6000; i++) {
+        tree.insertTuple(item(i));
+    }
+    for (int i = 0; i < 3000; i += 2) {
+        tree.deleteKey(i);
+    }
+    database.getBufferPool().resize(database.getBufferPool().size());
+    tree.insertTuple(item(6000));
+    crash(name);
+
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &recovered = dynamic_cast<db::BTreeFile &>(database.get(name));
+    EXPECT_EQ(ids(recovered), committed);
+    recovered.insertTuple(item(3000));
+    committed.push_back(3000);
+    EXPECT_EQ(ids(recovered), committed);
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, StealNoForce) {
+    const char *name = "log_policy.db";
+    std::remove(name);
+    std::remove("log_policy.log");
+    auto &database = db::getDatabase();
+    auto &pool = database.getBufferPool();
+    database.setLog(std::make_unique<db::LogManager>("log_policy.log"));
+    auto &log = *database.getLog();
+    database.add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = database.get(name);
+    const db::PageId pid{name, 0};
+
+    file.insertTuple(item(1));
+    const uint64_t lsn = pool.getPageLsn(pid);
+    EXPECT_GT(lsn, 0);
+    EXPECT_LE(log.getFlushedLsn(), lsn);
+    // a commit syncs the log, the page is not written
+    const size_t writes = file.getWrites().size();
+    log.commit();
+    EXPECT_GT(log.getFlushedLsn(), lsn);
+    EXPECT_EQ(file.getWrites().size(), writes);
+    EXPECT_TRUE(pool.isDirty(pid));
+
+    // a page that is not committed is written after its changes are in the log
+    file.insertTuple(item(2));
+    const uint64_t next_lsn = pool.getPageLsn(pid);
+    EXPECT_GT(next_lsn, lsn);
+    EXPECT_LE(log.getFlushedLsn(), next_lsn);
+    pool.flushPage(pid);
+    EXPECT_GT(log.getFlushedLsn(), next_lsn);
+    EXPECT_EQ(file.getWrites().size(), writes + 1);
+
+    // nothing is logged for a page that did not change
+    const uint64_t end = log.getNextLsn();
+    pool.markDirty(pid);
+    EXPECT_EQ(log.getNextLsn(), end);
+    EXPECT_EQ(pool.getPageLsn(pid), next_lsn);
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, GroupCommit) {
+    const char *name = "log_group.db";
+    std::remove(name);
+    std::remove("log_group.log");
+    auto &database = db::getDatabase();
+    database.setLog(std::make_unique<db::LogManager>("log_group.log", std::chrono::milliseconds(2)));
+    auto &log = *database.getLog();
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &tree = database.get(name);
+
+    constexpr int threads = 4;
+    constexpr int commits = 25;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < commits; i++) {
+                tree.insertTuple(item(i * threads + t));
+                const uint64_t lsn = log.commit();
+                EXPECT_GT(log.getFlushedLsn(), lsn);
+            }
+        });
+    }
+    for (auto &worker: workers) {
+        worker.join();
+    }
+    EXPECT_EQ(log.getNumCommits(), threads * commits);
+    // the commits that wait at the same time share a sync
+    EXPECT_LT(log.getNumSyncs(), threads * commits);
+    EXPECT_EQ(log.getFlushedLsn(), log.getNextLsn());
+    std::vector<int> expected(threads * commits);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(ids(tree), expected);
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, CheckpointRecovery) {
+    const char *name = "log_checkpoint.db";
+    const char *log_name = "log_checkpoint.log";
+    std::remove(name);
+    std::remove(log_name);
+    auto &database = db::getDatabase();
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &tree = database.get(name);
+    for (int i = 0; i < 3000; i++) {
+        tree.insertTuple(item(i * 7919 % 3000));
+    }
+    database.getLog()->commit();
+    // the pages written before the checkpoint are not redone
+    database.getBufferPool().resize(database.getBufferPool().size());
+    database.checkpoint();
+    EXPECT_EQ(database.getLog()->getNumCheckpoints(), 1);
+    for (int i = 3000; i < 3100; i++) {
+        tree.insertTuple(item(i));
+    }
+    database.getLog()->commit();
+    std::vector<int> committed = ids(tree);
+    for (int i = 0; i < 3000; i += 3) {
+        dynamic_cast<db::BTreeFile &>(tree).deleteKey(i);
+    }
+    crash(name);
+
+    database.setLog(std::make_unique<db::LogManager>(log_name, std::chrono::microseconds{}, 4));
+    // at least one record per insert was logged before the checkpoint
+    EXPECT_GT(database.getLog()->getNumRedone(), 0);
+    EXPECT_LT(database.getLog()->getNumRedone(), 3000);
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    EXPECT_EQ(ids(database.get(name)), committed);
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, FuzzyCheckpoint) {
+    const char *name = "log_fuzzy.db";
+    const char *log_name = "log_fuzzy.log";
+    std::remove(name);
+    std::remove(log_name);
+    auto &database = db::getDatabase();
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &tree = database.get(name);
+
+    // checkpoints are taken while a writer modifies the tree and pages are evicted
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; i < 4000; i++) {
+            tree.insertTuple(item(i * 7919 % 4000));
+            if (i % 500 == 499) {
+                database.getLog()->commit();
+            }
+        }
+        done = true;
+    });
+    while (!done) {
+        database.checkpoint();
+    }
+    writer.join();
+    EXPECT_GT(database.getLog()->getNumCheckpoints(), 0);
+    const std::vector<int> committed = ids(tree);
+    EXPECT_EQ(committed.size(), 4000);
+    for (int i = 4000; i < 4500; i++) {
+        tree.insertTuple(item(i));
+    }
+    database.checkpoint();
+    crash(name);
+
+    database.setLog(std::make_unique<db::LogManager>(log_name, std::chrono::microseconds{}, 3));
+    database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+    EXPECT_EQ(ids(database.get(name)), committed);
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, FailedWrite) {
+    const char *name = "log_failed.db";
+    const char *log_name = "log_failed.log";
+    std::remove(name);
+    std::remove(log_name);
+    auto &database = db::getDatabase();
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = database.get(name);
+    for (int i = 0; i < 100; i++) {
+        file.insertTuple(item(i));
+    }
+    auto &log = *database.getLog();
+    log.commit();
+    const std::vector<int> committed = ids(file);
+
+    // the log cannot grow: the records of the next commit are not written
+    for (int i = 100; i < 200; i++) {
+        file.insertTuple(item(i));
+    }
+    rlimit limit{};
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &limit), 0);
+    const auto handler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit small = limit;
+    small.rlim_cur = fileSize(log_name);
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &small), 0);
+    EXPECT_THROW(log.commit(), std::runtime_error);
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0);
+    std::signal(SIGXFSZ, handler);
+
+    // the records were lost with the failed write, the log cannot be written anymore
+    EXPECT_THROW(log.commit(), std::runtime_error);
+    EXPECT_THROW(log.flush(log.getNextLsn()), std::runtime_error);
+    crash(name);
+
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::HeapFile>(name, td));
+    EXPECT_EQ(ids(database.get(name)), committed);
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, FlushLatchedPage) {
+    const char *name = "log_latched.db";
+    const char *log_name = "log_latched.log";
+    std::remove(name);
+    std::remove(log_name);
+    auto &database = db::getDatabase();
+    auto &pool = database.getBufferPool();
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    database.add(std::make_unique<db::DbFile>(name, td));
+    const auto &file = database.get(name);
+    const db::PageId pid{name, 0};
+    pool.getPage(pid);
+
+    // the page is written between two changes, never in the middle of one
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 1; i <= 1000; i++) {
+            db::PageLatch latch(pool, pid, true);
+            // a change in two steps, as a split that moves half of the page
+            std::fill(latch.page.begin(), latch.page.begin() + db::DEFAULT_PAGE_SIZE / 2, static_cast<uint8_t>(i));
+            std::this_thread::yield();
+            std::fill(latch.page.begin() + db::DEFAULT_PAGE_SIZE / 2, latch.page.end(), static_cast<uint8_t>(i));
+            latch.markDirty();
+        }
+        done = true;
+    });
+    db::Page page;
+    size_t flushes = 0;
+    while (!done) {
+        pool.flushPage(pid);
+        file.readPage(page, pid.page);
+        EXPECT_EQ(std::count(page.begin(), page.end(), page[0]), page.size());
+        flushes++;
+    }
+    writer.join();
+    EXPECT_GT(flushes, 0);
+    pool.flushPage(pid);
+    file.readPage(page, pid.page);
+    EXPECT_EQ(std::count(page.begin(), page.end(), static_cast<uint8_t>(1000)), page.size());
+    database.remove(name);
+    database.setLog(nullptr);
+}
+
+TEST(LogTest, CommitDuringSplits) {
+    const char *log_name = "log_splits.log";
+    constexpr int count = 3000;
+    auto &database = db::getDatabase();
+    for (int round = 0; round < 4; round++) {
+        // the pages of the files of the previous rounds may still be in the BufferPool
+        const std::string name = "log_splits" + std::to_string(round) + ".db";
+        std::remove(name.c_str());
+        std::remove(log_name);
+        database.setLog(std::make_unique<db::LogManager>(log_name));
+        database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+        auto &tree = dynamic_cast<db::BTreeFile &>(database.get(name));
+
+        // another thread commits while the leaves and the index pages split, then the last inserts are not committed
+        std::atomic<int> inserted{0};
+        std::thread committer([&] {
+            while (inserted < count / 2 + round * 200) {
+                database.getLog()->commit();
+            }
+        });
+        for (int i = 0; i < count; i++) {
+            tree.insertTuple(item(i * 7919 % count));
+            inserted++;
+        }
+        committer.join();
+        crash(name);
+
+        // the last commit is between two inserts: the tree holds a prefix of the inserts, reachable from the root
+        database.setLog(std::make_unique<db::LogManager>(log_name));
+        database.add(std::make_unique<db::BTreeFile>(name, td, 0));
+        auto &recovered = dynamic_cast<db::BTreeFile &>(database.get(name));
+        const std::vector<int> committed = ids(recovered);
+        std::vector<int> expected;
+        for (int i = 0; i < static_cast<int>(committed.size()); i++) {
+            expected.push_back(i * 7919 % count);
+        }
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(committed, expected) << round;
+        for (int id: committed) {
+            EXPECT_TRUE(recovered.lookup(id).has_value()) << id;
+        }
+        database.remove(name);
+        database.setLog(nullptr);
+    }
+}
+
+TEST(LogTest, OperationBeforeCommit) {
+    const char *log_name = "log_operation.log";
+    std::remove(log_name);
+    auto &database = db::getDatabase();
+    database.setLog(std::make_unique<db::LogManager>(log_name));
+    auto &log = *database.getLog();
+
+    // a commit waits for the operation in progress
+    std::atomic<bool> committed{false};
+    std::thread committer;
+    {
+        const auto operation = database.startOperation();
+        EXPECT_TRUE(operation.owns_lock());
+        committer = std::thread([&] {
+            log.commit();
+            committed = true;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        EXPECT_FALSE(committed);
+        EXPECT_EQ(log.getNumCommits(), 0);
+    }
+    committer.join();
+    EXPECT_TRUE(committed);
+    EXPECT_EQ(log.getNumCommits(), 1);
+    database.setLog(nullptr);
+    EXPECT_FALSE(database.startOperation().owns_lock());
+}
+
+TEST(LogTest, TornPageRecovery) {
+    auto &database = db::getDatabase();
+    // a page written for the first time, then a page changed after a checkpoint
+    for (const bool checkpoint: {false, true}) {
+        const std::string name = checkpoint ? "log_torn_checkpoint.db" : "log_torn.db";
+        const std::string log_name = name + ".log";
+        std::remove(name.c_str());
+        std::remove(log_name.c_str());
+        database.setLog(std::make_unique<db::LogManager>(log_name));
+        database.add(std::make_unique<db::HeapFile>(name, td));
+        auto &file = database.get(name);
+        for (int i = 0; i < 20; i++) {
+            file.insertTuple(item(i));
+        }
+        if (checkpoint) {
+            database.getBufferPool().flushFile(name);
+            database.checkpoint();
+            for (int i = 20; i < 40; i++) {
+                file.insertTuple(item(i));
+            }
+        }
+        database.getLog()->commit();
+        const std::vector<int> committed = ids(file);
+
+        // the process stops between the write of the page and the write of its header
+        const std::string header = readBytes(name.c_str(), db::headerOffset(0), db::PAGE_HEADER_SIZE);
+        database.getBufferPool().flushFile(name);
+        writeBytes(name.c_str(), db::headerOffset(0), header);
+        crash(name);
+        {
+            db::DbFile torn(name, td);
+            db::Page page;
+            EXPECT_THROW(torn.readPage(page, 0), std::runtime_error);
+        }
+
+        database.setLog(std::make_unique<db::LogManager>(log_name));
+        database.add(std::make_unique<db::HeapFile>(name, td));
+        EXPECT_EQ(ids(database.get(name)), committed);
+        database.remove(name);
+        database.setLog(nullptr);
+    }
+}
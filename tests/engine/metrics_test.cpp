@@ -0,0 +1,124 @@
+#include <db/Database.hpp>
+#include <db/Metrics.hpp>
+#include <db/PageFormat.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT}, {"id"});
+} // namespace
+
+TEST(MetricsTest, Counter) {
+    db::Counter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; i++) {
+                counter.add();
+            }
+            counter.add(5);
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    EXPECT_EQ(counter.value(), 8 * 10005);
+    counter.reset();
+    EXPECT_EQ(counter.value(), 0);
+}
+
+TEST(MetricsTest, HistogramBuckets) {
+    // the small values are exact, the others are in a bucket at most 1/32 of their size
+    for (uint64_t value = 0; value < 32; value++) {
+        EXPECT_EQ(db::Histogram::bucket(value), value);
+        EXPECT_EQ(db::Histogram::highestValue(value), value);
+    }
+    size_t previous = 31;
+    for (uint64_t value: {uint64_t{32}, uint64_t{33}, uint64_t{63}, uint64_t{64}, uint64_t{1000}, uint64_t{123456789},
+                          ~uint64_t{0}}) {
+        const size_t bucket = db::Histogram::bucket(value);
+        EXPECT_GT(bucket, previous) << value;
+        EXPECT_LT(bucket, db::Histogram::NUM_BUCKETS);
+        const uint64_t highest = db::Histogram::highestValue(bucket);
+        EXPECT_GE(highest, value);
+        EXPECT_LE(highest - value, value / 32);
+        EXPECT_EQ(db::Histogram::bucket(highest), bucket);
+        if (highest != ~uint64_t{0}) {
+            EXPECT_EQ(db::Histogram::bucket(highest + 1), bucket + 1);
+        }
+        previous = bucket;
+    }
+}
+
+TEST(MetricsTest, HistogramPercentiles) {
+    db::Histogram histogram;
+    EXPECT_EQ(histogram.snapshot().percentile(50), 0);
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.record(value * 1000);
+    }
+    const db::HistogramSnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 1000);
+    EXPECT_EQ(snapshot.max, 1000000);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 500500);
+    for (double p: {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        const auto exact = static_cast<double>(p * 10 * 1000);
+        EXPECT_GE(snapshot.percentile(p), exact) << p;
+        EXPECT_LE(snapshot.percentile(p), exact * (1 + 1.0 / 32)) << p;
+    }
+    EXPECT_EQ(snapshot.percentile(100), 1000000);
+    histogram.reset();
+    EXPECT_EQ(histogram.snapshot().count, 0);
+}
+
+TEST(MetricsTest, BufferPool) {
+    const char *name = "metrics_pages.db";
+    std::remove(name);
+    {
+        db::DbFile file(name, td);
+        for (size_t id = 0; id < 8; id++) {
+            file.writePage(db::Page{}, id);
+        }
+    }
+    auto &database = db::getDatabase();
+    auto &pool = database.getBufferPool();
+    pool.resize(4);
+    database.add(std::make_unique<db::DbFile>(name, td));
+    db::Metrics &metrics = database.getMetrics();
+    metrics.reset();
+
+    // the first pages are evicted by the last ones, the last ones are then found in the pool
+    for (size_t id = 0; id < 8; id++) {
+        pool.getPage({name, id});
+        if (id == 0) {
+            pool.markDirty({name, id});
+        }
+    }
+    for (size_t id = 4; id < 8; id++) {
+        pool.getPage({name, id});
+    }
+    db::MetricsSnapshot snapshot = metrics.snapshot();
+    EXPECT_EQ(snapshot.counters["pool_hits"], 4);
+    EXPECT_EQ(snapshot.counters["pool_misses"], 8);
+    EXPECT_EQ(snapshot.counters["pool_evictions"], 4);
+    EXPECT_EQ(snapshot.counters["pool_writebacks"], 1);
+    EXPECT_EQ(snapshot.counters["pages_read"], 8);
+    EXPECT_EQ(snapshot.counters["pages_written"], 1);
+    EXPECT_EQ(snapshot.counters["bytes_read"], 8 * (db::DEFAULT_PAGE_SIZE + db::PAGE_HEADER_SIZE));
+    EXPECT_EQ(snapshot.histograms["read_latency_ns"].count, 8);
+    EXPECT_EQ(snapshot.histograms["write_latency_ns"].count, 1);
+    EXPECT_GT(snapshot.histograms["read_latency_ns"].max, 0);
+
+    std::ostringstream json;
+    snapshot.writeJson(json);
+    EXPECT_NE(json.str().find("\"pool_hits\": 4"), std::string::npos);
+    EXPECT_NE(json.str().find("\"read_latency_ns\": {\"count\": 8"), std::string::npos);
+    std::ostringstream prometheus;
+    snapshot.writePrometheus(prometheus);
+    EXPECT_NE(prometheus.str().find("db_pool_misses 8\n"), std::string::npos);
+    EXPECT_NE(prometheus.str().find("db_write_latency_ns_count 1\n"), std::string::npos);
+
+    database.remove(name);
+    pool.resize(db::DEFAULT_NUM_PAGES);
+    std::remove(name);
+}
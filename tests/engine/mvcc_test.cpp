@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <atomic>
+#include <db/Database.hpp>
+#include <db/SnapshotScan.hpp>
+#include <db/VersionedHeapFile.hpp>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <thread>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int i) { return {{i, "name" + std::to_string(i % 37), i / 2.0}}; }
+
+    db::VersionedHeapFile &createFile(const char *name, int num_tuples, std::chrono::milliseconds gc_interval = {}) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::VersionedHeapFile>(name, td, gc_interval));
+        auto &file = dynamic_cast<db::VersionedHeapFile &>(db::getDatabase().get(name));
+        for (int i = 0; i < num_tuples; i++) {
+            file.insertTuple(item(i));
+        }
+        return file;
+    }
+
+    std::vector<int> ids(db::Operator &op) {
+        std::vector<int> result;
+        op.open();
+        while (op.next()) {
+            EXPECT_EQ(op.getTuple().get_field(2), item(op.getInt(0)).get_field(2));
+            result.push_back(op.getInt(0));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<int> range(int first, int last) {
+        std::vector<int> result(last - first);
+        std::iota(result.begin(), result.end(), first);
+        return result;
+    }
+
+    void deleteIds(db::DbFile &file, int modulo) {
+        for (auto it = file.begin(); it != file.end(); file.next(it)) {
+            if (std::get<int>(file.getTuple(it).get_field(0)) % modulo == 0) {
+                file.deleteTuple(it);
+            }
+        }
+    }
+} // namespace
+
+TEST(MvccTest, SnapshotIsolation) {
+    auto &file = createFile("mvcc_snapshot.db", 1000);
+    auto &clock = db::getDatabase().getVersionClock();
+    {
+        const db::ReadView view(clock);
+        db::SnapshotScan old_scan(file, &view);
+        for (int i = 1000; i < 1500; i++) {
+            file.insertTuple(item(i));
+        }
+        deleteIds(file, 2);
+
+        // the snapshot does not see the changes made after it was opened
+        EXPECT_EQ(ids(old_scan), range(0, 1000));
+        std::vector<int> odd;
+        for (int i = 1; i < 1500; i += 2) {
+            odd.push_back(i);
+        }
+        db::SnapshotScan new_scan(file);
+        EXPECT_EQ(ids(new_scan), odd);
+        EXPECT_EQ(clock.getNumSnapshots(), 1);
+
+        // a scan sharing the view reads the same versions
+        db::SnapshotScan shared_scan(file, &view);
+        shared_scan.getFilter().add({0, db::PredicateOp::LT, 10});
+        EXPECT_EQ(ids(shared_scan), range(0, 10));
+    }
+    EXPECT_EQ(clock.getNumSnapshots(), 0);
+    db::getDatabase().remove("mvcc_snapshot.db");
+}
+
+TEST(MvccTest, GarbageCollection) {
+    auto &file = createFile("mvcc_gc.db", 2000);
+    const size_t pages = file.getNumPages();
+    auto view = std::make_unique<db::ReadView>(db::getDatabase().getVersionClock());
+    deleteIds(file, 2);
+    EXPECT_EQ(file.getNumGarbage(), 1000);
+
+    // the deleted versions are visible in the open snapshot
+    EXPECT_EQ(file.collectGarbage(), 0);
+    db::SnapshotScan scan(file, view.get());
+    EXPECT_EQ(ids(scan), range(0, 2000));
+    view.reset();
+    EXPECT_EQ(file.collectGarbage(), 1000);
+    EXPECT_EQ(file.getNumGarbage(), 0);
+    EXPECT_EQ(file.getNumReclaimed(), 1000);
+
+    // the reclaimed slots are reused
+    for (int i = 2000; i < 3000; i++) {
+        file.insertTuple(item(i));
+    }
+    EXPECT_EQ(file.getNumPages(), pages);
+    db::SnapshotScan new_scan(file);
+    std::vector<int> expected;
+    for (int i = 1; i < 3000; i++) {
+        if (i >= 2000 || i % 2 != 0) {
+            expected.push_back(i);
+        }
+    }
+    EXPECT_EQ(ids(new_scan), expected);
+    db::getDatabase().remove("mvcc_gc.db");
+}
+
+TEST(MvccTest, BackgroundCollector) {
+    auto &file = createFile("mvcc_collector.db", 500, std::chrono::milliseconds(1));
+    deleteIds(file, 5);
+    for (int i = 0; i < 1000 && file.getNumGarbage() > 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(file.getNumGarbage(), 0);
+    EXPECT_EQ(file.getNumReclaimed(), 100);
+    db::getDatabase().remove("mvcc_collector.db");
+}
+
+TEST(MvccTest, ReopenedFile) {
+    const char *name = "mvcc_reopen.db";
+    createFile(name, 1000);
+    deleteIds(db::getDatabase().get(name), 3);
+    db::getDatabase().remove(name);
+
+    // the tuples in the file are visible to every snapshot, the empty slots are reused
+    db::getDatabase().add(std::make_unique<db::VersionedHeapFile>(name, td));
+    auto &file = dynamic_cast<db::VersionedHeapFile &>(db::getDatabase().get(name));
+    const size_t pages = file.getNumPages();
+    std::vector<int> expected;
+    for (int i = 0; i < 1000; i++) {
+        if (i % 3 != 0) {
+            expected.push_back(i);
+        }
+    }
+    db::SnapshotScan scan(file);
+    EXPECT_EQ(ids(scan), expected);
+    for (int i = 0; i < 1000; i += 3) {
+        file.insertTuple(item(i));
+    }
+    EXPECT_EQ(file.getNumPages(), pages);
+    EXPECT_EQ(ids(scan), range(0, 1000));
+    db::getDatabase().remove(name);
+}
+
+TEST(MvccTest, ScanDuringIngest) {
+    constexpr int num_tuples = 20000;
+    auto &file = createFile("mvcc_ingest.db", 0, std::chrono::milliseconds(1));
+
+    // the writer inserts the ids in order, then deletes them in order
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; i < num_tuples; i++) {
+            file.insertTuple(item(i));
+        }
+        for (auto it = file.begin(); it != file.end(); file.next(it)) {
+            file.deleteTuple(it);
+        }
+        done = true;
+    });
+
+    // every snapshot sees a state of the file that existed: a prefix of the ids, or a suffix once they are deleted
+    size_t scans = 0;
+    db::SnapshotScan scan(file);
+    while (!done || scans == 0) {
+        const std::vector<int> seen = ids(scan);
+        if (!seen.empty()) {
+            EXPECT_EQ(seen, range(seen.front(), seen.back() + 1));
+            EXPECT_TRUE(seen.front() == 0 || seen.back() == num_tuples - 1);
+        }
+        scans++;
+    }
+    writer.join();
+    EXPECT_GT(scans, 0);
+    EXPECT_EQ(db::getDatabase().getVersionClock().getNumSnapshots(), 0);
+    db::SnapshotScan last_scan(file);
+    EXPECT_TRUE(ids(last_scan).empty());
+    db::getDatabase().remove("mvcc_ingest.db");
+}
@@ -0,0 +1,149 @@
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/Filter.hpp>
+#include <db/HashFile.hpp>
+#include <db/HeapFile.hpp>
+#include <db/Limit.hpp>
+#include <db/Project.hpp>
+#include <db/SeqScan.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int id) { return {{id, "item" + std::to_string(id % 100), static_cast<double>(id % 1000)}}; }
+
+    template<typename File, typename... Args>
+    File &createFile(const char *name, int num_tuples, Args... args) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<File>(name, td, args...));
+        auto &file = dynamic_cast<File &>(db::getDatabase().get(name));
+        for (int i = 0; i < num_tuples; i++) {
+            file.insertTuple(item(i));
+        }
+        return file;
+    }
+
+    /// An operator that counts the rows pulled from its input
+    class Counter : public db::Operator {
+        std::unique_ptr<db::Operator> child;
+
+    public:
+        size_t pulled = 0;
+
+        explicit Counter(std::unique_ptr<db::Operator> child) : child(std::move(child)) {}
+
+        const db::TupleDesc &getTupleDesc() const override { return child->getTupleDesc(); }
+
+        void open() override { child->open(); }
+
+        bool next() override {
+            pulled++;
+            return child->next();
+        }
+
+        const uint8_t *row() const override { return child->row(); }
+    };
+
+    std::vector<db::Tuple> collect(db::Operator &op) {
+        std::vector<db::Tuple> result;
+        op.open();
+        while (op.next()) {
+            result.push_back(op.getTuple());
+        }
+        return result;
+    }
+} // namespace
+
+TEST(OperatorTest, SeqScan) {
+    auto &heap = createFile<db::HeapFile>("operator_heap.db", 3000);
+    // leave holes in the pages
+    for (auto it = heap.begin(); it != heap.end(); heap.next(it)) {
+        if (std::get<int>(heap.getTuple(it).get_field(0)) % 7 == 0) {
+            heap.deleteTuple(it);
+        }
+    }
+    auto &btree = createFile<db::BTreeFile>("operator_btree.db", 3000, size_t{0});
+    auto &char_btree = createFile<db::BTreeFile>("operator_char_btree.db", 3000, std::vector<size_t>{1, 0});
+    auto &hash = createFile<db::HashFile>("operator_hash.db", 3000, size_t{0});
+    for (const db::DbFile *file: std::vector<const db::DbFile *>{&heap, &btree, &char_btree, &hash}) {
+        std::vector<db::Tuple> expected;
+        for (auto it = file->begin(); it != file->end(); file->next(it)) {
+            expected.push_back(file->getTuple(it));
+        }
+        db::SeqScan scan(*file);
+        EXPECT_FALSE(scan.next());
+        auto rows = collect(scan);
+        ASSERT_EQ(rows.size(), expected.size());
+        for (size_t i = 0; i < rows.size(); i++) {
+            EXPECT_EQ(rows[i].get_field(0), expected[i].get_field(0));
+            EXPECT_EQ(rows[i].get_field(1), expected[i].get_field(1));
+            EXPECT_EQ(rows[i].get_field(2), expected[i].get_field(2));
+        }
+        // the scan can be restarted
+        EXPECT_EQ(collect(scan).size(), expected.size());
+    }
+}
+
+TEST(OperatorTest, Pipeline) {
+    auto &file = createFile<db::BTreeFile>("operator_pipeline.db", 5000, size_t{0});
+    // SELECT price, id FROM file WHERE id >= 1000 AND price < 500.0 LIMIT 10 OFFSET 2
+    auto scan = std::make_unique<db::SeqScan>(file);
+    auto project = std::make_unique<db::Project>(std::move(scan), std::vector<size_t>{2, 0});
+    auto filter = std::make_unique<db::Filter>(
+            std::move(project), std::vector<db::Predicate>{{1, db::PredicateOp::GE, 1000}, {0, db::PredicateOp::LT, 500.0}});
+    // predicates refer to the fields of the projected rows
+    EXPECT_THROW(filter->pushDown({2, db::PredicateOp::EQ, 0}), std::logic_error);
+    EXPECT_THROW(filter->pushDown({0, db::PredicateOp::EQ, 0}), std::logic_error);
+    db::Limit limit(std::move(filter), 10, 2);
+    EXPECT_EQ(limit.getTupleDesc().field_name(0), "price");
+    EXPECT_EQ(limit.getTupleDesc().field_name(1), "id");
+    EXPECT_FALSE(limit.pushDown({1, db::PredicateOp::EQ, 0}));
+
+    std::vector<int> expected;
+    for (int id = 1000; id < 5000; id++) {
+        if (id % 1000 < 500) {
+            expected.push_back(id);
+        }
+    }
+    expected = {expected.begin() + 2, expected.begin() + 12};
+    limit.open();
+    std::vector<int> ids;
+    while (limit.next()) {
+        ids.push_back(limit.getInt(1));
+        EXPECT_EQ(limit.getDouble(0), ids.back() % 1000);
+    }
+    EXPECT_EQ(ids, expected);
+}
+
+TEST(OperatorTest, LimitZero) {
+    auto &file = createFile<db::HeapFile>("operator_limit.db", 100);
+    auto counter = std::make_unique<Counter>(std::make_unique<db::SeqScan>(file));
+    Counter &input = *counter;
+    db::Limit limit(std::move(counter), 0, 10);
+    EXPECT_TRUE(collect(limit).empty());
+    EXPECT_EQ(input.pulled, 0);
+
+    auto counted = std::make_unique<Counter>(std::make_unique<db::SeqScan>(file));
+    Counter &counted_input = *counted;
+    db::Limit limit3(std::move(counted), 3, 10);
+    EXPECT_EQ(collect(limit3).size(), 3);
+    EXPECT_EQ(counted_input.pulled, 13);
+}
+
+TEST(OperatorTest, StringPredicate) {
+    auto &file = createFile<db::HeapFile>("operator_strings.db", 1000);
+    db::Filter filter(std::make_unique<db::SeqScan>(file), {{1, db::PredicateOp::EQ, std::string("item42")}});
+    filter.open();
+    int count = 0;
+    while (filter.next()) {
+        EXPECT_EQ(filter.getString(1), "item42");
+        EXPECT_EQ(filter.getInt(0) % 100, 42);
+        count++;
+    }
+    EXPECT_EQ(count, 10);
+
+    db::Filter range(std::make_unique<db::SeqScan>(file), {{1, db::PredicateOp::LT, std::string("item2")}});
+    // item0, item1, item10 ... item19
+    EXPECT_EQ(collect(range).size(), 12 * 10);
+}
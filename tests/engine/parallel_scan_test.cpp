@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <db/Database.hpp>
+#include <db/Filter.hpp>
+#include <db/Gather.hpp>
+#include <db/HashAggregate.hpp>
+#include <db/HeapFile.hpp>
+#include <db/MorselQueue.hpp>
+#include <db/MorselScan.hpp>
+#include <db/Project.hpp>
+#include <db/SeqScan.hpp>
+#include <gtest/gtest.h>
+#include <map>
+#include <numeric>
+#include <thread>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    /// Items [0, count), with the even ids below 1000 deleted
+    db::HeapFile &createFile(const char *name, int count) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+        auto &file = dynamic_cast<db::HeapFile &>(db::getDatabase().get(name));
+        for (int i = 0; i < count; i++) {
+            file.insertTuple({{i, "name" + std::to_string(i % 13), static_cast<double>(i % 10)}});
+        }
+        for (auto it = file.begin(); it != file.end(); file.next(it)) {
+            const int id = std::get<int>(file.getTuple(it).get_field(0));
+            if (id < 1000 && id % 2 == 0) {
+                file.deleteTuple(it);
+            }
+        }
+        return file;
+    }
+
+    std::vector<int> ids(db::Operator &op) {
+        std::vector<int> result;
+        op.open();
+        while (op.next()) {
+            result.push_back(op.getInt(0));
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    class FailingScan : public db::Operator {
+        int rows = 0;
+
+    public:
+        const db::TupleDesc &getTupleDesc() const override { return td; }
+
+        void open() override { rows = 0; }
+
+        bool next() override {
+            if (++rows > 5000) {
+                throw std::runtime_error("read error");
+            }
+            return true;
+        }
+
+        const uint8_t *row() const override {
+            static std::vector<uint8_t> data(td.length());
+            return data.data();
+        }
+    };
+} // namespace
+
+TEST(ParallelScanTest, MorselQueue) {
+    db::MorselQueue queue(4, 7);
+    EXPECT_THROW(db::MorselQueue(0, 7), std::logic_error);
+    EXPECT_THROW(db::MorselQueue(4, 0), std::logic_error);
+
+    // a single worker takes its own range in order, then steals the rest
+    queue.start(1, 1000);
+    std::vector<int> taken(1000);
+    size_t expected_first = 0;
+    while (auto morsel = queue.take(0)) {
+        auto [first, last] = *morsel;
+        ASSERT_LT(first, last);
+        ASSERT_LE(last - first, 7);
+        if (first < 250) {
+            EXPECT_EQ(first, expected_first);
+            expected_first = last;
+        }
+        for (size_t page = first; page < last; page++) {
+            taken[page]++;
+        }
+    }
+    EXPECT_TRUE(std::all_of(taken.begin(), taken.end(), [](int n) { return n == 1; }));
+    EXPECT_GT(queue.numSteals(), 0);
+
+    // a start of the same scan does not refill the queue
+    queue.start(1, 1000);
+    EXPECT_FALSE(queue.take(2).has_value());
+
+    // every page is taken once by the threads
+    queue.start(2, 10007);
+    std::vector<std::vector<std::pair<size_t, size_t>>> morsels(4);
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < 4; w++) {
+        threads.emplace_back([&, w] {
+            while (auto morsel = queue.take(w)) {
+                morsels[w].push_back(*morsel);
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    std::vector<int> pages(10007);
+    for (const auto &worker: morsels) {
+        for (auto [first, last]: worker) {
+            for (size_t page = first; page < last; page++) {
+                pages[page]++;
+            }
+        }
+    }
+    EXPECT_TRUE(std::all_of(pages.begin(), pages.end(), [](int n) { return n == 1; }));
+}
+
+TEST(ParallelScanTest, Gather) {
+    constexpr int count = 20000;
+    auto &file = createFile("parallel_scan_gather.db", count);
+    std::vector<int> expected;
+    for (int i = 0; i < count; i++) {
+        if (i >= 1000 || i % 2 != 0) {
+            expected.push_back(i);
+        }
+    }
+
+    db::Gather gather(db::MorselScan::create(file, 4, 3));
+    EXPECT_EQ(ids(gather), expected);
+    // the scan can be restarted, also before the rows are consumed
+    gather.open();
+    EXPECT_EQ(ids(gather), expected);
+
+    // the filters run in the threads of the workers
+    std::vector<std::unique_ptr<db::Operator>> pipelines;
+    for (auto &scan: db::MorselScan::create(file, 3, 2)) {
+        pipelines.push_back(std::make_unique<db::Filter>(
+                std::move(scan), std::vector<db::Predicate>{{0, db::PredicateOp::LT, 5000}}));
+    }
+    db::Gather filtered(std::move(pipelines), 2);
+    EXPECT_TRUE(filtered.pushDown({1, db::PredicateOp::EQ, std::string("name3")}));
+    std::vector<int> expected_filtered;
+    std::copy_if(expected.begin(), expected.end(), std::back_inserter(expected_filtered),
+                 [](int i) { return i < 5000 && i % 13 == 3; });
+    EXPECT_EQ(ids(filtered), expected_filtered);
+
+    std::vector<std::unique_ptr<db::Operator>> failing;
+    failing.push_back(std::make_unique<FailingScan>());
+    failing.push_back(std::make_unique<db::SeqScan>(file));
+    db::Gather gather_failing(std::move(failing));
+    EXPECT_THROW(ids(gather_failing), std::runtime_error);
+
+    std::vector<std::unique_ptr<db::Operator>> different;
+    different.push_back(std::make_unique<db::SeqScan>(file));
+    different.push_back(std::make_unique<db::Project>(std::make_unique<db::SeqScan>(file), std::vector<size_t>{0}));
+    EXPECT_THROW(db::Gather(std::move(different)), std::logic_error);
+    EXPECT_THROW(db::Gather({}), std::logic_error);
+}
+
+TEST(ParallelScanTest, Aggregate) {
+    auto &file = createFile("parallel_scan_aggregate.db", 30000);
+    const std::vector<db::Aggregate> aggregates = {{db::AggregateOp::COUNT, 0}, {db::AggregateOp::SUM, 2}};
+    db::HashAggregate serial(std::make_unique<db::SeqScan>(file), {1}, aggregates);
+    db::HashAggregate parallel(db::MorselScan::create(file, 4, 1), {1}, aggregates);
+    auto groups = [](db::Operator &op) {
+        std::map<std::string, std::pair<int, double>> result;
+        op.open();
+        while (op.next()) {
+            result[std::string(op.getString(0))] = {op.getInt(1), op.getDouble(2)};
+        }
+        return result;
+    };
+    const auto expected = groups(serial);
+    EXPECT_EQ(expected.size(), 13);
+    EXPECT_EQ(groups(parallel), expected);
+    EXPECT_EQ(groups(parallel), expected);
+}
+
+TEST(ParallelScanTest, ConcurrentInsert) {
+    const char *name = "parallel_insert.db";
+    const char *serial_name = "parallel_insert_serial.db";
+    constexpr int num_threads = 8;
+    constexpr int count = 16000;
+    std::remove(name);
+    // a small pool: the pages are evicted while other threads insert into them
+    db::BufferPool &pool = db::getDatabase().getBufferPool();
+    pool.resize(16);
+    db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = db::getDatabase().get(name);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&file, t] {
+            for (int i = t; i < count; i += num_threads) {
+                file.insertTuple({{i, "name" + std::to_string(i % 13), static_cast<double>(i % 10)}});
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    db::SeqScan scan(file);
+    std::vector<int> expected(count);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_EQ(ids(scan), expected);
+    // every page but the last one is full, as if the tuples were inserted by a single thread
+    std::remove(serial_name);
+    db::getDatabase().add(std::make_unique<db::HeapFile>(serial_name, td));
+    auto &serial = db::getDatabase().get(serial_name);
+    for (int i = 0; i < count; i++) {
+        serial.insertTuple({{i, "name", 0.0}});
+    }
+    EXPECT_EQ(file.getNumPages(), serial.getNumPages());
+    pool.resize(db::DEFAULT_NUM_PAGES);
+}
@@ -0,0 +1,175 @@
+#include <cmath>
+#include <cstring>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/ScanFilter.hpp>
+#include <db/ScanKernels.hpp>
+#include <db/SeqScan.hpp>
+#include <functional>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    const std::vector<int> ints = {0, 1, -1, 7, 42, 100, std::numeric_limits<int>::min(),
+                                   std::numeric_limits<int>::max()};
+    const std::vector<double> doubles = {0.0, -0.0, 1.5, -1.5, 42.0, std::numeric_limits<double>::infinity(),
+                                         -std::numeric_limits<double>::infinity(), std::nan("")};
+    const std::vector<std::string> strings = {"", "a", "ab", "abc", "b", std::string(63, 'x'), std::string(64, 'x')};
+
+    /// Rows with every combination of interesting values
+    std::vector<uint8_t> makeRows(size_t count) {
+        std::vector<uint8_t> rows(count * td.length());
+        std::mt19937 gen(7);
+        for (size_t i = 0; i < count; i++) {
+            td.serialize(rows.data() + i * td.length(),
+                         {{ints[gen() % ints.size()], strings[gen() % strings.size()], doubles[gen() % doubles.size()]}});
+        }
+        return rows;
+    }
+
+    std::vector<db::SimdLevel> levels() {
+        std::vector<db::SimdLevel> result;
+        for (auto level: {db::SimdLevel::SCALAR, db::SimdLevel::AVX2, db::SimdLevel::AVX512}) {
+            if (db::simdSupported(level)) {
+                result.push_back(level);
+            }
+        }
+        return result;
+    }
+
+    int idOf(const uint8_t *row) {
+        int v;
+        memcpy(&v, row + td.offset_of(0), sizeof(v));
+        return v;
+    }
+
+    double priceOf(const uint8_t *row) {
+        double v;
+        memcpy(&v, row + td.offset_of(2), sizeof(v));
+        return v;
+    }
+
+    std::string_view nameOf(const uint8_t *row) {
+        const char *chars = reinterpret_cast<const char *>(row + td.offset_of(1));
+        return {chars, strnlen(chars, db::CHAR_SIZE)};
+    }
+
+    /// Check the bitmap of a filter against the evaluation of the filter on every row
+    void expectFilter(const db::ScanFilter &filter, const std::vector<uint8_t> &rows, size_t count,
+                      const std::function<bool(const uint8_t *)> &expected) {
+        std::vector<uint64_t> bitmap((count + 63) / 64, ~uint64_t{0});
+        filter.apply(rows.data(), count, bitmap.data());
+        for (size_t i = 0; i < count; i++) {
+            const uint8_t *row = rows.data() + i * td.length();
+            const bool bit = bitmap[i / 64] >> (i % 64) & 1;
+            ASSERT_EQ(bit, expected(row)) << "row " << i;
+            ASSERT_EQ(filter.test(row), bit) << "row " << i;
+        }
+        if (count % 64 != 0) {
+            EXPECT_EQ(bitmap.back() >> (count % 64), 0);
+        }
+    }
+} // namespace
+
+TEST(ScanKernelTest, Comparisons) {
+    constexpr size_t count = 1003;
+    const auto rows = makeRows(count);
+    const db::SimdLevel initial = db::getSimdLevel();
+    for (db::SimdLevel level: levels()) {
+        db::setSimdLevel(level);
+        for (auto op: {db::PredicateOp::EQ, db::PredicateOp::NE, db::PredicateOp::LT, db::PredicateOp::LE,
+                       db::PredicateOp::GT, db::PredicateOp::GE}) {
+            for (int v: ints) {
+                db::ScanFilter filter(td);
+                db::Predicate predicate{0, op, v};
+                filter.add(predicate);
+                expectFilter(filter, rows, count, [&](const uint8_t *row) { return predicate.test(td, row); });
+            }
+            for (double v: doubles) {
+                db::ScanFilter filter(td);
+                db::Predicate predicate{2, op, v};
+                filter.add(predicate);
+                expectFilter(filter, rows, count, [&](const uint8_t *row) { return predicate.test(td, row); });
+            }
+            for (const auto &v: strings) {
+                db::ScanFilter filter(td);
+                db::Predicate predicate{1, op, v};
+                filter.add(predicate);
+                expectFilter(filter, rows, count, [&](const uint8_t *row) { return predicate.test(td, row); });
+            }
+        }
+    }
+    db::setSimdLevel(initial);
+}
+
+TEST(ScanKernelTest, BetweenInPrefix) {
+    constexpr size_t count = 777;
+    const auto rows = makeRows(count);
+    const db::SimdLevel initial = db::getSimdLevel();
+    for (db::SimdLevel level: levels()) {
+        db::setSimdLevel(level);
+        db::ScanFilter filter(td);
+        filter.addBetween(0, -1, 42);
+        filter.addIn(2, {1.5, -0.0, std::nan("")});
+        expectFilter(filter, rows, count, [](const uint8_t *row) {
+            int id = idOf(row);
+            double price = priceOf(row);
+            return id >= -1 && id <= 42 && (price == 1.5 || price == 0.0);
+        });
+
+        db::ScanFilter prefix(td);
+        prefix.addPrefix(1, "a");
+        prefix.addIn(0, {7, 100, std::numeric_limits<int>::min()});
+        expectFilter(prefix, rows, count, [](const uint8_t *row) {
+            int id = idOf(row);
+            return nameOf(row).starts_with("a") &&
+                   (id == 7 || id == 100 || id == std::numeric_limits<int>::min());
+        });
+
+        db::ScanFilter empty_between(td);
+        empty_between.addBetween(2, 2.0, 1.0);
+        expectFilter(empty_between, rows, count, [](const uint8_t *) { return false; });
+
+        db::ScanFilter everything(td);
+        everything.addPrefix(1, "");
+        expectFilter(everything, rows, count, [](const uint8_t *) { return true; });
+    }
+    db::setSimdLevel(initial);
+
+    db::ScanFilter filter(td);
+    EXPECT_THROW(filter.addBetween(1, std::string("a"), std::string("b")), std::logic_error);
+    EXPECT_THROW(filter.addIn(0, {1.0}), std::logic_error);
+    EXPECT_THROW(filter.addPrefix(0, "a"), std::logic_error);
+}
+
+TEST(ScanKernelTest, HeapScan) {
+    const char *name = "scan_kernel_heap.db";
+    std::remove(name);
+    db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+    auto &file = db::getDatabase().get(name);
+    for (int i = 0; i < 3000; i++) {
+        file.insertTuple({{i, "name" + std::to_string(i % 10), static_cast<double>(i % 100)}});
+    }
+    // the deleted tuples are still in the data region of the pages, the occupancy bitmap excludes them
+    for (auto it = file.begin(); it != file.end(); file.next(it)) {
+        if (std::get<int>(file.getTuple(it).get_field(0)) % 2 == 0) {
+            file.deleteTuple(it);
+        }
+    }
+    db::SeqScan scan(file);
+    scan.getFilter().addBetween(0, 1000, 1999);
+    scan.getFilter().addPrefix(1, "name3");
+    scan.open();
+    std::vector<int> ids;
+    while (scan.next()) {
+        ids.push_back(scan.getInt(0));
+    }
+    std::vector<int> expected;
+    for (int i = 1003; i < 2000; i += 10) {
+        expected.push_back(i);
+    }
+    EXPECT_EQ(ids, expected);
+}
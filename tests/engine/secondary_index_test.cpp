@@ -0,0 +1,129 @@
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/PageFormat.hpp>
+#include <db/SecondaryIndex.hpp>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <map>
+#include <set>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "city", "age"});
+
+    db::HeapFile &createTable(const char *name) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+        return dynamic_cast<db::HeapFile &>(db::getDatabase().get(name));
+    }
+
+    db::SecondaryIndex &createIndex(const char *name, const char *table, size_t field) {
+        std::remove(name);
+        db::getDatabase().addIndex(std::make_unique<db::SecondaryIndex>(name, table, td, field));
+        return dynamic_cast<db::SecondaryIndex &>(db::getDatabase().get(name));
+    }
+
+    db::Tuple person(int id) { return {{id, "city" + std::to_string(id % 17), static_cast<double>(id % 50)}}; }
+
+    std::set<int> ids(const db::HeapFile &table, const std::vector<db::Iterator> &its) {
+        std::set<int> result;
+        for (const auto &it: its) {
+            result.insert(std::get<int>(table.getTuple(it).get_field(0)));
+        }
+        return result;
+    }
+} // namespace
+
+TEST(SecondaryIndexTest, Maintenance) {
+    auto &table = createTable("index_people.db");
+    constexpr int num_tuples = 6000;
+    for (int i = 0; i < num_tuples / 2; i++) {
+        table.insertTuple(person(i));
+    }
+    // the index is filled with the tuples already in the table
+    auto &by_city = createIndex("index_people_city.db", "index_people.db", 1);
+    for (int i = num_tuples / 2; i < num_tuples; i++) {
+        table.insertTuple(person(i));
+    }
+    auto &by_age = createIndex("index_people_age.db", "index_people.db", 2);
+    EXPECT_EQ(table.getIndexes().size(), 2);
+
+    std::map<std::string, std::set<int>> expected;
+    for (int i = 0; i < num_tuples; i++) {
+        expected[std::get<std::string>(person(i).get_field(1))].insert(i);
+    }
+    for (const auto &[city, city_ids]: expected) {
+        auto its = by_city.find(city);
+        EXPECT_TRUE(std::is_sorted(its.begin(), its.end(), [](const auto &a, const auto &b) {
+            return a.page < b.page || (a.page == b.page && a.slot < b.slot);
+        }));
+        EXPECT_EQ(ids(table, its), city_ids);
+    }
+    EXPECT_TRUE(by_city.find("nowhere").empty());
+
+    // delete every third tuple
+    std::set<int> deleted;
+    for (auto it = table.begin(); it != table.end(); table.next(it)) {
+        int id = std::get<int>(table.getTuple(it).get_field(0));
+        if (id % 3 == 0) {
+            table.deleteTuple(it);
+            deleted.insert(id);
+        }
+    }
+    for (auto &[city, city_ids]: expected) {
+        std::erase_if(city_ids, [&](int id) { return deleted.contains(id); });
+        EXPECT_EQ(ids(table, by_city.find(city)), city_ids);
+    }
+
+    std::set<int> middle_aged;
+    for (int i = 0; i < num_tuples; i++) {
+        if (i % 50 >= 20 && i % 50 <= 30 && !deleted.contains(i)) {
+            middle_aged.insert(i);
+        }
+    }
+    auto its = by_age.findRange(20.0, 30.0);
+    EXPECT_EQ(its.size(), middle_aged.size());
+    EXPECT_EQ(ids(table, its), middle_aged);
+
+    // a removed index is no longer maintained
+    auto removed = db::getDatabase().remove("index_people_age.db");
+    EXPECT_EQ(table.getIndexes().size(), 1);
+    table.insertTuple(person(num_tuples));
+    EXPECT_EQ(ids(table, by_city.find(std::get<std::string>(person(num_tuples).get_field(1)))).count(num_tuples), 1);
+}
+
+TEST(SecondaryIndexTest, InvalidTable) {
+    EXPECT_THROW(db::getDatabase().addIndex(std::make_unique<db::SecondaryIndex>("index_missing.db", "missing.db", td, 0)),
+                 std::logic_error);
+}
+
+TEST(SecondaryIndexTest, FailedFill) {
+    const char *catalog_name = "index_failed_catalog.db";
+    const char *table_name = "index_failed.db";
+    const char *index_name = "index_failed_city.db";
+    std::remove(catalog_name);
+    std::remove(index_name);
+    db::Database &database = db::getDatabase();
+    database.openCatalog(catalog_name);
+    db::HeapFile &table = createTable(table_name);
+    for (int i = 0; i < 500; i++) {
+        table.insertTuple(person(i));
+    }
+    database.remove(table_name);
+    {
+        // a page of the table is corrupted after the entries of the first page are inserted
+        std::fstream file(table_name, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(db::pageOffset(1) + 100));
+        file.put('x');
+    }
+    database.add(std::make_unique<db::HeapFile>(table_name, td));
+    auto &reopened = dynamic_cast<db::HeapFile &>(database.get(table_name));
+    EXPECT_THROW(database.addIndex(std::make_unique<db::SecondaryIndex>(index_name, table_name, td, 1)),
+                 std::runtime_error);
+    // the index is neither open nor in the catalog
+    EXPECT_TRUE(reopened.getIndexes().empty());
+    EXPECT_FALSE(database.getCatalog()->find(index_name).has_value());
+    EXPECT_TRUE(database.getCatalog()->find(table_name)->indexes.empty());
+    EXPECT_ANY_THROW(database.get(index_name));
+    database.remove(table_name);
+    database.closeCatalog();
+}
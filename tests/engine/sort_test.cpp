@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/ExternalSort.hpp>
+#include <db/HeapFile.hpp>
+#include <db/KeyLeafPage.hpp>
+#include <db/LeafPage.hpp>
+#include <db/SeqScan.hpp>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE, db::type_t::INT},
+                           {"id", "name", "price", "seq"});
+
+    /// Items with repeated ids, names and prices, in a random order; the seq field is the position in the input
+    std::vector<db::Tuple> items(int count) {
+        std::mt19937 gen(11);
+        std::vector<db::Tuple> result;
+        for (int i = 0; i < count; i++) {
+            const int id = static_cast<int>(gen() % 1000) - 500;
+            const std::string name = std::string(gen() % 3, 'a') + std::to_string(gen() % 50);
+            const double price = (static_cast<int>(gen() % 200) - 100) / 8.0;
+            result.push_back({{id, name, price, i}});
+        }
+        return result;
+    }
+
+    /// The leaves of a tree in key order, as written to its file
+    std::vector<db::Page> leaves(const db::BTreeFile &tree) {
+        db::getDatabase().getBufferPool().flushFile(tree.getName());
+        std::vector<db::Page> pages;
+        size_t last = 0;
+        for (auto it = tree.begin(); it != tree.end(); tree.next(it)) {
+            if (pages.empty() || it.page != last) {
+                last = it.page;
+                tree.readPage(pages.emplace_back(), last);
+            }
+        }
+        return pages;
+    }
+
+    db::DbFile &createHeap(const char *name, const std::vector<db::Tuple> &tuples) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+        auto &file = db::getDatabase().get(name);
+        for (const auto &t: tuples) {
+            file.insertTuple(t);
+        }
+        return file;
+    }
+
+    std::vector<db::field_t> fields(const db::Tuple &t) {
+        std::vector<db::field_t> result;
+        for (size_t i = 0; i < t.size(); i++) {
+            result.push_back(t.get_field(i));
+        }
+        return result;
+    }
+
+    /// The tuples sorted with std::stable_sort
+    std::vector<std::vector<db::field_t>> expectedOrder(const std::vector<db::Tuple> &tuples,
+                                                        const std::vector<db::SortField> &sort_fields) {
+        std::vector<std::vector<db::field_t>> result;
+        for (const auto &t: tuples) {
+            result.push_back(fields(t));
+        }
+        std::stable_sort(result.begin(), result.end(), [&](const auto &a, const auto &b) {
+            for (const auto &[field, descending]: sort_fields) {
+                if (a[field] != b[field]) {
+                    return descending ? b[field] < a[field] : a[field] < b[field];
+                }
+            }
+            return false;
+        });
+        return result;
+    }
+
+    std::vector<std::vector<db::field_t>> collect(db::Operator &op) {
+        std::vector<std::vector<db::field_t>> result;
+        op.open();
+        while (op.next()) {
+            result.push_back(fields(op.getTuple()));
+        }
+        return result;
+    }
+
+    size_t tempFiles() {
+        size_t count = 0;
+        for (const auto &entry: std::filesystem::directory_iterator(".")) {
+            const std::string name = entry.path().filename().string();
+            count += name.starts_with("sort_") && name.ends_with(".tmp");
+        }
+        return count;
+    }
+} // namespace
+
+TEST(SortTest, InMemory) {
+    const auto tuples = items(3000);
+    auto &file = createHeap("sort_memory.db", tuples);
+    const std::vector<db::SortField> sort_fields = {{1}, {2, true}};
+    db::ExternalSort sort(std::make_unique<db::SeqScan>(file), sort_fields, 1 << 24);
+    EXPECT_EQ(collect(sort), expectedOrder(tuples, sort_fields));
+    EXPECT_EQ(sort.numRuns(), 0);
+    EXPECT_EQ(tempFiles(), 0);
+
+    // the sort can be opened again
+    EXPECT_EQ(collect(sort), expectedOrder(tuples, sort_fields));
+
+    db::ExternalSort filtered(std::make_unique<db::SeqScan>(file), {{0, true}}, 1 << 24);
+    EXPECT_TRUE(filtered.pushDown({0, db::PredicateOp::LT, 0}));
+    std::vector<db::Tuple> negative;
+    std::copy_if(tuples.begin(), tuples.end(), std::back_inserter(negative),
+                 [](const db::Tuple &t) { return std::get<int>(t.get_field(0)) < 0; });
+    EXPECT_EQ(collect(filtered), expectedOrder(negative, {{0, true}}));
+
+    EXPECT_THROW(db::ExternalSort(std::make_unique<db::SeqScan>(file), {}), std::logic_error);
+    EXPECT_THROW(db::ExternalSort(std::make_unique<db::SeqScan>(file), {{4}}), std::logic_error);
+}
+
+TEST(SortTest, Spill) {
+    const auto tuples = items(20000);
+    auto &file = createHeap("sort_spill.db", tuples);
+    for (const std::vector<db::SortField> &sort_fields: std::vector<std::vector<db::SortField>>{
+            {{0}}, {{2, true}, {1}}, {{1, true}, {0, true}}}) {
+        // runs of about 1000 rows, merged directly
+        db::ExternalSort sort(std::make_unique<db::SeqScan>(file), sort_fields, 1 << 17, 1);
+        EXPECT_EQ(collect(sort), expectedOrder(tuples, sort_fields));
+        EXPECT_GT(sort.numRuns(), 10);
+    }
+    {
+        // a fan in of 2 needs several merge passes
+        db::ExternalSort sort(std::make_unique<db::SeqScan>(file), {{0}, {1}}, 3 * db::DEFAULT_PAGE_SIZE, 1);
+        sort.open();
+        EXPECT_GT(sort.numRuns(), 100);
+        EXPECT_GT(tempFiles(), 0);
+        EXPECT_EQ(collect(sort), expectedOrder(tuples, {{0}, {1}}));
+    }
+    EXPECT_EQ(tempFiles(), 0);
+
+    const auto empty = createHeap("sort_empty.db", {}).getName();
+    db::ExternalSort sort(std::make_unique<db::SeqScan>(db::getDatabase().get(empty)), {{0}}, 1);
+    EXPECT_TRUE(collect(sort).empty());
+}
+
+TEST(SortTest, BulkLoad) {
+    constexpr int count = 20000;
+    std::vector<int> ids(count);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(5));
+    std::vector<db::Tuple> tuples;
+    for (int id: ids) {
+        tuples.push_back({{id, "name" + std::to_string(id % 97), id / 2.0, id % 7}});
+    }
+    auto &heap = createHeap("sort_bulk_heap.db", tuples);
+
+    const char *name = "sort_bulk_int.db";
+    std::remove(name);
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(name, td, 0));
+    auto &tree = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(name));
+    db::ExternalSort sort(std::make_unique<db::SeqScan>(heap), {{0}}, 1 << 18);
+    tree.bulkLoad(sort);
+    EXPECT_GT(sort.numRuns(), 1);
+    int expected = 0;
+    for (auto it = tree.begin(); it != tree.end(); tree.next(it)) {
+        ASSERT_EQ(std::get<int>(tree.getTuple(it).get_field(0)), expected++);
+    }
+    EXPECT_EQ(expected, count);
+    for (int id: {0, 1, 4999, count - 1}) {
+        auto t = tree.lookup(id);
+        ASSERT_TRUE(t.has_value());
+        EXPECT_EQ(std::get<double>(t->get_field(2)), id / 2.0);
+    }
+    EXPECT_FALSE(tree.lookup(count).has_value());
+
+    // the leaves are 90% full, the last one holds the rest
+    auto pages = leaves(tree);
+    for (size_t i = 0; i + 1 < pages.size(); i++) {
+        const db::LeafPage leaf(pages[i], td, 0);
+        EXPECT_GE(leaf.header->size, leaf.capacity * 0.9);
+        EXPECT_LT(leaf.header->size, leaf.capacity - 1);
+    }
+
+    // the tree is modified as any other
+    for (int id = 0; id < count; id += 3) {
+        EXPECT_TRUE(tree.deleteKey(id));
+    }
+    for (int id = count; id < count + 1000; id++) {
+        tree.insertTuple({{id, "new", 0.0, 0}});
+    }
+    std::vector<int> keys;
+    for (auto it = tree.begin(); it != tree.end(); tree.next(it)) {
+        keys.push_back(std::get<int>(tree.getTuple(it).get_field(0)));
+    }
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    EXPECT_EQ(keys.size(), count - (count + 2) / 3 + 1000);
+
+    EXPECT_THROW(tree.bulkLoad(sort), std::logic_error);
+
+    // a composite key on (name, id), with several levels of index pages
+    const char *composite_name = "sort_bulk_composite.db";
+    std::remove(composite_name);
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(composite_name, td, std::vector<size_t>{1, 0}));
+    auto &composite = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(composite_name));
+    db::ExternalSort composite_sort(std::make_unique<db::SeqScan>(heap), {{1}, {0}});
+    composite.bulkLoad(composite_sort);
+    EXPECT_EQ(collect(composite_sort).size(), count);
+    std::vector<std::vector<db::field_t>> rows;
+    for (auto it = composite.begin(); it != composite.end(); composite.next(it)) {
+        rows.push_back(fields(composite.getTuple(it)));
+    }
+    EXPECT_EQ(rows, expectedOrder(tuples, {{1}, {0}}));
+    // the leaves are bounded by the separators of their parents, which they share with their neighbors
+    const db::KeyDesc kd(td, {1, 0});
+    pages = leaves(composite);
+    ASSERT_GT(pages.size(), 2);
+    for (size_t i = 0; i < pages.size(); i++) {
+        const db::KeyLeafPage leaf(pages[i], kd);
+        EXPECT_EQ(leaf.lowFence().empty(), i == 0);
+        EXPECT_EQ(leaf.highFence().empty(), i + 1 == pages.size());
+        if (i + 1 < pages.size()) {
+            EXPECT_EQ(leaf.highFence(), db::KeyLeafPage(pages[i + 1], kd).lowFence());
+            EXPECT_TRUE(leaf.filledTo(0.9));
+            EXPECT_FALSE(leaf.filledTo(0.95));
+        }
+        if (i > 0 && i + 1 < pages.size()) {
+            EXPECT_GT(leaf.header->prefix, 0);
+        }
+    }
+    auto t = composite.lookup(std::vector<db::field_t>{std::string("name5"), 5});
+    ASSERT_TRUE(t.has_value());
+    EXPECT_EQ(std::get<double>(t->get_field(2)), 2.5);
+    composite.insertTuple({{count, "name5", 0.0, 0}});
+    EXPECT_TRUE(composite.lookup(std::vector<db::field_t>{std::string("name5"), count}).has_value());
+
+    // the input must be sorted on the key
+    const char *unsorted_name = "sort_bulk_unsorted.db";
+    std::remove(unsorted_name);
+    db::getDatabase().add(std::make_unique<db::BTreeFile>(unsorted_name, td, 0));
+    auto &unsorted = dynamic_cast<db::BTreeFile &>(db::getDatabase().get(unsorted_name));
+    db::SeqScan scan(heap);
+    EXPECT_THROW(unsorted.bulkLoad(scan), std::runtime_error);
+}
@@ -0,0 +1,202 @@
+#include <db/AccessPath.hpp>
+#include <db/BTreeFile.hpp>
+#include <db/Catalog.hpp>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/HyperLogLog.hpp>
+#include <db/SecondaryIndex.hpp>
+#include <db/SeqScan.hpp>
+#include <gtest/gtest.h>
+#include <set>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "city", "age"});
+
+    constexpr int num_tuples = 20000;
+
+    /// Unique ids, 100 cities of which city0 is half of the tuples, and ages uniform in [0, 100)
+    db::Tuple person(int id) {
+        const std::string city = id % 2 == 0 ? "city0" : "city" + std::to_string(id % 99 + 1);
+        return {{id, city, static_cast<double>(id % 100)}};
+    }
+
+    db::HeapFile &createTable(const char *name) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+        auto &table = dynamic_cast<db::HeapFile &>(db::getDatabase().get(name));
+        for (int i = 0; i < num_tuples; i++) {
+            table.insertTuple(person(i));
+        }
+        return table;
+    }
+
+    std::multiset<int> ids(db::Operator &op) {
+        std::multiset<int> result;
+        op.open();
+        while (op.next()) {
+            result.insert(op.getInt(0));
+        }
+        return result;
+    }
+} // namespace
+
+TEST(StatisticsTest, HyperLogLog) {
+    EXPECT_THROW(db::HyperLogLog(2), std::logic_error);
+    db::HyperLogLog small;
+    db::HyperLogLog even;
+    db::HyperLogLog odd;
+    for (uint64_t i = 0; i < 100000; i++) {
+        // the hashes of a MurmurHash3 finalizer
+        uint64_t h = i;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        (i % 2 == 0 ? even : odd).add(h);
+        (i % 2 == 0 ? even : odd).add(h);
+        if (i < 100) {
+            small.add(h);
+        }
+    }
+    EXPECT_NEAR(small.estimate(), 100, 3);
+    EXPECT_NEAR(even.estimate(), 50000, 2500);
+    even.merge(odd);
+    EXPECT_NEAR(even.estimate(), 100000, 5000);
+    EXPECT_THROW(even.merge(db::HyperLogLog(10)), std::logic_error);
+}
+
+TEST(StatisticsTest, Collect) {
+    auto &table = createTable("statistics_people.db");
+    for (size_t workers: {1, 3}) {
+        const auto stats = db::TableStatistics::collect(table, workers);
+        EXPECT_EQ(stats.rows, num_tuples);
+        EXPECT_EQ(stats.pages, table.getNumPages());
+        ASSERT_EQ(stats.columns.size(), 3);
+        const db::ColumnStatistics &id = stats.columns[0];
+        EXPECT_EQ(id.min, db::field_t(0));
+        EXPECT_EQ(id.max, db::field_t(num_tuples - 1));
+        EXPECT_NEAR(id.distinct, num_tuples, num_tuples * 0.05);
+        EXPECT_EQ(id.bounds.size(), 64);
+        EXPECT_EQ(id.bounds.back(), db::field_t(num_tuples - 1));
+        EXPECT_NEAR(id.selectivity(db::PredicateOp::LT, 5000), 0.25, 0.02);
+        EXPECT_NEAR(id.selectivity(db::PredicateOp::GE, 5000), 0.75, 0.02);
+        EXPECT_NEAR(id.selectivity(db::PredicateOp::EQ, 5000), 1.0 / num_tuples, 1e-5);
+        EXPECT_EQ(id.selectivity(db::PredicateOp::EQ, -1), 0);
+        EXPECT_EQ(id.selectivity(db::PredicateOp::LT, -1), 0);
+        EXPECT_EQ(id.selectivity(db::PredicateOp::LE, num_tuples), 1);
+
+        // the frequent city fills half of the buckets
+        const db::ColumnStatistics &city = stats.columns[1];
+        EXPECT_NEAR(city.distinct, 100, 3);
+        EXPECT_EQ(city.min, db::field_t("city0"));
+        EXPECT_NEAR(city.selectivity(db::PredicateOp::EQ, "city0"), 0.5, 0.05);
+        EXPECT_NEAR(city.selectivity(db::PredicateOp::EQ, "city7"), 0.01, 0.005);
+        EXPECT_NEAR(city.selectivity(db::PredicateOp::NE, "city0"), 0.5, 0.05);
+
+        const db::ColumnStatistics &age = stats.columns[2];
+        EXPECT_NEAR(age.selectivity(db::PredicateOp::LE, 9.0), 0.1, 0.03);
+        EXPECT_NEAR(stats.selectivity({{0, db::PredicateOp::LT, 10000}, {2, db::PredicateOp::GE, 50.0}}), 0.25, 0.03);
+    }
+    EXPECT_THROW(db::TableStatistics::collect(table, 0), std::logic_error);
+    EXPECT_THROW(db::TableStatistics::collect(table, 1, 0), std::logic_error);
+    db::getDatabase().remove("statistics_people.db");
+}
+
+TEST(StatisticsTest, Sample) {
+    auto &table = createTable("statistics_sample.db");
+    const auto stats = db::TableStatistics::collect(table, 2, 0.3);
+    EXPECT_NEAR(stats.rows, num_tuples, num_tuples * 0.15);
+    // the unique ids are extrapolated, the cities were all seen
+    EXPECT_NEAR(stats.columns[0].distinct, num_tuples, num_tuples * 0.2);
+    EXPECT_NEAR(stats.columns[1].distinct, 100, 5);
+    EXPECT_NEAR(stats.columns[0].selectivity(db::PredicateOp::LT, 5000), 0.25, 0.05);
+    db::getDatabase().remove("statistics_sample.db");
+}
+
+TEST(StatisticsTest, BTreeFile) {
+    std::remove("statistics_btree.db");
+    db::getDatabase().add(std::make_unique<db::BTreeFile>("statistics_btree.db", td, std::vector<size_t>{0}));
+    auto &file = db::getDatabase().get("statistics_btree.db");
+    for (int i = 0; i < num_tuples; i++) {
+        file.insertTuple(person(i));
+    }
+    const auto stats = db::TableStatistics::collect(file, 4);
+    EXPECT_EQ(stats.rows, num_tuples);
+    EXPECT_EQ(stats.columns[0].min, db::field_t(0));
+    EXPECT_EQ(stats.columns[2].max, db::field_t(99.0));
+    EXPECT_NEAR(stats.columns[0].selectivity(db::PredicateOp::GT, 15000), 0.25, 0.02);
+    db::getDatabase().remove("statistics_btree.db");
+}
+
+TEST(StatisticsTest, Catalog) {
+    std::remove("statistics_catalog.db");
+    db::Database &database = db::getDatabase();
+    database.openCatalog("statistics_catalog.db");
+    createTable("statistics_cataloged.db");
+    const auto stats = database.analyze("statistics_cataloged.db");
+    const auto stored = database.getCatalog()->getStatistics("statistics_cataloged.db");
+    ASSERT_TRUE(stored.has_value());
+    EXPECT_EQ(stored->rows, stats.rows);
+    EXPECT_EQ(stored->pages, stats.pages);
+    ASSERT_EQ(stored->columns.size(), stats.columns.size());
+    for (size_t i = 0; i < stats.columns.size(); i++) {
+        EXPECT_EQ(stored->columns[i].distinct, stats.columns[i].distinct);
+        EXPECT_EQ(stored->columns[i].min, stats.columns[i].min);
+        EXPECT_EQ(stored->columns[i].max, stats.columns[i].max);
+        EXPECT_EQ(stored->columns[i].bounds, stats.columns[i].bounds);
+    }
+    // the description of the file is unchanged, describing it again keeps the statistics until they are dropped
+    EXPECT_EQ(database.getCatalog()->find("statistics_cataloged.db")->indexes.size(), 0);
+    EXPECT_EQ(database.getCatalog()->find("statistics_cataloged.db")->td.size(), 3);
+    database.getCatalog()->record(database.get("statistics_cataloged.db"));
+    EXPECT_EQ(database.getCatalog()->getStatistics("statistics_cataloged.db")->rows, stats.rows);
+    database.getCatalog()->dropStatistics("statistics_cataloged.db");
+    EXPECT_FALSE(database.getCatalog()->getStatistics("statistics_cataloged.db").has_value());
+    EXPECT_THROW(database.getCatalog()->setStatistics("statistics_missing.db", stats), std::logic_error);
+    database.remove("statistics_cataloged.db");
+    database.closeCatalog();
+    std::remove("statistics_cataloged.db");
+    std::remove("statistics_catalog.db");
+}
+
+TEST(StatisticsTest, AccessPath) {
+    auto &table = createTable("statistics_path.db");
+    std::remove("statistics_path_id.db");
+    std::remove("statistics_path_city.db");
+    db::getDatabase().addIndex(
+            std::make_unique<db::SecondaryIndex>("statistics_path_id.db", "statistics_path.db", td, 0));
+    db::getDatabase().addIndex(
+            std::make_unique<db::SecondaryIndex>("statistics_path_city.db", "statistics_path.db", td, 1));
+    const auto stats = db::TableStatistics::collect(table);
+
+    const auto check = [&](const std::vector<db::Predicate> &predicates, db::AccessMethod method) {
+        const db::AccessPath path = db::AccessPath::choose(table, stats, predicates);
+        EXPECT_EQ(path.method, method);
+        db::SeqScan expected(table);
+        for (const auto &predicate: predicates) {
+            expected.pushDown(predicate);
+        }
+        auto scan = path.open(table, predicates);
+        EXPECT_EQ(ids(*scan), ids(expected));
+        return path;
+    };
+    // a point or a short range of the ids, a rare city
+    auto path = check({{0, db::PredicateOp::EQ, 42}}, db::AccessMethod::INDEX_SCAN);
+    EXPECT_EQ(path.index->getField(), 0);
+    EXPECT_NEAR(path.rows, 1, 0.5);
+    check({{0, db::PredicateOp::GT, 100}, {0, db::PredicateOp::LE, 150}, {2, db::PredicateOp::LT, 20.0}},
+          db::AccessMethod::INDEX_SCAN);
+    path = check({{1, db::PredicateOp::EQ, "nowhere"}, {0, db::PredicateOp::GE, 1000}}, db::AccessMethod::INDEX_SCAN);
+    EXPECT_EQ(path.index->getField(), 1);
+    // most of the tuples, a city on a page out of three, the frequent city, no indexed field
+    check({{0, db::PredicateOp::GE, 1000}}, db::AccessMethod::FULL_SCAN);
+    check({{1, db::PredicateOp::EQ, "city7"}}, db::AccessMethod::FULL_SCAN);
+    check({{1, db::PredicateOp::EQ, "city0"}}, db::AccessMethod::FULL_SCAN);
+    check({{2, db::PredicateOp::EQ, 5.0}}, db::AccessMethod::FULL_SCAN);
+    check({{0, db::PredicateOp::NE, 5}}, db::AccessMethod::FULL_SCAN);
+
+    db::getDatabase().remove("statistics_path_id.db");
+    db::getDatabase().remove("statistics_path_city.db");
+    db::getDatabase().remove("statistics_path.db");
+}
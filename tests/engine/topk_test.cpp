@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <db/BTreeFile.hpp>
+#include <db/Database.hpp>
+#include <db/HeapFile.hpp>
+#include <db/ReverseBTreeScan.hpp>
+#include <db/SeqScan.hpp>
+#include <db/TopK.hpp>
+#include <gtest/gtest.h>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::Tuple item(int i) { return {{i, "name" + std::to_string(i % 37), (i % 101) / 2.0 - 10}}; }
+
+    template<typename File, typename... Args>
+    db::DbFile &createFile(const char *name, int count, Args... args) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<File>(name, td, args...));
+        auto &file = db::getDatabase().get(name);
+        for (int i = 0; i < count; i++) {
+            file.insertTuple(item(static_cast<int>(static_cast<int64_t>(i) * 7919 % count)));
+        }
+        return file;
+    }
+
+    std::vector<std::vector<db::field_t>> collect(db::Operator &op) {
+        std::vector<std::vector<db::field_t>> result;
+        op.open();
+        while (op.next()) {
+            const db::Tuple t = op.getTuple();
+            result.push_back({t.get_field(0), t.get_field(1), t.get_field(2)});
+        }
+        return result;
+    }
+
+    /// The first k tuples of a file in the order of the sort fields, with equal keys in the order of the file
+    std::vector<std::vector<db::field_t>> expected(const db::DbFile &file, const std::vector<db::SortField> &fields,
+                                                   size_t k) {
+        db::SeqScan scan(file);
+        auto rows = collect(scan);
+        std::stable_sort(rows.begin(), rows.end(), [&](const auto &a, const auto &b) {
+            for (const auto &[field, descending]: fields) {
+                if (a[field] != b[field]) {
+                    return descending ? b[field] < a[field] : a[field] < b[field];
+                }
+            }
+            return false;
+        });
+        rows.resize(std::min(k, rows.size()));
+        return rows;
+    }
+} // namespace
+
+TEST(TopKTest, Heap) {
+    auto &file = createFile<db::HeapFile>("topk_heap.db", 10000);
+    for (const std::vector<db::SortField> &fields: std::vector<std::vector<db::SortField>>{
+            {{0}}, {{0, true}}, {{2}, {1, true}}, {{1}}, {{2, true}}}) {
+        for (size_t k: {0, 1, 10, 1000, 10000, 20000}) {
+            auto op = db::topK(file, fields, k);
+            EXPECT_NE(dynamic_cast<db::TopK *>(op.get()), nullptr);
+            EXPECT_EQ(collect(*op), expected(file, fields, k)) << k;
+        }
+    }
+    // the operator can be opened again
+    db::TopK top(std::make_unique<db::SeqScan>(file), {{2}, {0}}, 5);
+    EXPECT_EQ(collect(top), expected(file, {{2}, {0}}, 5));
+    EXPECT_EQ(collect(top), expected(file, {{2}, {0}}, 5));
+
+    auto filtered = db::topK(file, {{0, true}}, 3, {{1, db::PredicateOp::EQ, std::string("name5")}});
+    EXPECT_EQ(collect(*filtered), (std::vector<std::vector<db::field_t>>{
+            {9995, std::string("name5"), 9995 % 101 / 2.0 - 10},
+            {9958, std::string("name5"), 9958 % 101 / 2.0 - 10},
+            {9921, std::string("name5"), 9921 % 101 / 2.0 - 10}}));
+
+    EXPECT_THROW(db::topK(file, {}, 1), std::logic_error);
+    EXPECT_THROW(db::topK(file, {{3}}, 1), std::logic_error);
+}
+
+TEST(TopKTest, BTree) {
+    constexpr int count = 20000;
+    auto &file = createFile<db::BTreeFile>("topk_btree.db", count, std::vector<size_t>{0});
+    auto &tree = dynamic_cast<db::BTreeFile &>(file);
+    for (int i = 0; i < 500; i++) {
+        tree.deleteKey(count - 1 - 2 * i);
+    }
+
+    db::ReverseBTreeScan reverse(tree);
+    auto all = collect(reverse);
+    ASSERT_EQ(all.size(), count - 500);
+    EXPECT_EQ(all, expected(file, {{0, true}}, count));
+    // a scan that is not opened produces nothing
+    db::ReverseBTreeScan unopened(tree);
+    EXPECT_FALSE(unopened.next());
+
+    db::BufferPool &pool = db::getDatabase().getBufferPool();
+    for (const std::vector<db::SortField> &fields: std::vector<std::vector<db::SortField>>{{{0}}, {{0, true}}}) {
+        // only the pages on the path to the first leaves are read
+        const auto first = expected(file, fields, 10);
+        pool.resize(pool.size());
+        const size_t reads = file.getReads().size();
+        auto op = db::topK(file, fields, 10);
+        EXPECT_EQ(dynamic_cast<db::TopK *>(op.get()), nullptr);
+        EXPECT_EQ(collect(*op), first);
+        EXPECT_LT(file.getReads().size() - reads, 10);
+    }
+    // other orders are computed with a heap
+    auto op = db::topK(file, {{0}, {2, true}}, 10);
+    EXPECT_NE(dynamic_cast<db::TopK *>(op.get()), nullptr);
+    EXPECT_EQ(collect(*op), expected(file, {{0}, {2, true}}, 10));
+
+    auto filtered = db::topK(file, {{0, true}}, 2, {{0, db::PredicateOp::LT, 100}});
+    EXPECT_EQ(collect(*filtered), (std::vector<std::vector<db::field_t>>{{99, std::string("name25"), 99 / 2.0 - 10},
+                                                                        {98, std::string("name24"), 98 / 2.0 - 10}}));
+}
+
+TEST(TopKTest, CompositeKey) {
+    auto &file = createFile<db::BTreeFile>("topk_composite.db", 5000, std::vector<size_t>{1, 0});
+    for (const std::vector<db::SortField> &fields: std::vector<std::vector<db::SortField>>{
+            {{1}}, {{1}, {0}}, {{1, true}, {0, true}}}) {
+        auto op = db::topK(file, fields, 50);
+        EXPECT_EQ(dynamic_cast<db::TopK *>(op.get()), nullptr);
+        EXPECT_EQ(collect(*op), expected(file, fields, 50));
+    }
+    auto empty = db::topK(createFile<db::BTreeFile>("topk_empty.db", 0, 0), {{0, true}}, 5);
+    EXPECT_TRUE(collect(*empty).empty());
+}
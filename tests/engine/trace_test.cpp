@@ -0,0 +1,112 @@
+#include <db/Database.hpp>
+#include <db/Filter.hpp>
+#include <db/HeapFile.hpp>
+#include <db/Profile.hpp>
+#include <db/SeqScan.hpp>
+#include <db/Tracer.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace {
+    const db::TupleDesc td({db::type_t::INT, db::type_t::CHAR, db::type_t::DOUBLE}, {"id", "name", "price"});
+
+    db::DbFile &createFile(const char *name, int count) {
+        std::remove(name);
+        db::getDatabase().add(std::make_unique<db::HeapFile>(name, td));
+        auto &file = db::getDatabase().get(name);
+        for (int i = 0; i < count; i++) {
+            file.insertTuple({{i, "name", i / 2.0}});
+        }
+        return file;
+    }
+
+    std::unique_ptr<db::Operator> plan(const db::DbFile &file) {
+        auto scan = std::make_unique<db::Profile>(std::make_unique<db::SeqScan>(file), "scan");
+        auto filter = std::make_unique<db::Filter>(std::move(scan), std::vector<db::Predicate>{});
+        return std::make_unique<db::Profile>(std::move(filter), "filter");
+    }
+
+    size_t drain(db::Operator &op) {
+        size_t count = 0;
+        op.open();
+        while (op.next()) {
+            count++;
+        }
+        return count;
+    }
+
+    uint64_t arg(const db::TraceEvent &event, const char *key) {
+        for (const auto &[k, value]: event.args) {
+            if (std::string(k) == key) {
+                return value;
+            }
+        }
+        return UINT64_MAX;
+    }
+} // namespace
+
+TEST(TraceTest, Disabled) {
+    const char *name = "trace_disabled.db";
+    auto &file = createFile(name, 1000);
+    db::Tracer::start();
+    db::Tracer::stop();
+    auto op = plan(file);
+    EXPECT_EQ(drain(*op), 1000);
+    op.reset();
+    EXPECT_TRUE(db::Tracer::getEvents().empty());
+    db::getDatabase().remove(name);
+}
+
+TEST(TraceTest, OperatorSpans) {
+    const char *name = "trace_scan.db";
+    auto &file = createFile(name, 5000);
+    const size_t pages = file.getNumPages();
+    // the pages that are not in the buffer pool are read during the scan
+    db::getDatabase().getBufferPool().resize(db::DEFAULT_NUM_PAGES);
+
+    db::Tracer::start();
+    auto op = plan(file);
+    EXPECT_EQ(drain(*op), 5000);
+    db::Tracer::stop();
+
+    const std::vector<db::TraceEvent> events = db::Tracer::getEvents();
+    const db::TraceEvent *scan = nullptr;
+    const db::TraceEvent *filter = nullptr;
+    size_t reads = 0;
+    for (const db::TraceEvent &event: events) {
+        if (event.name == "scan") {
+            scan = &event;
+        } else if (event.name == "filter") {
+            filter = &event;
+        } else if (event.name == "read") {
+            EXPECT_STREQ(event.category, "io");
+            reads += arg(event, "pages");
+        }
+    }
+    ASSERT_NE(scan, nullptr);
+    ASSERT_NE(filter, nullptr);
+    EXPECT_EQ(arg(*scan, "rows"), 5000);
+    EXPECT_EQ(arg(*filter, "rows"), 5000);
+    // every page is accessed at least once
+    EXPECT_GE(arg(*scan, "pages"), pages);
+    EXPECT_EQ(arg(*scan, "misses"), reads);
+    EXPECT_GT(reads, 0);
+    // the spans are nested: the filter contains the scan, the scan contains the reads
+    EXPECT_EQ(filter->thread, scan->thread);
+    EXPECT_LE(filter->start, scan->start);
+    EXPECT_GE(filter->start + filter->duration, scan->start + scan->duration);
+    EXPECT_EQ(&events.front(), filter);
+
+    std::ostringstream out;
+    db::Tracer::writeChromeTrace(out);
+    EXPECT_EQ(out.str().rfind("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [", 0), 0);
+    EXPECT_NE(out.str().find("{\"name\": \"scan\", \"cat\": \"operator\", \"ph\": \"X\""), std::string::npos);
+    EXPECT_NE(out.str().find("\"args\": {\"rows\": 5000, \"pages\": "), std::string::npos);
+
+    // a new trace starts empty
+    db::Tracer::start();
+    db::Tracer::stop();
+    EXPECT_TRUE(db::Tracer::getEvents().empty());
+    op.reset();
+    db::getDatabase().remove(name);
+}
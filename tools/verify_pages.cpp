@@ -0,0 +1,48 @@
+#include <cstring>
+#include <db/PageFormat.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+
+/**
+ * Check the page checksums of database files offline.
+ *
+ * Usage: verify_pages [-j threads] file...
+ *
+ * Prints the torn or corrupted pages of every file. The exit status is 1 if a page is bad, 2 if a file cannot be read.
+ */
+int main(int argc, char *argv[]) {
+    size_t threads = std::thread::hardware_concurrency();
+    int first = 1;
+    if (argc > 2 && strcmp(argv[1], "-j") == 0) {
+        threads = std::stoul(argv[2]);
+        first = 3;
+    }
+    if (first >= argc) {
+        std::cerr << "usage: " << argv[0] << " [-j threads] file..." << std::endl;
+        return 2;
+    }
+    int status = 0;
+    for (int i = first; i < argc; i++) {
+        struct stat st{};
+        try {
+            if (stat(argv[i], &st) == -1) {
+                throw std::runtime_error("stat");
+            }
+            const std::vector<size_t> bad = db::verifyFile(argv[i], threads);
+            std::cout << argv[i] << ": " << db::storedPages(st.st_size) << " pages, " << bad.size() << " bad"
+                      << std::endl;
+            for (size_t page: bad) {
+                std::cout << "  page " << page << std::endl;
+            }
+            if (!bad.empty() && status == 0) {
+                status = 1;
+            }
+        } catch (const std::runtime_error &e) {
+            std::cerr << argv[i] << ": " << e.what() << std::endl;
+            status = 2;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,460 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <db/BTreeFile.hpp>
+#include <db/BTreeScan.hpp>
+#include <db/Database.hpp>
+#include <db/HashFile.hpp>
+#include <db/Metrics.hpp>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    enum class Distribution {
+        UNIFORM, ZIPFIAN, LATEST
+    };
+
+    enum Op {
+        READ, UPDATE, INSERT, SCAN, READ_MODIFY_WRITE, NUM_OPS
+    };
+
+    const char *const op_names[NUM_OPS] = {"READ", "UPDATE", "INSERT", "SCAN", "READ_MODIFY_WRITE"};
+
+    /// The proportions of the operations of a workload, in percent
+    struct Workload {
+        char name;
+        std::array<int, NUM_OPS> mix;
+        Distribution distribution;
+    };
+
+    /// The core workloads of YCSB
+    const std::array<Workload, 6> workloads = {{{'A', {50, 50, 0, 0, 0}, Distribution::ZIPFIAN},
+                                                {'B', {95, 5, 0, 0, 0}, Distribution::ZIPFIAN},
+                                                {'C', {100, 0, 0, 0, 0}, Distribution::ZIPFIAN},
+                                                {'D', {95, 0, 5, 0, 0}, Distribution::LATEST},
+                                                {'E', {0, 0, 5, 95, 0}, Distribution::ZIPFIAN},
+                                                {'F', {50, 0, 0, 0, 50}, Distribution::ZIPFIAN}}};
+
+    constexpr size_t max_scan_length = 100;
+
+    struct Options {
+        char workload = 'A';
+        std::optional<Distribution> distribution;
+        size_t records = 100000;
+        size_t operations = 100000;
+        size_t threads = 1;
+        size_t fields = 10;
+        size_t pool_pages = 4096;
+        std::string file_type = "btree";
+        std::string name = "ycsb.db";
+        std::string json;
+        uint64_t seed = 1;
+    };
+
+    /**
+     * The key of the record inserted at a position, a bijection of [0, 2^31) so that the records are not inserted in
+     * key order, as YCSB hashes its keys.
+     */
+    int recordKey(uint64_t position) { return static_cast<int>((position * 0x9E3779B1) & 0x7FFFFFFF); }
+
+    /**
+     * The Zipfian distribution of YCSB (Gray et al., Quickly Generating Billion-Record Synthetic Databases) over
+     * [0, items), the lower values are the more popular. The number of items can grow, zeta is then extended.
+     */
+    class ZipfianGenerator {
+        static constexpr double theta = 0.99;
+        const double alpha = 1 / (1 - theta);
+        const double zeta2 = 1 + std::pow(0.5, theta);
+        uint64_t items = 0;
+        double zetan = 0;
+        double eta = 0;
+
+    public:
+        explicit ZipfianGenerator(uint64_t items) { grow(items); }
+
+        void grow(uint64_t new_items) {
+            if (new_items <= items) {
+                return;
+            }
+            for (uint64_t i = items; i < new_items; i++) {
+                zetan += 1 / std::pow(static_cast<double>(i + 1), theta);
+            }
+            items = new_items;
+            eta = (1 - std::pow(2.0 / static_cast<double>(items), 1 - theta)) / (1 - zeta2 / zetan);
+        }
+
+        uint64_t next(std::mt19937_64 &gen) {
+            const double u = std::uniform_real_distribution<double>(0, 1)(gen);
+            const double uz = u * zetan;
+            if (uz < 1) {
+                return 0;
+            }
+            if (uz < zeta2) {
+                return 1;
+            }
+            const auto value = static_cast<uint64_t>(static_cast<double>(items) * std::pow(eta * u - eta + 1, alpha));
+            return std::min(value, items - 1);
+        }
+    };
+
+    /// The state shared by the threads of a run
+    struct Shared {
+        db::DbFile &file;
+        const Options &options;
+        const Workload &workload;
+        const Distribution distribution;
+        /// The position of the next record to insert, the records before `acknowledged` are all inserted
+        std::atomic<uint64_t> next_record;
+        std::atomic<uint64_t> acknowledged;
+        std::array<db::Histogram, NUM_OPS> latencies;
+        std::array<db::Counter, NUM_OPS> failures;
+    };
+
+    db::Tuple makeRecord(int key, size_t fields, std::mt19937_64 &gen) {
+        std::vector<db::field_t> values{key};
+        for (size_t f = 0; f < fields; f++) {
+            std::string value(db::CHAR_SIZE - 1, ' ');
+            for (char &c: value) {
+                c = static_cast<char>('a' + gen() % 26);
+            }
+            values.emplace_back(std::move(value));
+        }
+        return db::Tuple(values);
+    }
+
+    std::optional<db::Tuple> lookup(const db::DbFile &file, int key) {
+        if (auto *btree = dynamic_cast<const db::BTreeFile *>(&file)) {
+            return btree->lookup(key);
+        }
+        return dynamic_cast<const db::HashFile &>(file).lookup(key);
+    }
+
+    size_t scan(const db::DbFile &file, int key, size_t length) {
+        const auto &btree = dynamic_cast<const db::BTreeFile &>(file);
+        db::BTreeScan scan(btree, btree.lowerBound({key}), btree.end());
+        scan.open();
+        size_t count = 0;
+        while (count < length && scan.next()) {
+            count++;
+        }
+        return count;
+    }
+
+    /// Run a function in threads, the first exception of a thread is thrown once they all finished
+    template<typename F>
+    void runThreads(size_t count, F &&f) {
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < count; t++) {
+            threads.emplace_back([&f, &errors, t] {
+                try {
+                    f(t);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        for (const auto &error: errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    /// The records inserted by the load phase, in parallel
+    void load(Shared &shared) {
+        runThreads(shared.options.threads, [&shared](size_t t) {
+            std::mt19937_64 gen(shared.options.seed * 1000 + t);
+            for (uint64_t i = t; i < shared.options.records; i += shared.options.threads) {
+                shared.file.insertTuple(makeRecord(recordKey(i), shared.options.fields, gen));
+            }
+        });
+    }
+
+    void run(Shared &shared, size_t thread, size_t operations, const ZipfianGenerator &zipfian) {
+        std::mt19937_64 gen(shared.options.seed * 1000 + 500 + thread);
+        ZipfianGenerator generator = zipfian;
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<size_t> scan_length(1, max_scan_length);
+        const auto chooseRecord = [&] {
+            const uint64_t records = shared.acknowledged.load(std::memory_order_acquire);
+            switch (shared.distribution) {
+                case Distribution::UNIFORM:
+                    return std::uniform_int_distribution<uint64_t>(0, records - 1)(gen);
+                case Distribution::ZIPFIAN:
+                    generator.grow(records);
+                    return generator.next(gen);
+                case Distribution::LATEST:
+                    generator.grow(records);
+                    return records - 1 - generator.next(gen);
+            }
+            return uint64_t{0};
+        };
+        for (size_t i = 0; i < operations; i++) {
+            int choice = percent(gen);
+            size_t op = 0;
+            while (choice >= shared.workload.mix[op]) {
+                choice -= shared.workload.mix[op];
+                op++;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            switch (op) {
+                case READ:
+                    if (!lookup(shared.file, recordKey(chooseRecord())).has_value()) {
+                        shared.failures[op].add();
+                    }
+                    break;
+                case UPDATE:
+                    shared.file.insertTuple(makeRecord(recordKey(chooseRecord()), shared.options.fields, gen));
+                    break;
+                case INSERT: {
+                    const uint64_t position = shared.next_record.fetch_add(1);
+                    shared.file.insertTuple(makeRecord(recordKey(position), shared.options.fields, gen));
+                    // the latest records are visible once all the records before them are inserted
+                    uint64_t expected = position;
+                    while (!shared.acknowledged.compare_exchange_weak(expected, position + 1,
+                                                                      std::memory_order_release)) {
+                        expected = position;
+                        std::this_thread::yield();
+                    }
+                    break;
+                }
+                case SCAN:
+                    scan(shared.file, recordKey(chooseRecord()), scan_length(gen));
+                    break;
+                case READ_MODIFY_WRITE: {
+                    const int key = recordKey(chooseRecord());
+                    std::optional<db::Tuple> record = lookup(shared.file, key);
+                    if (!record.has_value()) {
+                        shared.failures[op].add();
+                        break;
+                    }
+                    db::Tuple modified = makeRecord(key, shared.options.fields, gen);
+                    std::vector<db::field_t> values;
+                    for (size_t f = 0; f < record->size(); f++) {
+                        values.push_back(f == 1 ? modified.get_field(1) : record->get_field(f));
+                    }
+                    shared.file.insertTuple(db::Tuple(values));
+                    break;
+                }
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            shared.latencies[op].record(
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    const char *distributionName(Distribution distribution) {
+        switch (distribution) {
+            case Distribution::UNIFORM:
+                return "uniform";
+            case Distribution::ZIPFIAN:
+                return "zipfian";
+            case Distribution::LATEST:
+                return "latest";
+        }
+        return "";
+    }
+
+    Options parse(int argc, char *argv[]) {
+        Options options;
+        int opt;
+        while ((opt = getopt(argc, argv, "w:d:r:o:t:n:p:f:J:s:")) != -1) {
+            switch (opt) {
+                case 'w':
+                    options.workload = static_cast<char>(std::toupper(optarg[0]));
+                    if (optarg[1] != '\0' || options.workload < 'A' || options.workload > 'F') {
+                        throw std::invalid_argument("unknown workload " + std::string(optarg));
+                    }
+                    break;
+                case 'd':
+                    if (strcmp(optarg, "uniform") == 0) {
+                        options.distribution = Distribution::UNIFORM;
+                    } else if (strcmp(optarg, "zipfian") == 0) {
+                        options.distribution = Distribution::ZIPFIAN;
+                    } else if (strcmp(optarg, "latest") == 0) {
+                        options.distribution = Distribution::LATEST;
+                    } else {
+                        throw std::invalid_argument("unknown distribution " + std::string(optarg));
+                    }
+                    break;
+                case 'r':
+                    options.records = std::stoul(optarg);
+                    break;
+                case 'o':
+                    options.operations = std::stoul(optarg);
+                    break;
+                case 't':
+                    options.threads = std::stoul(optarg);
+                    break;
+                case 'n':
+                    options.fields = std::stoul(optarg);
+                    break;
+                case 'p':
+                    options.pool_pages = std::stoul(optarg);
+                    break;
+                case 'f':
+                    options.file_type = optarg;
+                    if (options.file_type != "btree" && options.file_type != "hash") {
+                        throw std::invalid_argument("unknown file type " + options.file_type);
+                    }
+                    break;
+                case 'J':
+                    options.json = optarg;
+                    break;
+                case 's':
+                    options.seed = std::stoull(optarg);
+                    break;
+                default:
+                    throw std::invalid_argument("unknown option");
+            }
+        }
+        if (options.records == 0 || options.threads == 0 || options.fields == 0) {
+            throw std::invalid_argument("records, threads and fields must be positive");
+        }
+        if (options.workload == 'E' && options.file_type == "hash") {
+            throw std::invalid_argument("workload E scans key ranges, it needs a btree");
+        }
+        return options;
+    }
+
+    void report(const Shared &shared, double load_seconds, double run_seconds, std::ostream &out) {
+        out << "workload " << shared.workload.name << ", " << distributionName(shared.distribution) << ", "
+            << shared.options.file_type << ", " << shared.options.records << " records, "
+            << shared.options.operations << " operations, " << shared.options.threads << " threads" << std::endl;
+        out << std::fixed << std::setprecision(0);
+        out << "load: " << std::setprecision(3) << load_seconds << " s, " << std::setprecision(0)
+            << static_cast<double>(shared.options.records) / load_seconds << " records/s" << std::endl;
+        out << "run:  " << std::setprecision(3) << run_seconds << " s, " << std::setprecision(0)
+            << static_cast<double>(shared.options.operations) / run_seconds << " ops/s" << std::endl;
+        out << std::setprecision(1);
+        for (size_t op = 0; op < NUM_OPS; op++) {
+            const db::HistogramSnapshot latency = shared.latencies[op].snapshot();
+            if (latency.count == 0) {
+                continue;
+            }
+            out << std::left << std::setw(18) << op_names[op] << std::right << " count " << std::setw(9)
+                << latency.count << "  mean " << std::setw(8) << latency.mean() / 1000 << " us  p50 " << std::setw(8)
+                << static_cast<double>(latency.percentile(50)) / 1000 << " us  p99 " << std::setw(8)
+                << static_cast<double>(latency.percentile(99)) / 1000 << " us  p999 " << std::setw(8)
+                << static_cast<double>(latency.percentile(99.9)) / 1000 << " us";
+            if (shared.failures[op].value() != 0) {
+                out << "  not found " << shared.failures[op].value();
+            }
+            out << std::endl;
+        }
+    }
+
+    void writeJson(const Shared &shared, double load_seconds, double run_seconds, std::ostream &out) {
+        out << "{\"workload\": \"" << shared.workload.name << "\", \"distribution\": \""
+            << distributionName(shared.distribution) << "\", \"file\": \"" << shared.options.file_type
+            << "\", \"records\": " << shared.options.records << ", \"operations\": " << shared.options.operations
+            << ", \"threads\": " << shared.options.threads << ", \"load_seconds\": " << load_seconds
+            << ", \"run_seconds\": " << run_seconds
+            << ", \"ops_per_second\": " << static_cast<double>(shared.options.operations) / run_seconds
+            << ", \"latency_ns\": {";
+        const char *separator = "";
+        for (size_t op = 0; op < NUM_OPS; op++) {
+            const db::HistogramSnapshot latency = shared.latencies[op].snapshot();
+            if (latency.count == 0) {
+                continue;
+            }
+            out << separator << "\"" << op_names[op] << "\": {\"count\": " << latency.count
+                << ", \"mean\": " << latency.mean() << ", \"p50\": " << latency.percentile(50)
+                << ", \"p99\": " << latency.percentile(99) << ", \"p999\": " << latency.percentile(99.9)
+                << ", \"max\": " << latency.max << ", \"not_found\": " << shared.failures[op].value() << "}";
+            separator = ", ";
+        }
+        out << "}}" << std::endl;
+    }
+
+    double seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+} // namespace
+
+/**
+ * Run a YCSB core workload against a BTreeFile or a HashFile.
+ *
+ * Usage: ycsb [-w A-F] [-d uniform|zipfian|latest] [-r records] [-o operations] [-t threads] [-n fields]
+ *             [-p pool pages] [-f btree|hash] [-J results.json] [-s seed]
+ *
+ * The records (an INT key and `fields` CHAR fields) are generated and loaded by the threads, then the threads run the
+ * operations of the workload: A update heavy, B read mostly, C read only, D read latest, E short ranges, F
+ * read-modify-write. The records are chosen with the distribution of the workload unless -d is given. The throughput
+ * and the latency percentiles of every operation are printed, and written as JSON with -J.
+ * The file ycsb.db is created in the working directory and removed at the end.
+ */
+int main(int argc, char *argv[]) {
+    Options options;
+    try {
+        options = parse(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "usage: " << argv[0] << " [-w A-F] [-d uniform|zipfian|latest] [-r records] [-o operations]"
+                  << " [-t threads] [-n fields] [-p pool pages] [-f btree|hash] [-J results.json] [-s seed]"
+                  << std::endl;
+        return 2;
+    }
+    const Workload &workload = workloads[options.workload - 'A'];
+
+    std::vector<db::type_t> types{db::type_t::INT};
+    std::vector<std::string> names{"key"};
+    for (size_t f = 0; f < options.fields; f++) {
+        types.push_back(db::type_t::CHAR);
+        names.push_back("field" + std::to_string(f));
+    }
+    const db::TupleDesc td(types, names);
+    auto &database = db::getDatabase();
+    database.getBufferPool().resize(options.pool_pages);
+    std::remove(options.name.c_str());
+    if (options.file_type == "btree") {
+        database.add(std::make_unique<db::BTreeFile>(options.name, td, 0));
+    } else {
+        database.add(std::make_unique<db::HashFile>(options.name, td, 0));
+    }
+
+    Shared shared{database.get(options.name), options, workload, options.distribution.value_or(workload.distribution),
+                  options.records, options.records, {}, {}};
+    try {
+        const auto load_start = std::chrono::steady_clock::now();
+        load(shared);
+        const double load_seconds = seconds(load_start);
+
+        // zeta of the records is computed once, the threads extend their copies as records are inserted
+        const ZipfianGenerator zipfian(options.records);
+        const auto run_start = std::chrono::steady_clock::now();
+        runThreads(options.threads, [&](size_t t) {
+            const size_t operations = options.operations / options.threads + (t < options.operations % options.threads);
+            run(shared, t, operations, zipfian);
+        });
+        const double run_seconds = seconds(run_start);
+
+        report(shared, load_seconds, run_seconds, std::cout);
+        if (!options.json.empty()) {
+            std::ofstream out(options.json);
+            writeJson(shared, load_seconds, run_seconds, out);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        database.remove(options.name);
+        std::remove(options.name.c_str());
+        return 1;
+    }
+    database.remove(options.name);
+    std::remove(options.name.c_str());
+    return 0;
+}